@@ -0,0 +1,33 @@
+import std;
+import liboai;
+
+using namespace liboai;
+
+int main() {
+    OpenAI oai;
+    if (oai.auth.SetKeyEnv("OPENAI_API_KEY")) {
+        // single-input calls made within 10ms of each other share a request
+        EmbeddingCoalescer coalescer(
+            *oai.Embedding,
+            "text-embedding-3-small",
+            { .max_batch_inputs = 512, .max_wait = std::chrono::milliseconds(10) }
+        );
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&coalescer, t] {
+                auto response = coalescer.Create("Query from thread " + std::to_string(t)).get();
+                if (response) {
+                    std::cout << response.value()["data"][0]["embedding"].size() << std::endl;
+                } else {
+                    std::cout << response.error().message << std::endl;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::cout << coalescer.Stats().batches << " request(s) sent" << std::endl;
+    }
+}
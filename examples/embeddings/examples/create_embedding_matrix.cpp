@@ -0,0 +1,34 @@
+import std;
+import liboai;
+
+using namespace liboai;
+
+int main() {
+    OpenAI oai;
+    if (oai.auth.SetKeyEnv("OPENAI_API_KEY")) {
+        std::vector<std::string> documents = {
+            "The food was delicious and the waiter...",
+            "The service was slow but friendly.",
+            "I would not come back."
+        };
+
+        // vectors arrive base64-encoded and are decoded into one float buffer
+        auto matrix = oai.Embedding->CreateMatrix("text-embedding-3-small", documents);
+        if (matrix) {
+            std::cout << matrix->rows() << " x " << matrix->dims() << " floats, "
+                      << matrix->GetTotalTokens() << " tokens" << std::endl;
+
+            // cosine similarity of the first two documents
+            const auto a = matrix->row(0), b = matrix->row(1);
+            double dot = 0.0, na = 0.0, nb = 0.0;
+            for (std::size_t i = 0; i < matrix->dims(); ++i) {
+                dot += a[i] * b[i];
+                na += a[i] * a[i];
+                nb += b[i] * b[i];
+            }
+            std::cout << "similarity: " << dot / std::sqrt(na * nb) << std::endl;
+        } else {
+            std::cout << matrix.error().message << std::endl;
+        }
+    }
+}
@@ -0,0 +1,23 @@
+import std;
+import liboai;
+
+using namespace liboai;
+
+int main() {
+    OpenAI oai;
+    if (oai.auth.SetKeyEnv("OPENAI_API_KEY")) {
+        std::vector<std::string> documents;
+        for (int i = 0; i < 5000; ++i) {
+            documents.push_back("Document number " + std::to_string(i));
+        }
+
+        // sent as three requests of at most 2048 inputs, concurrently
+        auto response = oai.Embedding->Create("text-embedding-3-small", documents);
+        if (response) {
+            std::cout << response.value()["data"].size() << " embeddings, "
+                      << response.value()["usage"]["total_tokens"] << " tokens" << std::endl;
+        } else {
+            std::cout << response.error().message << std::endl;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+import std;
+import liboai;
+
+using namespace liboai;
+
+int main() {
+    OpenAI oai;
+    if (oai.auth.SetKeyEnv("OPENAI_API_KEY")) {
+        std::vector<std::string> documents = {
+            "The cat sat on the mat.",
+            "Stock markets fell sharply on Monday.",
+            "A kitten was sleeping on the rug.",
+            "The central bank raised interest rates."
+        };
+
+        auto matrix = oai.Embedding->CreateMatrix("text-embedding-3-small", documents);
+        if (!matrix) {
+            std::cout << matrix.error().message << std::endl;
+            return 1;
+        }
+
+        // ids are the documents' positions
+        VectorIndex index;
+        if (auto added = index.Add(*matrix); !added) {
+            std::cout << added.error().message << std::endl;
+            return 1;
+        }
+        if (auto saved = index.Save("documents.vix"); !saved) {
+            std::cout << saved.error().message << std::endl;
+        }
+
+        std::vector<std::string> question = { "Where is the cat?" };
+        auto query = oai.Embedding->CreateMatrix("text-embedding-3-small", question);
+        if (!query) {
+            std::cout << query.error().message << std::endl;
+            return 1;
+        }
+
+        // reopen the saved index; its vectors are read straight from the file mapping
+        auto loaded = VectorIndex::Load("documents.vix");
+        if (!loaded) {
+            std::cout << loaded.error().message << std::endl;
+            return 1;
+        }
+        if (auto hits = loaded->Search(query->row(0), 2)) {
+            for (const auto& hit : *hits) {
+                std::cout << hit.score << "  " << documents[hit.id] << std::endl;
+            }
+        }
+        std::cout << "kernel: " << VectorKernels::Isa() << std::endl;
+    }
+}
@@ -0,0 +1,24 @@
+import std;
+import liboai;
+
+using namespace liboai;
+
+int main() {
+    OpenAI oai;
+    if (oai.auth.SetKeyEnv("OPENAI_API_KEY")) {
+        DownloadOptions options;
+        options.segments = 4;
+        options.on_progress = [](const TransferProgress& progress) {
+            std::cout << progress.bytes << " / " << progress.total << " bytes, "
+                      << progress.BytesPerSecond() / (1024 * 1024) << " MiB/s" << std::endl;
+            return true; // false cancels the download
+        };
+
+        auto content = oai.File->DownloadToMemory("file-XjGxS3KTG0uNmNOK362iJua3", options);
+        if (content) {
+            std::cout << content->size() << " bytes downloaded" << std::endl;
+        } else {
+            std::cout << content.error().message << std::endl;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+import std;
+import liboai;
+
+using namespace liboai;
+
+int main() {
+    OpenAI oai;
+    if (oai.auth.SetKeyEnv("OPENAI_API_KEY")) {
+        UploadOptions options;
+        options.chunk_size = 4 * 1024 * 1024;
+        options.on_progress = [](const TransferProgress& progress) {
+            std::cout << progress.bytes << " / " << progress.total << " bytes, "
+                      << progress.BytesPerSecond() / (1024 * 1024) << " MiB/s" << std::endl;
+            return true; // false cancels the upload
+        };
+
+        auto response = oai.File->Create("C:/some/folder/file.jsonl", "fine-tune", options);
+        if (response) {
+            std::cout << response.value() << std::endl;
+        } else {
+            std::cout << response.error().message << std::endl;
+        }
+    }
+}
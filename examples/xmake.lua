@@ -72,18 +72,24 @@ example_target("edits_create_edit_async", "edits/examples/create_edit_async.cpp"
 -- Embeddings examples
 example_target("embeddings_create_embedding", "embeddings/examples/create_embedding.cpp")
 example_target("embeddings_create_embedding_async", "embeddings/examples/create_embedding_async.cpp")
+example_target("embeddings_create_embeddings_batched", "embeddings/examples/create_embeddings_batched.cpp")
+example_target("embeddings_coalesce_embeddings", "embeddings/examples/coalesce_embeddings.cpp")
+example_target("embeddings_create_embedding_matrix", "embeddings/examples/create_embedding_matrix.cpp")
+example_target("embeddings_vector_search", "embeddings/examples/vector_search.cpp")
 
 -- Files examples
 example_target("files_delete_file", "files/examples/delete_file.cpp")
 example_target("files_delete_file_async", "files/examples/delete_file_async.cpp")
 example_target("files_download_uploaded_file", "files/examples/download_uploaded_file.cpp")
 example_target("files_download_uploaded_file_async", "files/examples/download_uploaded_file_async.cpp")
+example_target("files_download_uploaded_file_to_memory", "files/examples/download_uploaded_file_to_memory.cpp")
 example_target("files_list_files", "files/examples/list_files.cpp")
 example_target("files_list_files_async", "files/examples/list_files_async.cpp")
 example_target("files_retrieve_file", "files/examples/retrieve_file.cpp")
 example_target("files_retrieve_file_async", "files/examples/retrieve_file_async.cpp")
 example_target("files_upload_file", "files/examples/upload_file.cpp")
 example_target("files_upload_file_async", "files/examples/upload_file_async.cpp")
+example_target("files_upload_file_progress", "files/examples/upload_file_progress.cpp")
 
 -- Fine-tunes examples
 example_target("fine_tunes_cancel_fine_tune", "fine-tunes/examples/cancel_fine_tune.cpp")
@@ -117,3 +123,6 @@ example_target("models_retrieve_model_async", "models/examples/retrieve_model_as
 -- Moderations examples
 example_target("moderations_create_moderation", "moderations/examples/create_moderation.cpp")
 example_target("moderations_create_moderation_async", "moderations/examples/create_moderation_async.cpp")
+
+-- Network examples
+example_target("network_prepare_benchmark", "network/examples/prepare_benchmark.cpp")
@@ -17,14 +17,22 @@ export module liboai:components.audio;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.request;
 import :core.response;
 import :core.network;
 
 export namespace liboai {
     class Audio final : private Network {
     public:
-        explicit Audio(const std::string& root) : Network(root) {}
+        explicit Audio(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         ~Audio() = default;
         Audio(const Audio&) = delete;
@@ -48,6 +56,7 @@ export namespace liboai {
          *   - If set to 0, the model will use log probability to automatically
          *     increase the temperature until certain thresholds are hit.
          * @param language The language of the audio file.
+         * @param call     Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the data in JSON format.
          */
@@ -58,7 +67,8 @@ export namespace liboai {
             std::optional<std::string> prompt = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
             std::optional<float> temperature = std::nullopt,
-            std::optional<std::string> language = std::nullopt
+            std::optional<std::string> language = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -77,6 +87,7 @@ export namespace liboai {
          *   - If set to 0, the model will use log probability to automatically
          *     increase the temperature until certain thresholds are hit.
          * @param language The language of the audio file.
+         * @param call     Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the data in JSON format.
          */
@@ -87,9 +98,27 @@ export namespace liboai {
             const std::optional<std::string>& prompt = std::nullopt,
             const std::optional<std::string>& response_format = std::nullopt,
             std::optional<float> temperature = std::nullopt,
-            const std::optional<std::string>& language = std::nullopt
+            const std::optional<std::string>& language = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Transcribe(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto TranscribeCo(
+            const std::filesystem::path& file,
+            const std::string& model,
+            const std::optional<std::string>& prompt = std::nullopt,
+            const std::optional<std::string>& response_format = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            const std::optional<std::string>& language = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Translates audio into English.
          *
@@ -104,6 +133,7 @@ export namespace liboai {
          *   - Lower values like 0.2 will make it more focused and deterministic.
          *   - If set to 0, the model will use log probability to automatically
          *     increase the temperature until certain thresholds are hit.
+         * @param call        Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the data in JSON format.
          */
@@ -113,7 +143,8 @@ export namespace liboai {
             const std::string& model,
             std::optional<std::string> prompt = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<float> temperature = std::nullopt
+            std::optional<float> temperature = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -130,6 +161,7 @@ export namespace liboai {
          *   - Lower values like 0.2 will make it more focused and deterministic.
          *   - If set to 0, the model will use log probability to automatically
          *     increase the temperature until certain thresholds are hit.
+         * @param call        Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the data in JSON format.
          */
@@ -139,9 +171,26 @@ export namespace liboai {
             const std::string& model,
             const std::optional<std::string>& prompt = std::nullopt,
             const std::optional<std::string>& response_format = std::nullopt,
-            std::optional<float> temperature = std::nullopt
+            std::optional<float> temperature = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Translate(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto TranslateCo(
+            const std::filesystem::path& file,
+            const std::string& model,
+            const std::optional<std::string>& prompt = std::nullopt,
+            const std::optional<std::string>& response_format = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Turn text into lifelike spoken audio.
          *
@@ -166,6 +215,7 @@ export namespace liboai {
          *   - pcm
          * @param speed The speed of the generated audio.
          *   - Select a value from 0.25 to 4.0. 1.0 is the default.
+         * @param call  Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the data in JSON format.
          */
@@ -175,7 +225,8 @@ export namespace liboai {
             const std::string& voice,
             const std::string& input,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<float> speed = std::nullopt
+            std::optional<float> speed = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -202,6 +253,7 @@ export namespace liboai {
          *   - pcm
          * @param speed The speed of the generated audio.
          *   - Select a value from 0.25 to 4.0. 1.0 is the default.
+         * @param call  Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the data in JSON format.
          */
@@ -211,22 +263,68 @@ export namespace liboai {
             const std::string& voice,
             const std::string& input,
             const std::optional<std::string>& response_format = std::nullopt,
-            std::optional<float> speed = std::nullopt
+            std::optional<float> speed = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Speech(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto SpeechCo(
+            const std::string& model,
+            const std::string& voice,
+            const std::string& input,
+            const std::optional<std::string>& response_format = std::nullopt,
+            std::optional<float> speed = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto TranscribeRequest(
+            const std::filesystem::path& file,
+            const std::string& model,
+            std::optional<std::string> prompt,
+            std::optional<std::string> response_format,
+            std::optional<float> temperature,
+            std::optional<std::string> language
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto TranslateRequest(
+            const std::filesystem::path& file,
+            const std::string& model,
+            std::optional<std::string> prompt,
+            std::optional<std::string> response_format,
+            std::optional<float> temperature
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto SpeechRequest(
+            const std::string& model,
+            const std::string& voice,
+            const std::string& input,
+            std::optional<std::string> response_format,
+            std::optional<float> speed
+        ) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto Audio::Transcribe(
+    auto Audio::TranscribeRequest(
         const std::filesystem::path& file,
         const std::string& model,
         std::optional<std::string> prompt,
         std::optional<std::string> response_format,
         std::optional<float> temperature,
         std::optional<std::string> language
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         if (!this->Validate(file)) {
             return std::unexpected(
                 OpenAIError::file_error(
@@ -253,16 +351,37 @@ export namespace liboai {
             form.parts.emplace_back("language", language.value());
         }
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/audio/transcriptions",
-            "multipart/form-data",
-            this->m_auth.GetAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::OpenAIMultipart),
             std::move(form),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Audio::Transcribe(
+        const std::filesystem::path& file,
+        const std::string& model,
+        std::optional<std::string> prompt,
+        std::optional<std::string> response_format,
+        std::optional<float> temperature,
+        std::optional<std::string> language,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->TranscribeRequest(
+                file,
+                model,
+                std::move(prompt),
+                std::move(response_format),
+                temperature,
+                std::move(language)
+            ),
+            call
         );
     }
 
@@ -272,28 +391,52 @@ export namespace liboai {
         const std::optional<std::string>& prompt,
         const std::optional<std::string>& response_format,
         std::optional<float> temperature,
-        const std::optional<std::string>& language
+        const std::optional<std::string>& language,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &liboai::Audio::Transcribe,
-            this,
-            file,
-            model,
-            prompt,
-            response_format,
-            temperature,
-            language
+        return this->ExecuteAsync(
+            this->TranscribeRequest(
+                file,
+                model,
+                prompt,
+                response_format,
+                temperature,
+                language
+            ),
+            call
         );
     }
 
-    auto Audio::Translate(
+    auto Audio::TranscribeCo(
+        const std::filesystem::path& file,
+        const std::string& model,
+        const std::optional<std::string>& prompt,
+        const std::optional<std::string>& response_format,
+        std::optional<float> temperature,
+        const std::optional<std::string>& language,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->TranscribeRequest(
+                file,
+                model,
+                prompt,
+                response_format,
+                temperature,
+                language
+            ),
+            call
+        );
+    }
+
+    auto Audio::TranslateRequest(
         const std::filesystem::path& file,
         const std::string& model,
         std::optional<std::string> prompt,
         std::optional<std::string> response_format,
         std::optional<float> temperature
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         if (!this->Validate(file)) {
             return std::unexpected(
                 OpenAIError::file_error(
@@ -317,16 +460,35 @@ export namespace liboai {
             form.parts.emplace_back("temperature", std::to_string(temperature.value()));
         }
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/audio/translations",
-            "multipart/form-data",
-            this->m_auth.GetAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::OpenAIMultipart),
             std::move(form),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Audio::Translate(
+        const std::filesystem::path& file,
+        const std::string& model,
+        std::optional<std::string> prompt,
+        std::optional<std::string> response_format,
+        std::optional<float> temperature,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->TranslateRequest(
+                file,
+                model,
+                std::move(prompt),
+                std::move(response_format),
+                temperature
+            ),
+            call
         );
     }
 
@@ -335,27 +497,49 @@ export namespace liboai {
         const std::string& model,
         const std::optional<std::string>& prompt,
         const std::optional<std::string>& response_format,
-        std::optional<float> temperature
+        std::optional<float> temperature,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &liboai::Audio::Translate,
-            this,
-            file,
-            model,
-            prompt,
-            response_format,
-            temperature
+        return this->ExecuteAsync(
+            this->TranslateRequest(
+                file,
+                model,
+                prompt,
+                response_format,
+                temperature
+            ),
+            call
         );
     }
 
-    auto Audio::Speech(
+    auto Audio::TranslateCo(
+        const std::filesystem::path& file,
+        const std::string& model,
+        const std::optional<std::string>& prompt,
+        const std::optional<std::string>& response_format,
+        std::optional<float> temperature,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->TranslateRequest(
+                file,
+                model,
+                prompt,
+                response_format,
+                temperature
+            ),
+            call
+        );
+    }
+
+    auto Audio::SpeechRequest(
         const std::string& model,
         const std::string& voice,
         const std::string& input,
         std::optional<std::string> response_format,
         std::optional<float> speed
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("model", model);
         jcon.push_back("voice", voice);
@@ -368,16 +552,35 @@ export namespace liboai {
             jcon.push_back("speed", speed.value());
         }
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/audio/speech",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Audio::Speech(
+        const std::string& model,
+        const std::string& voice,
+        const std::string& input,
+        std::optional<std::string> response_format,
+        std::optional<float> speed,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->SpeechRequest(
+                model,
+                voice,
+                input,
+                std::move(response_format),
+                speed
+            ),
+            call
         );
     }
 
@@ -386,17 +589,38 @@ export namespace liboai {
         const std::string& voice,
         const std::string& input,
         const std::optional<std::string>& response_format,
-        std::optional<float> speed
+        std::optional<float> speed,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &liboai::Audio::Speech,
-            this,
-            model,
-            voice,
-            input,
-            response_format,
-            speed
+        return this->ExecuteAsync(
+            this->SpeechRequest(
+                model,
+                voice,
+                input,
+                response_format,
+                speed
+            ),
+            call
+        );
+    }
+
+    auto Audio::SpeechCo(
+        const std::string& model,
+        const std::string& voice,
+        const std::string& input,
+        const std::optional<std::string>& response_format,
+        std::optional<float> speed,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->SpeechRequest(
+                model,
+                voice,
+                input,
+                response_format,
+                speed
+            ),
+            call
         );
     }
 
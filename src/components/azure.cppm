@@ -18,7 +18,12 @@ export module liboai:components.azure;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.observer;
+import :core.request;
 import :core.response;
 import :core.network;
 import :components.chat;
@@ -26,7 +31,11 @@ import :components.chat;
 export namespace liboai {
     class Azure final : private Network {
     public:
-        explicit Azure(const std::string& root) : Network(root) {}
+        explicit Azure(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Azure(const Azure&) = delete;
         Azure& operator=(const Azure&) = delete;
@@ -47,6 +56,7 @@ export namespace liboai {
          * @param *api_version The API version to use for this operation. This follows the
          * YYYY-MM-DD format.
          * @param Refer to liboai::Completions::create for more information on the remaining
+         * @param call  Cancellation token and deadline of the call.
          * parameters.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
@@ -70,7 +80,8 @@ export namespace liboai {
             std::optional<float> frequency_penalty = std::nullopt,
             std::optional<uint16_t> best_of = std::nullopt,
             std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -83,6 +94,7 @@ export namespace liboai {
          * @param *api_version The API version to use for this operation. This follows the
          * YYYY-MM-DD format.
          * @param Refer to liboai::Completions::create for more information on the remaining
+         * @param call  Cancellation token and deadline of the call.
          * parameters.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
@@ -106,9 +118,39 @@ export namespace liboai {
             std::optional<float> frequency_penalty = std::nullopt,
             std::optional<uint16_t> best_of = std::nullopt,
             std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of CreateCompletion(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCompletionCo(
+            const std::string& resource_name,
+            const std::string& deployment_id,
+            const std::string& api_version,
+            std::optional<std::string> prompt = std::nullopt,
+            std::optional<std::string> suffix = std::nullopt,
+            std::optional<uint16_t> max_tokens = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<float> top_p = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<StreamCallback> stream = std::nullopt,
+            std::optional<uint8_t> logprobs = std::nullopt,
+            std::optional<bool> echo = std::nullopt,
+            std::optional<std::vector<std::string>> stop = std::nullopt,
+            std::optional<float> presence_penalty = std::nullopt,
+            std::optional<float> frequency_penalty = std::nullopt,
+            std::optional<uint16_t> best_of = std::nullopt,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Creates an embedding vector representing the input text.
          *
@@ -119,6 +161,7 @@ export namespace liboai {
          * @param *input Input text to get embeddings for, encoded as a string. The number of input
          * tokens varies depending on what model you are using.
          * @param Refer to liboai::Embeddings::create for more information on the remaining
+         * @param call  Cancellation token and deadline of the call.
          * parameters.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
@@ -129,7 +172,8 @@ export namespace liboai {
             const std::string& deployment_id,
             const std::string& api_version,
             const std::string& input,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -142,6 +186,7 @@ export namespace liboai {
          * @param *input Input text to get embeddings for, encoded as a string. The number of input
          * tokens varies depending on what model you are using.
          * @param Refer to liboai::Embeddings::create for more information on the remaining
+         * @param call  Cancellation token and deadline of the call.
          * parameters.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
@@ -152,9 +197,26 @@ export namespace liboai {
             const std::string& deployment_id,
             const std::string& api_version,
             const std::string& input,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of CreateEmbedding(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateEmbeddingCo(
+            const std::string& resource_name,
+            const std::string& deployment_id,
+            const std::string& api_version,
+            const std::string& input,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Creates a completion for the chat message.
          *
@@ -164,6 +226,7 @@ export namespace liboai {
          * YYYY-MM-DD format.
          * @param *conversation A Conversation object containing the conversation data.
          * @param Refer to liboai::Chat::create for more information on the remaining parameters.
+         * @param call  Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the data in JSON format.
          */
@@ -182,7 +245,8 @@ export namespace liboai {
             std::optional<float> presence_penalty = std::nullopt,
             std::optional<float> frequency_penalty = std::nullopt,
             std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -194,6 +258,7 @@ export namespace liboai {
          * YYYY-MM-DD format.
          * @param *conversation A Conversation object containing the conversation data.
          * @param Refer to liboai::Chat::create for more information on the remaining parameters.
+         * @param call  Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the data in JSON format.
          */
@@ -212,9 +277,35 @@ export namespace liboai {
             std::optional<float> presence_penalty = std::nullopt,
             std::optional<float> frequency_penalty = std::nullopt,
             std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of CreateChatCompletion(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateChatCompletionCo(
+            const std::string& resource_name,
+            const std::string& deployment_id,
+            const std::string& api_version,
+            Conversation& conversation,
+            std::optional<std::string> function_call = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<ChatStreamCallback> stream = std::nullopt,
+            std::optional<std::vector<std::string>> stop = std::nullopt,
+            std::optional<uint16_t> max_tokens = std::nullopt,
+            std::optional<float> presence_penalty = std::nullopt,
+            std::optional<float> frequency_penalty = std::nullopt,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Generate a batch of images from a text caption.
          *        Image generation is currently only available with api-version=2023-06-01-preview.
@@ -225,6 +316,7 @@ export namespace liboai {
          * @param *prompt The text to create an image from.
          * @param n The number of images to create.
          * @param size The size of the image to create.
+         * @param call Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -234,7 +326,8 @@ export namespace liboai {
             const std::string& api_version,
             const std::string& prompt,
             std::optional<uint8_t> n = std::nullopt,
-            std::optional<std::string> size = std::nullopt
+            std::optional<std::string> size = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -247,6 +340,7 @@ export namespace liboai {
          * @param *prompt The text to create an image from.
          * @param n The number of images to create.
          * @param size The size of the image to create.
+         * @param call Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -256,9 +350,26 @@ export namespace liboai {
             const std::string& api_version,
             const std::string& prompt,
             std::optional<uint8_t> n = std::nullopt,
-            std::optional<std::string> size = std::nullopt
+            std::optional<std::string> size = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of RequestImageGeneration(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto RequestImageGenerationCo(
+            const std::string& resource_name,
+            const std::string& api_version,
+            const std::string& prompt,
+            std::optional<uint8_t> n = std::nullopt,
+            std::optional<std::string> size = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Retrieve the results (URL) of a previously called image generation operation.
          *
@@ -266,6 +377,7 @@ export namespace liboai {
          * @param *api_version The API version to use for this operation. This follows the
          * YYYY-MM-DD format.
          * @param *operation_id The GUID that identifies the original image generation request.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -273,7 +385,8 @@ export namespace liboai {
         auto GetGeneratedImage(
             const std::string& resource_name,
             const std::string& api_version,
-            const std::string& operation_id
+            const std::string& operation_id,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -284,6 +397,7 @@ export namespace liboai {
          * @param *api_version The API version to use for this operation. This follows the
          * YYYY-MM-DD format.
          * @param *operation_id The GUID that identifies the original image generation request.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -291,9 +405,24 @@ export namespace liboai {
         auto GetGeneratedImageAsync(
             const std::string& resource_name,
             const std::string& api_version,
-            const std::string& operation_id
+            const std::string& operation_id,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of GetGeneratedImage(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto GetGeneratedImageCo(
+            const std::string& resource_name,
+            const std::string& api_version,
+            const std::string& operation_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Deletes the corresponding image from the Azure server.
          *
@@ -301,6 +430,7 @@ export namespace liboai {
          * @param *api_version The API version to use for this operation. This follows the
          * YYYY-MM-DD format.
          * @param *operation_id The GUID that identifies the original image generation request.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -308,7 +438,8 @@ export namespace liboai {
         auto DeleteGeneratedImage(
             const std::string& resource_name,
             const std::string& api_version,
-            const std::string& operation_id
+            const std::string& operation_id,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -318,6 +449,7 @@ export namespace liboai {
          * @param *api_version The API version to use for this operation. This follows the
          * YYYY-MM-DD format.
          * @param *operation_id The GUID that identifies the original image generation request.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -325,16 +457,103 @@ export namespace liboai {
         auto DeleteGeneratedImageAsync(
             const std::string& resource_name,
             const std::string& api_version,
-            const std::string& operation_id
+            const std::string& operation_id,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of DeleteGeneratedImage(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto DeleteGeneratedImageCo(
+            const std::string& resource_name,
+            const std::string& api_version,
+            const std::string& operation_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto CreateCompletionRequest(
+            const std::string& resource_name,
+            const std::string& deployment_id,
+            const std::string& api_version,
+            std::optional<std::string> prompt,
+            std::optional<std::string> suffix,
+            std::optional<uint16_t> max_tokens,
+            std::optional<float> temperature,
+            std::optional<float> top_p,
+            std::optional<uint16_t> n,
+            std::optional<StreamCallback> stream,
+            std::optional<uint8_t> logprobs,
+            std::optional<bool> echo,
+            std::optional<std::vector<std::string>> stop,
+            std::optional<float> presence_penalty,
+            std::optional<float> frequency_penalty,
+            std::optional<uint16_t> best_of,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateEmbeddingRequest(
+            const std::string& resource_name,
+            const std::string& deployment_id,
+            const std::string& api_version,
+            const std::string& input,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateChatCompletionRequest(
+            const std::string& resource_name,
+            const std::string& deployment_id,
+            const std::string& api_version,
+            Conversation& conversation,
+            std::optional<std::string> function_call,
+            std::optional<float> temperature,
+            std::optional<uint16_t> n,
+            std::optional<ChatStreamCallback> stream,
+            std::optional<std::vector<std::string>> stop,
+            std::optional<uint16_t> max_tokens,
+            std::optional<float> presence_penalty,
+            std::optional<float> frequency_penalty,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto RequestImageGenerationRequest(
+            const std::string& resource_name,
+            const std::string& api_version,
+            const std::string& prompt,
+            std::optional<uint8_t> n,
+            std::optional<std::string> size
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto GetGeneratedImageRequest(
+            const std::string& resource_name,
+            const std::string& api_version,
+            const std::string& operation_id
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto DeleteGeneratedImageRequest(
+            const std::string& resource_name,
+            const std::string& api_version,
+            const std::string& operation_id
+        ) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
         using StrippedStreamCallback = std::function<bool(std::string, intptr_t)>;
     };
 
     // Implementation
-    auto Azure::CreateCompletion(
+    auto Azure::CreateCompletionRequest(
         const std::string& resource_name,
         const std::string& deployment_id,
         const std::string& api_version,
@@ -353,7 +572,8 @@ export namespace liboai {
         std::optional<uint16_t> best_of,
         std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("prompt", std::move(prompt));
         jcon.push_back("suffix", std::move(suffix));
@@ -374,22 +594,67 @@ export namespace liboai {
         cpr::Parameters params;
         params.Add({ "api-version", api_version });
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             ("https://" + resource_name + this->GetAzureRoot() + "/deployments/" + deployment_id),
             "/completions",
-            "application/json",
-            this->m_auth.GetAzureAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
+            RequestHeaders(credentials, HeaderSet::AzureJson),
+            jcon.body(),
             std::move(params),
             stream ? cpr::WriteCallback{ [cb = std::move(stream.value())](
                                              std::string_view data,
                                              intptr_t userdata
                                          ) -> bool { return cb(std::string(data), userdata); } } :
                      cpr::WriteCallback{},
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Azure::CreateCompletion(
+        const std::string& resource_name,
+        const std::string& deployment_id,
+        const std::string& api_version,
+        std::optional<std::string> prompt,
+        std::optional<std::string> suffix,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        std::optional<uint16_t> n,
+        std::optional<StreamCallback> stream,
+        std::optional<uint8_t> logprobs,
+        std::optional<bool> echo,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<uint16_t> best_of,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateCompletionRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                std::move(prompt),
+                std::move(suffix),
+                max_tokens,
+                temperature,
+                top_p,
+                n,
+                std::move(stream),
+                logprobs,
+                echo,
+                std::move(stop),
+                presence_penalty,
+                frequency_penalty,
+                best_of,
+                std::move(logit_bias),
+                std::move(user)
+            ),
+            call
         );
     }
 
@@ -411,40 +676,88 @@ export namespace liboai {
         std::optional<float> frequency_penalty,
         std::optional<uint16_t> best_of,
         std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Azure::CreateCompletion,
-            this,
-            resource_name,
-            deployment_id,
-            api_version,
-            prompt,
-            suffix,
-            max_tokens,
-            temperature,
-            top_p,
-            n,
-            stream,
-            logprobs,
-            echo,
-            stop,
-            presence_penalty,
-            frequency_penalty,
-            best_of,
-            logit_bias,
-            user
+        return this->ExecuteAsync(
+            this->CreateCompletionRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                std::move(prompt),
+                std::move(suffix),
+                max_tokens,
+                temperature,
+                top_p,
+                n,
+                std::move(stream),
+                logprobs,
+                echo,
+                std::move(stop),
+                presence_penalty,
+                frequency_penalty,
+                best_of,
+                std::move(logit_bias),
+                std::move(user)
+            ),
+            call
         );
     }
 
-    auto Azure::CreateEmbedding(
+    auto Azure::CreateCompletionCo(
+        const std::string& resource_name,
+        const std::string& deployment_id,
+        const std::string& api_version,
+        std::optional<std::string> prompt,
+        std::optional<std::string> suffix,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        std::optional<uint16_t> n,
+        std::optional<StreamCallback> stream,
+        std::optional<uint8_t> logprobs,
+        std::optional<bool> echo,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<uint16_t> best_of,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateCompletionRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                std::move(prompt),
+                std::move(suffix),
+                max_tokens,
+                temperature,
+                top_p,
+                n,
+                std::move(stream),
+                logprobs,
+                echo,
+                std::move(stop),
+                presence_penalty,
+                frequency_penalty,
+                best_of,
+                std::move(logit_bias),
+                std::move(user)
+            ),
+            call
+        );
+    }
+
+    auto Azure::CreateEmbeddingRequest(
         const std::string& resource_name,
         const std::string& deployment_id,
         const std::string& api_version,
         const std::string& input,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("input", input);
         jcon.push_back("user", std::move(user));
@@ -452,17 +765,36 @@ export namespace liboai {
         cpr::Parameters params;
         params.Add({ "api-version", api_version });
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             ("https://" + resource_name + this->GetAzureRoot() + "/deployments/" + deployment_id),
             "/embeddings",
-            "application/json",
-            this->m_auth.GetAzureAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
+            RequestHeaders(credentials, HeaderSet::AzureJson),
+            jcon.body(),
             std::move(params),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Azure::CreateEmbedding(
+        const std::string& resource_name,
+        const std::string& deployment_id,
+        const std::string& api_version,
+        const std::string& input,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateEmbeddingRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                input,
+                std::move(user)
+            ),
+            call
         );
     }
 
@@ -471,21 +803,42 @@ export namespace liboai {
         const std::string& deployment_id,
         const std::string& api_version,
         const std::string& input,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Azure::CreateEmbedding,
-            this,
-            resource_name,
-            deployment_id,
-            api_version,
-            input,
-            user
+        return this->ExecuteAsync(
+            this->CreateEmbeddingRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                input,
+                std::move(user)
+            ),
+            call
         );
     }
 
-    auto Azure::CreateChatCompletion(
+    auto Azure::CreateEmbeddingCo(
+        const std::string& resource_name,
+        const std::string& deployment_id,
+        const std::string& api_version,
+        const std::string& input,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateEmbeddingRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                input,
+                std::move(user)
+            ),
+            call
+        );
+    }
+
+    auto Azure::CreateChatCompletionRequest(
         const std::string& resource_name,
         const std::string& deployment_id,
         const std::string& api_version,
@@ -500,7 +853,8 @@ export namespace liboai {
         std::optional<float> frequency_penalty,
         std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("temperature", std::move(temperature));
         jcon.push_back("n", std::move(n));
@@ -546,13 +900,12 @@ export namespace liboai {
         cpr::Parameters params;
         params.Add({ "api-version", api_version });
 
-        return this->Request(
+        auto request = this->Prepare(
             Method::HTTP_POST,
             ("https://" + resource_name + this->GetAzureRoot() + "/deployments/" + deployment_id),
             "/chat/completions",
-            "application/json",
-            this->m_auth.GetAzureAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
+            RequestHeaders(credentials, HeaderSet::AzureJson),
+            jcon.body(),
             std::move(params),
             _sscb ?
                 cpr::WriteCallback{
@@ -560,9 +913,51 @@ export namespace liboai {
                         return cb(std::string(data), userdata);
                     } } :
                 cpr::WriteCallback{},
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+        if (stream) {
+            request.on_finish = [&conversation] { conversation.FinishStream(); };
+        }
+        return request;
+    }
+
+    auto Azure::CreateChatCompletion(
+        const std::string& resource_name,
+        const std::string& deployment_id,
+        const std::string& api_version,
+        Conversation& conversation,
+        std::optional<std::string> function_call,
+        std::optional<float> temperature,
+        std::optional<uint16_t> n,
+        std::optional<ChatStreamCallback> stream,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateChatCompletionRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                conversation,
+                std::move(function_call),
+                temperature,
+                n,
+                std::move(stream),
+                std::move(stop),
+                max_tokens,
+                presence_penalty,
+                frequency_penalty,
+                std::move(logit_bias),
+                std::move(user)
+            ),
+            call
         );
     }
 
@@ -580,36 +975,76 @@ export namespace liboai {
         std::optional<float> presence_penalty,
         std::optional<float> frequency_penalty,
         std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Azure::CreateChatCompletion,
-            this,
-            resource_name,
-            deployment_id,
-            api_version,
-            std::ref(conversation),
-            function_call,
-            temperature,
-            n,
-            stream,
-            stop,
-            max_tokens,
-            presence_penalty,
-            frequency_penalty,
-            logit_bias,
-            user
+        return this->ExecuteAsync(
+            this->CreateChatCompletionRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                conversation,
+                std::move(function_call),
+                temperature,
+                n,
+                std::move(stream),
+                std::move(stop),
+                max_tokens,
+                presence_penalty,
+                frequency_penalty,
+                std::move(logit_bias),
+                std::move(user)
+            ),
+            call
         );
     }
 
-    auto Azure::RequestImageGeneration(
+    auto Azure::CreateChatCompletionCo(
+        const std::string& resource_name,
+        const std::string& deployment_id,
+        const std::string& api_version,
+        Conversation& conversation,
+        std::optional<std::string> function_call,
+        std::optional<float> temperature,
+        std::optional<uint16_t> n,
+        std::optional<ChatStreamCallback> stream,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateChatCompletionRequest(
+                resource_name,
+                deployment_id,
+                api_version,
+                conversation,
+                std::move(function_call),
+                temperature,
+                n,
+                std::move(stream),
+                std::move(stop),
+                max_tokens,
+                presence_penalty,
+                frequency_penalty,
+                std::move(logit_bias),
+                std::move(user)
+            ),
+            call
+        );
+    }
+
+    auto Azure::RequestImageGenerationRequest(
         const std::string& resource_name,
         const std::string& api_version,
         const std::string& prompt,
         std::optional<uint8_t> n,
         std::optional<std::string> size
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("prompt", prompt);
         jcon.push_back("n", std::move(n));
@@ -618,17 +1053,36 @@ export namespace liboai {
         cpr::Parameters params;
         params.Add({ "api-version", api_version });
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             ("https://" + resource_name + this->GetAzureRoot()),
             "/images/generations:submit",
-            "application/json",
-            this->m_auth.GetAzureAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
+            RequestHeaders(credentials, HeaderSet::AzureJson),
+            jcon.body(),
             std::move(params),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Azure::RequestImageGeneration(
+        const std::string& resource_name,
+        const std::string& api_version,
+        const std::string& prompt,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->RequestImageGenerationRequest(
+                resource_name,
+                api_version,
+                prompt,
+                n,
+                std::move(size)
+            ),
+            call
         );
     }
 
@@ -637,89 +1091,178 @@ export namespace liboai {
         const std::string& api_version,
         const std::string& prompt,
         std::optional<uint8_t> n,
-        std::optional<std::string> size
+        std::optional<std::string> size,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Azure::RequestImageGeneration,
-            this,
-            resource_name,
-            api_version,
-            prompt,
-            n,
-            size
+        return this->ExecuteAsync(
+            this->RequestImageGenerationRequest(
+                resource_name,
+                api_version,
+                prompt,
+                n,
+                std::move(size)
+            ),
+            call
         );
     }
 
-    auto Azure::GetGeneratedImage(
+    auto Azure::RequestImageGenerationCo(
+        const std::string& resource_name,
+        const std::string& api_version,
+        const std::string& prompt,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->RequestImageGenerationRequest(
+                resource_name,
+                api_version,
+                prompt,
+                n,
+                std::move(size)
+            ),
+            call
+        );
+    }
+
+    auto Azure::GetGeneratedImageRequest(
         const std::string& resource_name,
         const std::string& api_version,
         const std::string& operation_id
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         cpr::Parameters params;
         params.Add({ "api-version", api_version });
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_GET,
             ("https://" + resource_name + this->GetAzureRoot()),
             "/operations/images/" + operation_id,
-            "application/json",
-            this->m_auth.GetAzureAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::AzureJson),
+            EndpointTemplate{ "/operations/images/{id}" },
             std::move(params),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Azure::GetGeneratedImage(
+        const std::string& resource_name,
+        const std::string& api_version,
+        const std::string& operation_id,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->GetGeneratedImageRequest(
+                resource_name,
+                api_version,
+                operation_id
+            ),
+            call
         );
     }
 
     auto Azure::GetGeneratedImageAsync(
         const std::string& resource_name,
         const std::string& api_version,
-        const std::string& operation_id
+        const std::string& operation_id,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Azure::GetGeneratedImage,
-            this,
-            resource_name,
-            api_version,
-            operation_id
+        return this->ExecuteAsync(
+            this->GetGeneratedImageRequest(
+                resource_name,
+                api_version,
+                operation_id
+            ),
+            call
         );
     }
 
-    auto Azure::DeleteGeneratedImage(
+    auto Azure::GetGeneratedImageCo(
+        const std::string& resource_name,
+        const std::string& api_version,
+        const std::string& operation_id,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->GetGeneratedImageRequest(
+                resource_name,
+                api_version,
+                operation_id
+            ),
+            call
+        );
+    }
+
+    auto Azure::DeleteGeneratedImageRequest(
         const std::string& resource_name,
         const std::string& api_version,
         const std::string& operation_id
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         cpr::Parameters params;
         params.Add({ "api-version", api_version });
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_DELETE,
             ("https://" + resource_name + this->GetAzureRoot()),
             "/operations/images/" + operation_id,
-            "application/json",
-            this->m_auth.GetAzureAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::AzureJson),
+            EndpointTemplate{ "/operations/images/{id}" },
             std::move(params),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Azure::DeleteGeneratedImage(
+        const std::string& resource_name,
+        const std::string& api_version,
+        const std::string& operation_id,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->DeleteGeneratedImageRequest(
+                resource_name,
+                api_version,
+                operation_id
+            ),
+            call
         );
     }
 
     auto Azure::DeleteGeneratedImageAsync(
         const std::string& resource_name,
         const std::string& api_version,
-        const std::string& operation_id
+        const std::string& operation_id,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Azure::DeleteGeneratedImage,
-            this,
-            resource_name,
-            api_version,
-            operation_id
+        return this->ExecuteAsync(
+            this->DeleteGeneratedImageRequest(
+                resource_name,
+                api_version,
+                operation_id
+            ),
+            call
+        );
+    }
+
+    auto Azure::DeleteGeneratedImageCo(
+        const std::string& resource_name,
+        const std::string& api_version,
+        const std::string& operation_id,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->DeleteGeneratedImageRequest(
+                resource_name,
+                api_version,
+                operation_id
+            ),
+            call
         );
     }
 
@@ -1,2388 +1,2820 @@
-module;
-
-#include <cpr/cpr.h>
-
-#include <nlohmann/json.hpp>
-
-/**
- * @file chat.cppm
- * @brief Chat component module file
- *
- * This module contains all the methods for the Chat component of the OpenAI API.
- * This class provides access to 'Chat' endpoints on the OpenAI API and should be
- * accessed via the liboai module through an instantiated liboai::OpenAI
- * object after setting necessary authentication information through the
- * liboai::Authorization::Authorizer() singleton object.
- */
-
-export module liboai:components.chat;
-
-import std;
-import :core.authorization;
-import :core.error;
-import :core.response;
-import :core.network;
-
-export namespace liboai {
-    /**
-     * @brief Class containing methods for building Function objects to supply
-     *        to the OpenAI ChatCompletions component class via the associated
-     *        Conversation class.
-     */
-    class Functions final {
-    public:
-        Functions();
-        Functions(const Functions& other);
-        Functions(Functions&& old) noexcept;
-
+module;
+
+#include <cpr/cpr.h>
+
+#include <nlohmann/json.hpp>
+
+/**
+ * @file chat.cppm
+ * @brief Chat component module file
+ *
+ * This module contains all the methods for the Chat component of the OpenAI API.
+ * This class provides access to 'Chat' endpoints on the OpenAI API and should be
+ * accessed via the liboai module through an instantiated liboai::OpenAI
+ * object after setting necessary authentication information through the
+ * liboai::Authorization::Authorizer() singleton object.
+ */
+
+export module liboai:components.chat;
+
+import std;
+import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
+import :core.error;
+import :core.request;
+import :core.response;
+import :core.response_cache;
+import :core.sse;
+import :core.network;
+
+export namespace liboai {
+    /**
+     * @brief Class containing methods for building Function objects to supply
+     *        to the OpenAI ChatCompletions component class via the associated
+     *        Conversation class.
+     */
+    class Functions final {
+    public:
+        Functions();
+        Functions(const Functions& other);
+        Functions(Functions&& old) noexcept;
+
         template <class... _Fname>
         requires (... && std::convertible_to<_Fname, std::string_view>)
         Functions(_Fname... function_names) {
             auto result = this->AddFunctions(function_names...);
         }
-
-        ~Functions() = default;
-
-        Functions& operator=(const Functions& other);
-        Functions& operator=(Functions&& old) noexcept;
-
-        /**
-         * @brief Denotes a parameter of a function, which includes the
-         *        parameter's name, type, description, and an optional enumeration.
-         *
-         * @param name        The name of the parameter.
-         * @param type        The type of the parameter.
-         * @param description The description of the parameter.
-         * @param enumeration An optional enumeration of possible values for the parameter.
-         */
-        struct FunctionParameter {
-            FunctionParameter() = default;
-
-            FunctionParameter(
-                std::string_view name,
-                std::string_view type,
-                std::string_view description,
-                std::optional<std::vector<std::string>> enumeration = std::nullopt
-            )
-                : name(name), type(type), description(description), enumeration(enumeration) {}
-
-            FunctionParameter(const FunctionParameter& other) = default;
-            FunctionParameter(FunctionParameter&& old) noexcept = default;
-            ~FunctionParameter() = default;
-
-            FunctionParameter& operator=(const FunctionParameter& other) = default;
-            FunctionParameter& operator=(FunctionParameter&& old) noexcept = default;
-
-            std::string name;
-            std::string type;
-            std::string description;
-            std::optional<std::vector<std::string>> enumeration;
-        };
-
-        /**
-         * @brief Adds a function named 'function_name' to the list of functions.
-         *
-         * This function, once added, can then be referenced in subsequent 'Functions'
-         * class method calls by the name provided here.
-         *
-         * @param function_name The name of the function to add.
-         * @return True/False denoting whether the function was added successfully.
-         */
-        [[nodiscard]]
-        auto AddFunction(std::string_view function_name) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Same as AddFunction, but allows for adding multiple functions at once.
-         *
-         * @param function_names The name of the function to add.
-         * @return True/False denoting whether the functions were added successfully.
-         */
-        [[nodiscard]]
-        auto AddFunctions(std::initializer_list<std::string_view> function_names) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Same as AddFunction, but allows for adding multiple functions at once.
-         *
-         * @param function_names The name of the function to add.
-         * @return True/False denoting whether the functions were added successfully.
-         */
-        [[nodiscard]]
-        auto AddFunctions(std::vector<std::string> function_names) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Same as AddFunction, but allows for adding multiple functions at once.
-         *
-         * @param function_names The name of the function to add.
-         * @return True/False denoting whether the functions were added successfully.
-         */
-        template <
-            class... _Fnames,
-            std::enable_if_t<
-                std::conjunction_v<std::is_convertible<_Fnames, std::string_view>...>,
-                int> = 0>
-        [[nodiscard]] auto AddFunctions(_Fnames... function_names) & noexcept
-            -> Result<bool> {
-            return this->AddFunctions({ function_names... });
-        }
-
-        /**
-         * @brief Pops the specified function from the list of functions.
-         *
-         * This will also remove any associated name, description, parameters, and so on
-         * as it involves removing the entire 'function_name' key from the JSON object.
-         *
-         * @param function_name The name of the function to pop.
-         * @return True/False denoting whether the function was popped successfully.
-         */
-        [[nodiscard]]
-        auto PopFunction(std::string_view function_name) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Same as PopFunction, but allows for popping multiple functions at once.
-         *
-         * @param function_names The name of the function to pop.
-         * @return True/False denoting whether the functions were popped successfully.
-         */
-        [[nodiscard]]
-        auto PopFunctions(std::initializer_list<std::string_view> function_names) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Same as PopFunction, but allows for popping multiple functions at once.
-         *
-         * @param function_names The name of the function to pop.
-         * @return True/False denoting whether the functions were popped successfully.
-         */
-        [[nodiscard]]
-        auto PopFunctions(std::vector<std::string> function_names) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Same as PopFunction, but allows for popping multiple functions at once.
-         *
-         * @param function_names The name of the function to pop.
-         * @return True/False denoting whether the functions were popped successfully.
-         */
-        template <
-            class... _Fnames,
-            std::enable_if_t<
-                std::conjunction_v<std::is_convertible<_Fnames, std::string_view>...>,
-                int> = 0>
-        [[nodiscard]] auto PopFunctions(_Fnames... function_names) & noexcept
-            -> Result<bool> {
-            return this->PopFunctions({ function_names... });
-        }
-
-        /**
-         * @brief Sets a previously added function's description.
-         *
-         * @param target      The name of the function to set the description of.
-         * @param description The description to set for the function.
-         * @return True/False denoting whether the description was set successfully.
-         */
-        [[nodiscard]]
-        auto SetDescription(std::string_view target, std::string_view description) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Pops a previously added function's description.
-         *
-         * @param target The name of the function to pop the description of.
-         * @return True/False denoting whether the description was popped successfully.
-         */
-        [[nodiscard]]
-        auto PopDescription(std::string_view target) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Sets which set function parameters are required.
-         *
-         * @param target The name of the function to set the required parameters of.
-         * @param params A series of parameter names to set as required.
-         * @return True/False denoting whether the required parameters were set successfully.
-         */
-        [[nodiscard]]
-        auto SetRequired(
-            std::string_view target,
-            std::initializer_list<std::string_view> params
-        ) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Sets which set function parameters are required.
-         *
-         * @param target The name of the function to set the required parameters of.
-         * @param params A series of parameter names to set as required.
-         * @return True/False denoting whether the required parameters were set successfully.
-         */
-        [[nodiscard]]
-        auto SetRequired(std::string_view target, std::vector<std::string> params) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Sets which set function parameters are required.
-         *
-         * @param target The name of the function to set the required parameters of.
-         * @param params A series of parameter names to set as required.
-         * @return True/False denoting whether the required parameters were set successfully.
-         */
-        template <
-            class... _Rp,
-            std::enable_if_t<
-                std::conjunction_v<std::is_convertible<_Rp, std::string_view>...>,
-                int> = 0>
-        [[nodiscard]] auto SetRequired(std::string_view target, _Rp... params) & noexcept
-            -> Result<bool> {
-            return SetRequired(target, { params... });
-        }
-
-        /**
-         * @brief Pops previously set required function parameters.
-         *
-         * @param target The name of the function to pop the required parameters of.
-         * @return True/False denoting whether the required parameters were popped successfully.
-         */
-        [[nodiscard]]
-        auto PopRequired(std::string_view target) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Appends a parameter to a previously set series of required function parameters.
-         *
-         * This function should only be called if required parameters have already been
-         * set for 'target' via SetRequired().
-         *
-         * @param target The name of the function to append the required parameter to.
-         * @param param  The name of the parameter to append to the required parameters.
-         * @return True/False denoting whether the required parameter was appended successfully.
-         */
-        [[nodiscard]]
-        auto AppendRequired(std::string_view target, std::string_view param) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Appends multiple parameters to a previously set series of required
-         *        function parameters.
-         *
-         * This function should only be called if required parameters have already
-         * been set for 'target' via SetRequired().
-         *
-         * @param target The name of the function to append the required parameter to.
-         * @param params The name of the parameters to append to the required parameters.
-         * @return True/False denoting whether the required parameter was appended successfully.
-         */
-        [[nodiscard]]
-        auto AppendRequired(
-            std::string_view target,
-            std::initializer_list<std::string_view> params
-        ) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Appends multiple parameters to a previously set series of required
-         *        function parameters.
-         *
-         * This function should only be called if required parameters have already
-         * been set for 'target' via SetRequired().
-         *
-         * @param target The name of the function to append the required parameter to.
-         * @param params The name of the parameters to append to the required parameters.
-         * @return True/False denoting whether the required parameter was appended successfully.
-         */
-        [[nodiscard]]
-        auto AppendRequired(std::string_view target, std::vector<std::string> params) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Appends multiple parameters to a previously set series of required
-         *        function parameters.
-         *
-         * This function should only be called if required parameters have already
-         * been set for 'target' via SetRequired().
-         *
-         * @param target The name of the function to append the required parameter to.
-         * @param params The name of the parameters to append to the required parameters.
-         * @return True/False denoting whether the required parameter was appended successfully.
-         */
-        template <
-            class... _Rp,
-            std::enable_if_t<
-                std::conjunction_v<std::is_convertible<_Rp, std::string_view>...>,
-                int> = 0>
-        [[nodiscard]] auto AppendRequired(std::string_view target, _Rp... params) & noexcept
-            -> Result<bool> {
-            return AppendRequired(target, { params... });
-        }
-
-        /**
-         * @brief Adds a single parameter to an added function.
-         *
-         * @param target    The name of the function to add the parameter to.
-         * @param parameter The parameter to add to the function.
-         * @return True/False denoting whether the parameter was added successfully.
-         */
-        [[nodiscard]]
-        auto SetParameter(std::string_view target, FunctionParameter parameter) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Adds a series of parameters to an added function.
-         *
-         * @param target     The name of the function to add the parameters to.
-         * @param parameters The parameters to add to the function.
-         * @return True/False denoting whether the parameters were added successfully.
-         */
-        [[nodiscard]]
-        auto SetParameters(
-            std::string_view target,
-            std::initializer_list<FunctionParameter> parameters
-        ) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Adds a series of parameters to an added function.
-         *
-         * @param target     The name of the function to add the parameters to.
-         * @param parameters The parameters to add to the function.
-         * @return True/False denoting whether the parameters were added successfully.
-         */
-        [[nodiscard]]
-        auto
-        SetParameters(std::string_view target, std::vector<FunctionParameter> parameters) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Adds a series of parameters to an added function.
-         *
-         * @param target     The name of the function to add the parameters to.
-         * @param parameters The parameters to add to the function.
-         * @return True/False denoting whether the parameters were added successfully.
-         */
-        template <
-            class... _Fp,
-            std::enable_if_t<std::conjunction_v<std::is_same<_Fp, FunctionParameter>...>, int> = 0>
-        [[nodiscard]] auto SetParameters(std::string_view target, _Fp... parameters) & noexcept
-            -> Result<bool> {
-            return SetParameters(target, { parameters... });
-        }
-
-        /**
-         * @brief Pops all of a function's set parameters.
-         *
-         * This function removes set 'required' values and anything else that falls
-         * under the category of 'parameters' as a result of removing the entire
-         * 'parameters' section.
-         *
-         * @param target The name of the function to pop the parameters of.
-         * @return True/False denoting whether the parameters were popped successfully.
-         */
-        [[nodiscard]]
-        auto PopParameters(std::string_view target) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Pops one or more of a function's set parameters.
-         *
-         * @param target      The name of the function to pop the parameters of.
-         * @param param_names The names of the parameters to pop.
-         * @return True/False denoting whether the parameters were popped successfully.
-         */
-        [[nodiscard]]
-        auto PopParameters(
-            std::string_view target,
-            std::initializer_list<std::string_view> param_names
-        ) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Pops one or more of a function's set parameters.
-         *
-         * @param target      The name of the function to pop the parameters of.
-         * @param param_names The names of the parameters to pop.
-         * @return True/False denoting whether the parameters were popped successfully.
-         */
-        [[nodiscard]]
-        auto PopParameters(std::string_view target, std::vector<std::string> param_names) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Pops one or more of a function's set parameters.
-         *
-         * @param target      The name of the function to pop the parameters of.
-         * @param param_names The names of the parameters to pop.
-         * @return True/False denoting whether the parameters were popped successfully.
-         */
-        template <
-            class... _Pname,
-            std::enable_if_t<
-                std::conjunction_v<std::is_convertible<_Pname, std::string_view>...>,
-                int> = 0>
-        [[nodiscard]] auto PopParameters(std::string_view target, _Pname... param_names) & noexcept
-            -> Result<bool> {
-            return PopParameters(target, { param_names... });
-        }
-
-        /**
-         * @brief Appends a single parameter to a previously added function.
-         *
-         * @param target    The name of the function to append the parameter to.
-         * @param parameter The parameter to append to the function.
-         * @return True/False denoting whether the parameter was appended successfully.
-         */
-        [[nodiscard]]
-        auto AppendParameter(std::string_view target, FunctionParameter parameter) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Appends a series of parameters to a previously added function.
-         *
-         * @param target     The name of the function to append the parameters to.
-         * @param parameters The parameters to append to the function.
-         * @return True/False denoting whether the parameters were appended successfully.
-         */
-        [[nodiscard]]
-        auto AppendParameters(
-            std::string_view target,
-            std::initializer_list<FunctionParameter> parameters
-        ) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Appends a series of parameters to a previously added function.
-         *
-         * @param target     The name of the function to append the parameters to.
-         * @param parameters The parameters to append to the function.
-         * @return True/False denoting whether the parameters were appended successfully.
-         */
-        [[nodiscard]]
-        auto AppendParameters(
-            std::string_view target,
-            std::vector<FunctionParameter> parameters
-        ) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Appends a series of parameters to a previously added function.
-         *
-         * @param target     The name of the function to append the parameters to.
-         * @param parameters The parameters to append to the function.
-         * @return True/False denoting whether the parameters were appended successfully.
-         */
-        template <
-            class... _Fp,
-            std::enable_if_t<std::conjunction_v<std::is_same<_Fp, FunctionParameter>...>, int> = 0>
-        [[nodiscard]] auto AppendParameters(std::string_view target, _Fp... parameters) & noexcept
-            -> Result<bool> {
-            return AppendParameters(target, { parameters... });
-        }
-
-        /**
-         * @brief Returns the JSON object of the internal conversation.
-         */
-        auto GetJSON() const& noexcept -> const nlohmann::json&;
-
-    private:
-        using index = std::size_t;
-        [[nodiscard]] auto GetFunctionIndex(std::string_view function_name) const& noexcept
-            -> Result<index>;
-
-        nlohmann::json m_functions;
-    };
-
-    /**
-     * @brief Class containing, and used for keeping track of, the chat history.
-     *
-     * An object of this class should be created, set with system and user data,
-     * and provided to ChatCompletion::create (system is optional).
-     *
-     * The general usage of this class is as follows:
-     * - 1. Create a ChatCompletion::Conversation object.
-     * - 2. Set the user data, which is the user's input - such as a question or
-     *      a command as well as optionally set the system data to guide how the
-     *      assistant responds.
-     * - 3. Provide the ChatCompletion::Conversation object to ChatCompletion::create.
-     * - 4. Update the ChatCompletion::Conversation object with the response from
-     *      the API - either the object or the response content can be used to
-     *      update the object.
-     * - 5. Retrieve the assistant's response from the ChatCompletion::Conversation
-     *      object.
-     * - 6. Repeat steps 2, 3, 4 and 5 until the conversation is complete.
-     *
-     * After providing the object to ChatCompletion::create, the object will be
-     * updated with the 'assistant' response - this response is the assistant's
-     * response to the user's input. A developer could then retrieve this response
-     * and display it to the user, and then set the next user input in the object
-     * and pass it back to ChatCompletion::create, if desired.
-     */
-    class Conversation final {
-    public:
-        Conversation();
-        Conversation(const Conversation& other);
-        Conversation(Conversation&& old) noexcept;
-        explicit Conversation(std::string_view system_data);
-        Conversation(std::string_view system_data, std::string_view user_data);
-        Conversation(
-            std::string_view system_data,
-            std::initializer_list<std::string_view> user_data
-        );
-        explicit Conversation(std::initializer_list<std::string_view> user_data);
-        explicit Conversation(const std::vector<std::string>& user_data);
-        ~Conversation() = default;
-
-        Conversation& operator=(const Conversation& other);
-        Conversation& operator=(Conversation&& old) noexcept;
-
-        friend std::ostream& operator<<(std::ostream& os, const Conversation& conv);
-
-        /**
-         * @brief Changes the content of the first system message in the conversation.
-         *
-         * This method updates the content of the first system message in the
-         * conversation, if it exists and is of type "system". If the first message
-         * is not a system message or the conversation is empty, the method will
-         * return false.
-         *
-         * @param new_data A string_view containing the new content for the system
-         *                 message. Must be non-empty.
-         * @return True/False denoting whether the first system message was changed
-         *         successfully.
-         */
-        [[nodiscard]]
-        auto ChangeFirstSystemMessage(std::string_view new_data) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Sets the system data for the conversation.
-         *
-         * This method sets the system data for the conversation. The system data
-         * is the data that helps set the behavior of the assistant so it knows
-         * how to respond.
-         *
-         * @param data The system data to set.
-         * @return True/False denoting whether the system data was set successfully.
-         */
-        [[nodiscard]]
-        auto SetSystemData(std::string_view data) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Removes the set system data from the top of the conversation.
-         *
-         * The system data must be the first data set, if used, in order to be
-         * removed. If the system data is not the first data set, this method
-         * will return false.
-         *
-         * @return True/False denoting whether the system data was removed successfully.
-         */
-        [[nodiscard]]
-        auto PopSystemData() & noexcept -> Result<bool>;
-
-        /**
-         * @brief Adds user input to the conversation.
-         *
-         * This method adds user input to the conversation. The user input is the
-         * user's input - such as a question or a command.
-         *
-         * If using a system prompt, the user input should be provided after the
-         * system prompt is set - i.e. after SetSystemData() is called.
-         *
-         * @param data The user input to add.
-         * @return True/False denoting whether the user input was added successfully.
-         */
-        [[nodiscard]]
-        auto AddUserData(std::string_view data) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Adds user input to the conversation.
-         *
-         * This method adds user input to the conversation. The user input is the
-         * user's input - such as a question or a command.
-         *
-         * If using a system prompt, the user input should be provided after the
-         * system prompt is set - i.e. after SetSystemData() is called.
-         *
-         * @param data The user input to add.
-         * @param name The name of the author of this message. Name is required if
-         *             role is function, and it should be the name of the function
-         *             whose response is in the content.
-         * @return True/False denoting whether the user input was added successfully.
-         */
-        [[nodiscard]]
-        auto AddUserData(std::string_view data, std::string_view name) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Removes the last added user data.
-         *
-         * @return True/False denoting whether the user data was removed.
-         */
-        [[nodiscard]]
-        auto PopUserData() & noexcept -> Result<bool>;
-
-        /**
-         * @brief Gets the last response from the assistant.
-         *
-         * This method gets the last response from the assistant. The response is
-         * the assistant's response to the user's input.
-         */
-        auto GetLastResponse() const& noexcept -> Result<std::string>;
-
-        /**
-         * @brief Returns whether the most recent response contains a function_call.
-         *
-         * This follows a call to Update. It is important to note that, when making
-         * use of functions, a developer must call this method to determine whether
-         * the response contains a function call or if it contains a regular response.
-         *
-         * @return True/False denoting whether the most recent response contains a
-         *         function_call or not.
-         */
-        [[nodiscard]]
-        auto LastResponseIsFunctionCall() const& noexcept -> Result<bool>;
-
-        /**
-         * @brief Returns the name of the function_call in the most recent response.
-         *
-         * This should only be called if LastResponseIsFunctionCall() returns true.
-         */
-        [[nodiscard]]
-        auto GetLastFunctionCallName() const& noexcept -> Result<std::string>;
-
-        /**
-         * @brief Returns the arguments of the function_call in the most recent response.
-         *
-         * Returns them in their raw JSON form. This should only be called if
-         * LastResponseIsFunctionCall() returns true.
-         */
-        [[nodiscard]]
-        auto GetLastFunctionCallArguments() const& noexcept -> Result<std::string>;
-
-        /**
-         * @brief Removes the last assistant response.
-         *
-         * @return True/False denoting whether the last response was removed.
-         */
-        [[nodiscard]]
-        auto PopLastResponse() & noexcept -> Result<bool>;
-
-        /**
-         * @brief Updates the conversation given JSON data.
-         *
-         * This method updates the conversation given JSON data. The JSON data
-         * should be the JSON 'messages' data returned from the OpenAI API.
-         *
-         * This method should only be used if AppendStreamData was NOT used
-         * immediately before it.
-         *
-         * For instance, if we made a call to create*(), and provided a callback
-         * function to stream and, within this callback, we used AppendStreamData
-         * to update the conversation per message, we would NOT want to use this
-         * method. In this scenario, the AppendStreamData method would have already
-         * updated the conversation, so this method would be a bad idea to call
-         * afterwards.
-         *
-         * @param history The JSON data to update the conversation with. This should
-         *                be the 'messages' array of data returned from a call to
-         *                ChatCompletion::create.
-         * @return True/False denoting whether the conversation was updated.
-         */
-        [[nodiscard]]
-        auto Update(std::string_view history) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Updates the conversation given a Response object.
-         *
-         * This method updates the conversation given a Response object. This method
-         * should only be used if AppendStreamData was NOT used immediately before it.
-         *
-         * For instance, if we made a call to create*(), and provided a callback
-         * function to stream and, within this callback, we used AppendStreamData
-         * to update the conversation per message, we would NOT want to use this
-         * method. In this scenario, the AppendStreamData method would have already
-         * updated the conversation, so this method would be a bad idea to call
-         * afterwards.
-         *
-         * @param response The Response to update the conversation with. This should
-         *                 be the Response returned from a call to ChatCompletion::create.
-         * @return True/False denoting whether the update was successful.
-         */
-        [[nodiscard]]
-        auto Update(const Response& response) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Exports the entire conversation to a JSON string.
-         *
-         * This method exports the conversation to a JSON string. The JSON string
-         * can be used to save the conversation to a file. The exported string
-         * contains both the conversation and included functions, if any.
-         *
-         * @return The JSON string representing the conversation.
-         */
-        [[nodiscard]]
-        auto Export() const& noexcept -> Result<std::string>;
-
-        /**
-         * @brief Imports a conversation from a JSON string.
-         *
-         * This method imports a conversation from a JSON string. The JSON string
-         * should be the JSON string returned from a call to Export().
-         *
-         * @param json The JSON string to import the conversation from.
-         * @return True/False denoting whether the conversation was imported.
-         */
-        [[nodiscard]]
-        auto Import(std::string_view json) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Appends stream data (SSEs) from streamed methods.
-         *
-         * This method updates the conversation given a token from a streamed method.
-         * This method should be used when using streamed methods such as
-         * ChatCompletion::create or create_async with a callback supplied. This
-         * function should be called from within the stream's callback function
-         * receiving the SSEs.
-         *
-         * @param token Streamed token (data) to update the conversation with.
-         */
-        [[nodiscard]]
-        auto AppendStreamData(const std::string& data) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Appends stream data (SSEs) from streamed methods.
-         *
-         * This method updates the conversation given a token from a streamed method.
-         * This method should be used when using streamed methods such as
-         * ChatCompletion::create or create_async with a callback supplied. This
-         * function should be called from within the stream's callback function
-         * receiving the SSEs.
-         *
-         * @param token    Streamed token (data) to update the conversation with.
-         * @param delta    Output parameter. The delta to append to the conversation.
-         * @param completed Output parameter. Whether the stream is completed.
-         */
-        [[nodiscard]]
-        auto
-        AppendStreamData(const std::string& data, std::string& delta, bool& completed) & noexcept
-            -> Result<bool>;
-
-        /**
-         * @brief Sets the functions to be used for the conversation.
-         *
-         * This method sets the functions to be used for the conversation.
-         *
-         * @param functions The functions to set.
-         * @return True/False denoting whether the functions were set.
-         */
-        [[nodiscard]]
-        auto SetFunctions(const Functions& functions) & noexcept -> Result<bool>;
-
-        /**
-         * @brief Pops any previously set functions.
-         */
-        auto PopFunctions() & noexcept -> void;
-
-        /**
-         * @brief Returns the raw JSON dump of the internal conversation object
-         *        in string format.
-         */
-        [[nodiscard]]
-        auto GetRawConversation() const& noexcept -> Result<std::string>;
-
-        /**
-         * @brief Returns the JSON object of the internal conversation.
-         */
-        [[nodiscard]]
-        auto GetJSON() const& noexcept -> const nlohmann::json&;
-
-        /**
-         * @brief Returns the raw JSON dump of the internal functions object
-         *        in string format - if one exists.
-         */
-        [[nodiscard]]
-        auto GetRawFunctions() const& noexcept -> Result<std::string>;
-
-        /**
-         * @brief Returns the JSON object of the set functions.
-         */
-        [[nodiscard]]
-        auto GetFunctionsJSON() const& noexcept -> const nlohmann::json&;
-
-        /**
-         * @brief Returns whether the conversation has functions or not.
-         *
-         *        This function call from ChatComplete.
-         */
-        [[nodiscard]] constexpr auto HasFunctions() const& noexcept -> bool {
-            return this->m_functions ? true : false;
-        }
-
-        /**
-         * @brief Sets the maximum history size for the conversation.
-         *
-         * @param size The maximum number of messages allowed in the conversation history.
-         *             Older messages will be removed when the limit is exceeded.
-         */
-        auto SetMaxHistorySize(size_t size) noexcept -> void { m_max_history_size = size; }
-
-    private:
-        friend class ChatCompletion;
-        friend class Azure;
-        [[nodiscard]] auto SplitStreamedData(std::string data) const noexcept
-            -> Result<std::vector<std::string>>;
-        auto RemoveStrings(std::string& s, std::string_view p) const noexcept -> void;
-        auto EraseExtra() -> void;
-        /**
-         * @brief Split full stream data that read from remote server.
-         *
-         * @return vector of string that contains the split data that will contains
-         *         the last termination string(data: "DONE").
-         */
-        [[nodiscard]] auto SplitFullStreamedData(const std::string& data) const noexcept
-            -> Result<std::vector<std::string>>;
-        auto ParseStreamData(std::string data, std::string& delta, bool& completed) noexcept
-            -> Result<bool>;
-
-        nlohmann::json m_conversation;
-        std::optional<nlohmann::json> m_functions = std::nullopt;
-        bool m_last_resp_is_fc = false;
-        std::string m_last_incomplete_buffer;
-        size_t m_max_history_size = std::numeric_limits<size_t>::max();
-    };
-
-    class ChatCompletion final : private Network {
-    public:
-        explicit ChatCompletion(const std::string& root) : Network(root) {}
-
-        ChatCompletion(const ChatCompletion&) = delete;
-        ChatCompletion& operator=(const ChatCompletion&) = delete;
-        ChatCompletion(ChatCompletion&&) = delete;
-        ChatCompletion& operator=(ChatCompletion&&) = delete;
-        ~ChatCompletion() = default;
-
-        using ChatStreamCallback = std::function<bool(std::string, intptr_t, Conversation&)>;
-
-        /**
-         * @brief Creates a completion for the chat message.
-         *
-         * @param model            ID of the model to use. Currently, only gpt-3.5-turbo
-         *                         and gpt-3.5-turbo-0301 are supported.
-         * @param conversation     A Conversation object containing the conversation data.
-         * @param function_call    Controls how the model responds to function calls.
-         *                         "none" means the model does not call a function, and
-         *                         responds to the end-user. "auto" means the model can
-         *                         pick between an end-user or calling a function.
-         * @param temperature      What sampling temperature to use, between 0 and 2.
-         *                         Higher values like 0.8 will make the output more random,
-         *                         while lower values like 0.2 will make it more focused
-         *                         and deterministic.
-         * @param top_p            An alternative to sampling with temperature, called
-         *                         nucleus sampling, where the model considers the results
-         *                         of the tokens with top_p probability mass. So 0.1 means
-         *                         only the tokens comprising the top 10% probability mass
-         *                         are considered.
-         * @param n                How many chat completion choices to generate for each
-         *                         input message.
-         * @param stream           If set, partial message deltas will be sent, like in
-         *                         ChatGPT. Tokens will be sent as data-only server-sent
-         *                         events as they become available, with the stream
-         *                         terminated by a data: [DONE] message.
-         * @param stop             Up to 4 sequences where the API will stop generating
-         *                         further tokens.
-         * @param max_tokens       The maximum number of tokens allowed for the generated
-         *                         answer. By default, the number of tokens the model can
-         *                         return will be (4096 - prompt tokens).
-         * @param presence_penalty Number between -2.0 and 2.0. Positive values penalize
-         *                         new tokens based on whether they appear in the text so
-         *                         far, increasing the model's likelihood to talk about
-         *                         new topics.
-         * @param frequency_penalty Number between -2.0 and 2.0. Positive values penalize
-         *                          new tokens based on their existing frequency in the
-         *                          text so far, decreasing the model's likelihood to
-         *                          repeat the same line verbatim.
-         * @param logit_bias       Modify the likelihood of specified tokens appearing
-         *                         in the completion.
-         * @param user             The user ID to associate with the request. This is
-         *                         used to prevent abuse of the API.
-         *
-         * @return A liboai::Response object containing the data in JSON format.
-         */
-        [[nodiscard]]
-        auto Create(
-            const std::string& model,
-            Conversation& conversation,
-            std::optional<std::string> function_call = std::nullopt,
-            std::optional<float> temperature = std::nullopt,
-            std::optional<float> top_p = std::nullopt,
-            std::optional<uint16_t> n = std::nullopt,
-            std::optional<ChatStreamCallback> stream = std::nullopt,
-            std::optional<std::vector<std::string>> stop = std::nullopt,
-            std::optional<uint16_t> max_tokens = std::nullopt,
-            std::optional<float> presence_penalty = std::nullopt,
-            std::optional<float> frequency_penalty = std::nullopt,
-            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
-        ) const& noexcept -> Result<Response>;
-
-        /**
-         * @brief Asynchronously creates a completion for the chat message.
-         *
-         * @param model            ID of the model to use. Currently, only gpt-3.5-turbo
-         *                         and gpt-3.5-turbo-0301 are supported.
-         * @param conversation     A Conversation object containing the conversation data.
-         * @param function_call    Controls how the model responds to function calls.
-         *                         "none" means the model does not call a function, and
-         *                         responds to the end-user. "auto" means the model can
-         *                         pick between an end-user or calling a function.
-         * @param temperature      What sampling temperature to use, between 0 and 2.
-         *                         Higher values like 0.8 will make the output more random,
-         *                         while lower values like 0.2 will make it more focused
-         *                         and deterministic.
-         * @param top_p            An alternative to sampling with temperature, called
-         *                         nucleus sampling, where the model considers the results
-         *                         of the tokens with top_p probability mass. So 0.1 means
-         *                         only the tokens comprising the top 10% probability mass
-         *                         are considered.
-         * @param n                How many chat completion choices to generate for each
-         *                         input message.
-         * @param stream           If set, partial message deltas will be sent, like in
-         *                         ChatGPT. Tokens will be sent as data-only server-sent
-         *                         events as they become available, with the stream
-         *                         terminated by a data: [DONE] message.
-         * @param stop             Up to 4 sequences where the API will stop generating
-         *                         further tokens.
-         * @param max_tokens       The maximum number of tokens allowed for the generated
-         *                         answer. By default, the number of tokens the model can
-         *                         return will be (4096 - prompt tokens).
-         * @param presence_penalty Number between -2.0 and 2.0. Positive values penalize
-         *                         new tokens based on whether they appear in the text so
-         *                         far, increasing the model's likelihood to talk about
-         *                         new topics.
-         * @param frequency_penalty Number between -2.0 and 2.0. Positive values penalize
-         *                          new tokens based on their existing frequency in the
-         *                          text so far, decreasing the model's likelihood to
-         *                          repeat the same line verbatim.
-         * @param logit_bias       Modify the likelihood of specified tokens appearing
-         *                         in the completion.
-         * @param user             The user ID to associate with the request. This is
-         *                         used to prevent abuse of the API.
-         *
-         * @return A liboai::Response future containing the data in JSON format.
-         */
-        [[nodiscard]]
-        auto CreateAsync(
-            const std::string& model,
-            Conversation& conversation,
-            std::optional<std::string> function_call = std::nullopt,
-            std::optional<float> temperature = std::nullopt,
-            std::optional<float> top_p = std::nullopt,
-            std::optional<uint16_t> n = std::nullopt,
-            std::optional<ChatStreamCallback> stream = std::nullopt,
-            std::optional<std::vector<std::string>> stop = std::nullopt,
-            std::optional<uint16_t> max_tokens = std::nullopt,
-            std::optional<float> presence_penalty = std::nullopt,
-            std::optional<float> frequency_penalty = std::nullopt,
-            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
-        ) const& noexcept -> FutureExpected<Response>;
-
-    private:
-        Authorization& m_auth = Authorization::Authorizer();
-        using StrippedStreamCallback = std::function<bool(std::string, intptr_t)>;
-    };
-
-    // Conversation method implementations
-    inline Conversation::Conversation(const Conversation& other)
-        : m_conversation(other.m_conversation),
-          m_functions(other.m_functions),
-          m_last_resp_is_fc(other.m_last_resp_is_fc) {}
-
-    inline Conversation::Conversation()
-        : m_conversation(nlohmann::json::object()),
-          m_functions(nlohmann::json::object()),
-          m_last_resp_is_fc(false) {}
-
-    Conversation::Conversation(Conversation&& old) noexcept
-        : m_conversation(std::move(old.m_conversation)),
-          m_functions(std::move(old.m_functions)),
-          m_last_resp_is_fc(old.m_last_resp_is_fc) {
-        old.m_conversation = nlohmann::json::object();
-        old.m_functions = nlohmann::json::object();
-    }
-
-    Conversation::Conversation(std::string_view system_data) {
-        this->m_conversation["messages"] = nlohmann::json::array();
-        auto result = this->SetSystemData(system_data);
-    }
-
-    Conversation::Conversation(std::string_view system_data, std::string_view user_data) {
-        this->m_conversation["messages"] = nlohmann::json::array();
-        auto result = this->SetSystemData(system_data);
-        result = this->AddUserData(user_data);
-    }
-
-    Conversation::Conversation(
-        std::string_view system_data,
-        std::initializer_list<std::string_view> user_data
-    ) {
-        this->m_conversation["messages"] = nlohmann::json::array();
-        auto result = this->SetSystemData(system_data);
-
-        for (const auto& data : user_data) {
-            auto result = this->AddUserData(data);
-        }
-    }
-
-    Conversation::Conversation(std::initializer_list<std::string_view> user_data) {
-        this->m_conversation["messages"] = nlohmann::json::array();
-
-        for (const auto& data : user_data) {
-            auto result = this->AddUserData(data);
-        }
-    }
-
-    Conversation::Conversation(const std::vector<std::string>& user_data) {
-        this->m_conversation["messages"] = nlohmann::json::array();
-
-        for (const auto& data : user_data) {
-            auto result = this->AddUserData(data);
-        }
-    }
-
-    auto Conversation::operator=(const Conversation& other) -> Conversation& {
-        if (this != &other) {
-            this->m_conversation = other.m_conversation;
-            this->m_functions = other.m_functions;
-            this->m_last_resp_is_fc = other.m_last_resp_is_fc;
-        }
-        return *this;
-    }
-
-    auto Conversation::operator=(Conversation&& old) noexcept -> Conversation& {
-        this->m_conversation = std::move(old.m_conversation);
-        this->m_functions = std::move(old.m_functions);
-        this->m_last_resp_is_fc = old.m_last_resp_is_fc;
-
-        old.m_conversation = nlohmann::json::object();
-        old.m_functions = nlohmann::json::object();
-
-        return *this;
-    }
-
-    auto Conversation::ChangeFirstSystemMessage(std::string_view new_data) & noexcept
-        -> Result<bool> {
-        if (!new_data.empty() && !this->m_conversation["messages"].empty()) {
-            if (this->m_conversation["messages"][0]["role"].get<std::string>() == "system") {
-                this->m_conversation["messages"][0]["content"] = new_data;
-                return true; // System message changed successfuly
-            }
-            return false;    // First message is not a system message
-        }
-        return false;        // New data is empty or conversation is empty
-    }
-
-    auto Conversation::SetSystemData(std::string_view data) & noexcept -> Result<bool> {
-        // if data provided is non-empty
-        if (!data.empty()) {
-            // if system is not set already - only one system message shall exist in any
-            // conversation
-            for (const auto& message : this->m_conversation["messages"].items()) {
-                if (message.value()["role"].get<std::string>() == "system") {
-                    return false; // system already set
-                }
-            }
-            this->m_conversation["messages"].push_back(
-                {
-                    {    "role", "system" },
-                    { "content",     data }
-            }
-            );
-            return true; // system set successfully
-        }
-        return false;    // data is empty
-    }
-
-    auto Conversation::PopSystemData() & noexcept -> Result<bool> {
-        // if conversation is non-empty
-        if (!this->m_conversation["messages"].empty()) {
-            // if first message is system
-            if (this->m_conversation["messages"][0]["role"].get<std::string>() == "system") {
-                this->m_conversation["messages"].erase(0);
-                return true; // system message popped successfully
-            }
-            return false;    // first message is not system
-        }
-        return false;        // conversation is empty
-    }
-
-    auto Conversation::EraseExtra() -> void {
-        if (m_conversation["messages"].size() > m_max_history_size) {
-            // Ensure the system message is preserved
-            auto first_msg = m_conversation["messages"].begin();
-            if (first_msg != m_conversation["messages"].end() &&
-                (*first_msg)["role"].get<std::string>() == "system") {
-                m_conversation["messages"].erase(first_msg + 1);
-            } else {
-                m_conversation["messages"].erase(first_msg);
-            }
-        }
-    }
-
-    auto Conversation::AddUserData(std::string_view data) & noexcept -> Result<bool> {
-        // if data provided is non-empty
-        if (!data.empty()) {
-            EraseExtra();
-            this->m_conversation["messages"].push_back(
-                {
-                    {    "role", "user" },
-                    { "content",   data }
-            }
-            );
-            return true; // user data added successfully
-        }
-        return false;    // data is empty
-    }
-
-    auto Conversation::AddUserData(std::string_view data, std::string_view name) & noexcept
-        -> Result<bool> {
-        // if data provided is non-empty
-        if (!data.empty()) {
-            EraseExtra();
-            this->m_conversation["messages"].push_back(
-                {
-                    {    "role", "user" },
-                    { "content",   data },
-                    {    "name",   name }
-            }
-            );
-            return true; // user data added successfully
-        }
-        return false;    // data is empty
-    }
-
-    auto Conversation::PopUserData() & noexcept -> Result<bool> {
-        // if conversation is not empty
-        if (!this->m_conversation["messages"].empty()) {
-            // if last message is user message
-            if (this->m_conversation["messages"].back()["role"].get<std::string>() == "user") {
-                this->m_conversation["messages"].erase(this->m_conversation["messages"].end() - 1);
-                return true; // user data popped successfully
-            }
-            return false;    // last message is not user message
-        }
-        return false;        // conversation is empty
-    }
-
-    auto Conversation::GetLastResponse() const& noexcept -> Result<std::string> {
-        // if conversation is not empty
-        if (!this->m_conversation["messages"].empty()) {
-            // if last message is from assistant
-            if (this->m_conversation["messages"].back()["role"].get<std::string>() == "assistant") {
-                return this->m_conversation["messages"].back()["content"].get<std::string>();
-            }
-        }
-        return ""; // no response found
-    }
-
-    auto Conversation::LastResponseIsFunctionCall() const& noexcept -> Result<bool> {
-        return this->m_last_resp_is_fc;
-    }
-
-    auto Conversation::GetLastFunctionCallName() const& noexcept -> Result<std::string> {
-        if (this->m_conversation.contains("function_call")) {
-            if (this->m_conversation["function_call"].contains("name")) {
-                return this->m_conversation["function_call"]["name"].get<std::string>();
-            }
-        }
-
-        return "";
-    }
-
-    auto Conversation::GetLastFunctionCallArguments() const& noexcept -> Result<std::string> {
-        if (this->m_conversation.contains("function_call")) {
-            if (this->m_conversation["function_call"].contains("arguments")) {
-                return this->m_conversation["function_call"]["arguments"].get<std::string>();
-            }
-        }
-
-        return "";
-    }
-
-    auto Conversation::PopLastResponse() & noexcept -> Result<bool> {
-        // if conversation is not empty
-        if (!this->m_conversation["messages"].empty()) {
-            // if last message is assistant message
-            if (this->m_conversation["messages"].back()["role"].get<std::string>() == "assistant") {
-                this->m_conversation["messages"].erase(this->m_conversation["messages"].end() - 1);
-                return true; // assistant data popped successfully
-            }
-            return false;    // last message is not assistant message
-        }
-        return false;        // conversation is empty
-    }
-
-    auto Conversation::Update(std::string_view history) & noexcept -> Result<bool> {
-        // reset "last response is function call" flag
-        if (this->m_last_resp_is_fc) {
-            if (this->m_conversation.contains("function_call")) {
-                this->m_conversation.erase("function_call");
-            }
-            this->m_last_resp_is_fc = false;
-        }
-
-        // if history is non-empty
-        if (!history.empty()) {
-            nlohmann::json j = nlohmann::json::parse(history);
-            if (j.contains("choices")) { // top level, several messages
-                for (const auto& choice : j["choices"].items()) {
-                    if (choice.value().contains("message")) {
-                        if (choice.value()["message"].contains("role") &&
-                            choice.value()["message"].contains("content")) {
-                            if (!choice.value()["message"]["content"].is_null()) {
-                                EraseExtra();
-                                this->m_conversation["messages"].push_back(
-                                    {
-                                        {    "role",    choice.value()["message"]["role"] },
-                                        { "content", choice.value()["message"]["content"] }
-                                }
-                                );
-                            } else {
-                                EraseExtra();
-                                this->m_conversation["messages"].push_back(
-                                    {
-                                        {    "role", choice.value()["message"]["role"] },
-                                        { "content",                                "" }
-                                }
-                                );
-                            }
-
-                            if (choice.value()["message"].contains("function_call")) {
-                                // if a function_call is present in the response, the
-                                // conversation is not updated as there is no assistant
-                                // response to be added. However, we do add the function
-                                // information
-
-                                this->m_conversation["function_call"] = nlohmann::json::object();
-                                if (choice.value()["message"]["function_call"].contains("name")) {
-                                    this->m_conversation["function_call"]["name"] =
-                                        choice.value()["message"]["function_call"]["name"];
-                                }
-                                if (choice.value()["message"]["function_call"].contains(
-                                        "arguments"
-                                    )) {
-                                    this->m_conversation["function_call"]["arguments"] =
-                                        choice.value()["message"]["function_call"]["arguments"];
-                                }
-
-                                this->m_last_resp_is_fc = true;
-                            }
-
-                            return true;        // conversation updated successfully
-                        }
-                        return false;           // response is not valid
-                    }
-                    return false;               // no response found
-                }
-            } else if (j.contains("message")) { // mid level, single message
-                if (j["message"].contains("role") && j["message"].contains("content")) {
-                    if (j["message"]["content"].is_null()) {
-                        EraseExtra();
-                        this->m_conversation["messages"].push_back(
-                            {
-                                {    "role",    j["message"]["role"] },
-                                { "content", j["message"]["content"] }
-                        }
-                        );
-                    } else {
-                        EraseExtra();
-                        this->m_conversation["messages"].push_back(
-                            {
-                                {    "role", j["message"]["role"] },
-                                { "content",                   "" }
-                        }
-                        );
-                    }
-
-                    if (j["message"].contains("function_call")) {
-                        // if a function_call is present in the response, the
-                        // conversation is not updated as there is no assistant
-                        // response to be added. However, we do add the function
-                        // information
-
-                        this->m_conversation["function_call"] = nlohmann::json::object();
-                        if (j["message"]["function_call"].contains("name")) {
-                            this->m_conversation["function_call"]["name"] =
-                                j["message"]["function_call"]["name"];
-                        }
-                        if (j["message"]["function_call"].contains("arguments")) {
-                            this->m_conversation["function_call"]["arguments"] =
-                                j["message"]["function_call"]["arguments"];
-                        }
-
-                        this->m_last_resp_is_fc = true;
-                    }
-
-                    return true;                                      // conversation updated successfully
-                }
-                return false;                                         // response is not valid
-            } else if (j.contains("role") && j.contains("content")) { // low level, single message
-                if (j["message"]["content"].is_null()) {
-                    EraseExtra();
-                    this->m_conversation["messages"].push_back(
-                        {
-                            {    "role",    j["message"]["role"] },
-                            { "content", j["message"]["content"] }
-                    }
-                    );
-                } else {
-                    EraseExtra();
-                    this->m_conversation["messages"].push_back(
-                        {
-                            {    "role", j["message"]["role"] },
-                            { "content",                   "" }
-                    }
-                    );
-                }
-
-                if (j["message"].contains("function_call")) {
-                    // if a function_call is present in the response, the
-                    // conversation is not updated as there is no assistant
-                    // response to be added. However, we do add the function
-                    // information
-                    this->m_conversation["function_call"] = nlohmann::json::object();
-                    if (j["message"]["function_call"].contains("name")) {
-                        this->m_conversation["function_call"]["name"] =
-                            j["message"]["function_call"]["name"];
-                    }
-                    if (j["message"]["function_call"].contains("arguments")) {
-                        this->m_conversation["function_call"]["arguments"] =
-                            j["message"]["function_call"]["arguments"];
-                    }
-
-                    this->m_last_resp_is_fc = true;
-                }
-
-                return true;  // conversation updated successfully
-            } else {
-                return false; // invalid response
-            }
-        }
-        return false; // response is empty
-    }
-
-    auto Conversation::Update(const Response& response) & noexcept -> Result<bool> {
-        return this->Update(response.content);
-    }
-
-    auto Conversation::Export() const& noexcept -> Result<std::string> {
-        nlohmann::json j;
-
-        if (!this->m_conversation.empty()) {
-            j["messages"] = this->m_conversation["messages"];
-
-            if (this->m_functions) {
-                j["functions"] = this->m_functions.value()["functions"];
-            }
-
-            return j.dump(4); // conversation exported successfully
-        }
-
-        return ""; // conversation is empty
-    }
-
-    auto Conversation::Import(std::string_view json) & noexcept -> Result<bool> {
-        if (!json.empty()) {
-            nlohmann::json j = nlohmann::json::parse(json);
-
-            if (j.contains("messages")) {
-                this->m_conversation["messages"] = j["messages"];
-
-                if (j.contains("functions")) {
-                    this->m_functions = nlohmann::json();
-                    this->m_functions.value()["functions"] = j["functions"];
-                }
-
-                return true; // conversation imported successfully
-            }
-
-            return false; // no messages found
-        }
-
-        return false; // json is empty
-    }
-
-    auto Conversation::AppendStreamData(const std::string& data) & noexcept -> Result<bool> {
-        if (!data.empty()) {
-            std::string delta;
-            bool completed = false;
-            return this->ParseStreamData(data, delta, completed);
-        }
-
-        return false; // data is empty
-    }
-
-    auto Conversation::AppendStreamData(
-        const std::string& data,
-        std::string& delta,
-        bool& completed
-    ) & noexcept -> Result<bool> {
-        if (!data.empty()) {
-            return this->ParseStreamData(data, delta, completed);
-        }
-
-        return false;
-    }
-
-    auto Conversation::SetFunctions(const Functions& functions) & noexcept -> Result<bool> {
-        nlohmann::json j = functions.GetJSON();
-
-        if (!j.empty() && j.contains("functions") && j["functions"].size() > 0) {
-            this->m_functions = std::move(j);
-            return true; // functions set successfully
-        }
-
-        return false; // functions are empty
-    }
-
-    auto Conversation::PopFunctions() & noexcept -> void {
-        this->m_functions = std::nullopt;
-    }
-
-    auto Conversation::GetRawConversation() const& noexcept -> Result<std::string> {
-        return this->m_conversation.dump(4);
-    }
-
-    auto Conversation::GetJSON() const& noexcept -> const nlohmann::json& {
-        return this->m_conversation;
-    }
-
-    auto Conversation::GetRawFunctions() const& noexcept -> Result<std::string> {
-        return this->HasFunctions() ? this->m_functions.value().dump(4) : "";
-    }
-
-    auto Conversation::GetFunctionsJSON() const& noexcept -> const nlohmann::json& {
-        return this->m_functions.value();
-    }
-
-    auto Conversation::SplitStreamedData(std::string data) const noexcept
-        -> Result<std::vector<std::string>> {
-        // remove all instances of the string "data: " from the string
-        this->RemoveStrings(data, "data: ");
-
-        /*
-            Splits the streamed data into a vector of strings
-            via delimiter of two newlines.
-
-            For instance, a string of "Hello\n\nWorld" would
-            be split into a vector of {"Hello", "World"}, and
-            a string of "Hello World" would be split into
-            a vector of {"Hello World"}.
-        */
-        if (!data.empty()) {
-            std::vector<std::string> split_data;
-            std::string temp;
-            std::istringstream iss(data);
-            while (std::getline(iss, temp)) {
-                split_data.push_back(temp);
-            }
-
-            // remove empty strings from the vector
-            split_data.erase(
-                std::remove_if(
-                    split_data.begin(),
-                    split_data.end(),
-                    [](const std::string& s) { return s.empty(); }
-                ),
-                split_data.end()
-            );
-
-            return split_data;
-        }
-
-        return {};
-    }
-
-    auto Conversation::RemoveStrings(std::string& s, std::string_view p) const noexcept -> void {
-        std::string::size_type i = s.find(p);
-        while (i != std::string::npos) {
-            s.erase(i, p.length());
-            i = s.find(p, i);
-        }
-    }
-
-    auto Conversation::SplitFullStreamedData(const std::string& data) const noexcept
-        -> Result<std::vector<std::string>> {
-        if (data.empty()) {
-            return {};
-        }
-
-        std::vector<std::string> split_data;
-        std::string temp;
-        std::istringstream iss(data);
-        while (std::getline(iss, temp)) {
-            split_data.push_back(temp);
-        }
-
-        // remove empty strings from the vector
-        split_data.erase(
-            std::remove_if(
-                split_data.begin(),
-                split_data.end(),
-                [](const std::string& s) { return s.empty(); }
-            ),
-            split_data.end()
-        );
-
-        return split_data;
-    }
-
-    auto Conversation::ParseStreamData(
-        std::string data,
-        std::string& delta_content,
-        bool& completed
-    ) noexcept -> Result<bool> {
-        if (!m_last_incomplete_buffer.empty()) {
-            data = m_last_incomplete_buffer + data;
-            m_last_incomplete_buffer.clear();
-        }
-
-        auto lines_result = SplitFullStreamedData(data);
-        if (!lines_result) {
-            return std::unexpected(lines_result.error());
-        }
-        std::vector<std::string> data_lines = std::move(*lines_result);
-
-        if (data_lines.empty()) {
-            return false;
-        }
-
-        // create an empty message at the end of the conversation,
-        // marked as "pending" to indicate that the response is
-        // still being processed. This flag will be removed once
-        // the response is processed. If the marking already
-        // exists, keep appending to the same message.
-        if (this->m_conversation["messages"].empty() ||
-            !this->m_conversation["messages"].back().contains("pending")) {
-            this->m_conversation["messages"].push_back(
-                {
-                    {    "role",   "" },
-                    { "content",   "" },
-                    { "pending", true }
-            }
-            );
-        }
-
-        for (auto& line : data_lines) {
-            if (line.find("data: [DONE]") == std::string::npos) {
-                /*
-                    j should have content in the form of:
-                        {"id":"chatcmpl-7SKOck29emvbBbDS6cHg5xwnRrsLO","object":"chat.completion.chunk","created":1686985942,"model":"gpt-3.5-turbo-0613","choices":[{"index":0,"delta":{"content":"."},"finish_reason":null}]}
-                    where "delta" may be empty
-                */
-                this->RemoveStrings(line, "data: ");
-
-                nlohmann::json j;
-                try {
-                    j = nlohmann::json::parse(line);
-                } catch (const std::exception& e) {
-                    m_last_incomplete_buffer = line;
-                    continue;
-                }
-
-                if (j.contains("choices")) {
-                    if (j["choices"][0].contains("delta")) {
-                        if (!j["choices"][0]["delta"].empty() &&
-                            !j["choices"][0]["delta"].is_null()) {
-                            if (j["choices"][0]["delta"].contains("role")) {
-                                this->m_conversation["messages"].back()["role"] =
-                                    j["choices"][0]["delta"]["role"];
-                            }
-
-                            if (j["choices"][0]["delta"].contains("content")) {
-                                if (!j["choices"][0]["delta"]["content"].empty() &&
-                                    !j["choices"][0]["delta"]["content"].is_null()) {
-                                    std::string stream_content =
-                                        j["choices"][0]["delta"]["content"].get<std::string>();
-                                    this->m_conversation["messages"].back()["content"] =
-                                        this->m_conversation["messages"]
-                                            .back()["content"]
-                                            .get<std::string>() +
-                                        stream_content;
-                                    delta_content += stream_content;
-                                }
-
-                                // function calls do not have a content field,
-                                // set m_last_resp_is_fc to false and remove any
-                                // previously set function_call field in the
-                                // conversation
-                                if (this->m_last_resp_is_fc) {
-                                    if (this->m_conversation.contains("function_call")) {
-                                        this->m_conversation.erase("function_call");
-                                    }
-                                    this->m_last_resp_is_fc = false;
-                                }
-                            }
-
-                            if (j["choices"][0]["delta"].contains("function_call")) {
-                                if (!j["choices"][0]["delta"]["function_call"].empty() &&
-                                    !j["choices"][0]["delta"]["function_call"].is_null()) {
-                                    if (j["choices"][0]["delta"]["function_call"].contains(
-                                            "name"
-                                        )) {
-                                        if (!j["choices"][0]["delta"]["function_call"]["name"]
-                                                 .empty() &&
-                                            !j["choices"][0]["delta"]["function_call"]["name"]
-                                                 .is_null()) {
-                                            if (!this->m_conversation["messages"].back().contains(
-                                                    "function_call"
-                                                )) {
-                                                this->m_conversation["function_call"] = {
-                                                    { "name",
-                                                     j["choices"][0]["delta"]["function_call"]
-                                                       ["name"] }
-                                                };
-                                                this->m_last_resp_is_fc = true;
-                                            }
-                                        }
-                                    } else if (j["choices"][0]["delta"]["function_call"].contains(
-                                                   "arguments"
-                                               )) {
-                                        if (!j["choices"][0]["delta"]["function_call"]["arguments"]
-                                                 .empty() &&
-                                            !j["choices"][0]["delta"]["function_call"]["arguments"]
-                                                 .is_null()) {
-                                            if (!this->m_conversation["function_call"].contains(
-                                                    "arguments"
-                                                )) {
-                                                this->m_conversation["function_call"].push_back(
-                                                    { "arguments",
-                                                      j["choices"][0]["delta"]["function_call"]
-                                                       ["arguments"] }
-                                                );
-                                            } else {
-                                                this->m_conversation["function_call"]["arguments"] =
-                                                    this->m_conversation["function_call"]
-                                                                        ["arguments"]
-                                                                            .get<std::string>() +
-                                                    j["choices"][0]["delta"]["function_call"]
-                                                     ["arguments"]
-                                                         .get<std::string>();
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                } else {
-                    return false; // no "choices" found - invalid
-                }
-            } else {
-                // the response is complete, erase the "pending" flag
-                this->m_conversation["messages"].back().erase("pending");
-                completed = true;
-            }
-        }
-
-        return true; // last message received
-    }
-
-    auto ChatCompletion::Create(
-        const std::string& model,
-        Conversation& conversation,
-        std::optional<std::string> function_call,
-        std::optional<float> temperature,
-        std::optional<float> top_p,
-        std::optional<uint16_t> n,
-        std::optional<ChatStreamCallback> stream,
-        std::optional<std::vector<std::string>> stop,
-        std::optional<uint16_t> max_tokens,
-        std::optional<float> presence_penalty,
-        std::optional<float> frequency_penalty,
-        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
-        std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
-        JsonConstructor jcon;
-        jcon.push_back("model", model);
-        jcon.push_back("temperature", temperature);
-        jcon.push_back("top_p", top_p);
-        jcon.push_back("n", n);
-        jcon.push_back("stop", std::move(stop));
-        jcon.push_back("max_tokens", max_tokens);
-        jcon.push_back("presence_penalty", presence_penalty);
-        jcon.push_back("frequency_penalty", frequency_penalty);
-        jcon.push_back("logit_bias", std::move(logit_bias));
-        jcon.push_back("user", std::move(user));
-
-        if (function_call) {
-            if (function_call.value() == "none" || function_call.value() == "auto") {
-                nlohmann::json j;
-                j["function_call"] = function_call.value();
-                jcon.push_back("function_call", j["function_call"]);
-            } else {
-                nlohmann::json j;
-                j["function_call"] = {
-                    { "name", function_call.value() }
-                };
-                jcon.push_back("function_call", j["function_call"]);
-            }
-        }
-
-        StrippedStreamCallback _sscb = nullptr;
-        if (stream) {
-            _sscb = [stream, &conversation](std::string data, intptr_t userdata) -> bool {
-                ChatStreamCallback _stream = stream.value();
-                return _stream(data, userdata, conversation);
-            };
-
-            jcon.push_back("stream", _sscb);
-        }
-
-        if (conversation.GetJSON().contains("messages")) {
-            jcon.push_back("messages", conversation.GetJSON()["messages"]);
-        }
-
-        if (conversation.HasFunctions()) {
-            jcon.push_back("functions", conversation.GetFunctionsJSON()["functions"]);
-        }
-
-        return this->Request(
-            Method::HTTP_POST,
-            this->GetOpenAIRoot(),
-            "/chat/completions",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            _sscb ?
-                cpr::WriteCallback{
-                    [cb = std::move(_sscb)](std::string_view data, intptr_t userdata) -> bool {
-                        return cb(std::string(data), userdata);
-                    } } :
-                cpr::WriteCallback{},
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
-        );
-    }
-
-    auto ChatCompletion::CreateAsync(
-        const std::string& model,
-        Conversation& conversation,
-        std::optional<std::string> function_call,
-        std::optional<float> temperature,
-        std::optional<float> top_p,
-        std::optional<uint16_t> n,
-        std::optional<ChatStreamCallback> stream,
-        std::optional<std::vector<std::string>> stop,
-        std::optional<uint16_t> max_tokens,
-        std::optional<float> presence_penalty,
-        std::optional<float> frequency_penalty,
-        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
-        std::optional<std::string> user
-    ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &ChatCompletion::Create,
-            this,
-            model,
-            std::ref(conversation),
-            function_call,
-            temperature,
-            top_p,
-            n,
-            stream,
-            stop,
-            max_tokens,
-            presence_penalty,
-            frequency_penalty,
-            logit_bias,
-            user
-        );
-    }
-
-    auto operator<<(std::ostream& os, const Conversation& conv) -> std::ostream& {
-        auto raw_conv = conv.GetRawConversation();
-        os << (raw_conv ? *raw_conv : "") << std::endl;
-
-        if (conv.HasFunctions()) {
-            auto raw_funcs = conv.GetRawFunctions();
-            os << (raw_funcs ? *raw_funcs : "");
-        }
-
-        return os;
-    }
-
-    Functions::Functions() {
-        this->m_functions["functions"] = nlohmann::json::array();
-    }
-
-    Functions::Functions(const Functions& other) {
-        this->m_functions = other.m_functions;
-    }
-
-    Functions::Functions(Functions&& old) noexcept {
-        this->m_functions = std::move(old.m_functions);
-        old.m_functions = nlohmann::json::object();
-    }
-
-    auto Functions::operator=(const Functions& other) -> Functions& {
-        if (this != &other) {
-            this->m_functions = other.m_functions;
-        }
-        return *this;
-    }
-
-    auto Functions::operator=(Functions&& old) noexcept -> Functions& {
-        this->m_functions = std::move(old.m_functions);
-        old.m_functions = nlohmann::json::object();
-        return *this;
-    }
-
-    auto Functions::AddFunction(std::string_view function_name) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(function_name);
-        if (!idx_result) {
-            this->m_functions["functions"].push_back(
-                {
-                    { "name", function_name }
-            }
-            );
-            return true; // function added
-        }
-        return false;    // function already exists
-    }
-
-    auto Functions::AddFunctions(std::initializer_list<std::string_view> function_names) & noexcept
-        -> Result<bool> {
-        if (function_names.size() > 0) {
-            for (const auto& function_name : function_names) {
-                auto idx_result = this->GetFunctionIndex(function_name);
-                if (!idx_result) {
-                    this->m_functions["functions"].push_back(
-                        {
-                            { "name", function_name }
-                    }
-                    );
-                }
-            }
-            return true; // functions added
-        }
-        return false;    // functions not added (size 0)
-    }
-
-    auto Functions::AddFunctions(std::vector<std::string> function_names) & noexcept
-        -> Result<bool> {
-        if (function_names.size() > 0) {
-            for (auto& function_name : function_names) {
-                auto idx_result = this->GetFunctionIndex(function_name);
-                if (!idx_result) {
-                    this->m_functions["functions"].push_back(
-                        {
-                            { "name", std::move(function_name) }
-                    }
-                    );
-                }
-            }
-            return true; // functions added
-        }
-        return false;    // functions not added (size 0)
-    }
-
-    auto Functions::PopFunction(std::string_view function_name) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(function_name);
-
-        if (idx_result) {
-            this->m_functions["functions"].erase(
-                this->m_functions["functions"].begin() + static_cast<std::ptrdiff_t>(*idx_result)
-            );
-            return true; // function removed
-        }
-
-        return false; // function not removed
-    }
-
-    auto Functions::PopFunctions(std::initializer_list<std::string_view> function_names) & noexcept
-        -> Result<bool> {
-        if (function_names.size() > 0) {
-            for (const auto& function_name : function_names) {
-                auto idx_result = this->GetFunctionIndex(function_name);
-
-                if (idx_result) {
-                    this->m_functions["functions"].erase(
-                        this->m_functions["functions"].begin() +
-                        static_cast<std::ptrdiff_t>(*idx_result)
-                    );
-                }
-            }
-
-            return true; // functions removed
-        }
-
-        return false; // functions not removed (size 0)
-    }
-
-    auto Functions::PopFunctions(std::vector<std::string> function_names) & noexcept
-        -> Result<bool> {
-        if (function_names.size() > 0) {
-            for (const auto& function_name : function_names) {
-                auto idx_result = this->GetFunctionIndex(function_name);
-
-                if (idx_result) {
-                    this->m_functions["functions"].erase(
-                        this->m_functions["functions"].begin() +
-                        static_cast<std::ptrdiff_t>(*idx_result)
-                    );
-                }
-            }
-            return true; // functions removed
-        }
-
-        return false; // functions not removed (size 0)
-    }
-
-    auto Functions::SetDescription(std::string_view target, std::string_view description) & noexcept
-        -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (!this->m_functions["functions"][i].contains("description")) {
-                this->m_functions["functions"][i]["description"] = description;
-                return true; // description set successfully
-            }
-            return false;    // already has a description
-        }
-
-        return false; // function does not exist
-    }
-
-    auto Functions::PopDescription(std::string_view target) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("description")) {
-                this->m_functions["functions"][i].erase("description");
-                return true; // description removed successfully
-            }
-            return false;    // does not have a description
-        }
-
-        return false; // function does not exist
-    }
-
-    auto Functions::SetRequired(
-        std::string_view target,
-        std::initializer_list<std::string_view> params
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result && params.size() > 0) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                for (const auto& parameter : params) {
-                    this->m_functions["functions"][i]["parameters"]["required"] = params;
-                    return true; // required parameters set successfully
-                }
-            }
-        }
-
-        return false; // required parameters not set
-    }
-
-    auto Functions::SetRequired(std::string_view target, std::vector<std::string> params) & noexcept
-        -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result && params.size() > 0) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                for (const auto& parameter : params) {
-                    this->m_functions["functions"][i]["parameters"]["required"] = std::move(params);
-                    return true; // required parameters set successfully
-                }
-            }
-        }
-
-        return false; // required parameters not set
-    }
-
-    auto Functions::PopRequired(std::string_view target) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
-                    this->m_functions["functions"][i]["parameters"].erase("required");
-                    return true; // required parameters removed successfully
-                }
-            }
-        }
-
-        return false; // required parameters not removed
-    }
-
-    auto Functions::AppendRequired(std::string_view target, std::string_view param) & noexcept
-        -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
-                    this->m_functions["functions"][i]["parameters"]["required"].push_back(param);
-                    return true; // required parameter appended successfully
-                }
-            }
-        }
-
-        return false; // required parameter not appended
-    }
-
-    auto Functions::AppendRequired(
-        std::string_view target,
-        std::initializer_list<std::string_view> params
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result && params.size() > 0) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
-                    for (const auto& param : params) {
-                        this->m_functions["functions"][i]["parameters"]["required"].push_back(
-                            param
-                        );
-                    }
-
-                    return true; // required parameters appended successfully
-                }
-            }
-        }
-
-        return false; // required parameters not appended
-    }
-
-    auto
-    Functions::AppendRequired(std::string_view target, std::vector<std::string> params) & noexcept
-        -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result && params.size() > 0) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
-                    for (auto& param : params) {
-                        this->m_functions["functions"][i]["parameters"]["required"].push_back(
-                            std::move(param)
-                        );
-                    }
-
-                    return true; // required parameters appended successfully
-                }
-            }
-        }
-
-        return false; // required parameters not appended
-    }
-
-    auto Functions::SetParameter(std::string_view target, FunctionParameter parameter) & noexcept
-        -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (!this->m_functions["functions"][i].contains("parameters")) {
-                this->m_functions["functions"][i]["parameters"] = nlohmann::json::object();
-                this->m_functions["functions"][i]["parameters"]["properties"] =
-                    nlohmann::json::object();
-                this->m_functions["functions"][i]["parameters"]["type"] = "object";
-
-                this->m_functions["functions"][i]["parameters"]["properties"].push_back(
-                    {
-                        parameter.name,
-                        { { "type", std::move(parameter.type) },
-                               { "description", std::move(parameter.description) } }
-                }
-                );
-
-                if (parameter.enumeration) {
-                    this->m_functions["functions"][i]["parameters"]["properties"][parameter.name]
-                                     ["enum"] = std::move(parameter.enumeration.value());
-                }
-
-                return true; // parameter set successfully
-            }
-        }
-
-        return false; // function non-existent, or parameters already set (use AppendParameter(s))
-    }
-
-    auto Functions::SetParameters(
-        std::string_view target,
-        std::initializer_list<FunctionParameter> parameters
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (!this->m_functions["functions"][i].contains("parameters") &&
-                parameters.size() > 0) {
-                this->m_functions["functions"][i]["parameters"] = nlohmann::json::object();
-                this->m_functions["functions"][i]["parameters"]["properties"] =
-                    nlohmann::json::object();
-                this->m_functions["functions"][i]["parameters"]["type"] = "object";
-
-                for (const auto& parameter : parameters) {
-                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                            parameter.name
-                        )) {
-                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
-                            {
-                                parameter.name,
-                                { { "type", parameter.type },
-                                       { "description", parameter.description } }
-                        }
-                        );
-
-                        if (parameter.enumeration) {
-                            this->m_functions["functions"][i]["parameters"]["properties"]
-                                             [parameter.name]["enum"] =
-                                parameter.enumeration.value();
-                        }
-                    }
-                }
-
-                return true; // parameter set successfully
-            }
-        }
-
-        return false; // function non-existent, or parameters already set (use AppendParameter(s))
-    }
-
-    auto Functions::SetParameters(
-        std::string_view target,
-        std::vector<FunctionParameter> parameters
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (!this->m_functions["functions"][i].contains("parameters") &&
-                parameters.size() > 0) {
-                this->m_functions["functions"][i]["parameters"] = nlohmann::json::object();
-                this->m_functions["functions"][i]["parameters"]["properties"] =
-                    nlohmann::json::object();
-                this->m_functions["functions"][i]["parameters"]["type"] = "object";
-
-                for (auto& parameter : parameters) {
-                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                            parameter.name
-                        )) {
-                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
-                            {
-                                parameter.name,
-                                { { "type", std::move(parameter.type) },
-                                       { "description", std::move(parameter.description) } }
-                        }
-                        );
-
-                        if (parameter.enumeration) {
-                            this->m_functions["functions"][i]["parameters"]["properties"]
-                                             [parameter.name]["enum"] =
-                                std::move(parameter.enumeration.value());
-                        }
-                    }
-                }
-
-                return true; // parameter set successfully
-            }
-        }
-
-        return false; // function non-existent, or parameters already set (use AppendParameter(s))
-    }
-
-    auto Functions::PopParameters(std::string_view target) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                this->m_functions["functions"][i].erase("parameters");
-                return true; // parameters removed successfully
-            }
-        }
-
-        return false; // parameters not removed
-    }
-
-    auto Functions::PopParameters(
-        std::string_view target,
-        std::initializer_list<std::string_view> param_names
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                for (const auto& param_name : param_names) {
-                    if (this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                            param_name
-                        )) {
-                        this->m_functions["functions"][i]["parameters"]["properties"].erase(
-                            param_name
-                        );
-                    }
-                }
-
-                return true; // parameters removed successfully
-            }
-        }
-
-        return false; // parameters not removed
-    }
-
-    auto Functions::PopParameters(
-        std::string_view target,
-        std::vector<std::string> param_names
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                for (const auto& param_name : param_names) {
-                    if (this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                            param_name
-                        )) {
-                        this->m_functions["functions"][i]["parameters"]["properties"].erase(
-                            param_name
-                        );
-                    }
-                }
-
-                return true; // parameters removed successfully
-            }
-        }
-
-        return false; // parameters not removed
-    }
-
-    auto Functions::AppendParameter(std::string_view target, FunctionParameter parameter) & noexcept
-        -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                        parameter.name
-                    )) {
-                    this->m_functions["functions"][i]["parameters"]["properties"].push_back(
-                        {
-                            parameter.name,
-                            { { "type", std::move(parameter.type) },
-                                   { "description", std::move(parameter.description) } }
-                    }
-                    );
-
-                    if (parameter.enumeration) {
-                        this->m_functions["functions"][i]["parameters"]["properties"]
-                                         [parameter.name]["enum"] =
-                            std::move(parameter.enumeration.value());
-                    }
-
-                    return true; // parameter appended successfully
-                }
-            }
-        }
-
-        return false; // parameter not appended
-    }
-
-    auto Functions::AppendParameters(
-        std::string_view target,
-        std::initializer_list<FunctionParameter> parameters
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                for (const auto& parameter : parameters) {
-                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                            parameter.name
-                        )) {
-                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
-                            {
-                                parameter.name,
-                                { { "type", parameter.type },
-                                       { "description", parameter.description } }
-                        }
-                        );
-
-                        if (parameter.enumeration) {
-                            this->m_functions["functions"][i]["parameters"]["properties"]
-                                             [parameter.name]["enum"] =
-                                parameter.enumeration.value();
-                        }
-                    }
-                }
-
-                return true; // parameters appended successfully
-            }
-        }
-
-        return false; // parameters not appended
-    }
-
-    auto Functions::AppendParameters(
-        std::string_view target,
-        std::vector<FunctionParameter> parameters
-    ) & noexcept -> Result<bool> {
-        auto idx_result = this->GetFunctionIndex(target);
-
-        if (idx_result) {
-            index i = *idx_result;
-            if (this->m_functions["functions"][i].contains("parameters")) {
-                for (auto& parameter : parameters) {
-                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
-                            parameter.name
-                        )) {
-                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
-                            {
-                                parameter.name,
-                                { { "type", std::move(parameter.type) },
-                                       { "description", std::move(parameter.description) } }
-                        }
-                        );
-
-                        if (parameter.enumeration) {
-                            this->m_functions["functions"][i]["parameters"]["properties"]
-                                             [parameter.name]["enum"] =
-                                std::move(parameter.enumeration.value());
-                        }
-                    }
-                }
-
-                return true; // parameters appended successfully
-            }
-        }
-
-        return false; // parameters not appended
-    }
-
-    auto Functions::GetJSON() const& noexcept -> const nlohmann::json& {
-        return this->m_functions;
-    }
-
-    auto Functions::GetFunctionIndex(std::string_view function_name) const& noexcept
-        -> Result<index> {
-        index i = 0;
-
-        if (!this->m_functions.empty()) {
-            for (const auto& [key, value] : this->m_functions["functions"].items()) {
-                if (value.contains("name")) {
-                    if (value["name"].get<std::string>() == function_name) {
-                        return i;
-                    }
-                }
-                i++;
-            }
-        }
-
-        return std::unexpected(OpenAIError::parse_error("Function not found"));
-    }
-
-} // namespace liboai
+
+        ~Functions() = default;
+
+        Functions& operator=(const Functions& other);
+        Functions& operator=(Functions&& old) noexcept;
+
+        /**
+         * @brief Denotes a parameter of a function, which includes the
+         *        parameter's name, type, description, and an optional enumeration.
+         *
+         * @param name        The name of the parameter.
+         * @param type        The type of the parameter.
+         * @param description The description of the parameter.
+         * @param enumeration An optional enumeration of possible values for the parameter.
+         */
+        struct FunctionParameter {
+            FunctionParameter() = default;
+
+            FunctionParameter(
+                std::string_view name,
+                std::string_view type,
+                std::string_view description,
+                std::optional<std::vector<std::string>> enumeration = std::nullopt
+            )
+                : name(name), type(type), description(description), enumeration(enumeration) {}
+
+            FunctionParameter(const FunctionParameter& other) = default;
+            FunctionParameter(FunctionParameter&& old) noexcept = default;
+            ~FunctionParameter() = default;
+
+            FunctionParameter& operator=(const FunctionParameter& other) = default;
+            FunctionParameter& operator=(FunctionParameter&& old) noexcept = default;
+
+            std::string name;
+            std::string type;
+            std::string description;
+            std::optional<std::vector<std::string>> enumeration;
+        };
+
+        /**
+         * @brief Adds a function named 'function_name' to the list of functions.
+         *
+         * This function, once added, can then be referenced in subsequent 'Functions'
+         * class method calls by the name provided here.
+         *
+         * @param function_name The name of the function to add.
+         * @return True/False denoting whether the function was added successfully.
+         */
+        [[nodiscard]]
+        auto AddFunction(std::string_view function_name) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Same as AddFunction, but allows for adding multiple functions at once.
+         *
+         * @param function_names The name of the function to add.
+         * @return True/False denoting whether the functions were added successfully.
+         */
+        [[nodiscard]]
+        auto AddFunctions(std::initializer_list<std::string_view> function_names) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Same as AddFunction, but allows for adding multiple functions at once.
+         *
+         * @param function_names The name of the function to add.
+         * @return True/False denoting whether the functions were added successfully.
+         */
+        [[nodiscard]]
+        auto AddFunctions(std::vector<std::string> function_names) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Same as AddFunction, but allows for adding multiple functions at once.
+         *
+         * @param function_names The name of the function to add.
+         * @return True/False denoting whether the functions were added successfully.
+         */
+        template <
+            class... _Fnames,
+            std::enable_if_t<
+                std::conjunction_v<std::is_convertible<_Fnames, std::string_view>...>,
+                int> = 0>
+        [[nodiscard]] auto AddFunctions(_Fnames... function_names) & noexcept
+            -> Result<bool> {
+            return this->AddFunctions({ function_names... });
+        }
+
+        /**
+         * @brief Pops the specified function from the list of functions.
+         *
+         * This will also remove any associated name, description, parameters, and so on
+         * as it involves removing the entire 'function_name' key from the JSON object.
+         *
+         * @param function_name The name of the function to pop.
+         * @return True/False denoting whether the function was popped successfully.
+         */
+        [[nodiscard]]
+        auto PopFunction(std::string_view function_name) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Same as PopFunction, but allows for popping multiple functions at once.
+         *
+         * @param function_names The name of the function to pop.
+         * @return True/False denoting whether the functions were popped successfully.
+         */
+        [[nodiscard]]
+        auto PopFunctions(std::initializer_list<std::string_view> function_names) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Same as PopFunction, but allows for popping multiple functions at once.
+         *
+         * @param function_names The name of the function to pop.
+         * @return True/False denoting whether the functions were popped successfully.
+         */
+        [[nodiscard]]
+        auto PopFunctions(std::vector<std::string> function_names) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Same as PopFunction, but allows for popping multiple functions at once.
+         *
+         * @param function_names The name of the function to pop.
+         * @return True/False denoting whether the functions were popped successfully.
+         */
+        template <
+            class... _Fnames,
+            std::enable_if_t<
+                std::conjunction_v<std::is_convertible<_Fnames, std::string_view>...>,
+                int> = 0>
+        [[nodiscard]] auto PopFunctions(_Fnames... function_names) & noexcept
+            -> Result<bool> {
+            return this->PopFunctions({ function_names... });
+        }
+
+        /**
+         * @brief Sets a previously added function's description.
+         *
+         * @param target      The name of the function to set the description of.
+         * @param description The description to set for the function.
+         * @return True/False denoting whether the description was set successfully.
+         */
+        [[nodiscard]]
+        auto SetDescription(std::string_view target, std::string_view description) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Pops a previously added function's description.
+         *
+         * @param target The name of the function to pop the description of.
+         * @return True/False denoting whether the description was popped successfully.
+         */
+        [[nodiscard]]
+        auto PopDescription(std::string_view target) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Sets which set function parameters are required.
+         *
+         * @param target The name of the function to set the required parameters of.
+         * @param params A series of parameter names to set as required.
+         * @return True/False denoting whether the required parameters were set successfully.
+         */
+        [[nodiscard]]
+        auto SetRequired(
+            std::string_view target,
+            std::initializer_list<std::string_view> params
+        ) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Sets which set function parameters are required.
+         *
+         * @param target The name of the function to set the required parameters of.
+         * @param params A series of parameter names to set as required.
+         * @return True/False denoting whether the required parameters were set successfully.
+         */
+        [[nodiscard]]
+        auto SetRequired(std::string_view target, std::vector<std::string> params) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Sets which set function parameters are required.
+         *
+         * @param target The name of the function to set the required parameters of.
+         * @param params A series of parameter names to set as required.
+         * @return True/False denoting whether the required parameters were set successfully.
+         */
+        template <
+            class... _Rp,
+            std::enable_if_t<
+                std::conjunction_v<std::is_convertible<_Rp, std::string_view>...>,
+                int> = 0>
+        [[nodiscard]] auto SetRequired(std::string_view target, _Rp... params) & noexcept
+            -> Result<bool> {
+            return SetRequired(target, { params... });
+        }
+
+        /**
+         * @brief Pops previously set required function parameters.
+         *
+         * @param target The name of the function to pop the required parameters of.
+         * @return True/False denoting whether the required parameters were popped successfully.
+         */
+        [[nodiscard]]
+        auto PopRequired(std::string_view target) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Appends a parameter to a previously set series of required function parameters.
+         *
+         * This function should only be called if required parameters have already been
+         * set for 'target' via SetRequired().
+         *
+         * @param target The name of the function to append the required parameter to.
+         * @param param  The name of the parameter to append to the required parameters.
+         * @return True/False denoting whether the required parameter was appended successfully.
+         */
+        [[nodiscard]]
+        auto AppendRequired(std::string_view target, std::string_view param) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Appends multiple parameters to a previously set series of required
+         *        function parameters.
+         *
+         * This function should only be called if required parameters have already
+         * been set for 'target' via SetRequired().
+         *
+         * @param target The name of the function to append the required parameter to.
+         * @param params The name of the parameters to append to the required parameters.
+         * @return True/False denoting whether the required parameter was appended successfully.
+         */
+        [[nodiscard]]
+        auto AppendRequired(
+            std::string_view target,
+            std::initializer_list<std::string_view> params
+        ) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Appends multiple parameters to a previously set series of required
+         *        function parameters.
+         *
+         * This function should only be called if required parameters have already
+         * been set for 'target' via SetRequired().
+         *
+         * @param target The name of the function to append the required parameter to.
+         * @param params The name of the parameters to append to the required parameters.
+         * @return True/False denoting whether the required parameter was appended successfully.
+         */
+        [[nodiscard]]
+        auto AppendRequired(std::string_view target, std::vector<std::string> params) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Appends multiple parameters to a previously set series of required
+         *        function parameters.
+         *
+         * This function should only be called if required parameters have already
+         * been set for 'target' via SetRequired().
+         *
+         * @param target The name of the function to append the required parameter to.
+         * @param params The name of the parameters to append to the required parameters.
+         * @return True/False denoting whether the required parameter was appended successfully.
+         */
+        template <
+            class... _Rp,
+            std::enable_if_t<
+                std::conjunction_v<std::is_convertible<_Rp, std::string_view>...>,
+                int> = 0>
+        [[nodiscard]] auto AppendRequired(std::string_view target, _Rp... params) & noexcept
+            -> Result<bool> {
+            return AppendRequired(target, { params... });
+        }
+
+        /**
+         * @brief Adds a single parameter to an added function.
+         *
+         * @param target    The name of the function to add the parameter to.
+         * @param parameter The parameter to add to the function.
+         * @return True/False denoting whether the parameter was added successfully.
+         */
+        [[nodiscard]]
+        auto SetParameter(std::string_view target, FunctionParameter parameter) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Adds a series of parameters to an added function.
+         *
+         * @param target     The name of the function to add the parameters to.
+         * @param parameters The parameters to add to the function.
+         * @return True/False denoting whether the parameters were added successfully.
+         */
+        [[nodiscard]]
+        auto SetParameters(
+            std::string_view target,
+            std::initializer_list<FunctionParameter> parameters
+        ) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Adds a series of parameters to an added function.
+         *
+         * @param target     The name of the function to add the parameters to.
+         * @param parameters The parameters to add to the function.
+         * @return True/False denoting whether the parameters were added successfully.
+         */
+        [[nodiscard]]
+        auto
+        SetParameters(std::string_view target, std::vector<FunctionParameter> parameters) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Adds a series of parameters to an added function.
+         *
+         * @param target     The name of the function to add the parameters to.
+         * @param parameters The parameters to add to the function.
+         * @return True/False denoting whether the parameters were added successfully.
+         */
+        template <
+            class... _Fp,
+            std::enable_if_t<std::conjunction_v<std::is_same<_Fp, FunctionParameter>...>, int> = 0>
+        [[nodiscard]] auto SetParameters(std::string_view target, _Fp... parameters) & noexcept
+            -> Result<bool> {
+            return SetParameters(target, { parameters... });
+        }
+
+        /**
+         * @brief Pops all of a function's set parameters.
+         *
+         * This function removes set 'required' values and anything else that falls
+         * under the category of 'parameters' as a result of removing the entire
+         * 'parameters' section.
+         *
+         * @param target The name of the function to pop the parameters of.
+         * @return True/False denoting whether the parameters were popped successfully.
+         */
+        [[nodiscard]]
+        auto PopParameters(std::string_view target) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Pops one or more of a function's set parameters.
+         *
+         * @param target      The name of the function to pop the parameters of.
+         * @param param_names The names of the parameters to pop.
+         * @return True/False denoting whether the parameters were popped successfully.
+         */
+        [[nodiscard]]
+        auto PopParameters(
+            std::string_view target,
+            std::initializer_list<std::string_view> param_names
+        ) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Pops one or more of a function's set parameters.
+         *
+         * @param target      The name of the function to pop the parameters of.
+         * @param param_names The names of the parameters to pop.
+         * @return True/False denoting whether the parameters were popped successfully.
+         */
+        [[nodiscard]]
+        auto PopParameters(std::string_view target, std::vector<std::string> param_names) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Pops one or more of a function's set parameters.
+         *
+         * @param target      The name of the function to pop the parameters of.
+         * @param param_names The names of the parameters to pop.
+         * @return True/False denoting whether the parameters were popped successfully.
+         */
+        template <
+            class... _Pname,
+            std::enable_if_t<
+                std::conjunction_v<std::is_convertible<_Pname, std::string_view>...>,
+                int> = 0>
+        [[nodiscard]] auto PopParameters(std::string_view target, _Pname... param_names) & noexcept
+            -> Result<bool> {
+            return PopParameters(target, { param_names... });
+        }
+
+        /**
+         * @brief Appends a single parameter to a previously added function.
+         *
+         * @param target    The name of the function to append the parameter to.
+         * @param parameter The parameter to append to the function.
+         * @return True/False denoting whether the parameter was appended successfully.
+         */
+        [[nodiscard]]
+        auto AppendParameter(std::string_view target, FunctionParameter parameter) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Appends a series of parameters to a previously added function.
+         *
+         * @param target     The name of the function to append the parameters to.
+         * @param parameters The parameters to append to the function.
+         * @return True/False denoting whether the parameters were appended successfully.
+         */
+        [[nodiscard]]
+        auto AppendParameters(
+            std::string_view target,
+            std::initializer_list<FunctionParameter> parameters
+        ) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Appends a series of parameters to a previously added function.
+         *
+         * @param target     The name of the function to append the parameters to.
+         * @param parameters The parameters to append to the function.
+         * @return True/False denoting whether the parameters were appended successfully.
+         */
+        [[nodiscard]]
+        auto AppendParameters(
+            std::string_view target,
+            std::vector<FunctionParameter> parameters
+        ) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Appends a series of parameters to a previously added function.
+         *
+         * @param target     The name of the function to append the parameters to.
+         * @param parameters The parameters to append to the function.
+         * @return True/False denoting whether the parameters were appended successfully.
+         */
+        template <
+            class... _Fp,
+            std::enable_if_t<std::conjunction_v<std::is_same<_Fp, FunctionParameter>...>, int> = 0>
+        [[nodiscard]] auto AppendParameters(std::string_view target, _Fp... parameters) & noexcept
+            -> Result<bool> {
+            return AppendParameters(target, { parameters... });
+        }
+
+        /**
+         * @brief Returns the JSON object of the internal conversation.
+         */
+        auto GetJSON() const& noexcept -> const nlohmann::json&;
+
+    private:
+        using index = std::size_t;
+        [[nodiscard]] auto GetFunctionIndex(std::string_view function_name) const& noexcept
+            -> Result<index>;
+
+        nlohmann::json m_functions;
+    };
+
+    /**
+     * @brief The typed contents of one streamed chat completion chunk.
+     *
+     * Built from the data of a single server-sent event by
+     * ChatDelta::Parse(...); only the first choice is read.
+     */
+    struct ChatDelta {
+        std::optional<std::string> role = std::nullopt;
+        // whether the chunk had a 'content' field at all (it may be null)
+        bool has_content = false;
+        std::string content;
+        std::optional<std::string> function_name = std::nullopt;
+        std::optional<std::string> function_arguments = std::nullopt;
+        std::optional<std::string> finish_reason = std::nullopt;
+
+        /**
+         * @brief Parses the data of a chat.completion.chunk event.
+         *
+         * @param data The event's data, e.g. SseEvent::data.
+         * @return The delta, or a parse error if 'data' is not a valid chunk.
+         */
+        [[nodiscard]]
+        static auto Parse(std::string_view data) -> Result<ChatDelta>;
+    };
+
+    /**
+     * @brief Class containing, and used for keeping track of, the chat history.
+     *
+     * An object of this class should be created, set with system and user data,
+     * and provided to ChatCompletion::create (system is optional).
+     *
+     * The general usage of this class is as follows:
+     * - 1. Create a ChatCompletion::Conversation object.
+     * - 2. Set the user data, which is the user's input - such as a question or
+     *      a command as well as optionally set the system data to guide how the
+     *      assistant responds.
+     * - 3. Provide the ChatCompletion::Conversation object to ChatCompletion::create.
+     * - 4. Update the ChatCompletion::Conversation object with the response from
+     *      the API - either the object or the response content can be used to
+     *      update the object.
+     * - 5. Retrieve the assistant's response from the ChatCompletion::Conversation
+     *      object.
+     * - 6. Repeat steps 2, 3, 4 and 5 until the conversation is complete.
+     *
+     * After providing the object to ChatCompletion::create, the object will be
+     * updated with the 'assistant' response - this response is the assistant's
+     * response to the user's input. A developer could then retrieve this response
+     * and display it to the user, and then set the next user input in the object
+     * and pass it back to ChatCompletion::create, if desired.
+     */
+    class Conversation final {
+    public:
+        Conversation();
+        Conversation(const Conversation& other);
+        Conversation(Conversation&& old) noexcept;
+        explicit Conversation(std::string_view system_data);
+        Conversation(std::string_view system_data, std::string_view user_data);
+        Conversation(
+            std::string_view system_data,
+            std::initializer_list<std::string_view> user_data
+        );
+        explicit Conversation(std::initializer_list<std::string_view> user_data);
+        explicit Conversation(const std::vector<std::string>& user_data);
+        ~Conversation() = default;
+
+        Conversation& operator=(const Conversation& other);
+        Conversation& operator=(Conversation&& old) noexcept;
+
+        friend std::ostream& operator<<(std::ostream& os, const Conversation& conv);
+
+        /**
+         * @brief Changes the content of the first system message in the conversation.
+         *
+         * This method updates the content of the first system message in the
+         * conversation, if it exists and is of type "system". If the first message
+         * is not a system message or the conversation is empty, the method will
+         * return false.
+         *
+         * @param new_data A string_view containing the new content for the system
+         *                 message. Must be non-empty.
+         * @return True/False denoting whether the first system message was changed
+         *         successfully.
+         */
+        [[nodiscard]]
+        auto ChangeFirstSystemMessage(std::string_view new_data) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Sets the system data for the conversation.
+         *
+         * This method sets the system data for the conversation. The system data
+         * is the data that helps set the behavior of the assistant so it knows
+         * how to respond.
+         *
+         * @param data The system data to set.
+         * @return True/False denoting whether the system data was set successfully.
+         */
+        [[nodiscard]]
+        auto SetSystemData(std::string_view data) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Removes the set system data from the top of the conversation.
+         *
+         * The system data must be the first data set, if used, in order to be
+         * removed. If the system data is not the first data set, this method
+         * will return false.
+         *
+         * @return True/False denoting whether the system data was removed successfully.
+         */
+        [[nodiscard]]
+        auto PopSystemData() & noexcept -> Result<bool>;
+
+        /**
+         * @brief Adds user input to the conversation.
+         *
+         * This method adds user input to the conversation. The user input is the
+         * user's input - such as a question or a command.
+         *
+         * If using a system prompt, the user input should be provided after the
+         * system prompt is set - i.e. after SetSystemData() is called.
+         *
+         * @param data The user input to add.
+         * @return True/False denoting whether the user input was added successfully.
+         */
+        [[nodiscard]]
+        auto AddUserData(std::string_view data) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Adds user input to the conversation.
+         *
+         * This method adds user input to the conversation. The user input is the
+         * user's input - such as a question or a command.
+         *
+         * If using a system prompt, the user input should be provided after the
+         * system prompt is set - i.e. after SetSystemData() is called.
+         *
+         * @param data The user input to add.
+         * @param name The name of the author of this message. Name is required if
+         *             role is function, and it should be the name of the function
+         *             whose response is in the content.
+         * @return True/False denoting whether the user input was added successfully.
+         */
+        [[nodiscard]]
+        auto AddUserData(std::string_view data, std::string_view name) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Removes the last added user data.
+         *
+         * @return True/False denoting whether the user data was removed.
+         */
+        [[nodiscard]]
+        auto PopUserData() & noexcept -> Result<bool>;
+
+        /**
+         * @brief Gets the last response from the assistant.
+         *
+         * This method gets the last response from the assistant. The response is
+         * the assistant's response to the user's input.
+         */
+        auto GetLastResponse() const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Returns whether the most recent response contains a function_call.
+         *
+         * This follows a call to Update. It is important to note that, when making
+         * use of functions, a developer must call this method to determine whether
+         * the response contains a function call or if it contains a regular response.
+         *
+         * @return True/False denoting whether the most recent response contains a
+         *         function_call or not.
+         */
+        [[nodiscard]]
+        auto LastResponseIsFunctionCall() const& noexcept -> Result<bool>;
+
+        /**
+         * @brief Returns the name of the function_call in the most recent response.
+         *
+         * This should only be called if LastResponseIsFunctionCall() returns true.
+         */
+        [[nodiscard]]
+        auto GetLastFunctionCallName() const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Returns the arguments of the function_call in the most recent response.
+         *
+         * Returns them in their raw JSON form. This should only be called if
+         * LastResponseIsFunctionCall() returns true.
+         */
+        [[nodiscard]]
+        auto GetLastFunctionCallArguments() const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Removes the last assistant response.
+         *
+         * @return True/False denoting whether the last response was removed.
+         */
+        [[nodiscard]]
+        auto PopLastResponse() & noexcept -> Result<bool>;
+
+        /**
+         * @brief Updates the conversation given JSON data.
+         *
+         * This method updates the conversation given JSON data. The JSON data
+         * should be the JSON 'messages' data returned from the OpenAI API.
+         *
+         * This method should only be used if AppendStreamData was NOT used
+         * immediately before it.
+         *
+         * For instance, if we made a call to create*(), and provided a callback
+         * function to stream and, within this callback, we used AppendStreamData
+         * to update the conversation per message, we would NOT want to use this
+         * method. In this scenario, the AppendStreamData method would have already
+         * updated the conversation, so this method would be a bad idea to call
+         * afterwards.
+         *
+         * @param history The JSON data to update the conversation with. This should
+         *                be the 'messages' array of data returned from a call to
+         *                ChatCompletion::create.
+         * @return True/False denoting whether the conversation was updated.
+         */
+        [[nodiscard]]
+        auto Update(std::string_view history) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Updates the conversation given a Response object.
+         *
+         * This method updates the conversation given a Response object. This method
+         * should only be used if AppendStreamData was NOT used immediately before it.
+         *
+         * For instance, if we made a call to create*(), and provided a callback
+         * function to stream and, within this callback, we used AppendStreamData
+         * to update the conversation per message, we would NOT want to use this
+         * method. In this scenario, the AppendStreamData method would have already
+         * updated the conversation, so this method would be a bad idea to call
+         * afterwards.
+         *
+         * @param response The Response to update the conversation with. This should
+         *                 be the Response returned from a call to ChatCompletion::create.
+         * @return True/False denoting whether the update was successful.
+         */
+        [[nodiscard]]
+        auto Update(const Response& response) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Exports the entire conversation to a JSON string.
+         *
+         * This method exports the conversation to a JSON string. The JSON string
+         * can be used to save the conversation to a file. The exported string
+         * contains both the conversation and included functions, if any.
+         *
+         * @return The JSON string representing the conversation.
+         */
+        [[nodiscard]]
+        auto Export() const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Imports a conversation from a JSON string.
+         *
+         * This method imports a conversation from a JSON string. The JSON string
+         * should be the JSON string returned from a call to Export().
+         *
+         * @param json The JSON string to import the conversation from.
+         * @return True/False denoting whether the conversation was imported.
+         */
+        [[nodiscard]]
+        auto Import(std::string_view json) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Appends stream data (SSEs) from streamed methods.
+         *
+         * This method updates the conversation given a token from a streamed method.
+         * This method should be used when using streamed methods such as
+         * ChatCompletion::create or create_async with a callback supplied. This
+         * function should be called from within the stream's callback function
+         * receiving the SSEs.
+         *
+         * @param token Streamed token (data) to update the conversation with.
+         */
+        [[nodiscard]]
+        auto AppendStreamData(const std::string& data) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Appends stream data (SSEs) from streamed methods.
+         *
+         * This method updates the conversation given a token from a streamed method.
+         * This method should be used when using streamed methods such as
+         * ChatCompletion::create or create_async with a callback supplied. This
+         * function should be called from within the stream's callback function
+         * receiving the SSEs.
+         *
+         * @param token    Streamed token (data) to update the conversation with.
+         * @param delta    Output parameter. The delta to append to the conversation.
+         * @param completed Output parameter. Whether the stream is completed.
+         */
+        [[nodiscard]]
+        auto
+        AppendStreamData(const std::string& data, std::string& delta, bool& completed) & noexcept
+            -> Result<bool>;
+
+        /**
+         * @brief Sets the functions to be used for the conversation.
+         *
+         * This method sets the functions to be used for the conversation.
+         *
+         * @param functions The functions to set.
+         * @return True/False denoting whether the functions were set.
+         */
+        [[nodiscard]]
+        auto SetFunctions(const Functions& functions) & noexcept -> Result<bool>;
+
+        /**
+         * @brief Pops any previously set functions.
+         */
+        auto PopFunctions() & noexcept -> void;
+
+        /**
+         * @brief Returns the raw JSON dump of the internal conversation object
+         *        in string format.
+         */
+        [[nodiscard]]
+        auto GetRawConversation() const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Returns the JSON object of the internal conversation.
+         */
+        [[nodiscard]]
+        auto GetJSON() const& noexcept -> const nlohmann::json&;
+
+        /**
+         * @brief Returns the raw JSON dump of the internal functions object
+         *        in string format - if one exists.
+         */
+        [[nodiscard]]
+        auto GetRawFunctions() const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Returns the JSON object of the set functions.
+         */
+        [[nodiscard]]
+        auto GetFunctionsJSON() const& noexcept -> const nlohmann::json&;
+
+        /**
+         * @brief Returns whether the conversation has functions or not.
+         *
+         *        This function call from ChatComplete.
+         */
+        [[nodiscard]] constexpr auto HasFunctions() const& noexcept -> bool {
+            return this->m_functions ? true : false;
+        }
+
+        /**
+         * @brief Sets the maximum history size for the conversation.
+         *
+         * @param size The maximum number of messages allowed in the conversation history.
+         *             Older messages will be removed when the limit is exceeded.
+         */
+        auto SetMaxHistorySize(size_t size) noexcept -> void { m_max_history_size = size; }
+
+    private:
+        friend class ChatCompletion;
+        friend class Azure;
+        auto EraseExtra() -> void;
+        /**
+         * @brief Feeds stream data read from the remote server to the SSE
+         *        parser, applying each completed event to the conversation.
+         */
+        auto ParseStreamData(std::string_view data, std::string& delta, bool& completed) noexcept
+            -> Result<bool>;
+        auto ApplyStreamDelta(const ChatDelta& delta, std::string& delta_content) -> void;
+        /**
+         * @brief Moves the streamed content and function call arguments
+         *        into the pending message, if there is one, and clears
+         *        its "pending" flag.
+         */
+        auto CommitStreamData() -> void;
+        /**
+         * @brief Called once a stream has ended, whether or not [DONE] was
+         *        received: commits what was streamed and resets the parser
+         *        for the next stream.
+         */
+        auto FinishStream() -> void;
+
+        nlohmann::json m_conversation;
+        std::optional<nlohmann::json> m_functions = std::nullopt;
+        bool m_last_resp_is_fc = false;
+        SseParser m_sse;
+        // content and function_call arguments of the message being streamed;
+        // appended to in place and only committed to m_conversation when the
+        // stream ends
+        std::string m_stream_content, m_stream_arguments;
+        size_t m_max_history_size = std::numeric_limits<size_t>::max();
+    };
+
+    /**
+     * @brief The parameters of a chat completion, as taken by
+     *        ChatCompletion::Create(conversation, request).
+     *
+     * Unset members are left out of the request body, so designated
+     * initializers need only name the ones that matter:
+     *
+     * @code
+     * oai.ChatCompletion->Create(convo, { .model = "gpt-4o-mini", .temperature = 0.0f });
+     * @endcode
+     *
+     * See ChatCompletion::Create(model, conversation, ...) for what each
+     * parameter does.
+     */
+    struct ChatCompletionRequest {
+        using StreamCallback = std::function<bool(std::string, intptr_t, Conversation&)>;
+
+        std::string model;
+        // "none", "auto", or the name of the function the model must call
+        std::optional<std::string> function_call = std::nullopt;
+        std::optional<float> temperature = std::nullopt;
+        std::optional<float> top_p = std::nullopt;
+        std::optional<uint16_t> n = std::nullopt;
+        std::optional<StreamCallback> stream = std::nullopt;
+        std::optional<std::vector<std::string>> stop = std::nullopt;
+        std::optional<uint16_t> max_tokens = std::nullopt;
+        std::optional<float> presence_penalty = std::nullopt;
+        std::optional<float> frequency_penalty = std::nullopt;
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt;
+        std::optional<std::string> user = std::nullopt;
+    };
+
+    /**
+     * @brief A chat completion whose unchanging beginning is serialized
+     *        only once.
+     *
+     * The model and parameters of 'request', and the functions and
+     * messages of 'prefix' (typically the system prompt and any few-shot
+     * examples), are serialized when it is constructed. Every call through
+     * ChatCompletion::Create(prepared, conversation) then copies those
+     * bytes as they are and serializes only the messages of the call's own
+     * conversation after them, so building a body costs what is new rather
+     * than the whole history.
+     *
+     * @code
+     * const liboai::PreparedChatCompletion prepared(
+     *     { .model = "gpt-4o-mini", .temperature = 0.0f },
+     *     liboai::Conversation("You are a helpful assistant.")
+     * );
+     *
+     * liboai::Conversation turn;
+     * if (turn.AddUserData(question)) {
+     *     auto response = oai.ChatCompletion->Create(prepared, turn);
+     * }
+     * @endcode
+     *
+     * It is never modified once constructed, and can be used by any number
+     * of threads at once.
+     */
+    class PreparedChatCompletion final {
+    public:
+        /**
+         * @param request The model and parameters sent with every call.
+         * @param prefix  The messages every call starts with, and the
+         *                functions every call offers.
+         */
+        PreparedChatCompletion(const ChatCompletionRequest& request, const Conversation& prefix);
+
+        PreparedChatCompletion(const PreparedChatCompletion&) = default;
+        PreparedChatCompletion& operator=(const PreparedChatCompletion&) = delete;
+        ~PreparedChatCompletion() = default;
+
+    private:
+        friend class ChatCompletion;
+
+        /**
+         * @brief Writes all of a chat completion body but its end, leaving
+         *        the messages array open for more.
+         */
+        static auto WriteHead(
+            JsonWriter& json,
+            const ChatCompletionRequest& request,
+            const Conversation& conversation
+        ) -> void;
+
+        static auto WriteMessages(JsonWriter& json, const Conversation& conversation) -> void;
+
+        JsonWriter m_head;
+        std::optional<ChatCompletionRequest::StreamCallback> m_stream;
+        bool m_deterministic;
+    };
+
+    class ChatCompletion final : private Network {
+    public:
+        explicit ChatCompletion(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
+
+        ChatCompletion(const ChatCompletion&) = delete;
+        ChatCompletion& operator=(const ChatCompletion&) = delete;
+        ChatCompletion(ChatCompletion&&) = delete;
+        ChatCompletion& operator=(ChatCompletion&&) = delete;
+        ~ChatCompletion() = default;
+
+        using ChatStreamCallback = ChatCompletionRequest::StreamCallback;
+
+        /**
+         * @brief Creates a completion for the chat message.
+         *
+         * The request is only read, never copied (save for its stream
+         * callback), so one request can be reused for any number of calls.
+         *
+         * @param conversation A Conversation object containing the conversation data.
+         * @param request      The model and parameters to use.
+         * @param call         Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response object containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto Create(
+            Conversation& conversation,
+            const ChatCompletionRequest& request,
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
+
+        /**
+         * @brief Asynchronously creates a completion for the chat message.
+         *
+         * The request body is serialized before this returns, so 'request'
+         * need not outlive the call.
+         *
+         * @param conversation A Conversation object containing the conversation data.
+         * @param request      The model and parameters to use.
+         * @param call         Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response future containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto CreateAsync(
+            Conversation& conversation,
+            const ChatCompletionRequest& request,
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of Create(conversation, request); suspends
+         *        the awaiting coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            Conversation& conversation,
+            const ChatCompletionRequest& request,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
+        /**
+         * @brief Creates a completion for a prepared request, continued by
+         *        the messages of 'conversation'.
+         *
+         * Only those messages are serialized; the rest of the body is
+         * copied from 'prepared'. Stream callbacks are handed
+         * 'conversation', which should also be updated with the response
+         * to carry the exchange on.
+         *
+         * @param prepared     The unchanging beginning of the request.
+         * @param conversation The messages to send after those of 'prepared'.
+         *                     Its functions are not sent.
+         * @param call         Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response object containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto Create(
+            const PreparedChatCompletion& prepared,
+            Conversation& conversation,
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
+
+        /**
+         * @brief Asynchronously creates a completion for a prepared request,
+         *        continued by the messages of 'conversation'.
+         *
+         * @param prepared     The unchanging beginning of the request.
+         * @param conversation The messages to send after those of 'prepared'.
+         * @param call         Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response future containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto CreateAsync(
+            const PreparedChatCompletion& prepared,
+            Conversation& conversation,
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of Create(prepared, conversation);
+         *        suspends the awaiting coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const PreparedChatCompletion& prepared,
+            Conversation& conversation,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
+        /**
+         * @brief Creates a completion for the chat message.
+         *
+         * @param model            ID of the model to use. Currently, only gpt-3.5-turbo
+         *                         and gpt-3.5-turbo-0301 are supported.
+         * @param conversation     A Conversation object containing the conversation data.
+         * @param function_call    Controls how the model responds to function calls.
+         *                         "none" means the model does not call a function, and
+         *                         responds to the end-user. "auto" means the model can
+         *                         pick between an end-user or calling a function.
+         * @param temperature      What sampling temperature to use, between 0 and 2.
+         *                         Higher values like 0.8 will make the output more random,
+         *                         while lower values like 0.2 will make it more focused
+         *                         and deterministic.
+         * @param top_p            An alternative to sampling with temperature, called
+         *                         nucleus sampling, where the model considers the results
+         *                         of the tokens with top_p probability mass. So 0.1 means
+         *                         only the tokens comprising the top 10% probability mass
+         *                         are considered.
+         * @param n                How many chat completion choices to generate for each
+         *                         input message.
+         * @param stream           If set, partial message deltas will be sent, like in
+         *                         ChatGPT. Tokens will be sent as data-only server-sent
+         *                         events as they become available, with the stream
+         *                         terminated by a data: [DONE] message.
+         * @param stop             Up to 4 sequences where the API will stop generating
+         *                         further tokens.
+         * @param max_tokens       The maximum number of tokens allowed for the generated
+         *                         answer. By default, the number of tokens the model can
+         *                         return will be (4096 - prompt tokens).
+         * @param presence_penalty Number between -2.0 and 2.0. Positive values penalize
+         *                         new tokens based on whether they appear in the text so
+         *                         far, increasing the model's likelihood to talk about
+         *                         new topics.
+         * @param frequency_penalty Number between -2.0 and 2.0. Positive values penalize
+         *                          new tokens based on their existing frequency in the
+         *                          text so far, decreasing the model's likelihood to
+         *                          repeat the same line verbatim.
+         * @param logit_bias       Modify the likelihood of specified tokens appearing
+         *                         in the completion.
+         * @param user             The user ID to associate with the request. This is
+         *                         used to prevent abuse of the API.
+         * @param call             Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response object containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto Create(
+            const std::string& model,
+            Conversation& conversation,
+            std::optional<std::string> function_call = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<float> top_p = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<ChatStreamCallback> stream = std::nullopt,
+            std::optional<std::vector<std::string>> stop = std::nullopt,
+            std::optional<uint16_t> max_tokens = std::nullopt,
+            std::optional<float> presence_penalty = std::nullopt,
+            std::optional<float> frequency_penalty = std::nullopt,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
+
+        /**
+         * @brief Asynchronously creates a completion for the chat message.
+         *
+         * @param model            ID of the model to use. Currently, only gpt-3.5-turbo
+         *                         and gpt-3.5-turbo-0301 are supported.
+         * @param conversation     A Conversation object containing the conversation data.
+         * @param function_call    Controls how the model responds to function calls.
+         *                         "none" means the model does not call a function, and
+         *                         responds to the end-user. "auto" means the model can
+         *                         pick between an end-user or calling a function.
+         * @param temperature      What sampling temperature to use, between 0 and 2.
+         *                         Higher values like 0.8 will make the output more random,
+         *                         while lower values like 0.2 will make it more focused
+         *                         and deterministic.
+         * @param top_p            An alternative to sampling with temperature, called
+         *                         nucleus sampling, where the model considers the results
+         *                         of the tokens with top_p probability mass. So 0.1 means
+         *                         only the tokens comprising the top 10% probability mass
+         *                         are considered.
+         * @param n                How many chat completion choices to generate for each
+         *                         input message.
+         * @param stream           If set, partial message deltas will be sent, like in
+         *                         ChatGPT. Tokens will be sent as data-only server-sent
+         *                         events as they become available, with the stream
+         *                         terminated by a data: [DONE] message.
+         * @param stop             Up to 4 sequences where the API will stop generating
+         *                         further tokens.
+         * @param max_tokens       The maximum number of tokens allowed for the generated
+         *                         answer. By default, the number of tokens the model can
+         *                         return will be (4096 - prompt tokens).
+         * @param presence_penalty Number between -2.0 and 2.0. Positive values penalize
+         *                         new tokens based on whether they appear in the text so
+         *                         far, increasing the model's likelihood to talk about
+         *                         new topics.
+         * @param frequency_penalty Number between -2.0 and 2.0. Positive values penalize
+         *                          new tokens based on their existing frequency in the
+         *                          text so far, decreasing the model's likelihood to
+         *                          repeat the same line verbatim.
+         * @param logit_bias       Modify the likelihood of specified tokens appearing
+         *                         in the completion.
+         * @param user             The user ID to associate with the request. This is
+         *                         used to prevent abuse of the API.
+         * @param call             Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response future containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto CreateAsync(
+            const std::string& model,
+            Conversation& conversation,
+            std::optional<std::string> function_call = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<float> top_p = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<ChatStreamCallback> stream = std::nullopt,
+            std::optional<std::vector<std::string>> stop = std::nullopt,
+            std::optional<uint16_t> max_tokens = std::nullopt,
+            std::optional<float> presence_penalty = std::nullopt,
+            std::optional<float> frequency_penalty = std::nullopt,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& model,
+            Conversation& conversation,
+            std::optional<std::string> function_call = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<float> top_p = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<ChatStreamCallback> stream = std::nullopt,
+            std::optional<std::vector<std::string>> stop = std::nullopt,
+            std::optional<uint16_t> max_tokens = std::nullopt,
+            std::optional<float> presence_penalty = std::nullopt,
+            std::optional<float> frequency_penalty = std::nullopt,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
+    private:
+        [[nodiscard]]
+        auto CreateRequest(Conversation& conversation, const ChatCompletionRequest& request) const
+            -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateRequest(const PreparedChatCompletion& prepared, Conversation& conversation) const
+            -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateRequest(
+            cpr::Body body,
+            bool deterministic,
+            const std::optional<ChatStreamCallback>& stream,
+            Conversation& conversation
+        ) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
+    };
+
+    // Conversation method implementations
+    inline Conversation::Conversation(const Conversation& other)
+        : m_conversation(other.m_conversation),
+          m_functions(other.m_functions),
+          m_last_resp_is_fc(other.m_last_resp_is_fc),
+          m_sse(other.m_sse),
+          m_stream_content(other.m_stream_content),
+          m_stream_arguments(other.m_stream_arguments) {}
+
+    inline Conversation::Conversation()
+        : m_conversation(nlohmann::json::object()),
+          m_functions(nlohmann::json::object()),
+          m_last_resp_is_fc(false) {}
+
+    Conversation::Conversation(Conversation&& old) noexcept
+        : m_conversation(std::move(old.m_conversation)),
+          m_functions(std::move(old.m_functions)),
+          m_last_resp_is_fc(old.m_last_resp_is_fc),
+          m_sse(std::exchange(old.m_sse, {})),
+          m_stream_content(std::exchange(old.m_stream_content, {})),
+          m_stream_arguments(std::exchange(old.m_stream_arguments, {})) {
+        old.m_conversation = nlohmann::json::object();
+        old.m_functions = nlohmann::json::object();
+    }
+
+    Conversation::Conversation(std::string_view system_data) {
+        this->m_conversation["messages"] = nlohmann::json::array();
+        auto result = this->SetSystemData(system_data);
+    }
+
+    Conversation::Conversation(std::string_view system_data, std::string_view user_data) {
+        this->m_conversation["messages"] = nlohmann::json::array();
+        auto result = this->SetSystemData(system_data);
+        result = this->AddUserData(user_data);
+    }
+
+    Conversation::Conversation(
+        std::string_view system_data,
+        std::initializer_list<std::string_view> user_data
+    ) {
+        this->m_conversation["messages"] = nlohmann::json::array();
+        auto result = this->SetSystemData(system_data);
+
+        for (const auto& data : user_data) {
+            auto result = this->AddUserData(data);
+        }
+    }
+
+    Conversation::Conversation(std::initializer_list<std::string_view> user_data) {
+        this->m_conversation["messages"] = nlohmann::json::array();
+
+        for (const auto& data : user_data) {
+            auto result = this->AddUserData(data);
+        }
+    }
+
+    Conversation::Conversation(const std::vector<std::string>& user_data) {
+        this->m_conversation["messages"] = nlohmann::json::array();
+
+        for (const auto& data : user_data) {
+            auto result = this->AddUserData(data);
+        }
+    }
+
+    auto Conversation::operator=(const Conversation& other) -> Conversation& {
+        if (this != &other) {
+            this->m_conversation = other.m_conversation;
+            this->m_functions = other.m_functions;
+            this->m_last_resp_is_fc = other.m_last_resp_is_fc;
+            this->m_sse = other.m_sse;
+            this->m_stream_content = other.m_stream_content;
+            this->m_stream_arguments = other.m_stream_arguments;
+        }
+        return *this;
+    }
+
+    auto Conversation::operator=(Conversation&& old) noexcept -> Conversation& {
+        this->m_conversation = std::move(old.m_conversation);
+        this->m_functions = std::move(old.m_functions);
+        this->m_last_resp_is_fc = old.m_last_resp_is_fc;
+        this->m_sse = std::exchange(old.m_sse, {});
+        this->m_stream_content = std::exchange(old.m_stream_content, {});
+        this->m_stream_arguments = std::exchange(old.m_stream_arguments, {});
+
+        old.m_conversation = nlohmann::json::object();
+        old.m_functions = nlohmann::json::object();
+
+        return *this;
+    }
+
+    auto Conversation::ChangeFirstSystemMessage(std::string_view new_data) & noexcept
+        -> Result<bool> {
+        if (!new_data.empty() && !this->m_conversation["messages"].empty()) {
+            if (this->m_conversation["messages"][0]["role"].get<std::string>() == "system") {
+                this->m_conversation["messages"][0]["content"] = new_data;
+                return true; // System message changed successfuly
+            }
+            return false;    // First message is not a system message
+        }
+        return false;        // New data is empty or conversation is empty
+    }
+
+    auto Conversation::SetSystemData(std::string_view data) & noexcept -> Result<bool> {
+        // if data provided is non-empty
+        if (!data.empty()) {
+            // if system is not set already - only one system message shall exist in any
+            // conversation
+            for (const auto& message : this->m_conversation["messages"].items()) {
+                if (message.value()["role"].get<std::string>() == "system") {
+                    return false; // system already set
+                }
+            }
+            this->m_conversation["messages"].push_back(
+                {
+                    {    "role", "system" },
+                    { "content",     data }
+            }
+            );
+            return true; // system set successfully
+        }
+        return false;    // data is empty
+    }
+
+    auto Conversation::PopSystemData() & noexcept -> Result<bool> {
+        // if conversation is non-empty
+        if (!this->m_conversation["messages"].empty()) {
+            // if first message is system
+            if (this->m_conversation["messages"][0]["role"].get<std::string>() == "system") {
+                this->m_conversation["messages"].erase(0);
+                return true; // system message popped successfully
+            }
+            return false;    // first message is not system
+        }
+        return false;        // conversation is empty
+    }
+
+    auto Conversation::EraseExtra() -> void {
+        if (m_conversation["messages"].size() > m_max_history_size) {
+            // Ensure the system message is preserved
+            auto first_msg = m_conversation["messages"].begin();
+            if (first_msg != m_conversation["messages"].end() &&
+                (*first_msg)["role"].get<std::string>() == "system") {
+                m_conversation["messages"].erase(first_msg + 1);
+            } else {
+                m_conversation["messages"].erase(first_msg);
+            }
+        }
+    }
+
+    auto Conversation::AddUserData(std::string_view data) & noexcept -> Result<bool> {
+        // if data provided is non-empty
+        if (!data.empty()) {
+            EraseExtra();
+            this->m_conversation["messages"].push_back(
+                {
+                    {    "role", "user" },
+                    { "content",   data }
+            }
+            );
+            return true; // user data added successfully
+        }
+        return false;    // data is empty
+    }
+
+    auto Conversation::AddUserData(std::string_view data, std::string_view name) & noexcept
+        -> Result<bool> {
+        // if data provided is non-empty
+        if (!data.empty()) {
+            EraseExtra();
+            this->m_conversation["messages"].push_back(
+                {
+                    {    "role", "user" },
+                    { "content",   data },
+                    {    "name",   name }
+            }
+            );
+            return true; // user data added successfully
+        }
+        return false;    // data is empty
+    }
+
+    auto Conversation::PopUserData() & noexcept -> Result<bool> {
+        // if conversation is not empty
+        if (!this->m_conversation["messages"].empty()) {
+            // if last message is user message
+            if (this->m_conversation["messages"].back()["role"].get<std::string>() == "user") {
+                this->m_conversation["messages"].erase(this->m_conversation["messages"].end() - 1);
+                return true; // user data popped successfully
+            }
+            return false;    // last message is not user message
+        }
+        return false;        // conversation is empty
+    }
+
+    auto Conversation::GetLastResponse() const& noexcept -> Result<std::string> {
+        // if conversation is not empty
+        if (!this->m_conversation["messages"].empty()) {
+            // if last message is from assistant
+            if (this->m_conversation["messages"].back()["role"].get<std::string>() == "assistant") {
+                // still streaming - the content so far is held aside until it ends
+                if (this->m_conversation["messages"].back().contains("pending")) {
+                    return this->m_stream_content;
+                }
+                return this->m_conversation["messages"].back()["content"].get<std::string>();
+            }
+        }
+        return ""; // no response found
+    }
+
+    auto Conversation::LastResponseIsFunctionCall() const& noexcept -> Result<bool> {
+        return this->m_last_resp_is_fc;
+    }
+
+    auto Conversation::GetLastFunctionCallName() const& noexcept -> Result<std::string> {
+        if (this->m_conversation.contains("function_call")) {
+            if (this->m_conversation["function_call"].contains("name")) {
+                return this->m_conversation["function_call"]["name"].get<std::string>();
+            }
+        }
+
+        return "";
+    }
+
+    auto Conversation::GetLastFunctionCallArguments() const& noexcept -> Result<std::string> {
+        if (this->m_conversation.contains("function_call")) {
+            if (this->m_conversation["function_call"].contains("arguments")) {
+                return this->m_conversation["function_call"]["arguments"].get<std::string>() +
+                       this->m_stream_arguments;
+            }
+            return this->m_stream_arguments;
+        }
+
+        return "";
+    }
+
+    auto Conversation::PopLastResponse() & noexcept -> Result<bool> {
+        // if conversation is not empty
+        if (!this->m_conversation["messages"].empty()) {
+            // if last message is assistant message
+            if (this->m_conversation["messages"].back()["role"].get<std::string>() == "assistant") {
+                this->m_conversation["messages"].erase(this->m_conversation["messages"].end() - 1);
+                return true; // assistant data popped successfully
+            }
+            return false;    // last message is not assistant message
+        }
+        return false;        // conversation is empty
+    }
+
+    auto Conversation::Update(std::string_view history) & noexcept -> Result<bool> {
+        // reset "last response is function call" flag
+        if (this->m_last_resp_is_fc) {
+            if (this->m_conversation.contains("function_call")) {
+                this->m_conversation.erase("function_call");
+            }
+            this->m_last_resp_is_fc = false;
+        }
+
+        // if history is non-empty
+        if (!history.empty()) {
+            nlohmann::json j = nlohmann::json::parse(history);
+            if (j.contains("choices")) { // top level, several messages
+                for (const auto& choice : j["choices"].items()) {
+                    if (choice.value().contains("message")) {
+                        if (choice.value()["message"].contains("role") &&
+                            choice.value()["message"].contains("content")) {
+                            if (!choice.value()["message"]["content"].is_null()) {
+                                EraseExtra();
+                                this->m_conversation["messages"].push_back(
+                                    {
+                                        {    "role",    choice.value()["message"]["role"] },
+                                        { "content", choice.value()["message"]["content"] }
+                                }
+                                );
+                            } else {
+                                EraseExtra();
+                                this->m_conversation["messages"].push_back(
+                                    {
+                                        {    "role", choice.value()["message"]["role"] },
+                                        { "content",                                "" }
+                                }
+                                );
+                            }
+
+                            if (choice.value()["message"].contains("function_call")) {
+                                // if a function_call is present in the response, the
+                                // conversation is not updated as there is no assistant
+                                // response to be added. However, we do add the function
+                                // information
+
+                                this->m_conversation["function_call"] = nlohmann::json::object();
+                                if (choice.value()["message"]["function_call"].contains("name")) {
+                                    this->m_conversation["function_call"]["name"] =
+                                        choice.value()["message"]["function_call"]["name"];
+                                }
+                                if (choice.value()["message"]["function_call"].contains(
+                                        "arguments"
+                                    )) {
+                                    this->m_conversation["function_call"]["arguments"] =
+                                        choice.value()["message"]["function_call"]["arguments"];
+                                }
+
+                                this->m_last_resp_is_fc = true;
+                            }
+
+                            return true;        // conversation updated successfully
+                        }
+                        return false;           // response is not valid
+                    }
+                    return false;               // no response found
+                }
+            } else if (j.contains("message")) { // mid level, single message
+                if (j["message"].contains("role") && j["message"].contains("content")) {
+                    if (j["message"]["content"].is_null()) {
+                        EraseExtra();
+                        this->m_conversation["messages"].push_back(
+                            {
+                                {    "role",    j["message"]["role"] },
+                                { "content", j["message"]["content"] }
+                        }
+                        );
+                    } else {
+                        EraseExtra();
+                        this->m_conversation["messages"].push_back(
+                            {
+                                {    "role", j["message"]["role"] },
+                                { "content",                   "" }
+                        }
+                        );
+                    }
+
+                    if (j["message"].contains("function_call")) {
+                        // if a function_call is present in the response, the
+                        // conversation is not updated as there is no assistant
+                        // response to be added. However, we do add the function
+                        // information
+
+                        this->m_conversation["function_call"] = nlohmann::json::object();
+                        if (j["message"]["function_call"].contains("name")) {
+                            this->m_conversation["function_call"]["name"] =
+                                j["message"]["function_call"]["name"];
+                        }
+                        if (j["message"]["function_call"].contains("arguments")) {
+                            this->m_conversation["function_call"]["arguments"] =
+                                j["message"]["function_call"]["arguments"];
+                        }
+
+                        this->m_last_resp_is_fc = true;
+                    }
+
+                    return true;                                      // conversation updated successfully
+                }
+                return false;                                         // response is not valid
+            } else if (j.contains("role") && j.contains("content")) { // low level, single message
+                if (j["message"]["content"].is_null()) {
+                    EraseExtra();
+                    this->m_conversation["messages"].push_back(
+                        {
+                            {    "role",    j["message"]["role"] },
+                            { "content", j["message"]["content"] }
+                    }
+                    );
+                } else {
+                    EraseExtra();
+                    this->m_conversation["messages"].push_back(
+                        {
+                            {    "role", j["message"]["role"] },
+                            { "content",                   "" }
+                    }
+                    );
+                }
+
+                if (j["message"].contains("function_call")) {
+                    // if a function_call is present in the response, the
+                    // conversation is not updated as there is no assistant
+                    // response to be added. However, we do add the function
+                    // information
+                    this->m_conversation["function_call"] = nlohmann::json::object();
+                    if (j["message"]["function_call"].contains("name")) {
+                        this->m_conversation["function_call"]["name"] =
+                            j["message"]["function_call"]["name"];
+                    }
+                    if (j["message"]["function_call"].contains("arguments")) {
+                        this->m_conversation["function_call"]["arguments"] =
+                            j["message"]["function_call"]["arguments"];
+                    }
+
+                    this->m_last_resp_is_fc = true;
+                }
+
+                return true;  // conversation updated successfully
+            } else {
+                return false; // invalid response
+            }
+        }
+        return false; // response is empty
+    }
+
+    auto Conversation::Update(const Response& response) & noexcept -> Result<bool> {
+        return this->Update(response.content);
+    }
+
+    auto Conversation::Export() const& noexcept -> Result<std::string> {
+        nlohmann::json j;
+
+        if (!this->m_conversation.empty()) {
+            j["messages"] = this->m_conversation["messages"];
+
+            if (this->m_functions) {
+                j["functions"] = this->m_functions.value()["functions"];
+            }
+
+            return j.dump(4); // conversation exported successfully
+        }
+
+        return ""; // conversation is empty
+    }
+
+    auto Conversation::Import(std::string_view json) & noexcept -> Result<bool> {
+        if (!json.empty()) {
+            nlohmann::json j = nlohmann::json::parse(json);
+
+            if (j.contains("messages")) {
+                this->m_conversation["messages"] = j["messages"];
+
+                if (j.contains("functions")) {
+                    this->m_functions = nlohmann::json();
+                    this->m_functions.value()["functions"] = j["functions"];
+                }
+
+                return true; // conversation imported successfully
+            }
+
+            return false; // no messages found
+        }
+
+        return false; // json is empty
+    }
+
+    auto Conversation::AppendStreamData(const std::string& data) & noexcept -> Result<bool> {
+        if (!data.empty()) {
+            std::string delta;
+            bool completed = false;
+            return this->ParseStreamData(data, delta, completed);
+        }
+
+        return false; // data is empty
+    }
+
+    auto Conversation::AppendStreamData(
+        const std::string& data,
+        std::string& delta,
+        bool& completed
+    ) & noexcept -> Result<bool> {
+        if (!data.empty()) {
+            return this->ParseStreamData(data, delta, completed);
+        }
+
+        return false;
+    }
+
+    auto Conversation::SetFunctions(const Functions& functions) & noexcept -> Result<bool> {
+        nlohmann::json j = functions.GetJSON();
+
+        if (!j.empty() && j.contains("functions") && j["functions"].size() > 0) {
+            this->m_functions = std::move(j);
+            return true; // functions set successfully
+        }
+
+        return false; // functions are empty
+    }
+
+    auto Conversation::PopFunctions() & noexcept -> void {
+        this->m_functions = std::nullopt;
+    }
+
+    auto Conversation::GetRawConversation() const& noexcept -> Result<std::string> {
+        return this->m_conversation.dump(4);
+    }
+
+    auto Conversation::GetJSON() const& noexcept -> const nlohmann::json& {
+        return this->m_conversation;
+    }
+
+    auto Conversation::GetRawFunctions() const& noexcept -> Result<std::string> {
+        return this->HasFunctions() ? this->m_functions.value().dump(4) : "";
+    }
+
+    auto Conversation::GetFunctionsJSON() const& noexcept -> const nlohmann::json& {
+        return this->m_functions.value();
+    }
+
+    auto ChatDelta::Parse(std::string_view data) -> Result<ChatDelta> {
+        const nlohmann::json j = nlohmann::json::parse(data, nullptr, false);
+        if (j.is_discarded()) {
+            return std::unexpected(OpenAIError::parse_error("Malformed stream event data"));
+        }
+        if (!j.contains("choices")) {
+            return std::unexpected(OpenAIError::parse_error("Stream event contains no choices"));
+        }
+
+        ChatDelta delta;
+        if (!j["choices"].is_array() || j["choices"].empty()) {
+            return delta; // e.g. content filter results
+        }
+
+        const auto& choice = j["choices"][0];
+        if (auto it = choice.find("finish_reason"); it != choice.end() && it->is_string()) {
+            delta.finish_reason = it->get<std::string>();
+        }
+
+        auto d = choice.find("delta");
+        if (d == choice.end() || !d->is_object()) {
+            return delta;
+        }
+
+        if (auto it = d->find("role"); it != d->end() && it->is_string()) {
+            delta.role = it->get<std::string>();
+        }
+
+        if (auto it = d->find("content"); it != d->end()) {
+            delta.has_content = true;
+            if (it->is_string()) {
+                delta.content = it->get<std::string>();
+            }
+        }
+
+        if (auto fc = d->find("function_call"); fc != d->end() && fc->is_object()) {
+            if (auto it = fc->find("name"); it != fc->end() && it->is_string() &&
+                                            !it->get_ref<const std::string&>().empty()) {
+                delta.function_name = it->get<std::string>();
+            }
+            if (auto it = fc->find("arguments"); it != fc->end() && it->is_string() &&
+                                                 !it->get_ref<const std::string&>().empty()) {
+                delta.function_arguments = it->get<std::string>();
+            }
+        }
+
+        return delta;
+    }
+
+    auto Conversation::ParseStreamData(
+        std::string_view data,
+        std::string& delta_content,
+        bool& completed
+    ) noexcept -> Result<bool> {
+        Result<bool> result = false;
+
+        this->m_sse.Feed(data, [&](const SseEvent& event) -> bool {
+            auto& messages = this->m_conversation["messages"];
+
+            if (event.data == "[DONE]") {
+                // the response is complete, commit it and erase the "pending" flag
+                this->CommitStreamData();
+                completed = true;
+                result = true;
+                return true;
+            }
+
+            /*
+                event.data should have content in the form of:
+                    {"id":"chatcmpl-7SKOck29emvbBbDS6cHg5xwnRrsLO","object":"chat.completion.chunk","created":1686985942,"model":"gpt-3.5-turbo-0613","choices":[{"index":0,"delta":{"content":"."},"finish_reason":null}]}
+                where "delta" may be empty
+            */
+            auto delta = ChatDelta::Parse(event.data);
+            if (!delta) {
+                result = std::unexpected(delta.error());
+                return false;
+            }
+
+            // create an empty message at the end of the conversation,
+            // marked as "pending" to indicate that the response is
+            // still being processed. This flag will be removed once
+            // the response is processed. If the marking already
+            // exists, keep appending to the same message.
+            if (messages.empty() || !messages.back().contains("pending")) {
+                messages.push_back(
+                    {
+                        {    "role",   "" },
+                        { "content",   "" },
+                        { "pending", true }
+                }
+                );
+                this->m_stream_content.clear();
+                this->m_stream_arguments.clear();
+            }
+
+            this->ApplyStreamDelta(*delta, delta_content);
+            result = true;
+            return true;
+        });
+
+        return result;
+    }
+
+    auto Conversation::ApplyStreamDelta(const ChatDelta& delta, std::string& delta_content)
+        -> void {
+        auto& message = this->m_conversation["messages"].back();
+
+        if (delta.role) {
+            message["role"] = *delta.role;
+        }
+
+        if (delta.has_content) {
+            if (!delta.content.empty()) {
+                this->m_stream_content += delta.content;
+                delta_content += delta.content;
+            }
+
+            // function calls do not have a content field,
+            // set m_last_resp_is_fc to false and remove any
+            // previously set function_call field in the
+            // conversation
+            if (this->m_last_resp_is_fc) {
+                if (this->m_conversation.contains("function_call")) {
+                    this->m_conversation.erase("function_call");
+                }
+                this->m_stream_arguments.clear();
+                this->m_last_resp_is_fc = false;
+            }
+        }
+
+        if (delta.function_name && !message.contains("function_call")) {
+            this->m_conversation["function_call"] = {
+                { "name", *delta.function_name }
+            };
+            this->m_last_resp_is_fc = true;
+        }
+
+        if (delta.function_arguments) {
+            this->m_stream_arguments += *delta.function_arguments;
+        }
+    }
+
+    auto Conversation::CommitStreamData() -> void {
+        auto& messages = this->m_conversation["messages"];
+        if (messages.empty() || !messages.back().contains("pending")) {
+            this->m_stream_content.clear();
+            this->m_stream_arguments.clear();
+            return;
+        }
+
+        auto& message = messages.back();
+        message.erase("pending");
+        message["content"] = std::move(this->m_stream_content);
+        this->m_stream_content.clear();
+
+        if (!this->m_stream_arguments.empty()) {
+            auto& function_call = this->m_conversation["function_call"];
+            if (function_call.contains("arguments")) {
+                function_call["arguments"].get_ref<std::string&>() += this->m_stream_arguments;
+            } else {
+                function_call["arguments"] = std::move(this->m_stream_arguments);
+            }
+            this->m_stream_arguments.clear();
+        }
+    }
+
+    auto Conversation::FinishStream() -> void {
+        // a stream cut short (by its callback, a cancellation, the deadline
+        // or the network) never sees [DONE]; keep what it did deliver
+        this->CommitStreamData();
+        this->m_sse.Reset();
+    }
+
+    PreparedChatCompletion::PreparedChatCompletion(
+        const ChatCompletionRequest& request,
+        const Conversation& prefix
+    )
+        : m_stream(request.stream),
+          // only greedy sampling repeats its output
+          m_deterministic(request.temperature && *request.temperature == 0.0f) {
+        PreparedChatCompletion::WriteHead(this->m_head, request, prefix);
+    }
+
+    auto PreparedChatCompletion::WriteHead(
+        JsonWriter& json,
+        const ChatCompletionRequest& request,
+        const Conversation& conversation
+    ) -> void {
+        json.push_back("model", request.model);
+        json.push_back("temperature", request.temperature);
+        json.push_back("top_p", request.top_p);
+        json.push_back("n", request.n);
+        json.push_back("stop", request.stop);
+        json.push_back("max_tokens", request.max_tokens);
+        json.push_back("presence_penalty", request.presence_penalty);
+        json.push_back("frequency_penalty", request.frequency_penalty);
+        json.push_back("logit_bias", request.logit_bias);
+        json.push_back("user", request.user);
+
+        if (const auto& function_call = request.function_call) {
+            if (*function_call == "none" || *function_call == "auto") {
+                json.push_back("function_call", *function_call);
+            } else {
+                json.push_back("function_call", nlohmann::json{ { "name", *function_call } });
+            }
+        }
+
+        json.push_back("stream", request.stream);
+
+        if (conversation.HasFunctions()) {
+            json.push_back("functions", conversation.GetFunctionsJSON()["functions"]);
+        }
+
+        // last, so that a copy of the writer can append further messages
+        json.open_array("messages");
+        PreparedChatCompletion::WriteMessages(json, conversation);
+    }
+
+    auto PreparedChatCompletion::WriteMessages(JsonWriter& json, const Conversation& conversation)
+        -> void {
+        const auto& history = conversation.GetJSON();
+        if (const auto messages = history.find("messages"); messages != history.end()) {
+            // written out in place, rather than copied into a document first
+            for (const auto& message : *messages) {
+                if (message.contains("pending")) {
+                    // a stream still in progress; the flag is not the API's
+                    auto settled = message;
+                    settled.erase("pending");
+                    json.push_back_element(settled);
+                    continue;
+                }
+                json.push_back_element(message);
+            }
+        }
+    }
+
+    auto ChatCompletion::CreateRequest(
+        Conversation& conversation,
+        const ChatCompletionRequest& request
+    ) const -> Result<PreparedRequest> {
+        JsonWriter json;
+        PreparedChatCompletion::WriteHead(json, request, conversation);
+        json.close_array();
+
+        return this->CreateRequest(
+            std::move(json).body(),
+            request.temperature && *request.temperature == 0.0f,
+            request.stream,
+            conversation
+        );
+    }
+
+    auto ChatCompletion::CreateRequest(
+        const PreparedChatCompletion& prepared,
+        Conversation& conversation
+    ) const -> Result<PreparedRequest> {
+        JsonWriter json(prepared.m_head);
+        PreparedChatCompletion::WriteMessages(json, conversation);
+        json.close_array();
+
+        return this->CreateRequest(
+            std::move(json).body(),
+            prepared.m_deterministic,
+            prepared.m_stream,
+            conversation
+        );
+    }
+
+    auto ChatCompletion::CreateRequest(
+        cpr::Body body,
+        bool deterministic,
+        const std::optional<ChatStreamCallback>& stream,
+        Conversation& conversation
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+
+        cpr::WriteCallback on_write{};
+        if (stream) {
+            on_write = cpr::WriteCallback{
+                [stream = *stream,
+                 &conversation](std::string_view data, intptr_t userdata) -> bool {
+                    return stream(std::string(data), userdata, conversation);
+                }
+            };
+        }
+
+        auto request = this->Prepare(
+            Method::HTTP_POST,
+            this->GetOpenAIRoot(),
+            "/chat/completions",
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            std::move(body),
+            Cacheable{ deterministic },
+            std::move(on_write),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+        if (stream) {
+            request.on_finish = [&conversation] { conversation.FinishStream(); };
+        }
+        return request;
+    }
+
+    auto ChatCompletion::Create(
+        Conversation& conversation,
+        const ChatCompletionRequest& request,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->CreateRequest(conversation, request), call);
+    }
+
+    auto ChatCompletion::CreateAsync(
+        Conversation& conversation,
+        const ChatCompletionRequest& request,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->CreateRequest(conversation, request), call);
+    }
+
+    auto ChatCompletion::CreateCo(
+        Conversation& conversation,
+        const ChatCompletionRequest& request,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->CreateRequest(conversation, request), call);
+    }
+
+    auto ChatCompletion::Create(
+        const PreparedChatCompletion& prepared,
+        Conversation& conversation,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->CreateRequest(prepared, conversation), call);
+    }
+
+    auto ChatCompletion::CreateAsync(
+        const PreparedChatCompletion& prepared,
+        Conversation& conversation,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->CreateRequest(prepared, conversation), call);
+    }
+
+    auto ChatCompletion::CreateCo(
+        const PreparedChatCompletion& prepared,
+        Conversation& conversation,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->CreateRequest(prepared, conversation), call);
+    }
+
+    auto ChatCompletion::Create(
+        const std::string& model,
+        Conversation& conversation,
+        std::optional<std::string> function_call,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        std::optional<uint16_t> n,
+        std::optional<ChatStreamCallback> stream,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateRequest(
+                conversation,
+                {
+                    .model = model,
+                    .function_call = std::move(function_call),
+                    .temperature = temperature,
+                    .top_p = top_p,
+                    .n = n,
+                    .stream = std::move(stream),
+                    .stop = std::move(stop),
+                    .max_tokens = max_tokens,
+                    .presence_penalty = presence_penalty,
+                    .frequency_penalty = frequency_penalty,
+                    .logit_bias = std::move(logit_bias),
+                    .user = std::move(user),
+                }
+            ),
+            call
+        );
+    }
+
+    auto ChatCompletion::CreateAsync(
+        const std::string& model,
+        Conversation& conversation,
+        std::optional<std::string> function_call,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        std::optional<uint16_t> n,
+        std::optional<ChatStreamCallback> stream,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(
+            this->CreateRequest(
+                conversation,
+                {
+                    .model = model,
+                    .function_call = std::move(function_call),
+                    .temperature = temperature,
+                    .top_p = top_p,
+                    .n = n,
+                    .stream = std::move(stream),
+                    .stop = std::move(stop),
+                    .max_tokens = max_tokens,
+                    .presence_penalty = presence_penalty,
+                    .frequency_penalty = frequency_penalty,
+                    .logit_bias = std::move(logit_bias),
+                    .user = std::move(user),
+                }
+            ),
+            call
+        );
+    }
+
+    auto ChatCompletion::CreateCo(
+        const std::string& model,
+        Conversation& conversation,
+        std::optional<std::string> function_call,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        std::optional<uint16_t> n,
+        std::optional<ChatStreamCallback> stream,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateRequest(
+                conversation,
+                {
+                    .model = model,
+                    .function_call = std::move(function_call),
+                    .temperature = temperature,
+                    .top_p = top_p,
+                    .n = n,
+                    .stream = std::move(stream),
+                    .stop = std::move(stop),
+                    .max_tokens = max_tokens,
+                    .presence_penalty = presence_penalty,
+                    .frequency_penalty = frequency_penalty,
+                    .logit_bias = std::move(logit_bias),
+                    .user = std::move(user),
+                }
+            ),
+            call
+        );
+    }
+
+    auto operator<<(std::ostream& os, const Conversation& conv) -> std::ostream& {
+        auto raw_conv = conv.GetRawConversation();
+        os << (raw_conv ? *raw_conv : "") << std::endl;
+
+        if (conv.HasFunctions()) {
+            auto raw_funcs = conv.GetRawFunctions();
+            os << (raw_funcs ? *raw_funcs : "");
+        }
+
+        return os;
+    }
+
+    Functions::Functions() {
+        this->m_functions["functions"] = nlohmann::json::array();
+    }
+
+    Functions::Functions(const Functions& other) {
+        this->m_functions = other.m_functions;
+    }
+
+    Functions::Functions(Functions&& old) noexcept {
+        this->m_functions = std::move(old.m_functions);
+        old.m_functions = nlohmann::json::object();
+    }
+
+    auto Functions::operator=(const Functions& other) -> Functions& {
+        if (this != &other) {
+            this->m_functions = other.m_functions;
+        }
+        return *this;
+    }
+
+    auto Functions::operator=(Functions&& old) noexcept -> Functions& {
+        this->m_functions = std::move(old.m_functions);
+        old.m_functions = nlohmann::json::object();
+        return *this;
+    }
+
+    auto Functions::AddFunction(std::string_view function_name) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(function_name);
+        if (!idx_result) {
+            this->m_functions["functions"].push_back(
+                {
+                    { "name", function_name }
+            }
+            );
+            return true; // function added
+        }
+        return false;    // function already exists
+    }
+
+    auto Functions::AddFunctions(std::initializer_list<std::string_view> function_names) & noexcept
+        -> Result<bool> {
+        if (function_names.size() > 0) {
+            for (const auto& function_name : function_names) {
+                auto idx_result = this->GetFunctionIndex(function_name);
+                if (!idx_result) {
+                    this->m_functions["functions"].push_back(
+                        {
+                            { "name", function_name }
+                    }
+                    );
+                }
+            }
+            return true; // functions added
+        }
+        return false;    // functions not added (size 0)
+    }
+
+    auto Functions::AddFunctions(std::vector<std::string> function_names) & noexcept
+        -> Result<bool> {
+        if (function_names.size() > 0) {
+            for (auto& function_name : function_names) {
+                auto idx_result = this->GetFunctionIndex(function_name);
+                if (!idx_result) {
+                    this->m_functions["functions"].push_back(
+                        {
+                            { "name", std::move(function_name) }
+                    }
+                    );
+                }
+            }
+            return true; // functions added
+        }
+        return false;    // functions not added (size 0)
+    }
+
+    auto Functions::PopFunction(std::string_view function_name) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(function_name);
+
+        if (idx_result) {
+            this->m_functions["functions"].erase(
+                this->m_functions["functions"].begin() + static_cast<std::ptrdiff_t>(*idx_result)
+            );
+            return true; // function removed
+        }
+
+        return false; // function not removed
+    }
+
+    auto Functions::PopFunctions(std::initializer_list<std::string_view> function_names) & noexcept
+        -> Result<bool> {
+        if (function_names.size() > 0) {
+            for (const auto& function_name : function_names) {
+                auto idx_result = this->GetFunctionIndex(function_name);
+
+                if (idx_result) {
+                    this->m_functions["functions"].erase(
+                        this->m_functions["functions"].begin() +
+                        static_cast<std::ptrdiff_t>(*idx_result)
+                    );
+                }
+            }
+
+            return true; // functions removed
+        }
+
+        return false; // functions not removed (size 0)
+    }
+
+    auto Functions::PopFunctions(std::vector<std::string> function_names) & noexcept
+        -> Result<bool> {
+        if (function_names.size() > 0) {
+            for (const auto& function_name : function_names) {
+                auto idx_result = this->GetFunctionIndex(function_name);
+
+                if (idx_result) {
+                    this->m_functions["functions"].erase(
+                        this->m_functions["functions"].begin() +
+                        static_cast<std::ptrdiff_t>(*idx_result)
+                    );
+                }
+            }
+            return true; // functions removed
+        }
+
+        return false; // functions not removed (size 0)
+    }
+
+    auto Functions::SetDescription(std::string_view target, std::string_view description) & noexcept
+        -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (!this->m_functions["functions"][i].contains("description")) {
+                this->m_functions["functions"][i]["description"] = description;
+                return true; // description set successfully
+            }
+            return false;    // already has a description
+        }
+
+        return false; // function does not exist
+    }
+
+    auto Functions::PopDescription(std::string_view target) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("description")) {
+                this->m_functions["functions"][i].erase("description");
+                return true; // description removed successfully
+            }
+            return false;    // does not have a description
+        }
+
+        return false; // function does not exist
+    }
+
+    auto Functions::SetRequired(
+        std::string_view target,
+        std::initializer_list<std::string_view> params
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result && params.size() > 0) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                for (const auto& parameter : params) {
+                    this->m_functions["functions"][i]["parameters"]["required"] = params;
+                    return true; // required parameters set successfully
+                }
+            }
+        }
+
+        return false; // required parameters not set
+    }
+
+    auto Functions::SetRequired(std::string_view target, std::vector<std::string> params) & noexcept
+        -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result && params.size() > 0) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                for (const auto& parameter : params) {
+                    this->m_functions["functions"][i]["parameters"]["required"] = std::move(params);
+                    return true; // required parameters set successfully
+                }
+            }
+        }
+
+        return false; // required parameters not set
+    }
+
+    auto Functions::PopRequired(std::string_view target) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
+                    this->m_functions["functions"][i]["parameters"].erase("required");
+                    return true; // required parameters removed successfully
+                }
+            }
+        }
+
+        return false; // required parameters not removed
+    }
+
+    auto Functions::AppendRequired(std::string_view target, std::string_view param) & noexcept
+        -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
+                    this->m_functions["functions"][i]["parameters"]["required"].push_back(param);
+                    return true; // required parameter appended successfully
+                }
+            }
+        }
+
+        return false; // required parameter not appended
+    }
+
+    auto Functions::AppendRequired(
+        std::string_view target,
+        std::initializer_list<std::string_view> params
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result && params.size() > 0) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
+                    for (const auto& param : params) {
+                        this->m_functions["functions"][i]["parameters"]["required"].push_back(
+                            param
+                        );
+                    }
+
+                    return true; // required parameters appended successfully
+                }
+            }
+        }
+
+        return false; // required parameters not appended
+    }
+
+    auto
+    Functions::AppendRequired(std::string_view target, std::vector<std::string> params) & noexcept
+        -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result && params.size() > 0) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                if (this->m_functions["functions"][i]["parameters"].contains("required")) {
+                    for (auto& param : params) {
+                        this->m_functions["functions"][i]["parameters"]["required"].push_back(
+                            std::move(param)
+                        );
+                    }
+
+                    return true; // required parameters appended successfully
+                }
+            }
+        }
+
+        return false; // required parameters not appended
+    }
+
+    auto Functions::SetParameter(std::string_view target, FunctionParameter parameter) & noexcept
+        -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (!this->m_functions["functions"][i].contains("parameters")) {
+                this->m_functions["functions"][i]["parameters"] = nlohmann::json::object();
+                this->m_functions["functions"][i]["parameters"]["properties"] =
+                    nlohmann::json::object();
+                this->m_functions["functions"][i]["parameters"]["type"] = "object";
+
+                this->m_functions["functions"][i]["parameters"]["properties"].push_back(
+                    {
+                        parameter.name,
+                        { { "type", std::move(parameter.type) },
+                               { "description", std::move(parameter.description) } }
+                }
+                );
+
+                if (parameter.enumeration) {
+                    this->m_functions["functions"][i]["parameters"]["properties"][parameter.name]
+                                     ["enum"] = std::move(parameter.enumeration.value());
+                }
+
+                return true; // parameter set successfully
+            }
+        }
+
+        return false; // function non-existent, or parameters already set (use AppendParameter(s))
+    }
+
+    auto Functions::SetParameters(
+        std::string_view target,
+        std::initializer_list<FunctionParameter> parameters
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (!this->m_functions["functions"][i].contains("parameters") &&
+                parameters.size() > 0) {
+                this->m_functions["functions"][i]["parameters"] = nlohmann::json::object();
+                this->m_functions["functions"][i]["parameters"]["properties"] =
+                    nlohmann::json::object();
+                this->m_functions["functions"][i]["parameters"]["type"] = "object";
+
+                for (const auto& parameter : parameters) {
+                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                            parameter.name
+                        )) {
+                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
+                            {
+                                parameter.name,
+                                { { "type", parameter.type },
+                                       { "description", parameter.description } }
+                        }
+                        );
+
+                        if (parameter.enumeration) {
+                            this->m_functions["functions"][i]["parameters"]["properties"]
+                                             [parameter.name]["enum"] =
+                                parameter.enumeration.value();
+                        }
+                    }
+                }
+
+                return true; // parameter set successfully
+            }
+        }
+
+        return false; // function non-existent, or parameters already set (use AppendParameter(s))
+    }
+
+    auto Functions::SetParameters(
+        std::string_view target,
+        std::vector<FunctionParameter> parameters
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (!this->m_functions["functions"][i].contains("parameters") &&
+                parameters.size() > 0) {
+                this->m_functions["functions"][i]["parameters"] = nlohmann::json::object();
+                this->m_functions["functions"][i]["parameters"]["properties"] =
+                    nlohmann::json::object();
+                this->m_functions["functions"][i]["parameters"]["type"] = "object";
+
+                for (auto& parameter : parameters) {
+                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                            parameter.name
+                        )) {
+                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
+                            {
+                                parameter.name,
+                                { { "type", std::move(parameter.type) },
+                                       { "description", std::move(parameter.description) } }
+                        }
+                        );
+
+                        if (parameter.enumeration) {
+                            this->m_functions["functions"][i]["parameters"]["properties"]
+                                             [parameter.name]["enum"] =
+                                std::move(parameter.enumeration.value());
+                        }
+                    }
+                }
+
+                return true; // parameter set successfully
+            }
+        }
+
+        return false; // function non-existent, or parameters already set (use AppendParameter(s))
+    }
+
+    auto Functions::PopParameters(std::string_view target) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                this->m_functions["functions"][i].erase("parameters");
+                return true; // parameters removed successfully
+            }
+        }
+
+        return false; // parameters not removed
+    }
+
+    auto Functions::PopParameters(
+        std::string_view target,
+        std::initializer_list<std::string_view> param_names
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                for (const auto& param_name : param_names) {
+                    if (this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                            param_name
+                        )) {
+                        this->m_functions["functions"][i]["parameters"]["properties"].erase(
+                            param_name
+                        );
+                    }
+                }
+
+                return true; // parameters removed successfully
+            }
+        }
+
+        return false; // parameters not removed
+    }
+
+    auto Functions::PopParameters(
+        std::string_view target,
+        std::vector<std::string> param_names
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                for (const auto& param_name : param_names) {
+                    if (this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                            param_name
+                        )) {
+                        this->m_functions["functions"][i]["parameters"]["properties"].erase(
+                            param_name
+                        );
+                    }
+                }
+
+                return true; // parameters removed successfully
+            }
+        }
+
+        return false; // parameters not removed
+    }
+
+    auto Functions::AppendParameter(std::string_view target, FunctionParameter parameter) & noexcept
+        -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                        parameter.name
+                    )) {
+                    this->m_functions["functions"][i]["parameters"]["properties"].push_back(
+                        {
+                            parameter.name,
+                            { { "type", std::move(parameter.type) },
+                                   { "description", std::move(parameter.description) } }
+                    }
+                    );
+
+                    if (parameter.enumeration) {
+                        this->m_functions["functions"][i]["parameters"]["properties"]
+                                         [parameter.name]["enum"] =
+                            std::move(parameter.enumeration.value());
+                    }
+
+                    return true; // parameter appended successfully
+                }
+            }
+        }
+
+        return false; // parameter not appended
+    }
+
+    auto Functions::AppendParameters(
+        std::string_view target,
+        std::initializer_list<FunctionParameter> parameters
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                for (const auto& parameter : parameters) {
+                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                            parameter.name
+                        )) {
+                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
+                            {
+                                parameter.name,
+                                { { "type", parameter.type },
+                                       { "description", parameter.description } }
+                        }
+                        );
+
+                        if (parameter.enumeration) {
+                            this->m_functions["functions"][i]["parameters"]["properties"]
+                                             [parameter.name]["enum"] =
+                                parameter.enumeration.value();
+                        }
+                    }
+                }
+
+                return true; // parameters appended successfully
+            }
+        }
+
+        return false; // parameters not appended
+    }
+
+    auto Functions::AppendParameters(
+        std::string_view target,
+        std::vector<FunctionParameter> parameters
+    ) & noexcept -> Result<bool> {
+        auto idx_result = this->GetFunctionIndex(target);
+
+        if (idx_result) {
+            index i = *idx_result;
+            if (this->m_functions["functions"][i].contains("parameters")) {
+                for (auto& parameter : parameters) {
+                    if (!this->m_functions["functions"][i]["parameters"]["properties"].contains(
+                            parameter.name
+                        )) {
+                        this->m_functions["functions"][i]["parameters"]["properties"].push_back(
+                            {
+                                parameter.name,
+                                { { "type", std::move(parameter.type) },
+                                       { "description", std::move(parameter.description) } }
+                        }
+                        );
+
+                        if (parameter.enumeration) {
+                            this->m_functions["functions"][i]["parameters"]["properties"]
+                                             [parameter.name]["enum"] =
+                                std::move(parameter.enumeration.value());
+                        }
+                    }
+                }
+
+                return true; // parameters appended successfully
+            }
+        }
+
+        return false; // parameters not appended
+    }
+
+    auto Functions::GetJSON() const& noexcept -> const nlohmann::json& {
+        return this->m_functions;
+    }
+
+    auto Functions::GetFunctionIndex(std::string_view function_name) const& noexcept
+        -> Result<index> {
+        index i = 0;
+
+        if (!this->m_functions.empty()) {
+            for (const auto& [key, value] : this->m_functions["functions"].items()) {
+                if (value.contains("name")) {
+                    if (value["name"].get<std::string>() == function_name) {
+                        return i;
+                    }
+                }
+                i++;
+            }
+        }
+
+        return std::unexpected(OpenAIError::parse_error("Function not found"));
+    }
+
+} // namespace liboai
@@ -17,14 +17,57 @@ export module liboai:components.completions;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.request;
 import :core.response;
+import :core.response_cache;
 import :core.network;
 
 export namespace liboai {
+    /**
+     * @brief The parameters of a completion, as taken by
+     *        Completions::Create(request).
+     *
+     * Members left unset are not sent, so designated initializers only
+     * need the ones that matter:
+     *
+     * @code
+     * oai.Completion->Create({ .model = "gpt-3.5-turbo-instruct", .prompt = "Say hi", .n = 2 });
+     * @endcode
+     *
+     * See Completions::Create(model_id, ...) for what each parameter does.
+     */
+    struct CompletionRequest {
+        using StreamCallback = std::function<bool(std::string, intptr_t)>;
+
+        std::string model;
+        std::optional<std::string> prompt = std::nullopt;
+        std::optional<std::string> suffix = std::nullopt;
+        std::optional<uint16_t> max_tokens = std::nullopt;
+        std::optional<float> temperature = std::nullopt;
+        std::optional<float> top_p = std::nullopt;
+        std::optional<uint16_t> n = std::nullopt;
+        std::optional<StreamCallback> stream = std::nullopt;
+        std::optional<uint8_t> logprobs = std::nullopt;
+        std::optional<bool> echo = std::nullopt;
+        std::optional<std::vector<std::string>> stop = std::nullopt;
+        std::optional<float> presence_penalty = std::nullopt;
+        std::optional<float> frequency_penalty = std::nullopt;
+        std::optional<uint16_t> best_of = std::nullopt;
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt;
+        std::optional<std::string> user = std::nullopt;
+    };
+
     class Completions final : private Network {
     public:
-        explicit Completions(const std::string& root) : Network(root) {}
+        explicit Completions(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Completions(const Completions&) = delete;
         Completions& operator=(const Completions&) = delete;
@@ -32,7 +75,52 @@ export namespace liboai {
         Completions& operator=(Completions&&) = delete;
         ~Completions() = default;
 
-        using StreamCallback = std::function<bool(std::string, intptr_t)>;
+        using StreamCallback = CompletionRequest::StreamCallback;
+
+        /**
+         * @brief Given a prompt, the model will return one or more
+         * predicted completions.
+         *
+         * 'request' is read where it is and never copied, save for its
+         * stream callback, so it can be reused across calls.
+         *
+         * @param request The model, prompt and parameters to use.
+         * @param call    Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response object containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto Create(
+            const CompletionRequest& request,
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
+
+        /**
+         * @brief Asynchronously creates a completion from 'request', which
+         *        is serialized before this returns and need not outlive it.
+         *
+         * @param request The model, prompt and parameters to use.
+         * @param call    Cancellation token and deadline of the call.
+         *
+         * @return A liboai::Response future containing the data in JSON format.
+         */
+        [[nodiscard]]
+        auto CreateAsync(
+            const CompletionRequest& request,
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of Create(request); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const CompletionRequest& request,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
 
         /**
          * @brief Given a prompt, the model will return one or more
@@ -80,6 +168,7 @@ export namespace liboai {
          *                           completion. Accepts a json object that maps tokens (specified
          * by their token ID in the GPT tokenizer) to an associated bias value from -100 to 100.
          * @param user               A unique identifier representing your end-user.
+         * @param call               Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          * data in JSON format.
@@ -101,7 +190,8 @@ export namespace liboai {
             std::optional<float> frequency_penalty = std::nullopt,
             std::optional<uint16_t> best_of = std::nullopt,
             std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -154,6 +244,7 @@ export namespace liboai {
          *                           by their token ID in the GPT tokenizer) to an associated bias
          *                           value from -100 to 100.
          * @param user               A unique identifier representing your end-user.
+         * @param call               Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          * data in JSON format.
@@ -175,14 +266,109 @@ export namespace liboai {
             std::optional<float> frequency_penalty = std::nullopt,
             std::optional<uint16_t> best_of = std::nullopt,
             std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& model_id,
+            std::optional<std::string> prompt = std::nullopt,
+            std::optional<std::string> suffix = std::nullopt,
+            std::optional<uint16_t> max_tokens = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<float> top_p = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<StreamCallback> stream = std::nullopt,
+            std::optional<uint8_t> logprobs = std::nullopt,
+            std::optional<bool> echo = std::nullopt,
+            std::optional<std::vector<std::string>> stop = std::nullopt,
+            std::optional<float> presence_penalty = std::nullopt,
+            std::optional<float> frequency_penalty = std::nullopt,
+            std::optional<uint16_t> best_of = std::nullopt,
+            std::optional<std::unordered_map<std::string, int8_t>> logit_bias = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto CreateRequest(const CompletionRequest& request) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
+    auto Completions::CreateRequest(const CompletionRequest& request) const
+        -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        // only greedy sampling repeats its output
+        const bool deterministic = request.temperature && *request.temperature == 0.0f;
+
+        JsonWriter json;
+        json.push_back("model", request.model);
+        json.push_back("prompt", request.prompt);
+        json.push_back("suffix", request.suffix);
+        json.push_back("max_tokens", request.max_tokens);
+        json.push_back("temperature", request.temperature);
+        json.push_back("top_p", request.top_p);
+        json.push_back("n", request.n);
+        json.push_back("stream", request.stream);
+        json.push_back("logprobs", request.logprobs);
+        json.push_back("echo", request.echo);
+        json.push_back("stop", request.stop);
+        json.push_back("presence_penalty", request.presence_penalty);
+        json.push_back("frequency_penalty", request.frequency_penalty);
+        json.push_back("best_of", request.best_of);
+        json.push_back("logit_bias", request.logit_bias);
+        json.push_back("user", request.user);
+
+        return this->Prepare(
+            Method::HTTP_POST,
+            this->GetOpenAIRoot(),
+            "/completions",
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            std::move(json).body(),
+            Cacheable{ deterministic },
+            request.stream ?
+                cpr::WriteCallback{
+                    [cb = *request.stream](std::string_view data, intptr_t userdata) -> bool {
+                        return cb(std::string(data), userdata);
+                    } } :
+                cpr::WriteCallback{},
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Completions::Create(
+        const CompletionRequest& request,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->CreateRequest(request), call);
+    }
+
+    auto Completions::CreateAsync(
+        const CompletionRequest& request,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->CreateRequest(request), call);
+    }
+
+    auto Completions::CreateCo(
+        const CompletionRequest& request,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->CreateRequest(request), call);
+    }
+
     auto Completions::Create(
         const std::string& model_id,
         std::optional<std::string> prompt,
@@ -199,41 +385,29 @@ export namespace liboai {
         std::optional<float> frequency_penalty,
         std::optional<uint16_t> best_of,
         std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> Result<Response> {
-        JsonConstructor jcon;
-        jcon.push_back("model", model_id);
-        jcon.push_back("prompt", std::move(prompt));
-        jcon.push_back("suffix", std::move(suffix));
-        jcon.push_back("max_tokens", std::move(max_tokens));
-        jcon.push_back("temperature", std::move(temperature));
-        jcon.push_back("top_p", std::move(top_p));
-        jcon.push_back("n", std::move(n));
-        jcon.push_back("stream", stream);
-        jcon.push_back("logprobs", std::move(logprobs));
-        jcon.push_back("echo", std::move(echo));
-        jcon.push_back("stop", std::move(stop));
-        jcon.push_back("presence_penalty", std::move(presence_penalty));
-        jcon.push_back("frequency_penalty", std::move(frequency_penalty));
-        jcon.push_back("best_of", std::move(best_of));
-        jcon.push_back("logit_bias", std::move(logit_bias));
-        jcon.push_back("user", std::move(user));
-
-        return this->Request(
-            Method::HTTP_POST,
-            this->GetOpenAIRoot(),
-            "/completions",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            stream ? cpr::WriteCallback{ [cb = std::move(stream.value())](
-                                             std::string_view data,
-                                             intptr_t userdata
-                                         ) -> bool { return cb(std::string(data), userdata); } } :
-                     cpr::WriteCallback{},
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+        return this->Execute(
+            this->CreateRequest({
+                .model = model_id,
+                .prompt = std::move(prompt),
+                .suffix = std::move(suffix),
+                .max_tokens = max_tokens,
+                .temperature = temperature,
+                .top_p = top_p,
+                .n = n,
+                .stream = std::move(stream),
+                .logprobs = logprobs,
+                .echo = echo,
+                .stop = std::move(stop),
+                .presence_penalty = presence_penalty,
+                .frequency_penalty = frequency_penalty,
+                .best_of = best_of,
+                .logit_bias = std::move(logit_bias),
+                .user = std::move(user),
+            }),
+            call
         );
     }
 
@@ -253,28 +427,71 @@ export namespace liboai {
         std::optional<float> frequency_penalty,
         std::optional<uint16_t> best_of,
         std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &liboai::Completions::Create,
-            this,
-            model_id,
-            prompt,
-            suffix,
-            max_tokens,
-            temperature,
-            top_p,
-            n,
-            stream,
-            logprobs,
-            echo,
-            stop,
-            presence_penalty,
-            frequency_penalty,
-            best_of,
-            logit_bias,
-            user
+        return this->ExecuteAsync(
+            this->CreateRequest({
+                .model = model_id,
+                .prompt = std::move(prompt),
+                .suffix = std::move(suffix),
+                .max_tokens = max_tokens,
+                .temperature = temperature,
+                .top_p = top_p,
+                .n = n,
+                .stream = std::move(stream),
+                .logprobs = logprobs,
+                .echo = echo,
+                .stop = std::move(stop),
+                .presence_penalty = presence_penalty,
+                .frequency_penalty = frequency_penalty,
+                .best_of = best_of,
+                .logit_bias = std::move(logit_bias),
+                .user = std::move(user),
+            }),
+            call
+        );
+    }
+
+    auto Completions::CreateCo(
+        const std::string& model_id,
+        std::optional<std::string> prompt,
+        std::optional<std::string> suffix,
+        std::optional<uint16_t> max_tokens,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        std::optional<uint16_t> n,
+        std::optional<StreamCallback> stream,
+        std::optional<uint8_t> logprobs,
+        std::optional<bool> echo,
+        std::optional<std::vector<std::string>> stop,
+        std::optional<float> presence_penalty,
+        std::optional<float> frequency_penalty,
+        std::optional<uint16_t> best_of,
+        std::optional<std::unordered_map<std::string, int8_t>> logit_bias,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateRequest({
+                .model = model_id,
+                .prompt = std::move(prompt),
+                .suffix = std::move(suffix),
+                .max_tokens = max_tokens,
+                .temperature = temperature,
+                .top_p = top_p,
+                .n = n,
+                .stream = std::move(stream),
+                .logprobs = logprobs,
+                .echo = echo,
+                .stop = std::move(stop),
+                .presence_penalty = presence_penalty,
+                .frequency_penalty = frequency_penalty,
+                .best_of = best_of,
+                .logit_bias = std::move(logit_bias),
+                .user = std::move(user),
+            }),
+            call
         );
     }
 
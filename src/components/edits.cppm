@@ -17,14 +17,22 @@ export module liboai:components.edits;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.request;
 import :core.response;
 import :core.network;
 
 export namespace liboai {
     class Edits final : private Network {
     public:
-        explicit Edits(const std::string& root) : Network(root) {}
+        explicit Edits(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Edits(const Edits&) = delete;
         Edits& operator=(const Edits&) = delete;
@@ -50,6 +58,7 @@ export namespace liboai {
          *                     top_p probability mass. So 0.1 means only
          *                     the tokens comprising the top 10% probability
          *                     mass are considered.
+         * @param call         Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
@@ -61,7 +70,8 @@ export namespace liboai {
             std::optional<std::string> instruction = std::nullopt,
             std::optional<uint16_t> n = std::nullopt,
             std::optional<float> temperature = std::nullopt,
-            std::optional<float> top_p = std::nullopt
+            std::optional<float> top_p = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -82,6 +92,7 @@ export namespace liboai {
          *                     top_p probability mass. So 0.1 means only
          *                     the tokens comprising the top 10% probability
          *                     mass are considered.
+         * @param call         Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
@@ -93,22 +104,51 @@ export namespace liboai {
             std::optional<std::string> instruction = std::nullopt,
             std::optional<uint16_t> n = std::nullopt,
             std::optional<float> temperature = std::nullopt,
-            std::optional<float> top_p = std::nullopt
+            std::optional<float> top_p = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& model_id,
+            std::optional<std::string> input = std::nullopt,
+            std::optional<std::string> instruction = std::nullopt,
+            std::optional<uint16_t> n = std::nullopt,
+            std::optional<float> temperature = std::nullopt,
+            std::optional<float> top_p = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto CreateRequest(
+            const std::string& model_id,
+            std::optional<std::string> input,
+            std::optional<std::string> instruction,
+            std::optional<uint16_t> n,
+            std::optional<float> temperature,
+            std::optional<float> top_p
+        ) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto Edits::Create(
+    auto Edits::CreateRequest(
         const std::string& model_id,
         std::optional<std::string> input,
         std::optional<std::string> instruction,
         std::optional<uint16_t> n,
         std::optional<float> temperature,
         std::optional<float> top_p
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("model", model_id);
         jcon.push_back("input", std::move(input));
@@ -117,16 +157,37 @@ export namespace liboai {
         jcon.push_back("temperature", std::move(temperature));
         jcon.push_back("top_p", std::move(top_p));
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/edits",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Edits::Create(
+        const std::string& model_id,
+        std::optional<std::string> input,
+        std::optional<std::string> instruction,
+        std::optional<uint16_t> n,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateRequest(
+                model_id,
+                std::move(input),
+                std::move(instruction),
+                n,
+                temperature,
+                top_p
+            ),
+            call
         );
     }
 
@@ -136,18 +197,41 @@ export namespace liboai {
         std::optional<std::string> instruction,
         std::optional<uint16_t> n,
         std::optional<float> temperature,
-        std::optional<float> top_p
+        std::optional<float> top_p,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Edits::Create,
-            this,
-            model_id,
-            input,
-            instruction,
-            n,
-            temperature,
-            top_p
+        return this->ExecuteAsync(
+            this->CreateRequest(
+                model_id,
+                std::move(input),
+                std::move(instruction),
+                n,
+                temperature,
+                top_p
+            ),
+            call
+        );
+    }
+
+    auto Edits::CreateCo(
+        const std::string& model_id,
+        std::optional<std::string> input,
+        std::optional<std::string> instruction,
+        std::optional<uint16_t> n,
+        std::optional<float> temperature,
+        std::optional<float> top_p,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateRequest(
+                model_id,
+                std::move(input),
+                std::move(instruction),
+                n,
+                temperature,
+                top_p
+            ),
+            call
         );
     }
 
@@ -2,6 +2,8 @@ module;
 
 #include <cpr/cpr.h>
 
+#include <nlohmann/json.hpp>
+
 /**
  * @file embeddings.cppm
  *
@@ -11,20 +13,63 @@ module;
  * liboai.h header file through an instantiated liboai::OpenAI object after
  * setting necessary authentication information through the
  * liboai::Authorization::Authorizer() singleton object.
+ *
+ * Large numbers of inputs can be embedded with the span overload of
+ * Embeddings::Create(...), which splits them into API-sized batches sent
+ * concurrently, and many small concurrent calls can be merged into
+ * batched requests with liboai::EmbeddingCoalescer.
+ *
+ * Embeddings::CreateMatrix(...) returns the vectors as a
+ * liboai::EmbeddingMatrix instead, requesting them base64-encoded and
+ * decoding them straight into one float buffer without parsing the
+ * responses into JSON.
  */
 
 export module liboai:components.embeddings;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
+import :core.embedding_matrix;
 import :core.error;
+import :core.request;
 import :core.response;
+import :core.response_cache;
 import :core.network;
 
 export namespace liboai {
+    /**
+     * @brief How Embeddings::Create(...) splits a span of inputs.
+     */
+    struct EmbeddingBatchOptions {
+        // inputs per request; the API accepts at most 2048
+        std::size_t max_batch_inputs = 2048;
+        // total input bytes per request, keeping each request well below
+        // the API's per-request token limit
+        std::size_t max_batch_bytes = 1'000'000;
+        // requests in flight at once
+        std::size_t max_concurrency = 4;
+    };
+
+    /**
+     * @brief How the API encodes the returned vectors.
+     */
+    enum class EmbeddingEncoding : std::uint8_t {
+        Float, // arrays of JSON numbers
+        Base64 // little-endian float32, base64-encoded; about a quarter the size
+    };
+
+    class EmbeddingCoalescer;
+
     class Embeddings final : private Network {
     public:
-        explicit Embeddings(const std::string& root) : Network(root) {}
+        explicit Embeddings(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Embeddings(const Embeddings&) = delete;
         Embeddings& operator=(const Embeddings&) = delete;
@@ -38,6 +83,7 @@ export namespace liboai {
          * @param *model       The model to use for the edit.
          * @param input        The input text to edit.
          * @param user         A unique identifier representing your end-user
+         * @param call         Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
@@ -46,15 +92,73 @@ export namespace liboai {
         auto Create(
             const std::string& model_id,
             std::optional<std::string> input = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
+        /**
+         * @brief Creates embedding vectors for every input in 'inputs'.
+         *
+         * The inputs are split into batches as set by 'options', which are
+         * sent concurrently through the client's executor or event loop
+         * while the calling thread waits. Should not be called from a task
+         * running on the client's own executor.
+         *
+         * @param *model  The model to use.
+         * @param *inputs The input texts.
+         * @param user    A unique identifier representing your end-user
+         * @param options How to batch the inputs.
+         * @param call    Cancellation token and deadline of the call, shared
+         *                by every batch.
+         *
+         * @return A liboai::Response object whose 'data' array holds one
+         *         embedding per input, in input order, and whose 'usage'
+         *         sums that of every batch. If any batch fails, its error.
+         */
+        [[nodiscard]]
+        auto Create(
+            const std::string& model_id,
+            std::span<const std::string> inputs,
+            std::optional<std::string> user = std::nullopt,
+            EmbeddingBatchOptions options = {},
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
+
+        /**
+         * @brief Creates embedding vectors for every input in 'inputs' as
+         *        one contiguous matrix.
+         *
+         * Batches like the span overload of Create(...), but requests the
+         * vectors base64-encoded and decodes each batch's body directly
+         * into the matrix, so no JSON document is ever built for them.
+         *
+         * @param *model  The model to use.
+         * @param *inputs The input texts.
+         * @param user    A unique identifier representing your end-user
+         * @param options How to batch the inputs.
+         * @param call    Cancellation token and deadline of the call, shared
+         *                by every batch.
+         *
+         * @return A liboai::EmbeddingMatrix whose row i is the embedding of
+         *         inputs[i], with 'usage' summed over every batch. If any
+         *         batch fails, its error.
+         */
+        [[nodiscard]]
+        auto CreateMatrix(
+            const std::string& model_id,
+            std::span<const std::string> inputs,
+            std::optional<std::string> user = std::nullopt,
+            EmbeddingBatchOptions options = {},
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<EmbeddingMatrix>;
+
         /**
          * @brief Asynchronously creates an embedding vector representing the input text.
          *
          * @param *model       The model to use for the edit.
          * @param input        The input text to edit.
          * @param user         A unique identifier representing your end-user
+         * @param call         Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
@@ -63,43 +167,626 @@ export namespace liboai {
         auto CreateAsync(
             const std::string& model_id,
             std::optional<std::string> input = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& model_id,
+            std::optional<std::string> input = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        friend class EmbeddingCoalescer;
+
+        [[nodiscard]]
+        auto CreateRequest(
+            const std::string& model_id,
+            std::optional<std::string> input,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto BatchRequest(
+            const std::string& model_id,
+            std::span<const std::string> inputs,
+            const std::optional<std::string>& user,
+            EmbeddingEncoding encoding = EmbeddingEncoding::Float
+        ) const -> Result<PreparedRequest>;
+
+        /**
+         * @brief Sends 'inputs' in batches, at most 'max_concurrency' at a
+         *        time, and hands each batch's outcome to 'on_batch' in
+         *        input order.
+         *
+         * @param on_batch Invoked as on_batch(offset, count, Result<Response>&&)
+         *                 -> Result<void>; an error cancels the batches
+         *                 still in flight and is returned.
+         */
+        template <class OnBatch>
+        auto SendBatches(
+            const std::string& model_id,
+            std::span<const std::string> inputs,
+            const std::optional<std::string>& user,
+            EmbeddingBatchOptions options,
+            EmbeddingEncoding encoding,
+            const CallOptions& call,
+            OnBatch&& on_batch
+        ) const -> Result<void>;
+
+        /**
+         * @brief Runs 'task' on the client's executor.
+         */
+        [[nodiscard]]
+        auto Post(std::function<void()> task) const -> bool {
+            return this->GetContext()->GetExecutor().Execute(std::move(task));
+        }
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
+    };
+
+    /**
+     * @brief Tunables for liboai::EmbeddingCoalescer.
+     */
+    struct EmbeddingCoalescerOptions {
+        // inputs merged into one request at most
+        std::size_t max_batch_inputs = 256;
+        // longest an input waits for others to share its request
+        std::chrono::milliseconds max_wait{ 5 };
+    };
+
+    struct EmbeddingCoalescerStats {
+        std::uint64_t inputs = 0;
+        std::uint64_t batches = 0;
+    };
+
+    /**
+     * @brief Merges concurrent single-input embedding calls into batched
+     *        requests.
+     *
+     * Inputs passed to Create(...) from any number of threads are collected
+     * until 'max_batch_inputs' of them are waiting or the oldest has waited
+     * 'max_wait', and are then sent as one request on the client's
+     * executor. Each caller's future receives a Response holding only its
+     * own embedding (at index 0); 'usage' is not split between callers and
+     * is left out.
+     *
+     * The Embeddings object passed in must outlive the coalescer and every
+     * batch it has sent.
+     */
+    class EmbeddingCoalescer final {
+    public:
+        EmbeddingCoalescer(
+            const Embeddings& embeddings,
+            std::string model_id,
+            EmbeddingCoalescerOptions options = {}
+        );
+
+        EmbeddingCoalescer(const EmbeddingCoalescer&) = delete;
+        EmbeddingCoalescer& operator=(const EmbeddingCoalescer&) = delete;
+        EmbeddingCoalescer(EmbeddingCoalescer&&) = delete;
+        EmbeddingCoalescer& operator=(EmbeddingCoalescer&&) = delete;
+
+        /**
+         * @brief Sends whatever is still waiting and stops collecting.
+         */
+        ~EmbeddingCoalescer();
+
+        /**
+         * @brief Queues 'input' to be embedded with other concurrent inputs.
+         *
+         * @return A future holding a liboai::Response with the embedding of
+         *         'input', or the error of the batch it was sent in.
+         */
+        [[nodiscard]]
+        auto Create(std::string input) -> FutureExpected<Response>;
+
+        [[nodiscard]]
+        auto Stats() const noexcept -> EmbeddingCoalescerStats;
+
+    private:
+        struct Pending {
+            std::string input;
+            std::promise<Result<Response>> promise;
+            std::chrono::steady_clock::time_point since;
+        };
+
+        auto Run() -> void;
+        auto Send(std::vector<Pending> batch) -> void;
+
+        const Embeddings& m_embeddings;
+        const std::string m_model_id;
+        const EmbeddingCoalescerOptions m_options;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::vector<Pending> m_pending;
+        bool m_stopping = false;
+        std::atomic<std::uint64_t> m_inputs{ 0 }, m_batches{ 0 };
+        std::thread m_thread;
     };
 
     // Implementation
-    auto Embeddings::Create(
+    auto Embeddings::CreateRequest(
         const std::string& model_id,
         std::optional<std::string> input,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("model", model_id);
         jcon.push_back("input", std::move(input));
         jcon.push_back("user", std::move(user));
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/embeddings",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            Cacheable{},
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Embeddings::BatchRequest(
+        const std::string& model_id,
+        std::span<const std::string> inputs,
+        const std::optional<std::string>& user,
+        EmbeddingEncoding encoding
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        auto input = nlohmann::json::array();
+        for (const auto& text : inputs) {
+            input.push_back(text);
+        }
+
+        JsonConstructor jcon;
+        jcon.push_back("model", model_id);
+        jcon.push_back("input", std::optional<nlohmann::json>(std::move(input)));
+        jcon.push_back("user", std::optional<std::string>(user));
+        if (encoding == EmbeddingEncoding::Base64) {
+            jcon.push_back("encoding_format", "base64");
+        }
+
+        auto request = this->Prepare(
+            Method::HTTP_POST,
+            this->GetOpenAIRoot(),
+            "/embeddings",
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            Cacheable{},
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+        if (request && encoding == EmbeddingEncoding::Base64) {
+            // base64 bodies are only read by EmbeddingMatrix, which scans
+            // the text itself; parsing them would be wasted work
+            request->parsing = JsonParsing::Lazy;
+        }
+        return request;
+    }
+
+    template <class OnBatch>
+    auto Embeddings::SendBatches(
+        const std::string& model_id,
+        std::span<const std::string> inputs,
+        const std::optional<std::string>& user,
+        EmbeddingBatchOptions options,
+        EmbeddingEncoding encoding,
+        const CallOptions& call,
+        OnBatch&& on_batch
+    ) const -> Result<void> {
+        options.max_batch_inputs = std::clamp<std::size_t>(options.max_batch_inputs, 1, 2048);
+        options.max_concurrency = std::max<std::size_t>(options.max_concurrency, 1);
+
+        struct InFlight {
+            std::size_t offset, count;
+            FutureExpected<Response> future;
+        };
+        std::deque<InFlight> in_flight;
+        // every batch shares the call's deadline, however late it is sent,
+        // and a token of its own, cancelled along with the call's or as
+        // soon as one batch fails, so that the rest are not waited for
+        auto batch_call = call.Anchored();
+        batch_call.cancel = CancellationToken::Create();
+        const auto linked = call.cancel.Subscribe([cancel = batch_call.cancel] {
+            cancel.Cancel();
+        });
+
+        const auto finish = [&](Result<void> result) -> Result<void> {
+            call.cancel.Unsubscribe(linked);
+            if (!result) {
+                batch_call.cancel.Cancel();
+            }
+            return result;
+        };
+        const auto collect = [&](InFlight& batch) -> Result<void> {
+            return on_batch(batch.offset, batch.count, batch.future.get());
+        };
+
+        std::size_t offset = 0;
+        while (offset < inputs.size()) {
+            // grow the batch until either limit is reached (always at least one input)
+            std::size_t count = 0, bytes = 0;
+            while (offset + count < inputs.size() && count < options.max_batch_inputs) {
+                const auto size = inputs[offset + count].size();
+                if (count > 0 && bytes + size > options.max_batch_bytes) {
+                    break;
+                }
+                bytes += size;
+                ++count;
+            }
+
+            auto request =
+                this->BatchRequest(model_id, inputs.subspan(offset, count), user, encoding);
+            in_flight.push_back(
+                { offset, count, this->ExecuteAsync(std::move(request), batch_call) }
+            );
+            offset += count;
+
+            if (in_flight.size() >= options.max_concurrency) {
+                if (auto collected = collect(in_flight.front()); !collected) {
+                    return finish(std::move(collected));
+                }
+                in_flight.pop_front();
+            }
+        }
+        for (auto& batch : in_flight) {
+            if (auto collected = collect(batch); !collected) {
+                return finish(std::move(collected));
+            }
+        }
+        return finish({});
+    }
+
+    auto Embeddings::Create(
+        const std::string& model_id,
+        std::span<const std::string> inputs,
+        std::optional<std::string> user,
+        EmbeddingBatchOptions options,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        const auto started = std::chrono::steady_clock::now();
+
+        auto data = nlohmann::json::array();
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            data.push_back(nullptr);
+        }
+        std::int64_t prompt_tokens = 0, total_tokens = 0;
+        std::optional<Response> first;
+
+        // merges one batch into 'data', placing each embedding by its index
+        const auto collect =
+            [&](std::size_t offset, std::size_t count, Result<Response>&& res) -> Result<void> {
+            if (!res) {
+                return std::unexpected(res.error());
+            }
+
+            try {
+                auto& json = res->raw_json.get();
+                if (!json.is_object() || !json.contains("data") || !json["data"].is_array()) {
+                    return std::unexpected(
+                        OpenAIError::parse_error("Embedding response contains no 'data' array")
+                    );
+                }
+                auto& items = json["data"];
+                if (items.size() != count) {
+                    return std::unexpected(
+                        OpenAIError::parse_error("Embedding response is missing an input")
+                    );
+                }
+                // with as many items as inputs, distinct indices cover them all
+                std::vector<bool> seen(count, false);
+                for (std::size_t i = 0; i < items.size(); ++i) {
+                    auto& item = items[i];
+                    const auto index = item.value("index", i);
+                    if (index >= count) {
+                        return std::unexpected(
+                            OpenAIError::parse_error("Embedding response index out of range")
+                        );
+                    }
+                    if (seen[index]) {
+                        return std::unexpected(
+                            OpenAIError::parse_error("Embedding response repeats an input")
+                        );
+                    }
+                    seen[index] = true;
+                    item["index"] = offset + index;
+                    data[offset + index] = std::move(item);
+                }
+                if (json.contains("usage")) {
+                    prompt_tokens += json["usage"].value("prompt_tokens", std::int64_t{ 0 });
+                    total_tokens += json["usage"].value("total_tokens", std::int64_t{ 0 });
+                }
+            } catch (const nlohmann::json::exception& e) {
+                return std::unexpected(OpenAIError::parse_error(e.what()));
+            }
+
+            if (!first) {
+                first = std::move(*res);
+            }
+            return {};
+        };
+
+        if (auto sent = this->SendBatches(
+                model_id,
+                inputs,
+                user,
+                options,
+                EmbeddingEncoding::Float,
+                call,
+                collect
+            );
+            !sent) {
+            return std::unexpected(sent.error());
+        }
+
+        Response response = first ? std::move(*first) : Response{};
+        const auto model =
+            response.raw_json->is_object() ? response.raw_json->value("model", model_id) : model_id;
+        nlohmann::json merged = {
+            { "object", "list" },
+            {   "data", std::move(data) },
+            {  "model", model },
+            {  "usage",
+             { { "prompt_tokens", prompt_tokens }, { "total_tokens", total_tokens } } }
+        };
+        response.content = merged.dump();
+        response.raw_json = std::move(merged);
+        response.elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return response;
+    }
+
+    auto Embeddings::CreateMatrix(
+        const std::string& model_id,
+        std::span<const std::string> inputs,
+        std::optional<std::string> user,
+        EmbeddingBatchOptions options,
+        const CallOptions& call
+    ) const& noexcept -> Result<EmbeddingMatrix> {
+        EmbeddingMatrix matrix;
+        matrix.Reserve(inputs.size());
+
+        const auto collect =
+            [&](std::size_t offset, std::size_t count, Result<Response>&& res) -> Result<void> {
+            if (!res) {
+                return std::unexpected(res.error());
+            }
+            return matrix.Merge(res->content, offset, count);
+        };
+
+        if (auto sent = this->SendBatches(
+                model_id,
+                inputs,
+                user,
+                options,
+                EmbeddingEncoding::Base64,
+                call,
+                collect
+            );
+            !sent) {
+            return std::unexpected(sent.error());
+        }
+        if (matrix.rows() != inputs.size() || !matrix.complete()) {
+            return std::unexpected(
+                OpenAIError::parse_error("Embedding response is missing an input")
+            );
+        }
+        return matrix;
+    }
+
+    auto Embeddings::Create(
+        const std::string& model_id,
+        std::optional<std::string> input,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateRequest(model_id, std::move(input), std::move(user)),
+            call
         );
     }
 
     auto Embeddings::CreateAsync(
         const std::string& model_id,
         std::optional<std::string> input,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(std::launch::async, &Embeddings::Create, this, model_id, input, user);
+        return this->ExecuteAsync(
+            this->CreateRequest(model_id, std::move(input), std::move(user)),
+            call
+        );
+    }
+
+    auto Embeddings::CreateCo(
+        const std::string& model_id,
+        std::optional<std::string> input,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateRequest(model_id, std::move(input), std::move(user)),
+            call
+        );
+    }
+
+    EmbeddingCoalescer::EmbeddingCoalescer(
+        const Embeddings& embeddings,
+        std::string model_id,
+        EmbeddingCoalescerOptions options
+    )
+        : m_embeddings(embeddings),
+          m_model_id(std::move(model_id)),
+          m_options(options) {
+        this->m_thread = std::thread(&EmbeddingCoalescer::Run, this);
+    }
+
+    EmbeddingCoalescer::~EmbeddingCoalescer() {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_stopping = true;
+        }
+        this->m_cv.notify_one();
+        if (this->m_thread.joinable()) {
+            this->m_thread.join();
+        }
+    }
+
+    auto EmbeddingCoalescer::Create(std::string input) -> FutureExpected<Response> {
+        std::promise<Result<Response>> promise;
+        auto future = promise.get_future();
+
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            if (this->m_stopping) {
+                return MakeReadyFuture<Response>(
+                    std::unexpected(OpenAIError::rejected("Embedding coalescer is stopping"))
+                );
+            }
+            this->m_pending.push_back({
+                std::move(input),
+                std::move(promise),
+                std::chrono::steady_clock::now()
+            });
+            // the first input starts the wait, a full batch ends it
+            wake = this->m_pending.size() == 1 ||
+                   this->m_pending.size() >= this->m_options.max_batch_inputs;
+        }
+        if (wake) {
+            this->m_cv.notify_one();
+        }
+
+        this->m_inputs.fetch_add(1, std::memory_order_relaxed);
+        return future;
+    }
+
+    auto EmbeddingCoalescer::Stats() const noexcept -> EmbeddingCoalescerStats {
+        return {
+            this->m_inputs.load(std::memory_order_relaxed),
+            this->m_batches.load(std::memory_order_relaxed)
+        };
+    }
+
+    auto EmbeddingCoalescer::Run() -> void {
+        const std::size_t max_inputs =
+            std::clamp<std::size_t>(this->m_options.max_batch_inputs, 1, 2048);
+
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+        while (true) {
+            this->m_cv.wait(lock, [this] { return this->m_stopping || !this->m_pending.empty(); });
+            if (this->m_pending.empty()) {
+                break; // stopping, nothing left to send
+            }
+
+            const auto deadline = this->m_pending.front().since + this->m_options.max_wait;
+            this->m_cv.wait_until(lock, deadline, [this, max_inputs] {
+                return this->m_stopping || this->m_pending.size() >= max_inputs;
+            });
+
+            const std::size_t count = std::min(this->m_pending.size(), max_inputs);
+            std::vector<Pending> batch(
+                std::make_move_iterator(this->m_pending.begin()),
+                std::make_move_iterator(this->m_pending.begin() + count)
+            );
+            this->m_pending.erase(this->m_pending.begin(), this->m_pending.begin() + count);
+
+            lock.unlock();
+            this->Send(std::move(batch));
+            lock.lock();
+        }
+    }
+
+    auto EmbeddingCoalescer::Send(std::vector<Pending> batch) -> void {
+        this->m_batches.fetch_add(1, std::memory_order_relaxed);
+
+        // executor tasks must be copyable, the promises are not
+        auto shared = std::make_shared<std::vector<Pending>>(std::move(batch));
+        const auto fail = [](std::vector<Pending>& pending, const OpenAIError& error) {
+            for (auto& entry : pending) {
+                try {
+                    entry.promise.set_value(std::unexpected(error));
+                } catch (const std::future_error&) {
+                    // already answered
+                }
+            }
+        };
+
+        const Embeddings* embeddings = &this->m_embeddings;
+        auto task = [embeddings, model_id = this->m_model_id, shared, fail] {
+            std::vector<std::string> inputs;
+            inputs.reserve(shared->size());
+            for (auto& entry : *shared) {
+                inputs.push_back(std::move(entry.input));
+            }
+
+            auto res =
+                embeddings->Execute(embeddings->BatchRequest(model_id, inputs, std::nullopt));
+            if (!res) {
+                fail(*shared, res.error());
+                return;
+            }
+
+            try {
+                auto& json = res->raw_json.get();
+                auto& items = json.at("data");
+                std::vector<nlohmann::json*> by_index(shared->size(), nullptr);
+                for (std::size_t i = 0; i < items.size(); ++i) {
+                    const auto index = items[i].value("index", i);
+                    if (index < by_index.size()) {
+                        by_index[index] = &items[i];
+                    }
+                }
+
+                for (std::size_t i = 0; i < shared->size(); ++i) {
+                    if (!by_index[i]) {
+                        (*shared)[i].promise.set_value(std::unexpected(
+                            OpenAIError::parse_error("Embedding response is missing an input")
+                        ));
+                        continue;
+                    }
+
+                    auto item = std::move(*by_index[i]);
+                    item["index"] = 0;
+                    nlohmann::json single = {
+                        { "object", "list" },
+                        {   "data", nlohmann::json::array({ std::move(item) }) },
+                        {  "model", json.value("model", model_id) }
+                    };
+
+                    Response response;
+                    response.status_code = res->status_code;
+                    response.elapsed = res->elapsed;
+                    response.status_line = res->status_line;
+                    response.url = res->url;
+                    response.reason = res->reason;
+                    response.content = single.dump();
+                    response.raw_json = std::move(single);
+                    (*shared)[i].promise.set_value(std::move(response));
+                }
+            } catch (const nlohmann::json::exception& e) {
+                fail(*shared, OpenAIError::parse_error(e.what()));
+            }
+        };
+
+        if (!embeddings->Post(std::move(task))) {
+            fail(*shared, OpenAIError::rejected("Executor queue is full"));
+        }
     }
 
 } // namespace liboai
@@ -19,14 +19,24 @@ export module liboai:components.files;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.observer;
+import :core.request;
 import :core.response;
 import :core.network;
+import :core.transfer;
 
 export namespace liboai {
     class Files final : private Network {
     public:
-        explicit Files(const std::string& root) : Network(root) {}
+        explicit Files(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Files(const Files&) = delete;
         Files& operator=(const Files&) = delete;
@@ -41,7 +51,7 @@ export namespace liboai {
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto List() const& noexcept -> Result<Response>;
+        auto List(const CallOptions& call = {}) const& noexcept -> Result<Response>;
 
         /**
          * @brief Asynchronously returns a list of files that belong to the
@@ -51,7 +61,16 @@ export namespace liboai {
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto ListAsync() const& noexcept -> FutureExpected<Response>;
+        auto ListAsync(const CallOptions& call = {}) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of List(); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto ListCo(const CallOptions& call = {}) const& noexcept -> ResponseAwaitable;
 
         /**
          * @brief Upload a file that contains document(s) to be
@@ -59,8 +78,17 @@ export namespace liboai {
          *        the size of all the files uploaded by one organization
          *        can be up to 1 GB.
          *
+         * The file is streamed from disk in chunks of options.chunk_size
+         * bytes while the request is sent, so memory use does not grow
+         * with its size. options.on_progress is told how much
+         * of the request has been sent and how fast, and may cancel the
+         * upload by returning false, in which case the call fails with
+         * ErrorCode::CURLError. Uploads are not retried.
+         *
          * @param file     The JSON Lines file to be uploaded (path).
          * @param purpose  The intended purpose of the uploaded documents.
+         * @param options  Chunk size and progress callback of the upload.
+         * @param call     Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
@@ -68,7 +96,9 @@ export namespace liboai {
         [[nodiscard]]
         auto Create(
             const std::filesystem::path& file,
-            const std::string& purpose
+            const std::string& purpose,
+            const UploadOptions& options = {},
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -79,6 +109,8 @@ export namespace liboai {
          *
          * @param file     The JSON Lines file to be uploaded (path).
          * @param purpose  The intended purpose of the uploaded documents.
+         * @param options  Chunk size and progress callback of the upload.
+         * @param call     Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
@@ -86,65 +118,121 @@ export namespace liboai {
         [[nodiscard]]
         auto CreateAsync(
             const std::filesystem::path& file,
-            const std::string& purpose
+            const std::string& purpose,
+            const UploadOptions& options = {},
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::filesystem::path& file,
+            const std::string& purpose,
+            const UploadOptions& options = {},
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Delete [remove] a file.
          *
          * @param *file_id   The ID of the file to use for this request
+         * @param call       Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto Remove(const std::string& file_id) const& noexcept -> Result<Response>;
+        auto Remove(
+            const std::string& file_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
 
         /**
          * @brief Asynchronously delete [remove] a file.
          *
          * @param *file_id   The ID of the file to use for this request
+         * @param call       Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
          */
         [[nodiscard]]
         auto RemoveAsync(
-            const std::string& file_id
+            const std::string& file_id,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Remove(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto RemoveCo(
+            const std::string& file_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Returns information about a specific file.
          *
          * @param *file_id   The ID of the file to use for this request
+         * @param call       Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
          */
         [[nodiscard]]
         auto Retrieve(
-            const std::string& file_id
+            const std::string& file_id,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
          * @brief Asynchronously returns information about a specific file.
          *
          * @param *file_id   The ID of the file to use for this request
+         * @param call       Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
          */
         [[nodiscard]]
         auto RetrieveAsync(
-            const std::string& file_id
+            const std::string& file_id,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Retrieve(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto RetrieveCo(
+            const std::string& file_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Downloads the contents of the specified file
          *        to the specified path.
          *
+         * The download is buffered, resumed with a Range request if the
+         * connection drops, and split into options.segments parallel
+         * requests when the server allows it.
+         *
          * @param *file_id    The ID of the file to use for this request
          * @param *save_to    The path to save the file to
+         * @param options     Buffering, segmenting and progress of the download.
+         * @param call        Cancellation token and deadline of the call.
          *
          * @return a boolean value indicating whether the file was
          *         successfully downloaded or not.
@@ -152,7 +240,9 @@ export namespace liboai {
         [[nodiscard]]
         auto Download(
             const std::string& file_id,
-            const std::string& save_to
+            const std::string& save_to,
+            const DownloadOptions& options = {},
+            const CallOptions& call = {}
         ) const& noexcept -> Result<bool>;
 
         /**
@@ -161,6 +251,8 @@ export namespace liboai {
          *
          * @param *file_id    The ID of the file to use for this request
          * @param *save_to    The path to save the file to
+         * @param options     Buffering, segmenting and progress of the download.
+         * @param call        Cancellation token and deadline of the call.
          *
          * @return a boolean future indicating whether the file was
          *         successfully downloaded or not.
@@ -168,36 +260,99 @@ export namespace liboai {
         [[nodiscard]]
         auto DownloadAsync(
             const std::string& file_id,
-            const std::string& save_to
+            const std::string& save_to,
+            DownloadOptions options = {},
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<bool>;
 
+        /**
+         * @brief Downloads the contents of the specified file into memory.
+         *
+         * @param *file_id    The ID of the file to use for this request
+         * @param options     Buffering, segmenting and progress of the download.
+         * @param call        Cancellation token and deadline of the call.
+         *
+         * @return The contents of the file.
+         */
+        [[nodiscard]]
+        auto DownloadToMemory(
+            const std::string& file_id,
+            const DownloadOptions& options = {},
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<std::string>;
+
+        /**
+         * @brief Asynchronously downloads the contents of the specified
+         *        file into memory.
+         *
+         * @param *file_id    The ID of the file to use for this request
+         * @param options     Buffering, segmenting and progress of the download.
+         * @param call        Cancellation token and deadline of the call.
+         *
+         * @return A future containing the contents of the file.
+         */
+        [[nodiscard]]
+        auto DownloadToMemoryAsync(
+            const std::string& file_id,
+            DownloadOptions options = {},
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<std::string>;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto ListRequest() const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateRequest(
+            const std::filesystem::path& file,
+            const std::string& purpose,
+            const UploadOptions& options
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto RemoveRequest(const std::string& file_id) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto RetrieveRequest(const std::string& file_id) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto ContentUrl(const std::string& file_id) const -> std::string;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto Files::List() const& noexcept -> Result<Response> {
-        return this->Request(
+    auto Files::ListRequest() const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/files",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto Files::ListAsync() const& noexcept -> FutureExpected<Response> {
-        return std::async(std::launch::async, &Files::List, this);
+    auto Files::List(const CallOptions& call) const& noexcept -> Result<Response> {
+        return this->Execute(this->ListRequest(), call);
     }
 
-    auto
-    Files::Create(
+    auto Files::ListAsync(const CallOptions& call) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->ListRequest(), call);
+    }
+
+    auto Files::ListCo(const CallOptions& call) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->ListRequest(), call);
+    }
+
+    auto Files::CreateRequest(
         const std::filesystem::path& file,
-        const std::string& purpose
-    ) const& noexcept -> Result<Response> {
+        const std::string& purpose,
+        const UploadOptions& options
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         if (!this->Validate(file)) {
             return std::unexpected(
                 OpenAIError::file_error(
@@ -206,87 +361,198 @@ export namespace liboai {
             );
         }
 
-        cpr::Multipart form = {
-            { "purpose",                            purpose },
-            {    "file", cpr::File{ file.generic_string() } }
-        };
+        auto upload = MultipartUpload::Open(file, "file", { { "purpose", purpose } }, options);
+        if (!upload) {
+            return std::unexpected(upload.error());
+        }
+
+        // the prebuilt multipart headers lack the boundary of this body
+        auto headers = std::make_shared<cpr::Header>(credentials->openai_headers);
+        (*headers)["Content-Type"] = (*upload)->ContentType();
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/files",
-            "multipart/form-data",
-            this->m_auth.GetAuthorizationHeaders(),
-            std::move(form),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            std::move(headers),
+            (*upload)->ReadCallback(),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
+    auto
+    Files::Create(
+        const std::filesystem::path& file,
+        const std::string& purpose,
+        const UploadOptions& options,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->CreateRequest(file, purpose, options), call);
+    }
+
     auto Files::CreateAsync(
         const std::filesystem::path& file,
-        const std::string& purpose
+        const std::string& purpose,
+        const UploadOptions& options,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(std::launch::async, &Files::Create, this, file, purpose);
+        return this->ExecuteAsync(this->CreateRequest(file, purpose, options), call);
     }
 
-    auto Files::Remove(
-        const std::string& file_id
-    ) const& noexcept -> Result<Response> {
-        return this->Request(
+    auto Files::CreateCo(
+        const std::filesystem::path& file,
+        const std::string& purpose,
+        const UploadOptions& options,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->CreateRequest(file, purpose, options), call);
+    }
+
+    auto Files::RemoveRequest(const std::string& file_id) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_DELETE,
             this->GetOpenAIRoot(),
             "/files/" + file_id,
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/files/{id}" },
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto Files::RemoveAsync(const std::string& file_id) const& noexcept
+    auto Files::Remove(
+        const std::string& file_id,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->RemoveRequest(file_id), call);
+    }
+
+    auto Files::RemoveAsync(const std::string& file_id, const CallOptions& call) const& noexcept
         -> FutureExpected<Response> {
-        return std::async(std::launch::async, &Files::Remove, this, file_id);
+        return this->ExecuteAsync(this->RemoveRequest(file_id), call);
     }
 
-    auto Files::Retrieve(
-        const std::string& file_id
-    ) const& noexcept -> Result<Response> {
-        return this->Request(
+    auto Files::RemoveCo(
+        const std::string& file_id,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->RemoveRequest(file_id), call);
+    }
+
+    auto Files::RetrieveRequest(const std::string& file_id) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/files/" + file_id,
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/files/{id}" },
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto Files::RetrieveAsync(const std::string& file_id) const& noexcept
+    auto Files::Retrieve(
+        const std::string& file_id,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->RetrieveRequest(file_id), call);
+    }
+
+    auto Files::RetrieveAsync(const std::string& file_id, const CallOptions& call) const& noexcept
         -> FutureExpected<Response> {
-        return std::async(std::launch::async, &Files::Retrieve, this, file_id);
+        return this->ExecuteAsync(this->RetrieveRequest(file_id), call);
+    }
+
+    auto Files::RetrieveCo(
+        const std::string& file_id,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->RetrieveRequest(file_id), call);
+    }
+
+    auto Files::ContentUrl(const std::string& file_id) const -> std::string {
+        return this->GetOpenAIRoot() + "/files/" + file_id + "/content";
     }
 
     auto Files::Download(
         const std::string& file_id,
-        const std::string& save_to
+        const std::string& save_to,
+        const DownloadOptions& options,
+        const CallOptions& call
     ) const& noexcept -> Result<bool> {
-        return Network::Download(
-            save_to,
-            ("https://api.openai.com/v1/files/" + file_id + "/content"),
-            this->m_auth.GetAuthorizationHeaders()
-        );
+        const auto credentials = this->m_auth.GetCredentials();
+        try {
+            auto stats = Downloader::ToFile(
+                save_to,
+                this->ContentUrl(file_id),
+                credentials->openai_headers,
+                options,
+                credentials->proxies,
+                credentials->proxy_auth,
+                RequestControl::From(call)
+            );
+            if (!stats) {
+                return std::unexpected(stats.error());
+            }
+            return true;
+        } catch (const std::exception& e) {
+            return std::unexpected(OpenAIError::file_error(e.what()));
+        }
     }
 
     auto Files::DownloadAsync(
         const std::string& file_id,
-        const std::string& save_to
+        const std::string& save_to,
+        DownloadOptions options,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<bool> {
-        return std::async(std::launch::async, &Files::Download, this, file_id, save_to);
+        return this->Async(
+            [this, file_id, save_to, options = std::move(options), call = call.Anchored()]() {
+                return this->Download(file_id, save_to, options, call);
+            }
+        );
+    }
+
+    auto Files::DownloadToMemory(
+        const std::string& file_id,
+        const DownloadOptions& options,
+        const CallOptions& call
+    ) const& noexcept -> Result<std::string> {
+        const auto credentials = this->m_auth.GetCredentials();
+        try {
+            std::string content;
+            auto stats = Downloader::ToMemory(
+                content,
+                this->ContentUrl(file_id),
+                credentials->openai_headers,
+                options,
+                credentials->proxies,
+                credentials->proxy_auth,
+                RequestControl::From(call)
+            );
+            if (!stats) {
+                return std::unexpected(stats.error());
+            }
+            return content;
+        } catch (const std::exception& e) {
+            return std::unexpected(OpenAIError::file_error(e.what()));
+        }
+    }
+
+    auto Files::DownloadToMemoryAsync(
+        const std::string& file_id,
+        DownloadOptions options,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<std::string> {
+        return this->Async([this, file_id, options = std::move(options), call = call.Anchored()]() {
+            return this->DownloadToMemory(file_id, options, call);
+        });
     }
 
 } // namespace liboai
@@ -17,14 +17,23 @@ export module liboai:components.fine_tunes;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.observer;
+import :core.request;
 import :core.response;
 import :core.network;
 
 export namespace liboai {
     class FineTunes final : private Network {
     public:
-        explicit FineTunes(const std::string& root) : Network(root) {}
+        explicit FineTunes(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         FineTunes(const FineTunes&) = delete;
         FineTunes& operator=(const FineTunes&) = delete;
@@ -60,6 +69,7 @@ export namespace liboai {
          * @param classification_betas If this is provided, we calculate F-beta
          *                             scores at the specified beta values.
          * @param suffix A suffix to append to the model name.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in
          *         JSON format.
@@ -77,7 +87,8 @@ export namespace liboai {
             std::optional<uint16_t> classification_n_classes = std::nullopt,
             std::optional<std::string> classification_positive_class = std::nullopt,
             std::optional<std::vector<float>> classification_betas = std::nullopt,
-            std::optional<std::string> suffix = std::nullopt
+            std::optional<std::string> suffix = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -106,6 +117,7 @@ export namespace liboai {
          * @param classification_betas If this is provided, we calculate F-beta
          *                             scores at the specified beta values.
          * @param suffix A suffix to append to the model name.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
@@ -123,9 +135,33 @@ export namespace liboai {
             std::optional<uint16_t> classification_n_classes = std::nullopt,
             std::optional<std::string> classification_positive_class = std::nullopt,
             std::optional<std::vector<float>> classification_betas = std::nullopt,
-            std::optional<std::string> suffix = std::nullopt
+            std::optional<std::string> suffix = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& training_file,
+            std::optional<std::string> validation_file = std::nullopt,
+            std::optional<std::string> model_id = std::nullopt,
+            std::optional<uint8_t> n_epochs = std::nullopt,
+            std::optional<uint16_t> batch_size = std::nullopt,
+            std::optional<float> learning_rate_multiplier = std::nullopt,
+            std::optional<float> prompt_loss_weight = std::nullopt,
+            std::optional<bool> compute_classification_metrics = std::nullopt,
+            std::optional<uint16_t> classification_n_classes = std::nullopt,
+            std::optional<std::string> classification_positive_class = std::nullopt,
+            std::optional<std::vector<float>> classification_betas = std::nullopt,
+            std::optional<std::string> suffix = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief List your organization's fine-tuning jobs.
          *
@@ -133,7 +169,7 @@ export namespace liboai {
          *         JSON format.
          */
         [[nodiscard]]
-        auto List() const& noexcept -> Result<Response>;
+        auto List(const CallOptions& call = {}) const& noexcept -> Result<Response>;
 
         /**
          * @brief Asynchronously list your organization's fine-tuning jobs.
@@ -142,55 +178,96 @@ export namespace liboai {
          *         JSON format.
          */
         [[nodiscard]]
-        auto ListAsync() const& noexcept -> FutureExpected<Response>;
+        auto ListAsync(const CallOptions& call = {}) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of List(); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto ListCo(const CallOptions& call = {}) const& noexcept -> ResponseAwaitable;
 
         /**
          * @brief Returns information about a specific file.
          *
          * @param *fine_tune_id The ID of the fine-tune job.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in
          *         JSON format.
          */
         [[nodiscard]]
-        auto Retrieve(const std::string& fine_tune_id) const& noexcept
+        auto Retrieve(const std::string& fine_tune_id, const CallOptions& call = {}) const& noexcept
             -> Result<Response>;
 
         /**
          * @brief Asynchronously returns information about a specific file.
          *
          * @param *fine_tune_id The ID of the fine-tune job.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
          */
         [[nodiscard]]
-        auto RetrieveAsync(const std::string& fine_tune_id) const& noexcept
-            -> FutureExpected<Response>;
+        auto RetrieveAsync(
+            const std::string& fine_tune_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of Retrieve(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto RetrieveCo(
+            const std::string& fine_tune_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
 
         /**
          * @brief Immediately cancel a fine-tune job.
          *
          * @param *fine_tune_id The ID of the fine-tune job to cancel.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in
          *         JSON format.
          */
         [[nodiscard]]
-        auto Cancel(const std::string& fine_tune_id) const& noexcept
+        auto Cancel(const std::string& fine_tune_id, const CallOptions& call = {}) const& noexcept
             -> Result<Response>;
 
         /**
          * @brief Immediately cancel a fine-tune job asynchronously.
          *
          * @param *fine_tune_id The ID of the fine-tune job to cancel.
+         * @param call          Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
          */
         [[nodiscard]]
-        auto CancelAsync(const std::string& fine_tune_id) const& noexcept
-            -> FutureExpected<Response>;
+        auto CancelAsync(
+            const std::string& fine_tune_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of Cancel(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CancelCo(
+            const std::string& fine_tune_id,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
 
         /**
          * @brief Get fine-grained status updates for a fine-tune job.
@@ -200,6 +277,7 @@ export namespace liboai {
          *               callback is supplied, this parameter is disabled and the
          *               API will wait until the completion is finished before
          *               returning the response.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
@@ -207,7 +285,8 @@ export namespace liboai {
         [[nodiscard]]
         auto ListEvents(
             const std::string& fine_tune_id,
-            std::optional<StreamCallback> stream = std::nullopt
+            std::optional<StreamCallback> stream = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -219,6 +298,7 @@ export namespace liboai {
          *               callback is supplied, this parameter is disabled and the
          *               API will wait until the completion is finished before
          *               returning the response.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
@@ -226,40 +306,105 @@ export namespace liboai {
         [[nodiscard]]
         auto ListEventsAsync(
             const std::string& fine_tune_id,
-            std::optional<StreamCallback> stream = std::nullopt
+            std::optional<StreamCallback> stream = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of ListEvents(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto ListEventsCo(
+            const std::string& fine_tune_id,
+            std::optional<StreamCallback> stream = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Delete a fine-tuned model. You must have the Owner role in
          *        your organization.
          *
          * @param *model The model to delete.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
          */
         [[nodiscard]]
-        auto Remove(const std::string& model) const& noexcept -> Result<Response>;
+        auto Remove(
+            const std::string& model,
+            const CallOptions& call = {}
+        ) const& noexcept -> Result<Response>;
 
         /**
          * @brief Asynchronously deletes a fine-tuned model. You must have the
          *        Owner role in your organization.
          *
          * @param *model The model to delete.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in
          *         JSON format.
          */
         [[nodiscard]]
-        auto RemoveAsync(const std::string& model) const& noexcept
+        auto RemoveAsync(const std::string& model, const CallOptions& call = {}) const& noexcept
             -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Remove(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto RemoveCo(
+            const std::string& model,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto CreateRequest(
+            const std::string& training_file,
+            std::optional<std::string> validation_file,
+            std::optional<std::string> model_id,
+            std::optional<uint8_t> n_epochs,
+            std::optional<uint16_t> batch_size,
+            std::optional<float> learning_rate_multiplier,
+            std::optional<float> prompt_loss_weight,
+            std::optional<bool> compute_classification_metrics,
+            std::optional<uint16_t> classification_n_classes,
+            std::optional<std::string> classification_positive_class,
+            std::optional<std::vector<float>> classification_betas,
+            std::optional<std::string> suffix
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto ListRequest() const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto RetrieveRequest(const std::string& fine_tune_id) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CancelRequest(const std::string& fine_tune_id) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto ListEventsRequest(
+            const std::string& fine_tune_id,
+            std::optional<StreamCallback> stream
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto RemoveRequest(const std::string& model) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto FineTunes::Create(
+    auto FineTunes::CreateRequest(
         const std::string& training_file,
         std::optional<std::string> validation_file,
         std::optional<std::string> model_id,
@@ -272,7 +417,8 @@ export namespace liboai {
         std::optional<std::string> classification_positive_class,
         std::optional<std::vector<float>> classification_betas,
         std::optional<std::string> suffix
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("training_file", training_file);
         jcon.push_back("validation_file", std::move(validation_file));
@@ -287,16 +433,49 @@ export namespace liboai {
         jcon.push_back("classification_betas", std::move(classification_betas));
         jcon.push_back("suffix", std::move(suffix));
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/fine-tunes",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto FineTunes::Create(
+        const std::string& training_file,
+        std::optional<std::string> validation_file,
+        std::optional<std::string> model_id,
+        std::optional<uint8_t> n_epochs,
+        std::optional<uint16_t> batch_size,
+        std::optional<float> learning_rate_multiplier,
+        std::optional<float> prompt_loss_weight,
+        std::optional<bool> compute_classification_metrics,
+        std::optional<uint16_t> classification_n_classes,
+        std::optional<std::string> classification_positive_class,
+        std::optional<std::vector<float>> classification_betas,
+        std::optional<std::string> suffix,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateRequest(
+                training_file,
+                std::move(validation_file),
+                std::move(model_id),
+                n_epochs,
+                batch_size,
+                learning_rate_multiplier,
+                prompt_loss_weight,
+                compute_classification_metrics,
+                classification_n_classes,
+                std::move(classification_positive_class),
+                std::move(classification_betas),
+                std::move(suffix)
+            ),
+            call
         );
     }
 
@@ -312,135 +491,242 @@ export namespace liboai {
         std::optional<uint16_t> classification_n_classes,
         std::optional<std::string> classification_positive_class,
         std::optional<std::vector<float>> classification_betas,
-        std::optional<std::string> suffix
+        std::optional<std::string> suffix,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &liboai::FineTunes::Create,
-            this,
-            training_file,
-            validation_file,
-            model_id,
-            n_epochs,
-            batch_size,
-            learning_rate_multiplier,
-            prompt_loss_weight,
-            compute_classification_metrics,
-            classification_n_classes,
-            classification_positive_class,
-            classification_betas,
-            suffix
+        return this->ExecuteAsync(
+            this->CreateRequest(
+                training_file,
+                std::move(validation_file),
+                std::move(model_id),
+                n_epochs,
+                batch_size,
+                learning_rate_multiplier,
+                prompt_loss_weight,
+                compute_classification_metrics,
+                classification_n_classes,
+                std::move(classification_positive_class),
+                std::move(classification_betas),
+                std::move(suffix)
+            ),
+            call
         );
     }
 
-    auto FineTunes::List() const& noexcept -> Result<Response> {
-        return this->Request(
+    auto FineTunes::CreateCo(
+        const std::string& training_file,
+        std::optional<std::string> validation_file,
+        std::optional<std::string> model_id,
+        std::optional<uint8_t> n_epochs,
+        std::optional<uint16_t> batch_size,
+        std::optional<float> learning_rate_multiplier,
+        std::optional<float> prompt_loss_weight,
+        std::optional<bool> compute_classification_metrics,
+        std::optional<uint16_t> classification_n_classes,
+        std::optional<std::string> classification_positive_class,
+        std::optional<std::vector<float>> classification_betas,
+        std::optional<std::string> suffix,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateRequest(
+                training_file,
+                std::move(validation_file),
+                std::move(model_id),
+                n_epochs,
+                batch_size,
+                learning_rate_multiplier,
+                prompt_loss_weight,
+                compute_classification_metrics,
+                classification_n_classes,
+                std::move(classification_positive_class),
+                std::move(classification_betas),
+                std::move(suffix)
+            ),
+            call
+        );
+    }
+
+    auto FineTunes::ListRequest() const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/fine-tunes",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto FineTunes::ListAsync() const& noexcept -> FutureExpected<Response> {
-        return std::async(std::launch::async, &liboai::FineTunes::List, this);
+    auto FineTunes::List(const CallOptions& call) const& noexcept -> Result<Response> {
+        return this->Execute(this->ListRequest(), call);
+    }
+
+    auto FineTunes::ListAsync(const CallOptions& call) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->ListRequest(), call);
+    }
+
+    auto FineTunes::ListCo(const CallOptions& call) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->ListRequest(), call);
     }
 
-    auto FineTunes::Retrieve(const std::string& fine_tune_id) const& noexcept
-        -> Result<Response> {
-        return this->Request(
+    auto FineTunes::RetrieveRequest(
+        const std::string& fine_tune_id
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/fine-tunes/" + fine_tune_id,
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/fine-tunes/{id}" },
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto FineTunes::RetrieveAsync(const std::string& fine_tune_id) const& noexcept
-        -> FutureExpected<Response> {
-        return std::async(std::launch::async, &liboai::FineTunes::Retrieve, this, fine_tune_id);
+    auto FineTunes::Retrieve(
+        const std::string& fine_tune_id,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->RetrieveRequest(fine_tune_id), call);
     }
 
-    auto FineTunes::Cancel(const std::string& fine_tune_id) const& noexcept -> Result<Response> {
-        return this->Request(
+    auto FineTunes::RetrieveAsync(
+        const std::string& fine_tune_id,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->RetrieveRequest(fine_tune_id), call);
+    }
+
+    auto FineTunes::RetrieveCo(
+        const std::string& fine_tune_id,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->RetrieveRequest(fine_tune_id), call);
+    }
+
+    auto FineTunes::CancelRequest(
+        const std::string& fine_tune_id
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/fine-tunes/" + fine_tune_id + "/cancel",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/fine-tunes/{id}/cancel" },
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto FineTunes::CancelAsync(const std::string& fine_tune_id) const& noexcept
-        -> FutureExpected<Response> {
-        return std::async(std::launch::async, &liboai::FineTunes::Cancel, this, fine_tune_id);
+    auto FineTunes::Cancel(
+        const std::string& fine_tune_id,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->CancelRequest(fine_tune_id), call);
     }
 
-    auto FineTunes::ListEvents(
+    auto FineTunes::CancelAsync(
+        const std::string& fine_tune_id,
+        const CallOptions& call
+    ) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->CancelRequest(fine_tune_id), call);
+    }
+
+    auto FineTunes::CancelCo(
+        const std::string& fine_tune_id,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->CancelRequest(fine_tune_id), call);
+    }
+
+    auto FineTunes::ListEventsRequest(
         const std::string& fine_tune_id,
         std::optional<StreamCallback> stream
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         cpr::Parameters params;
         stream ? params.Add({ "stream", "true" }) : void();
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/fine-tunes/" + fine_tune_id + "/events",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/fine-tunes/{id}/events" },
             std::move(params),
             stream ? cpr::WriteCallback{ [cb = std::move(stream.value())](
                                              std::string_view data,
                                              intptr_t userdata
                                          ) -> bool { return cb(std::string(data), userdata); } } :
                      cpr::WriteCallback{},
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
+    auto FineTunes::ListEvents(
+        const std::string& fine_tune_id,
+        std::optional<StreamCallback> stream,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->ListEventsRequest(fine_tune_id, std::move(stream)), call);
+    }
+
     auto FineTunes::ListEventsAsync(
         const std::string& fine_tune_id,
-        std::optional<StreamCallback> stream
+        std::optional<StreamCallback> stream,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &liboai::FineTunes::ListEvents,
-            this,
-            fine_tune_id,
-            stream
-        );
+        return this->ExecuteAsync(this->ListEventsRequest(fine_tune_id, std::move(stream)), call);
     }
 
-    auto FineTunes::Remove(const std::string& model) const& noexcept -> Result<Response> {
-        return this->Request(
+    auto FineTunes::ListEventsCo(
+        const std::string& fine_tune_id,
+        std::optional<StreamCallback> stream,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->ListEventsRequest(fine_tune_id, std::move(stream)), call);
+    }
+
+    auto FineTunes::RemoveRequest(const std::string& model) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_DELETE,
             this->GetOpenAIRoot(),
             "/models/" + model,
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/models/{model}" },
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto FineTunes::RemoveAsync(const std::string& model) const& noexcept
+    auto FineTunes::Remove(
+        const std::string& model,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->RemoveRequest(model), call);
+    }
+
+    auto FineTunes::RemoveAsync(const std::string& model, const CallOptions& call) const& noexcept
         -> FutureExpected<Response> {
-        return std::async(std::launch::async, &liboai::FineTunes::Remove, this, model);
+        return this->ExecuteAsync(this->RemoveRequest(model), call);
+    }
+
+    auto FineTunes::RemoveCo(
+        const std::string& model,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->RemoveRequest(model), call);
     }
 
 } // namespace liboai
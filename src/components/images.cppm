@@ -17,14 +17,22 @@ export module liboai:components.images;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.request;
 import :core.response;
 import :core.network;
 
 export namespace liboai {
     class Images final : private Network {
     public:
-        explicit Images(const std::string& root) : Network(root) {}
+        explicit Images(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Images(const Images&) = delete;
         Images& operator=(const Images&) = delete;
@@ -40,6 +48,7 @@ export namespace liboai {
          * @param size             The size of the image to create.
          * @param response_format  The format of the response.
          * @param user             A unique identifier representing an end-user.
+         * @param call             Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -49,7 +58,8 @@ export namespace liboai {
             std::optional<uint8_t> n = std::nullopt,
             std::optional<std::string> size = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -60,6 +70,7 @@ export namespace liboai {
          * @param size             The size of the image to create.
          * @param response_format  The format of the response.
          * @param user             A unique identifier representing an end-user.
+         * @param call             Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in JSON format.
          */
@@ -69,9 +80,26 @@ export namespace liboai {
             std::optional<uint8_t> n = std::nullopt,
             std::optional<std::string> size = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& prompt,
+            std::optional<uint8_t> n = std::nullopt,
+            std::optional<std::string> size = std::nullopt,
+            std::optional<std::string> response_format = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Images component method to produce an edited image from a provided
          *        base image and mask image according to given text.
@@ -83,6 +111,7 @@ export namespace liboai {
          * @param size             The size of the image to create.
          * @param response_format  The format of the response.
          * @param user             A unique identifier representing an end-user.
+         * @param call             Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -94,7 +123,8 @@ export namespace liboai {
             std::optional<uint8_t> n = std::nullopt,
             std::optional<std::string> size = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -108,6 +138,7 @@ export namespace liboai {
          * @param size             The size of the image to create.
          * @param response_format  The format of the response.
          * @param user             A unique identifier representing an end-user.
+         * @param call             Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in JSON format.
          */
@@ -119,9 +150,28 @@ export namespace liboai {
             std::optional<uint8_t> n = std::nullopt,
             std::optional<std::string> size = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of CreateEdit(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateEditCo(
+            const std::filesystem::path& image,
+            const std::string& prompt,
+            std::optional<std::filesystem::path> mask = std::nullopt,
+            std::optional<uint8_t> n = std::nullopt,
+            std::optional<std::string> size = std::nullopt,
+            std::optional<std::string> response_format = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
         /**
          * @brief Images component method to produce a variation of a supplied image.
          *
@@ -130,6 +180,7 @@ export namespace liboai {
          * @param size             The size of the image to create.
          * @param response_format  The format of the response.
          * @param user             A unique identifier representing an end-user.
+         * @param call             Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s) data in JSON format.
          */
@@ -139,7 +190,8 @@ export namespace liboai {
             std::optional<uint8_t> n = std::nullopt,
             std::optional<std::string> size = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -151,6 +203,7 @@ export namespace liboai {
          * @param size             The size of the image to create.
          * @param response_format  The format of the response.
          * @param user             A unique identifier representing an end-user.
+         * @param call             Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s) data in JSON format.
          */
@@ -160,21 +213,68 @@ export namespace liboai {
             std::optional<uint8_t> n = std::nullopt,
             std::optional<std::string> size = std::nullopt,
             std::optional<std::string> response_format = std::nullopt,
-            std::optional<std::string> user = std::nullopt
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of CreateVariation(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateVariationCo(
+            const std::filesystem::path& image,
+            std::optional<uint8_t> n = std::nullopt,
+            std::optional<std::string> size = std::nullopt,
+            std::optional<std::string> response_format = std::nullopt,
+            std::optional<std::string> user = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto CreateRequest(
+            const std::string& prompt,
+            std::optional<uint8_t> n,
+            std::optional<std::string> size,
+            std::optional<std::string> response_format,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateEditRequest(
+            const std::filesystem::path& image,
+            const std::string& prompt,
+            std::optional<std::filesystem::path> mask,
+            std::optional<uint8_t> n,
+            std::optional<std::string> size,
+            std::optional<std::string> response_format,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto CreateVariationRequest(
+            const std::filesystem::path& image,
+            std::optional<uint8_t> n,
+            std::optional<std::string> size,
+            std::optional<std::string> response_format,
+            std::optional<std::string> user
+        ) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto Images::Create(
+    auto Images::CreateRequest(
         const std::string& prompt,
         std::optional<uint8_t> n,
         std::optional<std::string> size,
         std::optional<std::string> response_format,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("prompt", prompt);
         jcon.push_back("n", std::move(n));
@@ -182,16 +282,35 @@ export namespace liboai {
         jcon.push_back("response_format", std::move(response_format));
         jcon.push_back("user", std::move(user));
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/images/generations",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Images::Create(
+        const std::string& prompt,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        std::optional<std::string> response_format,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateRequest(
+                prompt,
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
         );
     }
 
@@ -200,21 +319,42 @@ export namespace liboai {
         std::optional<uint8_t> n,
         std::optional<std::string> size,
         std::optional<std::string> response_format,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Images::Create,
-            this,
-            prompt,
-            n,
-            size,
-            response_format,
-            user
+        return this->ExecuteAsync(
+            this->CreateRequest(
+                prompt,
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
         );
     }
 
-    auto Images::CreateEdit(
+    auto Images::CreateCo(
+        const std::string& prompt,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        std::optional<std::string> response_format,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateRequest(
+                prompt,
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
+        );
+    }
+
+    auto Images::CreateEditRequest(
         const std::filesystem::path& image,
         const std::string& prompt,
         std::optional<std::filesystem::path> mask,
@@ -222,7 +362,8 @@ export namespace liboai {
         std::optional<std::string> size,
         std::optional<std::string> response_format,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         if (!this->Validate(image)) {
             return std::unexpected(
                 OpenAIError::file_error(
@@ -259,16 +400,39 @@ export namespace liboai {
             form.parts.emplace_back("user", user.value());
         }
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/images/edits",
-            "multipart/form-data",
-            this->m_auth.GetAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::OpenAIMultipart),
             std::move(form),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Images::CreateEdit(
+        const std::filesystem::path& image,
+        const std::string& prompt,
+        std::optional<std::filesystem::path> mask,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        std::optional<std::string> response_format,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateEditRequest(
+                image,
+                prompt,
+                std::move(mask),
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
         );
     }
 
@@ -279,29 +443,55 @@ export namespace liboai {
         std::optional<uint8_t> n,
         std::optional<std::string> size,
         std::optional<std::string> response_format,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Images::CreateEdit,
-            this,
-            image,
-            prompt,
-            mask,
-            n,
-            size,
-            response_format,
-            user
+        return this->ExecuteAsync(
+            this->CreateEditRequest(
+                image,
+                prompt,
+                std::move(mask),
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
         );
     }
 
-    auto Images::CreateVariation(
+    auto Images::CreateEditCo(
+        const std::filesystem::path& image,
+        const std::string& prompt,
+        std::optional<std::filesystem::path> mask,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        std::optional<std::string> response_format,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateEditRequest(
+                image,
+                prompt,
+                std::move(mask),
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
+        );
+    }
+
+    auto Images::CreateVariationRequest(
         const std::filesystem::path& image,
         std::optional<uint8_t> n,
         std::optional<std::string> size,
         std::optional<std::string> response_format,
         std::optional<std::string> user
-    ) const& noexcept -> Result<Response> {
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         if (!this->Validate(image)) {
             return std::unexpected(
                 OpenAIError::file_error(
@@ -327,16 +517,35 @@ export namespace liboai {
             form.parts.emplace_back("user", user.value());
         }
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/images/variations",
-            "multipart/form-data",
-            this->m_auth.GetAuthorizationHeaders(),
+            RequestHeaders(credentials, HeaderSet::OpenAIMultipart),
             std::move(form),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
+        );
+    }
+
+    auto Images::CreateVariation(
+        const std::filesystem::path& image,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        std::optional<std::string> response_format,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(
+            this->CreateVariationRequest(
+                image,
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
         );
     }
 
@@ -345,17 +554,38 @@ export namespace liboai {
         std::optional<uint8_t> n,
         std::optional<std::string> size,
         std::optional<std::string> response_format,
-        std::optional<std::string> user
+        std::optional<std::string> user,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(
-            std::launch::async,
-            &Images::CreateVariation,
-            this,
-            image,
-            n,
-            size,
-            response_format,
-            user
+        return this->ExecuteAsync(
+            this->CreateVariationRequest(
+                image,
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
+        );
+    }
+
+    auto Images::CreateVariationCo(
+        const std::filesystem::path& image,
+        std::optional<uint8_t> n,
+        std::optional<std::string> size,
+        std::optional<std::string> response_format,
+        std::optional<std::string> user,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(
+            this->CreateVariationRequest(
+                image,
+                n,
+                std::move(size),
+                std::move(response_format),
+                std::move(user)
+            ),
+            call
         );
     }
 
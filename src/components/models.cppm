@@ -15,14 +15,23 @@ export module liboai:components.models;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.observer;
+import :core.request;
 import :core.response;
 import :core.network;
 
 export namespace liboai {
     class Models final : private Network {
     public:
-        explicit Models(const std::string& root) : Network(root) {}
+        explicit Models(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Models(const Models&) = delete;
         Models& operator=(const Models&) = delete;
@@ -37,7 +46,7 @@ export namespace liboai {
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto List() const& noexcept -> Result<Response>;
+        auto List(const CallOptions& call = {}) const& noexcept -> Result<Response>;
 
         /**
          * @brief Asynchronously list all available models.
@@ -46,70 +55,122 @@ export namespace liboai {
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto ListAsync() const& noexcept -> FutureExpected<Response>;
+        auto ListAsync(const CallOptions& call = {}) const& noexcept -> FutureExpected<Response>;
+
+        /**
+         * @brief Coroutine variant of List(); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto ListCo(const CallOptions& call = {}) const& noexcept -> ResponseAwaitable;
 
         /**
          * @brief Retrieve a specific model's information.
          *
          * @param model The model to retrieve information for.
+         * @param call  Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto Retrieve(const std::string& model) const& noexcept
+        auto Retrieve(const std::string& model, const CallOptions& call = {}) const& noexcept
             -> liboai::Result<liboai::Response>;
 
         /**
          * @brief Asynchronously retrieve a specific model's information.
          *
          * @param model The model to retrieve information for.
+         * @param call  Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
          */
         [[nodiscard]]
-        auto RetrieveAsync(const std::string& model) const& noexcept
+        auto RetrieveAsync(const std::string& model, const CallOptions& call = {}) const& noexcept
             -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Retrieve(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto RetrieveCo(
+            const std::string& model,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto ListRequest() const -> Result<PreparedRequest>;
+
+        [[nodiscard]]
+        auto RetrieveRequest(const std::string& model) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto Models::List() const& noexcept -> Result<Response> {
-        return this->Request(
+    auto Models::ListRequest() const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/models",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto Models::ListAsync() const& noexcept -> FutureExpected<Response> {
-        return std::async(std::launch::async, &liboai::Models::List, this);
+    auto Models::List(const CallOptions& call) const& noexcept -> Result<Response> {
+        return this->Execute(this->ListRequest(), call);
     }
 
-    auto Models::Retrieve(const std::string& model) const& noexcept -> Result<Response> {
-        return this->Request(
+    auto Models::ListAsync(const CallOptions& call) const& noexcept -> FutureExpected<Response> {
+        return this->ExecuteAsync(this->ListRequest(), call);
+    }
+
+    auto Models::ListCo(const CallOptions& call) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->ListRequest(), call);
+    }
+
+    auto Models::RetrieveRequest(const std::string& model) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
+        return this->Prepare(
             Method::HTTP_GET,
             this->GetOpenAIRoot(),
             "/models/" + model,
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            EndpointTemplate{ "/models/{model}" },
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
-    auto Models::RetrieveAsync(const std::string& model) const& noexcept
+    auto Models::Retrieve(
+        const std::string& model,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->RetrieveRequest(model), call);
+    }
+
+    auto Models::RetrieveAsync(const std::string& model, const CallOptions& call) const& noexcept
         -> FutureExpected<Response> {
-        return std::async(std::launch::async, &liboai::Models::Retrieve, this, model);
+        return this->ExecuteAsync(this->RetrieveRequest(model), call);
+    }
+
+    auto Models::RetrieveCo(
+        const std::string& model,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->RetrieveRequest(model), call);
     }
 
 } // namespace liboai
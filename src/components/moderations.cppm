@@ -17,14 +17,23 @@ export module liboai:components.moderations;
 
 import std;
 import :core.authorization;
+import :core.awaitable;
+import :core.cancellation;
+import :core.context;
 import :core.error;
+import :core.request;
 import :core.response;
+import :core.response_cache;
 import :core.network;
 
 export namespace liboai {
     class Moderations final : private Network {
     public:
-        explicit Moderations(const std::string& root) : Network(root) {}
+        explicit Moderations(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        )
+            : Network(root, std::move(context)) {}
 
         Moderations(const Moderations&) = delete;
         Moderations& operator=(const Moderations&) = delete;
@@ -38,6 +47,7 @@ export namespace liboai {
          *
          * @param *input The text to be moderated.
          * @param model  The model to use for the moderation.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response object containing the image(s)
          *         data in JSON format.
@@ -45,7 +55,8 @@ export namespace liboai {
         [[nodiscard]]
         auto Create(
             const std::string& input,
-            std::optional<std::string> model = std::nullopt
+            std::optional<std::string> model = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> Result<Response>;
 
         /**
@@ -54,6 +65,7 @@ export namespace liboai {
          *
          * @param *input The text to be moderated.
          * @param model  The model to use for the moderation.
+         * @param call   Cancellation token and deadline of the call.
          *
          * @return A liboai::Response future containing the image(s)
          *         data in JSON format.
@@ -61,39 +73,79 @@ export namespace liboai {
         [[nodiscard]]
         auto CreateAsync(
             const std::string& input,
-            std::optional<std::string> model = std::nullopt
+            std::optional<std::string> model = std::nullopt,
+            const CallOptions& call = {}
         ) const& noexcept -> FutureExpected<Response>;
 
+        /**
+         * @brief Coroutine variant of Create(...); suspends the awaiting
+         *        coroutine until the response arrives.
+         *
+         * @return An awaitable yielding the liboai::Response.
+         */
+        [[nodiscard]]
+        auto CreateCo(
+            const std::string& input,
+            std::optional<std::string> model = std::nullopt,
+            const CallOptions& call = {}
+        ) const& noexcept -> ResponseAwaitable;
+
     private:
-        Authorization& m_auth = Authorization::Authorizer();
+        [[nodiscard]]
+        auto CreateRequest(
+            const std::string& input,
+            std::optional<std::string> model
+        ) const -> Result<PreparedRequest>;
+
+        Authorization& m_auth = this->GetContext()->GetAuthorization();
     };
 
     // Implementation
-    auto
-    Moderations::Create(const std::string& input, std::optional<std::string> model) const& noexcept
-        -> Result<Response> {
+    auto Moderations::CreateRequest(
+        const std::string& input,
+        std::optional<std::string> model
+    ) const -> Result<PreparedRequest> {
+        const auto credentials = this->m_auth.GetCredentials();
         JsonConstructor jcon;
         jcon.push_back("input", input);
         jcon.push_back("model", std::move(model));
 
-        return this->Request(
+        return this->Prepare(
             Method::HTTP_POST,
             this->GetOpenAIRoot(),
             "/moderations",
-            "application/json",
-            this->m_auth.GetAuthorizationHeaders(),
-            cpr::Body{ jcon.dump() },
-            this->m_auth.GetProxies(),
-            this->m_auth.GetProxyAuth(),
-            this->m_auth.GetMaxTimeout()
+            RequestHeaders(credentials, HeaderSet::OpenAIJson),
+            jcon.body(),
+            Cacheable{},
+            credentials->proxies,
+            credentials->proxy_auth,
+            credentials->timeout
         );
     }
 
+    auto
+    Moderations::Create(
+        const std::string& input,
+        std::optional<std::string> model,
+        const CallOptions& call
+    ) const& noexcept -> Result<Response> {
+        return this->Execute(this->CreateRequest(input, std::move(model)), call);
+    }
+
     auto Moderations::CreateAsync(
         const std::string& input,
-        std::optional<std::string> model
+        std::optional<std::string> model,
+        const CallOptions& call
     ) const& noexcept -> FutureExpected<Response> {
-        return std::async(std::launch::async, &Moderations::Create, this, input, model);
+        return this->ExecuteAsync(this->CreateRequest(input, std::move(model)), call);
+    }
+
+    auto Moderations::CreateCo(
+        const std::string& input,
+        std::optional<std::string> model,
+        const CallOptions& call
+    ) const& noexcept -> ResponseAwaitable {
+        return this->ExecuteCo(this->CreateRequest(input, std::move(model)), call);
     }
 
 } // namespace liboai
@@ -5,36 +5,91 @@
  *
  * This module provides declarations for authorization directives
  * for authorizing requests with the OpenAI API. Each component class
- * makes use of a single object accessed via liboai::Authorization::Authorizer()
- * to retrieve and use user-set authorization information to successfully
- * complete component API requests.
+ * uses the liboai::Authorization object of its liboai::ClientContext to
+ * retrieve and use user-set authorization information to successfully
+ * complete component API requests. Unless a context is given its own
+ * object, this is the process-wide one returned by
+ * liboai::Authorization::Authorizer().
+ *
+ * The authorization state is published as an immutable
+ * liboai::Credentials snapshot. Requests read the current snapshot
+ * without taking a lock, and each setter publishes a new snapshot
+ * atomically, so keys can be rotated while requests are in flight:
+ * a request uses either the old credentials or the new ones, never a mix.
  */
 
 module;
 
+#include <version>
+
 #include <cpr/cpr.h>
 
 export module liboai:core.authorization;
 
 import std;
-import :core.network;
 import :core.response;
 
 export namespace liboai {
+    /**
+     * @brief Selects one of the complete request header lists kept by
+     *        each liboai::Credentials snapshot.
+     */
+    enum class HeaderSet : std::uint8_t {
+        OpenAIJson,      // OpenAI authorization, application/json
+        OpenAIMultipart, // OpenAI authorization, multipart/form-data
+        AzureJson        // Azure authorization, application/json
+    };
+
+    /**
+     * @brief An immutable snapshot of the authorization state.
+     */
+    struct Credentials {
+        Credentials() = default;
+        Credentials(const Credentials&) = default;
+        Credentials& operator=(const Credentials&) = default;
+        Credentials(Credentials&&) = default;
+        Credentials& operator=(Credentials&&) = default;
+        ~Credentials();
+
+        std::string key, org;
+        cpr::Header openai_headers, azure_headers;
+        cpr::Proxies proxies;
+        cpr::ProxyAuthentication proxy_auth;
+        cpr::Timeout timeout{ 30000 };
+
+        // openai_headers / azure_headers plus a Content-Type, indexed by
+        // HeaderSet; rebuilt whenever a new snapshot is published
+        std::array<cpr::Header, 3> request_headers;
+
+        auto BuildRequestHeaders() -> void;
+    };
+
+    /**
+     * @brief Returns one of the snapshot's prebuilt request header lists.
+     *
+     * The returned pointer shares ownership of the whole snapshot, so the
+     * list stays alive and unchanged for as long as it is held; its address
+     * alone identifies its contents.
+     */
+    [[nodiscard]]
+    auto RequestHeaders(const std::shared_ptr<const Credentials>& credentials, HeaderSet set)
+        -> std::shared_ptr<const cpr::Header>;
+
     class Authorization final {
     public: // cons/des, operator deletions
-        Authorization() = default;
+        Authorization() : m_credentials(MakeEmptyCredentials()) {}
         Authorization(const Authorization&) = delete;
         Authorization& operator=(const Authorization&) = delete;
         Authorization(Authorization&&) = delete;
         Authorization& operator=(Authorization&&) = delete;
-        ~Authorization();
+        ~Authorization() = default;
 
         /**
          * @brief Singleton paradigm access method.
          *
-         * @return A reference to the singleton instance of this class to be
-         *         used in all component classes.
+         * @return A reference to the singleton instance of this class, used
+         *         by every component class whose context was not given its
+         *         own Authorization.
          */
         [[nodiscard]]
         static Authorization& Authorizer() noexcept {
@@ -211,23 +266,39 @@ export namespace liboai {
          * @brief Sets the timeout for component calls in milliseconds.
          */
         auto SetMaxTimeout(int32_t ms) noexcept -> void {
-            this->m_timeout = cpr::Timeout(ms);
+            this->Update([ms](Credentials& c) { c.timeout = cpr::Timeout(ms); });
+        }
+
+        /**
+         * @brief Returns the current credentials snapshot.
+         *
+         * Lock-free. The snapshot never changes; a request should take one
+         * and read every credential it needs from it, so that a concurrent
+         * key rotation cannot leave it with a mix of old and new values.
+         */
+        [[nodiscard]]
+        auto GetCredentials() const noexcept -> std::shared_ptr<const Credentials> {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            return this->m_credentials.load(std::memory_order_acquire);
+#else
+            return std::atomic_load_explicit(&this->m_credentials, std::memory_order_acquire);
+#endif
         }
 
         /**
          * @brief Returns currently the set authorization key.
          */
         [[nodiscard]]
-        constexpr auto GetKey() const noexcept -> const std::string& {
-            return this->m_key;
+        auto GetKey() const noexcept -> std::string {
+            return this->GetCredentials()->key;
         }
 
         /**
          * @brief Returns the currently set organization identifier.
          */
         [[nodiscard]]
-        constexpr auto GetOrganization() const noexcept -> const std::string& {
-            return this->m_org;
+        auto GetOrganization() const noexcept -> std::string {
+            return this->GetCredentials()->org;
         }
 
         /**
@@ -235,7 +306,7 @@ export namespace liboai {
          */
         [[nodiscard]]
         auto GetProxies() const noexcept -> cpr::Proxies {
-            return this->m_proxies;
+            return this->GetCredentials()->proxies;
         }
 
         /**
@@ -243,7 +314,7 @@ export namespace liboai {
          */
         [[nodiscard]]
         auto GetProxyAuth() const noexcept -> cpr::ProxyAuthentication {
-            return this->m_proxyAuth;
+            return this->GetCredentials()->proxy_auth;
         }
 
         /**
@@ -251,7 +322,7 @@ export namespace liboai {
          */
         [[nodiscard]]
         auto GetMaxTimeout() const noexcept -> cpr::Timeout {
-            return this->m_timeout;
+            return this->GetCredentials()->timeout;
         }
 
         /**
@@ -259,8 +330,8 @@ export namespace liboai {
          *         for use in component calls.
          */
         [[nodiscard]]
-        constexpr auto GetAuthorizationHeaders() const noexcept -> const cpr::Header& {
-            return this->m_openai_auth_headers;
+        auto GetAuthorizationHeaders() const noexcept -> cpr::Header {
+            return this->GetCredentials()->openai_headers;
         }
 
         /**
@@ -268,36 +339,113 @@ export namespace liboai {
          *         information for use in Azure component calls.
          */
         [[nodiscard]]
-        constexpr auto GetAzureAuthorizationHeaders() const noexcept -> const cpr::Header& {
-            return this->m_azure_auth_headers;
+        auto GetAzureAuthorizationHeaders() const noexcept -> cpr::Header {
+            return this->GetCredentials()->azure_headers;
         }
 
+    private:
+        /**
+         * @brief Publishes a modified copy of the current credentials.
+         *
+         * Writers are serialized; readers are never blocked.
+         */
+        template <class Fn>
+        auto Update(Fn&& fn) -> void {
+            std::lock_guard<std::mutex> lock(this->m_update_mutex);
+
+            auto next = std::make_shared<Credentials>(*this->GetCredentials());
+            std::forward<Fn>(fn)(*next);
+            next->BuildRequestHeaders();
+
+            std::shared_ptr<const Credentials> published = std::move(next);
+#if defined(__cpp_lib_atomic_shared_ptr)
+            this->m_credentials.store(std::move(published), std::memory_order_release);
+#else
+            std::atomic_store_explicit(
+                &this->m_credentials,
+                std::move(published),
+                std::memory_order_release
+            );
+#endif
+        }
+
+        [[nodiscard]]
+        static auto MakeEmptyCredentials() -> std::shared_ptr<const Credentials>;
+
+        /**
+         * @brief Reads the first line of the file at 'path', if it is non-empty.
+         */
+        [[nodiscard]]
+        static auto ReadFirstLine(const std::filesystem::path& path)
+            -> std::optional<std::string>;
+
     private: // member variables
-        std::string m_key, m_org;
-        cpr::Header m_openai_auth_headers, m_azure_auth_headers;
-        cpr::Proxies m_proxies;
-        cpr::ProxyAuthentication m_proxyAuth;
-        cpr::Timeout m_timeout{ 30000 };
+#if defined(__cpp_lib_atomic_shared_ptr)
+        std::atomic<std::shared_ptr<const Credentials>> m_credentials;
+#else
+        // only ever accessed through std::atomic_load / std::atomic_store
+        std::shared_ptr<const Credentials> m_credentials;
+#endif
+        std::mutex m_update_mutex;
     };
 
     // Implementation
-    Authorization::~Authorization() {
+    Credentials::~Credentials() {
         // Securely clear the key memory
-        if (!this->m_key.empty()) {
-            volatile char* p = const_cast<volatile char*>(this->m_key.data());
-            for (size_t i = 0; i < this->m_key.size(); ++i) {
+        if (!this->key.empty()) {
+            volatile char* p = const_cast<volatile char*>(this->key.data());
+            for (size_t i = 0; i < this->key.size(); ++i) {
                 p[i] = '\0';
             }
         }
     }
 
+    auto Credentials::BuildRequestHeaders() -> void {
+        const auto build = [](const cpr::Header& auth, const char* content_type) {
+            cpr::Header headers = auth;
+            headers["Content-Type"] = content_type;
+            return headers;
+        };
+
+        this->request_headers[static_cast<std::size_t>(HeaderSet::OpenAIJson)] =
+            build(this->openai_headers, "application/json");
+        this->request_headers[static_cast<std::size_t>(HeaderSet::OpenAIMultipart)] =
+            build(this->openai_headers, "multipart/form-data");
+        this->request_headers[static_cast<std::size_t>(HeaderSet::AzureJson)] =
+            build(this->azure_headers, "application/json");
+    }
+
+    auto RequestHeaders(const std::shared_ptr<const Credentials>& credentials, HeaderSet set)
+        -> std::shared_ptr<const cpr::Header> {
+        return { credentials, &credentials->request_headers[static_cast<std::size_t>(set)] };
+    }
+
+    auto Authorization::MakeEmptyCredentials() -> std::shared_ptr<const Credentials> {
+        auto credentials = std::make_shared<Credentials>();
+        credentials->BuildRequestHeaders();
+        return credentials;
+    }
+
+    auto Authorization::ReadFirstLine(const std::filesystem::path& path)
+        -> std::optional<std::string> {
+        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path) &&
+            std::filesystem::file_size(path) > 0) {
+            std::ifstream file(path);
+            if (file.is_open()) {
+                std::string line;
+                std::getline(file, line);
+                return line;
+            }
+        }
+        return std::nullopt;
+    }
+
     auto Authorization::SetKey(std::string_view key) noexcept -> bool {
         if (!key.empty()) {
-            this->m_key = key;
-            if (this->m_openai_auth_headers.count("Authorization") > 0) {
-                this->m_openai_auth_headers.erase("Authorization");
-            }
-            this->m_openai_auth_headers["Authorization"] = ("Bearer " + this->m_key);
+            this->Update([key](Credentials& c) {
+                c.key = key;
+                c.openai_headers["Authorization"] = ("Bearer " + c.key);
+            });
             return true;
         }
         return false;
@@ -305,11 +453,11 @@ export namespace liboai {
 
     auto Authorization::SetAzureKey(std::string_view key) noexcept -> bool {
         if (!key.empty()) {
-            this->m_key = key;
-            if (this->m_azure_auth_headers.size() > 0) {
-                this->m_azure_auth_headers.clear();
-            }
-            this->m_azure_auth_headers["api-key"] = this->m_key;
+            this->Update([key](Credentials& c) {
+                c.key = key;
+                c.azure_headers.clear();
+                c.azure_headers["api-key"] = c.key;
+            });
             return true;
         }
         return false;
@@ -317,74 +465,42 @@ export namespace liboai {
 
     auto Authorization::SetAzureKeyAD(std::string_view key) noexcept -> bool {
         if (!key.empty()) {
-            this->m_key = key;
-            if (this->m_azure_auth_headers.size() > 0) {
-                this->m_azure_auth_headers.clear();
-            }
-            this->m_azure_auth_headers["Authorization"] = ("Bearer " + this->m_key);
+            this->Update([key](Credentials& c) {
+                c.key = key;
+                c.azure_headers.clear();
+                c.azure_headers["Authorization"] = ("Bearer " + c.key);
+            });
             return true;
         }
         return false;
     }
 
     auto Authorization::SetKeyFile(const std::filesystem::path& path) noexcept -> bool {
-        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path) &&
-            std::filesystem::file_size(path) > 0) {
-            std::ifstream file(path);
-            if (file.is_open()) {
-                std::getline(file, this->m_key);
-                if (this->m_openai_auth_headers.count("Authorization") > 0) {
-                    this->m_openai_auth_headers.erase("Authorization");
-                }
-                this->m_openai_auth_headers["Authorization"] = ("Bearer " + this->m_key);
-                return true;
-            }
+        if (auto key = ReadFirstLine(path)) {
+            return this->SetKey(*key);
         }
         return false;
     }
 
     auto Authorization::SetAzureKeyFile(const std::filesystem::path& path) noexcept -> bool {
-        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path) &&
-            std::filesystem::file_size(path) > 0) {
-            std::ifstream file(path);
-            if (file.is_open()) {
-                std::getline(file, this->m_key);
-                if (this->m_azure_auth_headers.size() > 0) {
-                    this->m_azure_auth_headers.clear();
-                }
-                this->m_azure_auth_headers["api-key"] = this->m_key;
-                return true;
-            }
+        if (auto key = ReadFirstLine(path)) {
+            return this->SetAzureKey(*key);
         }
         return false;
     }
 
     auto Authorization::SetAzureKeyFileAD(const std::filesystem::path& path) noexcept -> bool {
-        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path) &&
-            std::filesystem::file_size(path) > 0) {
-            std::ifstream file(path);
-            if (file.is_open()) {
-                std::getline(file, this->m_key);
-                if (this->m_azure_auth_headers.size() > 0) {
-                    this->m_azure_auth_headers.clear();
-                }
-                this->m_azure_auth_headers["Authorization"] = ("Bearer " + this->m_key);
-                return true;
-            }
+        if (auto key = ReadFirstLine(path)) {
+            return this->SetAzureKeyAD(*key);
         }
         return false;
     }
 
     auto Authorization::SetKeyEnv(std::string_view var) noexcept -> bool {
         if (!var.empty()) {
-            const char* key = std::getenv(var.data());
+            const char* key = std::getenv(std::string(var).c_str());
             if (key != nullptr) {
-                this->m_key = key;
-                if (this->m_openai_auth_headers.count("Authorization") > 0) {
-                    this->m_openai_auth_headers.erase("Authorization");
-                }
-                this->m_openai_auth_headers["Authorization"] = ("Bearer " + this->m_key);
-                return true;
+                return this->SetKey(key);
             }
             return false;
         }
@@ -393,14 +509,9 @@ export namespace liboai {
 
     auto Authorization::SetAzureKeyEnv(std::string_view var) noexcept -> bool {
         if (!var.empty()) {
-            const char* key = std::getenv(var.data());
+            const char* key = std::getenv(std::string(var).c_str());
             if (key != nullptr) {
-                this->m_key = key;
-                if (this->m_azure_auth_headers.size() > 0) {
-                    this->m_azure_auth_headers.clear();
-                }
-                this->m_azure_auth_headers["api-key"] = this->m_key;
-                return true;
+                return this->SetAzureKey(key);
             }
             return false;
         }
@@ -409,14 +520,9 @@ export namespace liboai {
 
     auto Authorization::SetAzureKeyEnvAD(std::string_view var) noexcept -> bool {
         if (!var.empty()) {
-            const char* key = std::getenv(var.data());
+            const char* key = std::getenv(std::string(var).c_str());
             if (key != nullptr) {
-                this->m_key = key;
-                if (this->m_azure_auth_headers.size() > 0) {
-                    this->m_azure_auth_headers.clear();
-                }
-                this->m_azure_auth_headers["Authorization"] = ("Bearer " + this->m_key);
-                return true;
+                return this->SetAzureKeyAD(key);
             }
             return false;
         }
@@ -425,42 +531,27 @@ export namespace liboai {
 
     auto Authorization::SetOrganization(std::string_view org) noexcept -> bool {
         if (!org.empty()) {
-            this->m_org = std::move(org);
-            if (this->m_openai_auth_headers.count("OpenAI-Organization") > 0) {
-                this->m_openai_auth_headers.erase("OpenAI-Organization");
-            }
-            this->m_openai_auth_headers["OpenAI-Organization"] = this->m_org;
+            this->Update([org](Credentials& c) {
+                c.org = org;
+                c.openai_headers["OpenAI-Organization"] = c.org;
+            });
             return true;
         }
         return false;
     }
 
     auto Authorization::SetOrganizationFile(const std::filesystem::path& path) noexcept -> bool {
-        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path) &&
-            std::filesystem::file_size(path) > 0) {
-            std::ifstream file(path);
-            if (file.is_open()) {
-                std::getline(file, this->m_key);
-                if (this->m_openai_auth_headers.count("OpenAI-Organization") > 0) {
-                    this->m_openai_auth_headers.erase("OpenAI-Organization");
-                }
-                this->m_openai_auth_headers["OpenAI-Organization"] = this->m_org;
-                return true;
-            }
+        if (auto org = ReadFirstLine(path)) {
+            return this->SetOrganization(*org);
         }
         return false;
     }
 
     auto Authorization::SetOrganizationEnv(std::string_view var) noexcept -> bool {
         if (!var.empty()) {
-            const char* org = std::getenv(var.data());
+            const char* org = std::getenv(std::string(var).c_str());
             if (org != nullptr) {
-                this->m_org = org;
-                if (this->m_openai_auth_headers.count("OpenAI-Organization") > 0) {
-                    this->m_openai_auth_headers.erase("OpenAI-Organization");
-                }
-                this->m_openai_auth_headers["OpenAI-Organization"] = this->m_org;
-                return true;
+                return this->SetOrganization(org);
             }
             return false;
         }
@@ -470,28 +561,30 @@ export namespace liboai {
     auto Authorization::SetProxies(
         const std::initializer_list<std::pair<const std::string, std::string>>& hosts
     ) noexcept -> void {
-        this->m_proxies = cpr::Proxies(hosts);
+        this->Update([&hosts](Credentials& c) { c.proxies = cpr::Proxies(hosts); });
     }
 
     auto Authorization::SetProxies(
         std::initializer_list<std::pair<const std::string, std::string>>&& hosts
     ) noexcept -> void {
-        this->m_proxies = cpr::Proxies(std::move(hosts));
+        this->Update([&hosts](Credentials& c) { c.proxies = cpr::Proxies(std::move(hosts)); });
     }
 
     auto Authorization::SetProxies(const std::map<std::string, std::string>& hosts) noexcept
         -> void {
-        this->m_proxies = cpr::Proxies(hosts);
+        this->Update([&hosts](Credentials& c) { c.proxies = cpr::Proxies(hosts); });
     }
 
     auto Authorization::SetProxies(std::map<std::string, std::string>&& hosts) noexcept -> void {
-        this->m_proxies = cpr::Proxies(std::move(hosts));
+        this->Update([&hosts](Credentials& c) { c.proxies = cpr::Proxies(std::move(hosts)); });
     }
 
     auto Authorization::SetProxyAuth(
         const std::map<std::string, cpr::EncodedAuthentication>& proto_up
     ) noexcept -> void {
-        this->m_proxyAuth = cpr::ProxyAuthentication(proto_up);
+        this->Update([&proto_up](Credentials& c) {
+            c.proxy_auth = cpr::ProxyAuthentication(proto_up);
+        });
     }
 
 } // namespace liboai
@@ -0,0 +1,95 @@
+/**
+ * @file awaitable.cppm
+ *
+ * liboai coroutine support.
+ * This module provides declarations for liboai::ResponseAwaitable, the
+ * type returned by the *Co variant of every component endpoint. Awaiting
+ * it hands the request to the client's liboai::EventLoop and suspends
+ * the calling coroutine; no thread is blocked while the request is in
+ * flight.
+ *
+ * The coroutine is resumed on the event loop thread that completed the
+ * transfer, and every other transfer on that thread waits while it runs.
+ * Blocking liboai methods called there are safe: they are sent from the
+ * calling thread, or through the executor, rather than queued behind it.
+ * Waiting on a future that some other thread completes through the loop
+ * (an EmbeddingCoalescer result, or an *Async call made on a thread that
+ * is not a loop thread) deadlocks, however. Such waits, and any other
+ * long work, belong on the caller's own scheduler.
+ */
+
+module;
+
+// Standard library headers
+#include <coroutine>
+#include <expected>
+#include <optional>
+#include <utility>
+
+export module liboai:core.awaitable;
+
+import :core.error;
+import :core.event_loop;
+import :core.request;
+import :core.response;
+
+export namespace liboai {
+
+    class ResponseAwaitable final {
+    public:
+        ResponseAwaitable(Result<PreparedRequest> request, EventLoop& loop) noexcept
+            : m_request(std::move(request)), m_loop(&loop) {}
+
+        /**
+         * @brief An awaitable that completes immediately with 'result',
+         *        such as a response served from the cache.
+         */
+        [[nodiscard]]
+        static auto Ready(Result<Response> result, EventLoop& loop) -> ResponseAwaitable {
+            ResponseAwaitable awaitable(std::unexpected(OpenAIError{}), loop);
+            awaitable.m_result.emplace(std::move(result));
+            return awaitable;
+        }
+
+        ResponseAwaitable(const ResponseAwaitable&) = delete;
+        ResponseAwaitable& operator=(const ResponseAwaitable&) = delete;
+        ResponseAwaitable(ResponseAwaitable&&) = default;
+        ResponseAwaitable& operator=(ResponseAwaitable&&) = default;
+        ~ResponseAwaitable() = default;
+
+        /**
+         * @brief Requests that could not be prepared, or that already have
+         *        their result, complete immediately.
+         */
+        [[nodiscard]]
+        auto await_ready() const noexcept -> bool {
+            return !this->m_request.has_value() || this->m_result.has_value();
+        }
+
+        auto await_suspend(std::coroutine_handle<> handle) -> void {
+            // the coroutine may be resumed (and this awaiter destroyed) before
+            // Submit returns, so nothing below may touch 'this'
+            this->m_loop->Submit(
+                std::move(*this->m_request),
+                [this, handle](Result<Response> result) {
+                    this->m_result.emplace(std::move(result));
+                    handle.resume();
+                }
+            );
+        }
+
+        [[nodiscard]]
+        auto await_resume() -> Result<Response> {
+            if (this->m_result) {
+                return std::move(*this->m_result);
+            }
+            return std::unexpected(this->m_request.error());
+        }
+
+    private:
+        Result<PreparedRequest> m_request;
+        EventLoop* m_loop;
+        std::optional<Result<Response>> m_result;
+    };
+
+} // namespace liboai
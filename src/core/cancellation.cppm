@@ -0,0 +1,301 @@
+/**
+ * @file cancellation.cppm
+ *
+ * liboai cancellation implementation.
+ * This module provides declarations for liboai::CancellationToken, with
+ * which a caller gives up on requests it no longer needs, and
+ * liboai::CallOptions, the token and deadline every endpoint method
+ * accepts as its last parameter.
+ *
+ * A request whose token is cancelled or whose deadline passes has its
+ * transfer aborted and its connection closed, and fails with
+ * ErrorCode::Cancelled or ErrorCode::DeadlineExceeded. If that happens
+ * while it waits for the rate limiter, a retry or an executor thread,
+ * it is never sent at all.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+export module liboai:core.cancellation;
+
+import :core.error;
+
+export namespace liboai {
+
+    /**
+     * @brief A shared flag through which requests are cancelled.
+     *
+     * Copies refer to the same flag; cancelling one cancels every
+     * request given any of them. A default-constructed token has no
+     * flag and can never be cancelled, so it costs nothing to pass.
+     */
+    class CancellationToken final {
+    public:
+        using Callback = std::function<void()>;
+
+        CancellationToken() noexcept = default;
+
+        /**
+         * @return A new token that is not cancelled yet.
+         */
+        [[nodiscard]]
+        static auto Create() -> CancellationToken;
+
+        /**
+         * @brief Cancels every request given this token. Idempotent.
+         */
+        auto Cancel() const noexcept -> void;
+
+        [[nodiscard]]
+        auto IsCancelled() const noexcept -> bool {
+            return this->m_state && this->m_state->cancelled.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @return False for a default-constructed token.
+         */
+        [[nodiscard]]
+        auto CanBeCancelled() const noexcept -> bool {
+            return this->m_state != nullptr;
+        }
+
+        /**
+         * @brief Sleeps for 'duration', or until the token is cancelled.
+         *
+         * @return Whether the token was cancelled.
+         */
+        auto WaitFor(std::chrono::steady_clock::duration duration) const -> bool;
+
+        /**
+         * @brief Registers 'callback' to be invoked when the token is
+         *        cancelled, or right away if it already is.
+         *
+         * Callbacks run on the thread calling Cancel(), while the token's
+         * lock is held: they must be quick and must not use the token.
+         *
+         * @return An id for Unsubscribe(...); 0 if the callback will never
+         *         be invoked again.
+         */
+        [[nodiscard]]
+        auto Subscribe(Callback callback) const -> std::uint64_t;
+
+        /**
+         * @brief Removes a callback. Once this returns, the callback is
+         *        not running and will not be invoked.
+         */
+        auto Unsubscribe(std::uint64_t id) const noexcept -> void;
+
+    private:
+        struct State {
+            std::atomic<bool> cancelled{ false };
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::vector<std::pair<std::uint64_t, Callback>> callbacks;
+            std::uint64_t next_id = 1;
+        };
+
+        std::shared_ptr<State> m_state;
+    };
+
+    /**
+     * @brief Per-call controls, accepted by every endpoint method.
+     *
+     * @code
+     * auto token = liboai::CancellationToken::Create();
+     * auto future = oai.ChatCompletion->CreateAsync(model, convo, ..., { .cancel = token });
+     * // ...
+     * token.Cancel();
+     * @endcode
+     */
+    struct CallOptions {
+        // aborts the call when cancelled
+        CancellationToken cancel{};
+        // the longest the whole call may take, rate limiting, retries and
+        // waits in between included
+        std::optional<std::chrono::milliseconds> timeout = std::nullopt;
+        // the same as a point in time; when both are set the earlier applies
+        std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt;
+
+        /**
+         * @return A copy whose timeout has been turned into a deadline,
+         *         counted from now, for work done later on the call's behalf.
+         */
+        [[nodiscard]]
+        auto Anchored() const -> CallOptions;
+    };
+
+    /**
+     * @brief The cancellation token and absolute deadline of one request.
+     */
+    struct RequestControl {
+        CancellationToken cancel{};
+        std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt;
+
+        /**
+         * @brief Resolves CallOptions::timeout against the current time.
+         */
+        [[nodiscard]]
+        static auto From(const CallOptions& options) -> RequestControl;
+
+        /**
+         * @return Whether the request can be cancelled or has a deadline.
+         */
+        explicit operator bool() const noexcept {
+            return this->cancel.CanBeCancelled() || this->deadline.has_value();
+        }
+
+        /**
+         * @return The error to fail the request with, if it was cancelled
+         *         or its deadline has passed.
+         */
+        [[nodiscard]]
+        auto Check() const -> std::optional<OpenAIError>;
+
+        /**
+         * @return The time left until the deadline, rounded up and never
+         *         below 1ms (curl takes a 0ms timeout as none at all);
+         *         nullopt without a deadline.
+         */
+        [[nodiscard]]
+        auto Remaining() const noexcept -> std::optional<std::chrono::milliseconds>;
+
+        /**
+         * @brief Waits 'duration' before the request goes on.
+         *
+         * Returns early if the request is cancelled meanwhile, and does not
+         * wait at all if the deadline would pass first.
+         *
+         * @return The error to fail the request with, if it must not go on.
+         */
+        [[nodiscard]]
+        auto Wait(std::chrono::steady_clock::duration duration) const
+            -> std::optional<OpenAIError>;
+    };
+
+    // Implementation
+    inline auto CancellationToken::Create() -> CancellationToken {
+        CancellationToken token;
+        token.m_state = std::make_shared<State>();
+        return token;
+    }
+
+    inline auto CancellationToken::Cancel() const noexcept -> void {
+        if (!this->m_state) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(this->m_state->mutex);
+        if (this->m_state->cancelled.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        this->m_state->wake.notify_all();
+        for (auto& [id, callback] : this->m_state->callbacks) {
+            try {
+                callback();
+            } catch (...) {
+            }
+        }
+        this->m_state->callbacks.clear();
+    }
+
+    inline auto CancellationToken::WaitFor(std::chrono::steady_clock::duration duration) const
+        -> bool {
+        if (!this->m_state) {
+            std::this_thread::sleep_for(duration);
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(this->m_state->mutex);
+        return this->m_state->wake.wait_for(lock, duration, [this] {
+            return this->m_state->cancelled.load(std::memory_order_acquire);
+        });
+    }
+
+    inline auto CancellationToken::Subscribe(Callback callback) const -> std::uint64_t {
+        if (!this->m_state) {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(this->m_state->mutex);
+        if (this->m_state->cancelled.load(std::memory_order_acquire)) {
+            callback();
+            return 0;
+        }
+        const auto id = this->m_state->next_id++;
+        this->m_state->callbacks.emplace_back(id, std::move(callback));
+        return id;
+    }
+
+    inline auto CancellationToken::Unsubscribe(std::uint64_t id) const noexcept -> void {
+        if (!this->m_state || id == 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(this->m_state->mutex);
+        std::erase_if(this->m_state->callbacks, [id](const auto& entry) {
+            return entry.first == id;
+        });
+    }
+
+    inline auto CallOptions::Anchored() const -> CallOptions {
+        const auto control = RequestControl::From(*this);
+        return { control.cancel, std::nullopt, control.deadline };
+    }
+
+    inline auto RequestControl::From(const CallOptions& options) -> RequestControl {
+        RequestControl control{ options.cancel, options.deadline };
+        if (options.timeout) {
+            const auto due = std::chrono::steady_clock::now() + *options.timeout;
+            control.deadline = control.deadline ? std::min(*control.deadline, due) : due;
+        }
+        return control;
+    }
+
+    inline auto RequestControl::Check() const -> std::optional<OpenAIError> {
+        if (this->cancel.IsCancelled()) {
+            return OpenAIError::cancelled("Request cancelled");
+        }
+        if (this->deadline && std::chrono::steady_clock::now() >= *this->deadline) {
+            return OpenAIError::deadline_exceeded("Request deadline exceeded");
+        }
+        return std::nullopt;
+    }
+
+    inline auto RequestControl::Remaining() const noexcept
+        -> std::optional<std::chrono::milliseconds> {
+        if (!this->deadline) {
+            return std::nullopt;
+        }
+        const auto left = *this->deadline - std::chrono::steady_clock::now();
+        return std::max(
+            std::chrono::ceil<std::chrono::milliseconds>(left),
+            std::chrono::milliseconds{ 1 }
+        );
+    }
+
+    inline auto RequestControl::Wait(std::chrono::steady_clock::duration duration) const
+        -> std::optional<OpenAIError> {
+        if (this->deadline && std::chrono::steady_clock::now() + duration >= *this->deadline) {
+            return OpenAIError::deadline_exceeded("Request deadline exceeded");
+        }
+        if (this->cancel.WaitFor(duration)) {
+            return OpenAIError::cancelled("Request cancelled");
+        }
+        return std::nullopt;
+    }
+
+} // namespace liboai
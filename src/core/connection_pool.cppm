@@ -0,0 +1,390 @@
+/**
+ * @file connection_pool.cppm
+ *
+ * liboai connection pool implementation.
+ * This module provides declarations for the per-host pool of reusable
+ * cpr::Session objects used by liboai::Network. Each pooled session
+ * owns a single curl easy handle, and with it curl's connection cache,
+ * so consecutive requests to the same host reuse the already established
+ * TCP connection and TLS session instead of handshaking again.
+ *
+ * Sessions are handed out as RAII leases; a lease returns its session to
+ * the pool when destroyed, where it is kept alive until it has been idle
+ * for longer than the configured idle timeout.
+ *
+ * A pooled session also remembers the URL and the (immutable) header
+ * list it was last configured with, so a request to the same endpoint
+ * with the same credentials does not copy either into the session again.
+ */
+
+module;
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Third-party library headers
+#include <cpr/cpr.h>
+#include <curl/curl.h>
+
+export module liboai:core.connection_pool;
+
+export namespace liboai {
+
+    /**
+     * @brief Tunables for liboai::ConnectionPool.
+     */
+    struct ConnectionPoolOptions {
+        // maximum number of idle sessions kept per host
+        std::size_t max_idle_per_host = 8;
+        // idle sessions (and their connections) older than this are dropped
+        std::chrono::seconds idle_timeout{ 60 };
+        // whether to enable TCP keep-alive probes on pooled connections
+        bool tcp_keep_alive = true;
+        std::chrono::seconds keep_alive_idle{ 30 };
+        std::chrono::seconds keep_alive_interval{ 15 };
+    };
+
+    /**
+     * @brief Counters reported by liboai::ConnectionPool::Stats().
+     *
+     * 'handshakes' counts transfers that had to open a new connection,
+     * 'reuses' counts transfers served over an already open connection.
+     */
+    struct ConnectionPoolStats {
+        std::uint64_t handshakes = 0;
+        std::uint64_t reuses = 0;
+        std::uint64_t sessions_created = 0;
+        std::size_t idle_sessions = 0;
+    };
+
+    class ConnectionPool final {
+    private:
+        struct State;
+
+    public:
+        /**
+         * @brief Exclusive, movable handle to a pooled cpr::Session.
+         *
+         * The session is returned to its pool when the lease is destroyed.
+         */
+        class Lease final {
+        public:
+            Lease() = default;
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            Lease(Lease&& old) noexcept = default;
+            Lease& operator=(Lease&& old) noexcept;
+            ~Lease();
+
+            [[nodiscard]]
+            auto operator*() const noexcept -> cpr::Session& {
+                return *this->m_session;
+            }
+
+            [[nodiscard]]
+            auto operator->() const noexcept -> cpr::Session* {
+                return this->m_session.get();
+            }
+
+            [[nodiscard]]
+            explicit operator bool() const noexcept {
+                return this->m_session != nullptr;
+            }
+
+            /**
+             * @brief Records whether the last transfer performed on this
+             *        session opened a new connection or reused one.
+             *
+             * Should be called once after each completed transfer.
+             */
+            auto RecordTransfer() noexcept -> void;
+
+            /**
+             * @brief Points the session at root + endpoint.
+             *
+             * Nothing is allocated or copied when the session was last
+             * used with the same URL.
+             */
+            auto SetUrl(std::string_view root, std::string_view endpoint) -> void;
+
+            /**
+             * @brief Sets the session's headers to an immutable header list.
+             *
+             * Lists are compared by address: if the session already carries
+             * this very list, it is left as is. The lease keeps the list alive
+             * while it is applied to the session.
+             */
+            auto SetHeader(std::shared_ptr<const cpr::Header> headers) -> void;
+
+        private:
+            friend class ConnectionPool;
+            friend struct ConnectionPool::State;
+
+            struct Applied {
+                std::string url;
+                std::shared_ptr<const cpr::Header> headers;
+            };
+
+            Lease(
+                std::shared_ptr<State> state,
+                std::string host,
+                std::unique_ptr<cpr::Session> session,
+                Applied applied = {}
+            ) noexcept
+                : m_state(std::move(state)),
+                  m_host(std::move(host)),
+                  m_session(std::move(session)),
+                  m_applied(std::move(applied)) {}
+
+            auto Release() noexcept -> void;
+
+            std::shared_ptr<State> m_state;
+            std::string m_host;
+            std::unique_ptr<cpr::Session> m_session;
+            // what the session is currently configured with
+            Applied m_applied;
+        };
+
+        explicit ConnectionPool(ConnectionPoolOptions options = {});
+
+        ConnectionPool(const ConnectionPool&) = delete;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+        ConnectionPool(ConnectionPool&&) = delete;
+        ConnectionPool& operator=(ConnectionPool&&) = delete;
+        ~ConnectionPool() = default;
+
+        /**
+         * @brief Leases a session for the host of the passed URL.
+         *
+         * An idle session for the same scheme://host[:port] is reused when
+         * one is available; otherwise a new session is created.
+         *
+         * @param url The full URL the session will be used for.
+         */
+        [[nodiscard]]
+        auto Acquire(std::string_view url) -> Lease;
+
+        /**
+         * @return Handshake/reuse counters and the current idle session count.
+         */
+        [[nodiscard]]
+        auto Stats() const noexcept -> ConnectionPoolStats;
+
+        /**
+         * @brief Drops every idle session, closing their connections.
+         */
+        auto Clear() noexcept -> void;
+
+        [[nodiscard]]
+        auto GetOptions() const noexcept -> const ConnectionPoolOptions&;
+
+        /**
+         * @brief Returns the scheme://host[:port] part of a URL, used as pool key.
+         */
+        [[nodiscard]]
+        static auto HostKey(std::string_view url) noexcept -> std::string_view;
+
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // Implementation
+    struct ConnectionPool::State {
+        struct IdleSession {
+            std::unique_ptr<cpr::Session> session;
+            Lease::Applied applied;
+            std::chrono::steady_clock::time_point since;
+        };
+
+        explicit State(ConnectionPoolOptions opts) : options(std::move(opts)) {}
+
+        const ConnectionPoolOptions options;
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::vector<IdleSession>> idle;
+        std::atomic<std::uint64_t> handshakes{ 0 };
+        std::atomic<std::uint64_t> reuses{ 0 };
+        std::atomic<std::uint64_t> sessions_created{ 0 };
+    };
+
+    inline ConnectionPool::ConnectionPool(ConnectionPoolOptions options)
+        : m_state(std::make_shared<State>(std::move(options))) {}
+
+    inline auto ConnectionPool::HostKey(std::string_view url) noexcept -> std::string_view {
+        auto scheme_end = url.find("://");
+        auto authority_begin = scheme_end == std::string_view::npos ? 0 : scheme_end + 3;
+        auto authority_end = url.find_first_of("/?#", authority_begin);
+        return url.substr(0, authority_end);
+    }
+
+    inline auto ConnectionPool::Acquire(std::string_view url) -> Lease {
+        std::string host(HostKey(url));
+        const auto now = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(this->m_state->mutex);
+            auto it = this->m_state->idle.find(host);
+            if (it != this->m_state->idle.end()) {
+                auto& sessions = it->second;
+                while (!sessions.empty()) {
+                    auto entry = std::move(sessions.back());
+                    sessions.pop_back();
+                    if (now - entry.since <= this->m_state->options.idle_timeout) {
+                        // clear per-request state left over from the previous use
+                        entry.session->RemoveContent();
+                        entry.session->SetParameters(cpr::Parameters{});
+                        entry.session->SetWriteCallback(cpr::WriteCallback{});
+                        entry.session->SetReadCallback(cpr::ReadCallback{});
+                        // drop the progress callback a cancellable request set
+                        curl_easy_setopt(
+                            entry.session->GetCurlHolder()->handle,
+                            CURLOPT_NOPROGRESS,
+                            1L
+                        );
+                        return Lease(
+                            this->m_state,
+                            std::move(host),
+                            std::move(entry.session),
+                            std::move(entry.applied)
+                        );
+                    }
+                    // expired - drop it (and its connection) and keep looking
+                }
+            }
+        }
+
+        auto session = std::make_unique<cpr::Session>();
+        CURL* handle = session->GetCurlHolder()->handle;
+        const auto& options = this->m_state->options;
+        curl_easy_setopt(
+            handle,
+            CURLOPT_MAXAGE_CONN,
+            static_cast<long>(options.idle_timeout.count())
+        );
+        if (options.tcp_keep_alive) {
+            curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(
+                handle,
+                CURLOPT_TCP_KEEPIDLE,
+                static_cast<long>(options.keep_alive_idle.count())
+            );
+            curl_easy_setopt(
+                handle,
+                CURLOPT_TCP_KEEPINTVL,
+                static_cast<long>(options.keep_alive_interval.count())
+            );
+        }
+        this->m_state->sessions_created.fetch_add(1, std::memory_order_relaxed);
+
+        return Lease(this->m_state, std::move(host), std::move(session));
+    }
+
+    inline auto ConnectionPool::Stats() const noexcept -> ConnectionPoolStats {
+        ConnectionPoolStats stats;
+        stats.handshakes = this->m_state->handshakes.load(std::memory_order_relaxed);
+        stats.reuses = this->m_state->reuses.load(std::memory_order_relaxed);
+        stats.sessions_created = this->m_state->sessions_created.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(this->m_state->mutex);
+        for (const auto& [host, sessions] : this->m_state->idle) {
+            stats.idle_sessions += sessions.size();
+        }
+        return stats;
+    }
+
+    inline auto ConnectionPool::Clear() noexcept -> void {
+        std::lock_guard<std::mutex> lock(this->m_state->mutex);
+        this->m_state->idle.clear();
+    }
+
+    inline auto ConnectionPool::GetOptions() const noexcept -> const ConnectionPoolOptions& {
+        return this->m_state->options;
+    }
+
+    inline auto ConnectionPool::Lease::operator=(Lease&& old) noexcept -> Lease& {
+        if (this != &old) {
+            this->Release();
+            this->m_state = std::move(old.m_state);
+            this->m_host = std::move(old.m_host);
+            this->m_session = std::move(old.m_session);
+            this->m_applied = std::move(old.m_applied);
+        }
+        return *this;
+    }
+
+    inline ConnectionPool::Lease::~Lease() {
+        this->Release();
+    }
+
+    inline auto ConnectionPool::Lease::RecordTransfer() noexcept -> void {
+        if (!this->m_session || !this->m_state) {
+            return;
+        }
+
+        // CURLINFO_NUM_CONNECTS is the number of new connections the last
+        // transfer had to create; zero means an existing one was reused
+        long connects = 0;
+        curl_easy_getinfo(this->m_session->GetCurlHolder()->handle, CURLINFO_NUM_CONNECTS, &connects);
+        if (connects > 0) {
+            this->m_state->handshakes.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            this->m_state->reuses.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline auto ConnectionPool::Lease::SetUrl(std::string_view root, std::string_view endpoint)
+        -> void {
+        const std::string_view current = this->m_applied.url;
+        if (current.size() == root.size() + endpoint.size() && current.starts_with(root) &&
+            current.ends_with(endpoint)) {
+            return;
+        }
+
+        this->m_applied.url.assign(root).append(endpoint);
+        this->m_session->SetUrl(cpr::Url{ this->m_applied.url });
+    }
+
+    inline auto ConnectionPool::Lease::SetHeader(std::shared_ptr<const cpr::Header> headers)
+        -> void {
+        if (headers == this->m_applied.headers) {
+            return;
+        }
+
+        this->m_session->SetHeader(headers ? *headers : cpr::Header{});
+        this->m_applied.headers = std::move(headers);
+    }
+
+    inline auto ConnectionPool::Lease::Release() noexcept -> void {
+        if (!this->m_session || !this->m_state) {
+            return;
+        }
+
+        try {
+            std::lock_guard<std::mutex> lock(this->m_state->mutex);
+            auto& sessions = this->m_state->idle[this->m_host];
+            if (sessions.size() < this->m_state->options.max_idle_per_host) {
+                sessions.push_back({
+                    std::move(this->m_session),
+                    std::move(this->m_applied),
+                    std::chrono::steady_clock::now()
+                });
+            }
+        } catch (...) {
+            // allocation failure - let the session (and its connection) close
+        }
+
+        this->m_session.reset();
+        this->m_applied = {};
+        this->m_state.reset();
+    }
+
+} // namespace liboai
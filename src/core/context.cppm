@@ -0,0 +1,220 @@
+/**
+ * @file context.cppm
+ *
+ * liboai client context implementation.
+ * This module provides declarations for liboai::ClientContext, the
+ * state shared by every component class of a single liboai::OpenAI
+ * instance (such as its credentials, its connection pool, the
+ * executor running its asynchronous calls and, when selected, the
+ * event loop transport).
+ *
+ * Contexts share nothing with one another unless told to, so several
+ * clients - one per tenant, say - can live in the same process, each
+ * with its own key, organization, proxies, timeout and connections.
+ *
+ * Component classes constructed without a context fall back to the
+ * process-wide context returned by liboai::ClientContext::Default().
+ */
+
+module;
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+export module liboai:core.context;
+
+import :core.authorization;
+import :core.connection_pool;
+import :core.event_loop;
+import :core.executor;
+import :core.observer;
+import :core.rate_limiter;
+import :core.response_cache;
+import :core.response;
+import :core.retry;
+
+export namespace liboai {
+
+    /**
+     * @brief How the component classes of a context send their requests.
+     */
+    enum class TransportMode : std::uint8_t {
+        // each request blocks the thread sending it; *Async calls each
+        // occupy one executor thread for the duration of the request
+        Blocking,
+        // requests are driven by a liboai::EventLoop; *Async calls occupy
+        // no thread while they wait on the network
+        EventLoop
+    };
+
+    /**
+     * @brief Construction-time options for liboai::ClientContext.
+     */
+    struct ClientOptions {
+        ConnectionPoolOptions connection_pool{};
+        // executor running *Async calls; if null, a ThreadPoolExecutor
+        // configured with 'thread_pool' is created on first use
+        std::shared_ptr<Executor> executor = nullptr;
+        ThreadPoolOptions thread_pool{};
+        TransportMode transport = TransportMode::Blocking;
+        // number of loop threads used by TransportMode::EventLoop
+        std::size_t event_loop_threads = 1;
+        // when response bodies are parsed; JsonParsing::Lazy defers it to
+        // the first access of Response::raw_json or Response::operator[]
+        JsonParsing json_parsing = JsonParsing::Eager;
+        // credentials used by this context's requests; if null, the
+        // process-wide Authorization::Authorizer() is shared
+        std::shared_ptr<Authorization> authorization = nullptr;
+        // when and how failed requests are retried
+        RetryPolicy retry{};
+        // client-side requests/min and tokens/min limiting, shared by every
+        // component of the context
+        RateLimitOptions rate_limit{};
+        // serves repeated deterministic requests (embeddings, moderations,
+        // temperature-0 completions) without calling the API; may be
+        // shared between contexts. Null disables caching.
+        std::shared_ptr<ResponseCache> cache = nullptr;
+        // told of the start, first byte, streamed chunks and outcome of
+        // every request; e.g. a MetricsCollector. Null observes nothing.
+        std::shared_ptr<RequestObserver> observer = nullptr;
+    };
+
+    class ClientContext final {
+    public:
+        explicit ClientContext(ClientOptions options = {})
+            : m_options(std::move(options)),
+              m_pool(std::make_shared<ConnectionPool>(m_options.connection_pool)),
+              m_auth(
+                  m_options.authorization ?
+                      m_options.authorization :
+                      // non-owning; the singleton outlives every context
+                      std::shared_ptr<Authorization>(
+                          std::shared_ptr<Authorization>(),
+                          &Authorization::Authorizer()
+                      )
+              ),
+              m_retry(std::make_shared<RetryController>(m_options.retry)),
+              m_limiter(
+                  m_options.rate_limit.enabled ?
+                      std::make_shared<RateLimiter>(m_options.rate_limit) :
+                      nullptr
+              ) {}
+
+        ClientContext(const ClientContext&) = delete;
+        ClientContext& operator=(const ClientContext&) = delete;
+        ClientContext(ClientContext&&) = delete;
+        ClientContext& operator=(ClientContext&&) = delete;
+        ~ClientContext() = default;
+
+        /**
+         * @brief Returns the process-wide context used by component classes
+         *        that were not given one explicitly.
+         */
+        [[nodiscard]]
+        static auto Default() -> const std::shared_ptr<ClientContext>& {
+            static const std::shared_ptr<ClientContext> instance =
+                std::make_shared<ClientContext>();
+            return instance;
+        }
+
+        [[nodiscard]]
+        auto GetOptions() const noexcept -> const ClientOptions& {
+            return this->m_options;
+        }
+
+        /**
+         * @return The credentials used by every component of this context.
+         */
+        [[nodiscard]]
+        auto GetAuthorization() const noexcept -> Authorization& {
+            return *this->m_auth;
+        }
+
+        /**
+         * @return The controller deciding which of this context's failed
+         *         requests are retried.
+         */
+        [[nodiscard]]
+        auto GetRetryController() const noexcept -> const std::shared_ptr<RetryController>& {
+            return this->m_retry;
+        }
+
+        /**
+         * @return The rate limiter shared by every component of this
+         *         context, or null if ClientOptions::rate_limit disabled it.
+         */
+        [[nodiscard]]
+        auto GetRateLimiter() const noexcept -> const std::shared_ptr<RateLimiter>& {
+            return this->m_limiter;
+        }
+
+        /**
+         * @return The response cache of this context, or null if it has none.
+         */
+        [[nodiscard]]
+        auto GetResponseCache() const noexcept -> const std::shared_ptr<ResponseCache>& {
+            return this->m_options.cache;
+        }
+
+        /**
+         * @return The request observer of this context, or null if it has none.
+         */
+        [[nodiscard]]
+        auto GetObserver() const noexcept -> const std::shared_ptr<RequestObserver>& {
+            return this->m_options.observer;
+        }
+
+        /**
+         * @return The connection pool shared by every component of this context.
+         */
+        [[nodiscard]]
+        auto GetConnectionPool() const noexcept -> ConnectionPool& {
+            return *this->m_pool;
+        }
+
+        /**
+         * @return The executor that runs this context's *Async calls.
+         */
+        [[nodiscard]]
+        auto GetExecutor() const -> Executor& {
+            std::call_once(this->m_executor_once, [this] {
+                this->m_executor = this->m_options.executor ?
+                                       this->m_options.executor :
+                                       std::make_shared<ThreadPoolExecutor>(
+                                           this->m_options.thread_pool
+                                       );
+            });
+            return *this->m_executor;
+        }
+
+        /**
+         * @return The event loop driving this context's requests when
+         *         ClientOptions::transport is TransportMode::EventLoop.
+         *         Created on first use.
+         */
+        [[nodiscard]]
+        auto GetEventLoop() const -> EventLoop& {
+            std::call_once(this->m_event_loop_once, [this] {
+                this->m_event_loop =
+                    std::make_unique<EventLoop>(this->m_options.event_loop_threads);
+            });
+            return *this->m_event_loop;
+        }
+
+    private:
+        const ClientOptions m_options;
+        const std::shared_ptr<ConnectionPool> m_pool;
+        const std::shared_ptr<Authorization> m_auth;
+        const std::shared_ptr<RetryController> m_retry;
+        const std::shared_ptr<RateLimiter> m_limiter;
+        mutable std::once_flag m_executor_once;
+        mutable std::shared_ptr<Executor> m_executor;
+        mutable std::once_flag m_event_loop_once;
+        mutable std::unique_ptr<EventLoop> m_event_loop;
+    };
+
+} // namespace liboai
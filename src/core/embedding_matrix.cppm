@@ -0,0 +1,1046 @@
+/**
+ * @file embedding_matrix.cppm
+ *
+ * liboai embedding matrix implementation.
+ * This module provides declarations for liboai::EmbeddingMatrix, a
+ * typed view of the result of an embeddings request: one contiguous,
+ * row-major buffer of floats holding one row per input.
+ *
+ * The matrix is decoded straight from the response body. The
+ * 'data[].embedding' arrays are located with a minimal scanner and their
+ * numbers written directly into the buffer, without building a JSON
+ * document; bodies requested with encoding_format=base64 are decoded
+ * from base64 into the buffer's bytes, which is cheaper still and
+ * yields the exact float32 values the API computed. Base64 is decoded
+ * 16 to 64 characters at a time with SSSE3, AVX2 or NEON where the CPU
+ * has them, picked at startup like liboai::VectorKernels.
+ */
+
+module;
+
+#include <version>
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
+
+// Platform headers
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+// each decoder is compiled for its own ISA and chosen at runtime
+#define LIBOAI_VECTOR_TARGET(isa) __attribute__((target(isa)))
+#define LIBOAI_VECTOR_RUNTIME_DISPATCH 1
+#define LIBOAI_VECTOR_SSSE3 1
+#define LIBOAI_VECTOR_AVX2 1
+#else
+// only the ISAs enabled for the whole build (/arch) are available; this
+// includes clang-cl, whose __builtin_cpu_supports needs compiler-rt
+#define LIBOAI_VECTOR_TARGET(isa)
+#if defined(__AVX__)
+#define LIBOAI_VECTOR_SSSE3 1
+#endif
+#if defined(__AVX2__)
+#define LIBOAI_VECTOR_AVX2 1
+#endif
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LIBOAI_VECTOR_NEON 1
+#endif
+
+export module liboai:core.embedding_matrix;
+
+import :core.error;
+import :core.response;
+
+export namespace liboai {
+
+    class EmbeddingMatrix final {
+    public:
+        EmbeddingMatrix() = default;
+        EmbeddingMatrix(const EmbeddingMatrix&) = default;
+        EmbeddingMatrix& operator=(const EmbeddingMatrix&) = default;
+        EmbeddingMatrix(EmbeddingMatrix&&) noexcept = default;
+        EmbeddingMatrix& operator=(EmbeddingMatrix&&) noexcept = default;
+        ~EmbeddingMatrix() = default;
+
+        /**
+         * @brief Decodes the body of an embeddings response.
+         *
+         * Accepts embeddings encoded either as arrays of numbers or as
+         * base64 strings. Row i holds the embedding with index i; each
+         * index must appear exactly once.
+         */
+        [[nodiscard]]
+        static auto Parse(std::string_view body) -> Result<EmbeddingMatrix>;
+
+        /**
+         * @brief Decodes the content of an embeddings response. The
+         *        response's JSON is not accessed (nor, if deferred, parsed).
+         */
+        [[nodiscard]]
+        static auto FromResponse(const Response& response) -> Result<EmbeddingMatrix> {
+            return EmbeddingMatrix::Parse(response.content);
+        }
+
+        /**
+         * @brief Decodes another embeddings response body into this matrix,
+         *        its embedding with index i going to row 'row_offset' + i.
+         *
+         * Used to assemble the result of several batched requests. Rows
+         * are added as needed; every embedding must have the same length,
+         * and every index must be below 'row_limit' and appear only once
+         * (checked before any room is made for the row).
+         */
+        auto Merge(std::string_view body, std::size_t row_offset, std::size_t row_limit)
+            -> Result<void>;
+
+        /**
+         * @return Whether every row up to rows() was given an embedding.
+         */
+        [[nodiscard]]
+        auto complete() const noexcept -> bool {
+            return this->m_filled_rows == this->m_rows;
+        }
+
+        /**
+         * @brief Reserves room for 'rows' rows once their length is known.
+         */
+        auto Reserve(std::size_t rows) -> void;
+
+        [[nodiscard]]
+        auto rows() const noexcept -> std::size_t {
+            return this->m_rows;
+        }
+
+        [[nodiscard]]
+        auto dims() const noexcept -> std::size_t {
+            return this->m_dims;
+        }
+
+        [[nodiscard]]
+        auto empty() const noexcept -> bool {
+            return this->m_rows == 0;
+        }
+
+        /**
+         * @return Every row, back to back.
+         */
+        [[nodiscard]]
+        auto data() const noexcept -> std::span<const float> {
+            return this->m_data;
+        }
+
+        [[nodiscard]]
+        auto row(std::size_t i) const noexcept -> std::span<const float> {
+            return std::span<const float>(this->m_data).subspan(i * this->m_dims, this->m_dims);
+        }
+
+        [[nodiscard]]
+        auto operator[](std::size_t i) const noexcept -> std::span<const float> {
+            return this->row(i);
+        }
+
+#if defined(__cpp_lib_mdspan)
+        /**
+         * @return The matrix as a rows() x dims() mdspan.
+         */
+        [[nodiscard]]
+        auto view() const noexcept
+            -> std::mdspan<const float, std::dextents<std::size_t, 2>> {
+            // the pointer-and-extents constructor is explicit
+            return std::mdspan<const float, std::dextents<std::size_t, 2>>(
+                this->m_data.data(),
+                this->m_rows,
+                this->m_dims
+            );
+        }
+#endif
+
+        /**
+         * @brief Releases the buffer, e.g. to hand it to another container.
+         */
+        [[nodiscard]]
+        auto release() && noexcept -> std::vector<float> {
+            this->m_rows = this->m_dims = this->m_filled_rows = 0;
+            this->m_filled.clear();
+            return std::move(this->m_data);
+        }
+
+        [[nodiscard]]
+        auto GetModel() const noexcept -> const std::string& {
+            return this->m_model;
+        }
+
+        [[nodiscard]]
+        auto GetPromptTokens() const noexcept -> std::uint64_t {
+            return this->m_prompt_tokens;
+        }
+
+        [[nodiscard]]
+        auto GetTotalTokens() const noexcept -> std::uint64_t {
+            return this->m_total_tokens;
+        }
+
+    private:
+        using Iter = const char*;
+
+        // minimal JSON scanning; each advances 'p' past what it consumed
+        static auto SkipWs(Iter& p, Iter end) noexcept -> void;
+        static auto SkipString(Iter& p, Iter end) noexcept -> bool;
+        static auto SkipValue(Iter& p, Iter end) noexcept -> bool;
+        static auto ReadString(Iter& p, Iter end, std::string_view& out) noexcept -> bool;
+        static auto ReadUnsigned(Iter& p, Iter end, std::uint64_t& out) noexcept -> bool;
+        static auto ReadFloat(Iter& p, Iter end, float& out) noexcept -> bool;
+
+        auto ParseData(Iter& p, Iter end, std::size_t row_offset, std::size_t row_limit)
+            -> Result<void>;
+        auto ParseUsage(Iter& p, Iter end) -> Result<void>;
+        // decodes one embedding into 'out', which must hold exactly its values
+        auto DecodeEmbedding(Iter& p, Iter end, std::span<float> out) -> Result<void>;
+        // decodes one embedding of yet unknown length into m_scratch
+        auto DecodeEmbedding(Iter& p, Iter end) -> Result<void>;
+        // the row of the embedding with 'index', which must not be placed yet
+        auto PlaceRow(std::size_t row_offset, std::uint64_t index, std::size_t row_limit)
+            -> Result<std::span<float>>;
+
+        /**
+         * @brief Decodes base64 'in' into exactly out.size() bytes.
+         */
+        [[nodiscard]]
+        static auto DecodeBase64(std::string_view in, std::span<unsigned char> out) noexcept
+            -> bool;
+        [[nodiscard]]
+        static auto Base64Size(std::string_view in) noexcept -> std::size_t;
+
+        // decodes whole blocks of 'size' base64 characters (no padding) from
+        // 'in' into 'out', stopping at the first block holding anything
+        // else; returns the characters decoded, a multiple of 4
+        using BlockDecoder =
+            std::size_t (*)(const unsigned char* in, std::size_t size, unsigned char* out) noexcept;
+
+        [[nodiscard]]
+        static auto Decoder() noexcept -> BlockDecoder {
+            static const BlockDecoder decoder = SelectDecoder();
+            return decoder;
+        }
+
+        // nullptr when only the scalar decoder is available
+        static auto SelectDecoder() noexcept -> BlockDecoder;
+#if defined(LIBOAI_VECTOR_SSSE3)
+        LIBOAI_VECTOR_TARGET("ssse3")
+        static auto DecodeBlocksSsse3(const unsigned char* in, std::size_t size, unsigned char* out)
+            noexcept -> std::size_t;
+#endif
+#if defined(LIBOAI_VECTOR_AVX2)
+        LIBOAI_VECTOR_TARGET("avx2")
+        static auto DecodeBlocksAvx2(const unsigned char* in, std::size_t size, unsigned char* out)
+            noexcept -> std::size_t;
+#endif
+#if defined(LIBOAI_VECTOR_NEON)
+        static auto DecodeBlocksNeon(const unsigned char* in, std::size_t size, unsigned char* out)
+            noexcept -> std::size_t;
+#endif
+
+        std::vector<float> m_data;
+        std::size_t m_rows = 0, m_dims = 0, m_reserve_rows = 0, m_filled_rows = 0;
+        std::vector<bool> m_filled;
+        std::string m_model;
+        std::uint64_t m_prompt_tokens = 0, m_total_tokens = 0;
+        // an embedding decoded before its row or length was known
+        std::vector<float> m_scratch;
+    };
+
+    // Implementation
+    inline auto EmbeddingMatrix::Parse(std::string_view body) -> Result<EmbeddingMatrix> {
+        // every entry names its embedding, so none can have a higher index
+        std::size_t entries = 0;
+        for (auto at = body.find("\"embedding\""); at != std::string_view::npos;
+             at = body.find("\"embedding\"", at + 1)) {
+            ++entries;
+        }
+
+        EmbeddingMatrix matrix;
+        if (auto merged = matrix.Merge(body, 0, entries); !merged) {
+            return std::unexpected(merged.error());
+        }
+        if (!matrix.complete()) {
+            return std::unexpected(
+                OpenAIError::parse_error("Embeddings 'data' array is missing an index")
+            );
+        }
+        return matrix;
+    }
+
+    inline auto EmbeddingMatrix::Reserve(std::size_t rows) -> void {
+        this->m_reserve_rows = rows;
+        if (this->m_dims != 0) {
+            this->m_data.reserve(rows * this->m_dims);
+        }
+    }
+
+    inline auto EmbeddingMatrix::Merge(
+        std::string_view body,
+        std::size_t row_offset,
+        std::size_t row_limit
+    ) -> Result<void> {
+        const auto malformed = [] {
+            return std::unexpected(OpenAIError::parse_error("Malformed embeddings response"));
+        };
+
+        Iter p = body.data();
+        const Iter end = body.data() + body.size();
+
+        SkipWs(p, end);
+        if (p == end || *p != '{') {
+            return malformed();
+        }
+        ++p;
+
+        while (true) {
+            SkipWs(p, end);
+            if (p != end && *p == '}') {
+                break;
+            }
+
+            std::string_view key;
+            if (!ReadString(p, end, key)) {
+                return malformed();
+            }
+            SkipWs(p, end);
+            if (p == end || *p != ':') {
+                return malformed();
+            }
+            ++p;
+            SkipWs(p, end);
+
+            if (key == "data") {
+                if (auto parsed = this->ParseData(p, end, row_offset, row_limit); !parsed) {
+                    return parsed;
+                }
+            } else if (key == "usage") {
+                if (auto parsed = this->ParseUsage(p, end); !parsed) {
+                    return parsed;
+                }
+            } else if (key == "model" && p != end && *p == '"') {
+                std::string_view model;
+                if (!ReadString(p, end, model)) {
+                    return malformed();
+                }
+                this->m_model.assign(model);
+            } else if (!SkipValue(p, end)) {
+                return malformed();
+            }
+
+            SkipWs(p, end);
+            if (p != end && *p == ',') {
+                ++p;
+            } else if (p != end && *p == '}') {
+                break;
+            } else {
+                return malformed();
+            }
+        }
+        return {};
+    }
+
+    inline auto EmbeddingMatrix::ParseData(
+        Iter& p,
+        Iter end,
+        std::size_t row_offset,
+        std::size_t row_limit
+    ) -> Result<void> {
+        const auto malformed = [] {
+            return std::unexpected(OpenAIError::parse_error("Malformed embeddings 'data' array"));
+        };
+
+        if (p == end || *p != '[') {
+            return malformed();
+        }
+        ++p;
+
+        for (std::size_t position = 0;; ++position) {
+            SkipWs(p, end);
+            if (p != end && *p == ']') {
+                ++p;
+                return {};
+            }
+            if (p == end || *p != '{') {
+                return malformed();
+            }
+            ++p;
+
+            // 'index' normally precedes 'embedding'; if it does not, the
+            // embedding is decoded aside and moved into place afterwards
+            std::uint64_t index = position;
+            bool have_index = false, have_embedding = false, in_scratch = false;
+
+            while (true) {
+                SkipWs(p, end);
+                if (p != end && *p == '}') {
+                    ++p;
+                    break;
+                }
+
+                std::string_view key;
+                if (!ReadString(p, end, key)) {
+                    return malformed();
+                }
+                SkipWs(p, end);
+                if (p == end || *p != ':') {
+                    return malformed();
+                }
+                ++p;
+                SkipWs(p, end);
+
+                if (key == "index") {
+                    if (!ReadUnsigned(p, end, index)) {
+                        return malformed();
+                    }
+                    have_index = true;
+                } else if (key == "embedding") {
+                    if (have_index && this->m_dims != 0) {
+                        auto row = this->PlaceRow(row_offset, index, row_limit);
+                        if (!row) {
+                            return std::unexpected(row.error());
+                        }
+                        if (auto decoded = this->DecodeEmbedding(p, end, *row); !decoded) {
+                            return decoded;
+                        }
+                    } else {
+                        if (auto decoded = this->DecodeEmbedding(p, end); !decoded) {
+                            return decoded;
+                        }
+                        in_scratch = true;
+                    }
+                    have_embedding = true;
+                } else if (!SkipValue(p, end)) {
+                    return malformed();
+                }
+
+                SkipWs(p, end);
+                if (p != end && *p == ',') {
+                    ++p;
+                } else if (p != end && *p == '}') {
+                    ++p;
+                    break;
+                } else {
+                    return malformed();
+                }
+            }
+
+            if (!have_embedding) {
+                return std::unexpected(
+                    OpenAIError::parse_error("Embeddings 'data' entry has no embedding")
+                );
+            }
+            if (in_scratch) {
+                if (this->m_dims == 0) {
+                    this->m_dims = this->m_scratch.size();
+                    this->m_data.reserve(
+                        std::max<std::size_t>(this->m_reserve_rows, 1) * this->m_dims
+                    );
+                } else if (this->m_scratch.size() != this->m_dims) {
+                    return std::unexpected(
+                        OpenAIError::parse_error("Embeddings differ in length")
+                    );
+                }
+                auto row = this->PlaceRow(row_offset, index, row_limit);
+                if (!row) {
+                    return std::unexpected(row.error());
+                }
+                std::copy(this->m_scratch.begin(), this->m_scratch.end(), row->begin());
+            }
+
+            SkipWs(p, end);
+            if (p != end && *p == ',') {
+                ++p;
+            } else if (p == end || *p != ']') {
+                return malformed();
+            }
+        }
+    }
+
+    inline auto EmbeddingMatrix::ParseUsage(Iter& p, Iter end) -> Result<void> {
+        if (p == end || *p != '{') {
+            // e.g. null
+            if (SkipValue(p, end)) {
+                return {};
+            }
+            return std::unexpected(OpenAIError::parse_error("Malformed embeddings 'usage'"));
+        }
+        ++p;
+
+        while (true) {
+            SkipWs(p, end);
+            if (p != end && *p == '}') {
+                ++p;
+                return {};
+            }
+
+            std::string_view key;
+            if (!ReadString(p, end, key)) {
+                break;
+            }
+            SkipWs(p, end);
+            if (p == end || *p != ':') {
+                break;
+            }
+            ++p;
+            SkipWs(p, end);
+
+            std::uint64_t value = 0;
+            if (key == "prompt_tokens" && ReadUnsigned(p, end, value)) {
+                this->m_prompt_tokens += value;
+            } else if (key == "total_tokens" && ReadUnsigned(p, end, value)) {
+                this->m_total_tokens += value;
+            } else if (!SkipValue(p, end)) {
+                break;
+            }
+
+            SkipWs(p, end);
+            if (p != end && *p == ',') {
+                ++p;
+            } else if (p != end && *p == '}') {
+                ++p;
+                return {};
+            } else {
+                break;
+            }
+        }
+        return std::unexpected(OpenAIError::parse_error("Malformed embeddings 'usage'"));
+    }
+
+    inline auto EmbeddingMatrix::PlaceRow(
+        std::size_t row_offset,
+        std::uint64_t index,
+        std::size_t row_limit
+    ) -> Result<std::span<float>> {
+        // checked before resizing, as the index comes from the response
+        if (index >= row_limit) {
+            return std::unexpected(
+                OpenAIError::parse_error("Embeddings 'data' index out of range")
+            );
+        }
+        const auto row = row_offset + static_cast<std::size_t>(index);
+        if (row >= this->m_rows) {
+            this->m_rows = row + 1;
+            this->m_data.resize(this->m_rows * this->m_dims);
+            this->m_filled.resize(this->m_rows, false);
+        }
+        if (this->m_filled[row]) {
+            return std::unexpected(
+                OpenAIError::parse_error("Embeddings 'data' repeats an index")
+            );
+        }
+        this->m_filled[row] = true;
+        this->m_filled_rows += 1;
+        return std::span<float>(this->m_data).subspan(row * this->m_dims, this->m_dims);
+    }
+
+    inline auto EmbeddingMatrix::DecodeEmbedding(Iter& p, Iter end, std::span<float> out)
+        -> Result<void> {
+        if (p != end && *p == '"') {
+            std::string_view encoded;
+            if (!ReadString(p, end, encoded)) {
+                return std::unexpected(OpenAIError::parse_error("Malformed base64 embedding"));
+            }
+            if (Base64Size(encoded) != out.size_bytes() ||
+                !DecodeBase64(
+                    encoded,
+                    { reinterpret_cast<unsigned char*>(out.data()), out.size_bytes() }
+                )) {
+                return std::unexpected(
+                    OpenAIError::parse_error("Base64 embedding has an unexpected length")
+                );
+            }
+            if constexpr (std::endian::native == std::endian::big) {
+                // the API sends little-endian float32
+                for (auto& value : out) {
+                    value =
+                        std::bit_cast<float>(std::byteswap(std::bit_cast<std::uint32_t>(value)));
+                }
+            }
+            return {};
+        }
+
+        if (p == end || *p != '[') {
+            return std::unexpected(OpenAIError::parse_error("Malformed embedding"));
+        }
+        ++p;
+
+        std::size_t count = 0;
+        while (true) {
+            SkipWs(p, end);
+            if (p != end && *p == ']') {
+                ++p;
+                break;
+            }
+            float value = 0.0f;
+            if (count == out.size() || !ReadFloat(p, end, value)) {
+                return std::unexpected(
+                    OpenAIError::parse_error("Embedding has an unexpected length")
+                );
+            }
+            out[count++] = value;
+
+            SkipWs(p, end);
+            if (p != end && *p == ',') {
+                ++p;
+            }
+        }
+
+        if (count != out.size()) {
+            return std::unexpected(OpenAIError::parse_error("Embeddings differ in length"));
+        }
+        return {};
+    }
+
+    inline auto EmbeddingMatrix::DecodeEmbedding(Iter& p, Iter end) -> Result<void> {
+        this->m_scratch.clear();
+
+        if (p != end && *p == '"') {
+            Iter q = p;
+            std::string_view encoded;
+            if (!ReadString(q, end, encoded) || Base64Size(encoded) % sizeof(float) != 0) {
+                return std::unexpected(OpenAIError::parse_error("Malformed base64 embedding"));
+            }
+            this->m_scratch.resize(Base64Size(encoded) / sizeof(float));
+            return this->DecodeEmbedding(p, end, this->m_scratch);
+        }
+
+        if (p == end || *p != '[') {
+            return std::unexpected(OpenAIError::parse_error("Malformed embedding"));
+        }
+        ++p;
+
+        while (true) {
+            SkipWs(p, end);
+            if (p != end && *p == ']') {
+                ++p;
+                return {};
+            }
+            float value = 0.0f;
+            if (!ReadFloat(p, end, value)) {
+                return std::unexpected(OpenAIError::parse_error("Malformed embedding"));
+            }
+            this->m_scratch.push_back(value);
+
+            SkipWs(p, end);
+            if (p != end && *p == ',') {
+                ++p;
+            }
+        }
+    }
+
+    inline auto EmbeddingMatrix::SkipWs(Iter& p, Iter end) noexcept -> void {
+        while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+            ++p;
+        }
+    }
+
+    inline auto EmbeddingMatrix::SkipString(Iter& p, Iter end) noexcept -> bool {
+        ++p; // opening quote
+        while (p != end) {
+            if (*p == '\\') {
+                p += (end - p >= 2) ? 2 : 1;
+            } else if (*p++ == '"') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline auto EmbeddingMatrix::ReadString(Iter& p, Iter end, std::string_view& out) noexcept
+        -> bool {
+        if (p == end || *p != '"') {
+            return false;
+        }
+        const Iter begin = p + 1;
+        if (!SkipString(p, end)) {
+            return false;
+        }
+        // raw (still escaped) contents; the strings read here never need unescaping
+        out = std::string_view(begin, static_cast<std::size_t>(p - 1 - begin));
+        return true;
+    }
+
+    inline auto EmbeddingMatrix::SkipValue(Iter& p, Iter end) noexcept -> bool {
+        if (p == end) {
+            return false;
+        }
+        if (*p == '"') {
+            return SkipString(p, end);
+        }
+        if (*p != '{' && *p != '[') {
+            // number or literal
+            while (p != end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' &&
+                   *p != '\r' && *p != '\t') {
+                ++p;
+            }
+            return true;
+        }
+
+        std::size_t depth = 0;
+        while (p != end) {
+            if (*p == '"') {
+                if (!SkipString(p, end)) {
+                    return false;
+                }
+                continue;
+            }
+            if (*p == '{' || *p == '[') {
+                ++depth;
+            } else if (*p == '}' || *p == ']') {
+                if (--depth == 0) {
+                    ++p;
+                    return true;
+                }
+            }
+            ++p;
+        }
+        return false;
+    }
+
+    inline auto EmbeddingMatrix::ReadUnsigned(Iter& p, Iter end, std::uint64_t& out) noexcept
+        -> bool {
+        const auto [ptr, ec] = std::from_chars(p, end, out);
+        if (ec != std::errc{}) {
+            return false;
+        }
+        p = ptr;
+        return true;
+    }
+
+    inline auto EmbeddingMatrix::ReadFloat(Iter& p, Iter end, float& out) noexcept -> bool {
+#if defined(__cpp_lib_to_chars)
+        const auto [ptr, ec] = std::from_chars(p, end, out);
+        if (ec != std::errc{}) {
+            return false;
+        }
+        p = ptr;
+        return true;
+#else
+        // no floating-point from_chars; strtof stops at the ',' or ']'
+        // that always follows a number inside an embedding array
+        char* stop = nullptr;
+        out = std::strtof(p, &stop);
+        if (stop == p || stop > end) {
+            return false;
+        }
+        p = stop;
+        return true;
+#endif
+    }
+
+    inline auto EmbeddingMatrix::Base64Size(std::string_view in) noexcept -> std::size_t {
+        if (in.size() % 4 != 0) {
+            return 0; // not base64; rejected by DecodeBase64
+        }
+        std::size_t padding = 0;
+        if (!in.empty() && in.back() == '=') {
+            ++padding;
+            if (in.size() > 1 && in[in.size() - 2] == '=') {
+                ++padding;
+            }
+        }
+        return in.size() / 4 * 3 - padding;
+    }
+
+    inline auto
+    EmbeddingMatrix::DecodeBase64(std::string_view in, std::span<unsigned char> out) noexcept
+        -> bool {
+        // 6-bit value of each character; 0x100 marks characters outside the alphabet
+        static constexpr auto table = [] {
+            std::array<std::uint32_t, 256> t{};
+            t.fill(0x100);
+            constexpr std::string_view alphabet =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (std::size_t i = 0; i < alphabet.size(); ++i) {
+                t[static_cast<unsigned char>(alphabet[i])] = static_cast<std::uint32_t>(i);
+            }
+            return t;
+        }();
+
+        if (in.size() % 4 != 0) {
+            return false;
+        }
+
+        const auto* src = reinterpret_cast<const unsigned char*>(in.data());
+        unsigned char* dst = out.data();
+        std::size_t quads = in.size() / 4;
+        const bool padded = quads > 0 && in.back() == '=';
+        if (padded) {
+            --quads; // the final, padded quad is decoded separately
+        }
+
+        // as much as the vector decoder takes, then two quads (8 characters
+        // -> 6 bytes) per iteration, with a single validity check for both
+        std::size_t q = 0;
+        if (const auto decoder = Decoder()) {
+            const auto decoded = decoder(src, quads * 4, dst);
+            q = decoded / 4;
+            src += decoded;
+            dst += q * 3;
+        }
+        for (; q + 2 <= quads; q += 2, src += 8, dst += 6) {
+            const std::uint32_t a0 = table[src[0]], a1 = table[src[1]], a2 = table[src[2]],
+                                a3 = table[src[3]], b0 = table[src[4]], b1 = table[src[5]],
+                                b2 = table[src[6]], b3 = table[src[7]];
+            if ((a0 | a1 | a2 | a3 | b0 | b1 | b2 | b3) & 0x100) {
+                return false;
+            }
+            const std::uint32_t a = a0 << 18 | a1 << 12 | a2 << 6 | a3;
+            const std::uint32_t b = b0 << 18 | b1 << 12 | b2 << 6 | b3;
+            dst[0] = static_cast<unsigned char>(a >> 16);
+            dst[1] = static_cast<unsigned char>(a >> 8);
+            dst[2] = static_cast<unsigned char>(a);
+            dst[3] = static_cast<unsigned char>(b >> 16);
+            dst[4] = static_cast<unsigned char>(b >> 8);
+            dst[5] = static_cast<unsigned char>(b);
+        }
+        for (; q < quads; ++q, src += 4, dst += 3) {
+            const std::uint32_t c0 = table[src[0]], c1 = table[src[1]], c2 = table[src[2]],
+                                c3 = table[src[3]];
+            if ((c0 | c1 | c2 | c3) & 0x100) {
+                return false;
+            }
+            const std::uint32_t c = c0 << 18 | c1 << 12 | c2 << 6 | c3;
+            dst[0] = static_cast<unsigned char>(c >> 16);
+            dst[1] = static_cast<unsigned char>(c >> 8);
+            dst[2] = static_cast<unsigned char>(c);
+        }
+
+        if (padded) {
+            const std::uint32_t c0 = table[src[0]], c1 = table[src[1]];
+            const std::uint32_t c2 = src[2] == '=' ? 0 : table[src[2]];
+            if ((c0 | c1 | c2) & 0x100) {
+                return false;
+            }
+            const std::uint32_t c = c0 << 18 | c1 << 12 | c2 << 6;
+            *dst++ = static_cast<unsigned char>(c >> 16);
+            if (src[2] != '=') {
+                *dst++ = static_cast<unsigned char>(c >> 8);
+            }
+        }
+
+        return dst == out.data() + out.size();
+    }
+
+    inline auto EmbeddingMatrix::SelectDecoder() noexcept -> BlockDecoder {
+#if defined(LIBOAI_VECTOR_RUNTIME_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return &EmbeddingMatrix::DecodeBlocksAvx2;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return &EmbeddingMatrix::DecodeBlocksSsse3;
+        }
+#elif defined(LIBOAI_VECTOR_AVX2)
+        return &EmbeddingMatrix::DecodeBlocksAvx2;
+#elif defined(LIBOAI_VECTOR_SSSE3)
+        return &EmbeddingMatrix::DecodeBlocksSsse3;
+#elif defined(LIBOAI_VECTOR_NEON)
+        return &EmbeddingMatrix::DecodeBlocksNeon;
+#endif
+        return nullptr;
+    }
+
+    // The vector decoders classify each character by its two nibbles: a
+    // character is base64 when lut_lo[lo] & lut_hi[hi] is zero, and
+    // lut_roll[hi] (lut_roll[1] for '/') turns it into its 6-bit value.
+    // The values are then packed from 4 x 6 bits into 3 bytes.
+
+#if defined(LIBOAI_VECTOR_SSSE3)
+    LIBOAI_VECTOR_TARGET("ssse3")
+    inline auto EmbeddingMatrix::DecodeBlocksSsse3(
+        const unsigned char* in,
+        std::size_t size,
+        unsigned char* out
+    ) noexcept -> std::size_t {
+        const __m128i lut_lo = _mm_setr_epi8(
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+        );
+        const __m128i lut_hi = _mm_setr_epi8(
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+        );
+        const __m128i lut_roll =
+            _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i pack =
+            _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+        const __m128i mask_2f = _mm_set1_epi8(0x2F);
+
+        std::size_t done = 0;
+        for (; done + 16 <= size; done += 16, out += 12) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+            const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), mask_2f);
+            const __m128i lo_nibbles = _mm_and_si128(chars, mask_2f);
+            const __m128i invalid = _mm_and_si128(
+                _mm_shuffle_epi8(lut_lo, lo_nibbles),
+                _mm_shuffle_epi8(lut_hi, hi_nibbles)
+            );
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF) {
+                break;
+            }
+            const __m128i roll = _mm_shuffle_epi8(
+                lut_roll,
+                _mm_add_epi8(_mm_cmpeq_epi8(chars, mask_2f), hi_nibbles)
+            );
+            chars = _mm_add_epi8(chars, roll);
+
+            const __m128i merged = _mm_madd_epi16(
+                _mm_maddubs_epi16(chars, _mm_set1_epi32(0x01400140)),
+                _mm_set1_epi32(0x00011000)
+            );
+            const __m128i bytes = _mm_shuffle_epi8(merged, pack);
+            // exactly 12 bytes, so the last block does not write past 'out'
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+            const auto tail =
+                static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+            std::memcpy(out + 8, &tail, sizeof(tail));
+        }
+        return done;
+    }
+#endif
+
+#if defined(LIBOAI_VECTOR_AVX2)
+    LIBOAI_VECTOR_TARGET("avx2")
+    inline auto EmbeddingMatrix::DecodeBlocksAvx2(
+        const unsigned char* in,
+        std::size_t size,
+        unsigned char* out
+    ) noexcept -> std::size_t {
+        // the byte shuffles work per 128-bit lane, so each table is repeated
+        const __m256i lut_lo = _mm256_setr_epi8(
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+        );
+        const __m256i lut_hi = _mm256_setr_epi8(
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+        );
+        const __m256i lut_roll = _mm256_setr_epi8(
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+        );
+        const __m256i pack = _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+        );
+        const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+
+        std::size_t done = 0;
+        for (; done + 32 <= size; done += 32, out += 24) {
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + done));
+            const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(chars, 4), mask_2f);
+            const __m256i lo_nibbles = _mm256_and_si256(chars, mask_2f);
+            if (!_mm256_testz_si256(
+                    _mm256_shuffle_epi8(lut_lo, lo_nibbles),
+                    _mm256_shuffle_epi8(lut_hi, hi_nibbles)
+                )) {
+                break;
+            }
+            const __m256i roll = _mm256_shuffle_epi8(
+                lut_roll,
+                _mm256_add_epi8(_mm256_cmpeq_epi8(chars, mask_2f), hi_nibbles)
+            );
+            chars = _mm256_add_epi8(chars, roll);
+
+            const __m256i merged = _mm256_madd_epi16(
+                _mm256_maddubs_epi16(chars, _mm256_set1_epi32(0x01400140)),
+                _mm256_set1_epi32(0x00011000)
+            );
+            // 12 bytes per lane, moved next to each other
+            const __m256i bytes = _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(merged, pack),
+                _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)
+            );
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+            _mm_storel_epi64(
+                reinterpret_cast<__m128i*>(out + 16),
+                _mm256_extracti128_si256(bytes, 1)
+            );
+        }
+        return done;
+    }
+#endif
+
+#if defined(LIBOAI_VECTOR_NEON)
+    inline auto EmbeddingMatrix::DecodeBlocksNeon(
+        const unsigned char* in,
+        std::size_t size,
+        unsigned char* out
+    ) noexcept -> std::size_t {
+        static constexpr std::uint8_t lo_table[16] = {
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+        };
+        static constexpr std::uint8_t hi_table[16] = {
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+        };
+        // -65 and -71 as bytes; the additions wrap
+        static constexpr std::uint8_t roll_table[16] = {
+            0, 16, 19, 4, 191, 191, 185, 185, 0, 0, 0, 0, 0, 0, 0, 0
+        };
+        const uint8x16_t lut_lo = vld1q_u8(lo_table);
+        const uint8x16_t lut_hi = vld1q_u8(hi_table);
+        const uint8x16_t lut_roll = vld1q_u8(roll_table);
+
+        // the nibbles are split exactly, so no index exceeds the tables
+        const auto translate = [&](uint8x16_t& chars) -> bool {
+            const uint8x16_t hi_nibbles = vshrq_n_u8(chars, 4);
+            const uint8x16_t lo_nibbles = vandq_u8(chars, vdupq_n_u8(0x0F));
+            const uint8x16_t invalid =
+                vandq_u8(vqtbl1q_u8(lut_lo, lo_nibbles), vqtbl1q_u8(lut_hi, hi_nibbles));
+            if (vmaxvq_u8(invalid) != 0) {
+                return false;
+            }
+            const uint8x16_t slash = vceqq_u8(chars, vdupq_n_u8(0x2F));
+            chars = vaddq_u8(chars, vqtbl1q_u8(lut_roll, vaddq_u8(slash, hi_nibbles)));
+            return true;
+        };
+
+        std::size_t done = 0;
+        for (; done + 64 <= size; done += 64, out += 48) {
+            // character i of every quad goes to chars.val[i]
+            uint8x16x4_t chars = vld4q_u8(in + done);
+            if (!translate(chars.val[0]) || !translate(chars.val[1]) ||
+                !translate(chars.val[2]) || !translate(chars.val[3])) {
+                break;
+            }
+            uint8x16x3_t bytes;
+            bytes.val[0] = vorrq_u8(vshlq_n_u8(chars.val[0], 2), vshrq_n_u8(chars.val[1], 4));
+            bytes.val[1] = vorrq_u8(vshlq_n_u8(chars.val[1], 4), vshrq_n_u8(chars.val[2], 2));
+            bytes.val[2] = vorrq_u8(vshlq_n_u8(chars.val[2], 6), chars.val[3]);
+            vst3q_u8(out, bytes);
+        }
+        return done;
+    }
+#endif
+
+} // namespace liboai
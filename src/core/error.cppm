@@ -16,6 +16,7 @@ module;
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 export module liboai:core.error;
 
@@ -34,19 +35,25 @@ export namespace liboai {
         RateLimited = 1004,
         ConnectionError = 1005,
         FileError = 1006,
-        CURLError = 1007
+        CURLError = 1007,
+        Rejected = 1008,
+        Cancelled = 1009,
+        DeadlineExceeded = 1010
     };
 
     inline auto GetHttpStatus(ErrorCode code) -> int {
         static const std::unordered_map<ErrorCode, int> status_map = {
-            {         ErrorCode::Success, 200 },
-            {  ErrorCode::FailureToParse,   0 },
-            {      ErrorCode::BadRequest, 400 },
-            {        ErrorCode::APIError, 500 },
-            {     ErrorCode::RateLimited, 429 },
-            { ErrorCode::ConnectionError,   0 },
-            {       ErrorCode::FileError,   0 },
-            {       ErrorCode::CURLError,   0 },
+            {          ErrorCode::Success, 200 },
+            {   ErrorCode::FailureToParse,   0 },
+            {       ErrorCode::BadRequest, 400 },
+            {         ErrorCode::APIError, 500 },
+            {      ErrorCode::RateLimited, 429 },
+            {  ErrorCode::ConnectionError,   0 },
+            {        ErrorCode::FileError,   0 },
+            {        ErrorCode::CURLError,   0 },
+            {         ErrorCode::Rejected,   0 },
+            {        ErrorCode::Cancelled,   0 },
+            { ErrorCode::DeadlineExceeded,   0 },
         };
         auto it = status_map.find(code);
         return it != status_map.end() ? it->second : 0;
@@ -54,14 +61,17 @@ export namespace liboai {
 
     inline auto GetErrorMessage(ErrorCode code) -> std::string {
         static const std::unordered_map<ErrorCode, std::string> message_map = {
-            {         ErrorCode::Success,                  "Success" },
-            {  ErrorCode::FailureToParse, "Failed to parse response" },
-            {      ErrorCode::BadRequest,              "Bad request" },
-            {        ErrorCode::APIError,                "API error" },
-            {     ErrorCode::RateLimited,             "Rate limited" },
-            { ErrorCode::ConnectionError,         "Connection error" },
-            {       ErrorCode::FileError,               "File error" },
-            {       ErrorCode::CURLError,               "CURL error" },
+            {          ErrorCode::Success,                  "Success" },
+            {   ErrorCode::FailureToParse, "Failed to parse response" },
+            {       ErrorCode::BadRequest,              "Bad request" },
+            {         ErrorCode::APIError,                "API error" },
+            {      ErrorCode::RateLimited,             "Rate limited" },
+            {  ErrorCode::ConnectionError,         "Connection error" },
+            {        ErrorCode::FileError,               "File error" },
+            {        ErrorCode::CURLError,               "CURL error" },
+            {         ErrorCode::Rejected,         "Request rejected" },
+            {        ErrorCode::Cancelled,        "Request cancelled" },
+            { ErrorCode::DeadlineExceeded,        "Deadline exceeded" },
         };
         auto it = message_map.find(code);
         return it != message_map.end() ? it->second : "Unknown error";
@@ -96,6 +106,8 @@ export namespace liboai {
         std::string message;
         int http_status = 0;
         std::optional<std::chrono::seconds> retry_after;
+        // the same wait without rounding, when the server gave it
+        std::optional<std::chrono::milliseconds> retry_after_ms;
 
         OpenAIError() = default;
 
@@ -103,7 +115,8 @@ export namespace liboai {
             : code(c),
               message(GetErrorMessage(c)),
               http_status(GetHttpStatus(c)),
-              retry_after(std::nullopt) {}
+              retry_after(std::nullopt),
+              retry_after_ms(std::nullopt) {}
 
         OpenAIError(
             ErrorCode c,
@@ -152,6 +165,18 @@ export namespace liboai {
         static OpenAIError curl_error(std::string msg) {
             return { ErrorCode::CURLError, std::move(msg) };
         }
+
+        static OpenAIError rejected(std::string msg) {
+            return { ErrorCode::Rejected, std::move(msg) };
+        }
+
+        static OpenAIError cancelled(std::string msg) {
+            return { ErrorCode::Cancelled, std::move(msg) };
+        }
+
+        static OpenAIError deadline_exceeded(std::string msg) {
+            return { ErrorCode::DeadlineExceeded, std::move(msg) };
+        }
     };
 
     /**
@@ -176,4 +201,15 @@ export namespace liboai {
         return std::unexpected(result.error());
     }
 
+    /**
+     * @brief Wraps an already available result in a ready FutureExpected.
+     */
+    template <typename T>
+    [[nodiscard]]
+    auto MakeReadyFuture(Result<T> result) -> FutureExpected<T> {
+        std::promise<Result<T>> promise;
+        promise.set_value(std::move(result));
+        return promise.get_future();
+    }
+
 } // namespace liboai
@@ -0,0 +1,494 @@
+/**
+ * @file event_loop.cppm
+ *
+ * liboai event loop transport implementation.
+ * This module provides declarations for liboai::EventLoop, a
+ * non-blocking transport built on curl's multi interface. Each loop
+ * thread owns one curl multi handle and drives every transfer
+ * submitted to it concurrently, sleeping in curl_multi_poll (epoll,
+ * kqueue or WSAPoll depending on the platform) while all of them wait
+ * on the network. A handful of loop threads can therefore serve
+ * thousands of in-flight requests.
+ *
+ * Completion callbacks, as well as any streaming write callbacks set on
+ * the request, are invoked on the loop thread and should not block.
+ * Blocking liboai calls made there anyway are sent from the calling
+ * thread instead of being queued behind it (see OnLoopThread()).
+ *
+ * Failed transfers that their RetryController wants retried are parked
+ * on the loop thread until their backoff has elapsed and then started
+ * again. Requests held back by the client's RateLimiter wait the same
+ * way; neither occupies a thread.
+ *
+ * Cancelling a transfer's token wakes its loop thread, which removes
+ * the transfer from the multi handle at once; transfers whose deadline
+ * passes are removed the same way.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Third-party library headers
+#include <cpr/cpr.h>
+#include <curl/curl.h>
+
+export module liboai:core.event_loop;
+
+import :core.cancellation;
+import :core.error;
+import :core.observer;
+import :core.rate_limiter;
+import :core.request;
+import :core.response;
+import :core.response_cache;
+import :core.retry;
+import :core.sse;
+
+export namespace liboai {
+
+    struct EventLoopStats {
+        std::size_t active = 0;
+        std::uint64_t completed = 0;
+    };
+
+    class EventLoop final {
+    public:
+        using Completion = std::function<void(Result<Response>)>;
+
+        /**
+         * @brief Starts 'thread_count' loop threads (at least one).
+         */
+        explicit EventLoop(std::size_t thread_count = 1);
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+        EventLoop(EventLoop&&) = delete;
+        EventLoop& operator=(EventLoop&&) = delete;
+
+        /**
+         * @brief Stops the loop threads. Transfers still in flight are
+         *        aborted and complete with a connection error.
+         */
+        ~EventLoop();
+
+        /**
+         * @brief Starts sending a prepared request without blocking.
+         *
+         * @param request     The request to send.
+         * @param on_complete Invoked on a loop thread once the transfer
+         *                    has finished (successfully or not). If the
+         *                    loop is shutting down, it is invoked on the
+         *                    calling thread before Submit returns.
+         */
+        auto Submit(PreparedRequest request, Completion on_complete) -> void;
+
+        /**
+         * @brief Starts sending a prepared request without blocking.
+         *
+         * @return A future that becomes ready once the transfer has finished.
+         */
+        [[nodiscard]]
+        auto Submit(PreparedRequest request) -> FutureExpected<Response>;
+
+        [[nodiscard]]
+        auto Stats() const noexcept -> EventLoopStats;
+
+        /**
+         * @return Whether the calling thread is a loop thread, of any
+         *         EventLoop. A loop thread that waits for a transfer to be
+         *         driven by a loop thread may be waiting on itself.
+         */
+        [[nodiscard]]
+        static auto OnLoopThread() noexcept -> bool {
+            return EventLoop::s_on_loop_thread;
+        }
+
+    private:
+        struct Transfer {
+            PreparedRequest request;
+            Completion on_complete;
+            // wakes the loop when the request's token is cancelled
+            std::uint64_t cancel_subscription = 0;
+        };
+
+        struct Delayed {
+            std::chrono::steady_clock::time_point due;
+            Transfer transfer;
+        };
+
+        struct Worker {
+            CURLM* multi = nullptr;
+            std::mutex mutex;
+            std::vector<Transfer> incoming;
+            bool stopping = false;
+            // only ever touched by the worker's own thread
+            std::unordered_map<CURL*, Transfer> active;
+            std::vector<Delayed> delayed;
+            std::atomic<std::size_t> load{ 0 };
+            std::thread thread;
+        };
+
+        auto Run(Worker& worker) -> void;
+        auto Start(Worker& worker, Transfer&& transfer) -> void;
+        auto Finish(Worker& worker, Transfer& transfer, Result<Response> result) -> void;
+        // finishes the transfers that were cancelled or ran out of time
+        auto Abandon(Worker& worker) -> void;
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::atomic<std::uint64_t> m_completed{ 0 };
+        static inline thread_local bool s_on_loop_thread = false;
+    };
+
+    // Implementation
+    inline EventLoop::EventLoop(std::size_t thread_count) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+
+        thread_count = std::max<std::size_t>(1, thread_count);
+        this->m_workers.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->multi = curl_multi_init();
+            worker->thread = std::thread(&EventLoop::Run, this, std::ref(*worker));
+            this->m_workers.push_back(std::move(worker));
+        }
+    }
+
+    inline EventLoop::~EventLoop() {
+        for (auto& worker : this->m_workers) {
+            {
+                std::lock_guard<std::mutex> lock(worker->mutex);
+                worker->stopping = true;
+            }
+            curl_multi_wakeup(worker->multi);
+        }
+        for (auto& worker : this->m_workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+            curl_multi_cleanup(worker->multi);
+        }
+
+        curl_global_cleanup();
+    }
+
+    inline auto EventLoop::Submit(PreparedRequest request, Completion on_complete) -> void {
+        // hand the transfer to the least loaded loop thread
+        auto it = std::min_element(
+            this->m_workers.begin(),
+            this->m_workers.end(),
+            [](const auto& a, const auto& b) { return a->load.load() < b->load.load(); }
+        );
+        Worker& worker = **it;
+
+        const auto subscription = request.control.cancel.Subscribe([multi = worker.multi] {
+            curl_multi_wakeup(multi);
+        });
+
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            if (!worker.stopping) {
+                worker.load.fetch_add(1, std::memory_order_relaxed);
+                worker.incoming.push_back(
+                    { std::move(request), std::move(on_complete), subscription }
+                );
+                lock.unlock();
+                curl_multi_wakeup(worker.multi);
+                return;
+            }
+        }
+
+        // the loop has drained its queue for the last time; nothing would
+        // ever pick this transfer up
+        request.control.cancel.Unsubscribe(subscription);
+        if (request.trace) {
+            request.trace->Finish(
+                std::unexpected(OpenAIError::connection_error("Event loop stopped")),
+                0
+            );
+        }
+        try {
+            if (request.on_finish) {
+                request.on_finish();
+            }
+            if (on_complete) {
+                on_complete(std::unexpected(OpenAIError::connection_error("Event loop stopped")));
+            }
+        } catch (...) {
+        }
+    }
+
+    inline auto EventLoop::Submit(PreparedRequest request) -> FutureExpected<Response> {
+        auto promise = std::make_shared<std::promise<Result<Response>>>();
+        auto future = promise->get_future();
+
+        this->Submit(std::move(request), [promise](Result<Response> result) {
+            promise->set_value(std::move(result));
+        });
+
+        return future;
+    }
+
+    inline auto EventLoop::Stats() const noexcept -> EventLoopStats {
+        EventLoopStats stats;
+        for (const auto& worker : this->m_workers) {
+            stats.active += worker->load.load(std::memory_order_relaxed);
+        }
+        stats.completed = this->m_completed.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    inline auto EventLoop::Start(Worker& worker, Transfer&& transfer) -> void {
+        auto& request = transfer.request;
+        if (request.limiter && !request.permit) {
+            auto admission = request.limiter->Admit(request.token_cost);
+            request.permit = std::move(admission.permit);
+            if (admission.wait.count() > 0) {
+                worker.delayed.push_back({
+                    std::chrono::steady_clock::now() + admission.wait,
+                    std::move(transfer)
+                });
+                return;
+            }
+        }
+
+        if (auto error = request.control.Check()) {
+            request.permit.Refund();
+            this->Finish(worker, transfer, std::unexpected(std::move(*error)));
+            return;
+        }
+
+        if (request.trace) {
+            request.trace->Start();
+        }
+        if (request.stream_clock) {
+            request.stream_clock->Start();
+        }
+
+        auto& session = *request.session;
+        switch (request.method) {
+            case HttpMethod::HTTP_GET:
+                session.PrepareGet();
+                break;
+            case HttpMethod::HTTP_POST:
+                session.PreparePost();
+                break;
+            case HttpMethod::HTTP_DELETE:
+                session.PrepareDelete();
+                break;
+        }
+
+        CURL* handle = session.GetCurlHolder()->handle;
+        if (curl_multi_add_handle(worker.multi, handle) != CURLM_OK) {
+            this->Finish(
+                worker,
+                transfer,
+                std::unexpected(OpenAIError::curl_error("Failed to add transfer to event loop"))
+            );
+            return;
+        }
+        worker.active.emplace(handle, std::move(transfer));
+    }
+
+    inline auto EventLoop::Finish(Worker& worker, Transfer& transfer, Result<Response> result)
+        -> void {
+        transfer.request.control.cancel.Unsubscribe(transfer.cancel_subscription);
+        transfer.cancel_subscription = 0;
+
+        if (const auto& clock = transfer.request.stream_clock; clock && result) {
+            result->stream = clock->Timings();
+        }
+        if (const auto& key = transfer.request.cache_key) {
+            transfer.request.cache->Store(*key, result);
+        }
+        if (const auto& trace = transfer.request.trace) {
+            trace->Finish(result, transfer.request.retry_state.retries);
+        }
+        try {
+            if (transfer.request.on_finish) {
+                transfer.request.on_finish();
+            }
+            if (transfer.on_complete) {
+                transfer.on_complete(std::move(result));
+            }
+        } catch (...) {
+            // never let a user callback take down the loop thread
+        }
+        worker.load.fetch_sub(1, std::memory_order_relaxed);
+        this->m_completed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline auto EventLoop::Abandon(Worker& worker) -> void {
+        for (auto it = worker.active.begin(); it != worker.active.end();) {
+            auto error = it->second.request.control.Check();
+            if (!error) {
+                ++it;
+                continue;
+            }
+            // removing a handle mid-transfer makes curl close its connection
+            curl_multi_remove_handle(worker.multi, it->first);
+            auto transfer = std::move(it->second);
+            it = worker.active.erase(it);
+            this->Finish(worker, transfer, std::unexpected(std::move(*error)));
+        }
+
+        for (auto it = worker.delayed.begin(); it != worker.delayed.end();) {
+            auto error = it->transfer.request.control.Check();
+            if (!error) {
+                ++it;
+                continue;
+            }
+            auto transfer = std::move(it->transfer);
+            it = worker.delayed.erase(it);
+            // still waiting on the limiter, if it holds a permit
+            transfer.request.permit.Refund();
+            this->Finish(worker, transfer, std::unexpected(std::move(*error)));
+        }
+    }
+
+    inline auto EventLoop::Run(Worker& worker) -> void {
+        EventLoop::s_on_loop_thread = true;
+        std::vector<Transfer> pending;
+
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                if (worker.stopping) {
+                    break;
+                }
+                pending.swap(worker.incoming);
+            }
+
+            // retries whose backoff has elapsed are started with the new work
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = worker.delayed.begin(); it != worker.delayed.end();) {
+                if (it->due <= now) {
+                    pending.push_back(std::move(it->transfer));
+                    it = worker.delayed.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            for (auto& transfer : pending) {
+                this->Start(worker, std::move(transfer));
+            }
+            pending.clear();
+
+            int running = 0;
+            curl_multi_perform(worker.multi, &running);
+
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(worker.multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) {
+                    continue;
+                }
+
+                // msg is invalidated by curl_multi_remove_handle
+                CURL* handle = msg->easy_handle;
+                CURLcode code = msg->data.result;
+                curl_multi_remove_handle(worker.multi, handle);
+
+                auto node = worker.active.extract(handle);
+                if (node.empty()) {
+                    continue;
+                }
+
+                auto& transfer = node.mapped();
+                auto cpr_res = transfer.request.session->Complete(code);
+                transfer.request.session.RecordTransfer();
+                transfer.request.permit.Release(cpr_res.header);
+                auto result =
+                    to_liboai_response(std::move(cpr_res), transfer.request.parsing, handle);
+
+                if (auto& retry = transfer.request.retry) {
+                    if (auto delay = retry->NextDelay(result, transfer.request.retry_state)) {
+                        const auto due = std::chrono::steady_clock::now() + *delay;
+                        const auto& deadline = transfer.request.control.deadline;
+                        if (!deadline || due < *deadline) {
+                            worker.delayed.push_back({ due, std::move(transfer) });
+                            continue;
+                        }
+                        result = std::unexpected(
+                            OpenAIError::deadline_exceeded("Request deadline exceeded")
+                        );
+                    }
+                }
+                this->Finish(worker, transfer, std::move(result));
+            }
+
+            this->Abandon(worker);
+
+            // sleep until there is network activity, new work, a retry is
+            // due or a deadline passes
+            int timeout_ms = 1000;
+            now = std::chrono::steady_clock::now();
+            const auto wake_at = [&](std::chrono::steady_clock::time_point when) {
+                const auto wait = std::chrono::ceil<std::chrono::milliseconds>(when - now).count();
+                timeout_ms = static_cast<int>(std::clamp<decltype(wait)>(wait, 0, timeout_ms));
+            };
+            for (const auto& delayed : worker.delayed) {
+                wake_at(delayed.due);
+                if (const auto& deadline = delayed.transfer.request.control.deadline) {
+                    wake_at(*deadline);
+                }
+            }
+            for (const auto& [handle, transfer] : worker.active) {
+                if (const auto& deadline = transfer.request.control.deadline) {
+                    wake_at(*deadline);
+                }
+            }
+            curl_multi_poll(worker.multi, nullptr, 0, timeout_ms, nullptr);
+        }
+
+        // shutting down - abort whatever is still queued or in flight
+        for (auto& [handle, transfer] : worker.active) {
+            curl_multi_remove_handle(worker.multi, handle);
+            this->Finish(
+                worker,
+                transfer,
+                std::unexpected(OpenAIError::connection_error("Event loop stopped"))
+            );
+        }
+        worker.active.clear();
+
+        for (auto& delayed : worker.delayed) {
+            delayed.transfer.request.permit.Refund();
+            this->Finish(
+                worker,
+                delayed.transfer,
+                std::unexpected(OpenAIError::connection_error("Event loop stopped"))
+            );
+        }
+        worker.delayed.clear();
+
+        // Submit rejects new work once 'stopping' is set, so this is the
+        // last of it; completions may submit more, so none run under the lock
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            pending.swap(worker.incoming);
+        }
+        for (auto& transfer : pending) {
+            this->Finish(
+                worker,
+                transfer,
+                std::unexpected(OpenAIError::connection_error("Event loop stopped"))
+            );
+        }
+    }
+
+} // namespace liboai
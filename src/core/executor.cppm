@@ -0,0 +1,257 @@
+/**
+ * @file executor.cppm
+ *
+ * liboai executor implementation.
+ * This module provides declarations for the executor used to run
+ * the work behind every *Async component method. Rather than starting
+ * a new thread per call via std::async, asynchronous calls are queued
+ * on an Executor - by default a fixed-size pool of worker threads with
+ * a bounded queue - so that bursts of requests cannot exhaust the
+ * process's threads.
+ *
+ * Users may supply their own Executor implementation (for instance, to
+ * share their application's thread pool) through liboai::ClientOptions.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module liboai:core.executor;
+
+import :core.error;
+
+export namespace liboai {
+
+    /**
+     * @brief Interface for running asynchronous liboai work.
+     */
+    class Executor {
+    public:
+        virtual ~Executor() = default;
+
+        /**
+         * @brief Schedules a task for execution.
+         *
+         * @param task The task to run.
+         * @return True if the task was accepted, false if it was rejected
+         *         (in which case it will never run).
+         */
+        [[nodiscard]]
+        virtual auto Execute(std::function<void()> task) -> bool = 0;
+    };
+
+    /**
+     * @brief What ThreadPoolExecutor does when its limits are reached.
+     */
+    enum class OverflowPolicy : std::uint8_t {
+        Block, // the submitting thread waits for room
+        Reject // the task is rejected with ErrorCode::Rejected
+    };
+
+    struct ThreadPoolOptions {
+        // number of worker threads; 0 selects std::thread::hardware_concurrency()
+        std::size_t worker_count = 0;
+        // maximum number of queued (not yet running) tasks; 0 means unbounded
+        std::size_t max_queue_depth = 1024;
+        // maximum number of queued plus running tasks; 0 means unbounded
+        std::size_t max_in_flight = 0;
+        OverflowPolicy on_overflow = OverflowPolicy::Block;
+    };
+
+    struct ExecutorStats {
+        std::size_t queued = 0;
+        std::size_t running = 0;
+        std::uint64_t completed = 0;
+        std::uint64_t rejected = 0;
+    };
+
+    /**
+     * @brief Default Executor: a fixed-size pool of worker threads.
+     */
+    class ThreadPoolExecutor final : public Executor {
+    public:
+        explicit ThreadPoolExecutor(ThreadPoolOptions options = {});
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor(ThreadPoolExecutor&&) = delete;
+        ThreadPoolExecutor& operator=(ThreadPoolExecutor&&) = delete;
+
+        /**
+         * @brief Runs all queued tasks to completion, then joins the workers.
+         */
+        ~ThreadPoolExecutor() override;
+
+        [[nodiscard]]
+        auto Execute(std::function<void()> task) -> bool override;
+
+        [[nodiscard]]
+        auto Stats() const noexcept -> ExecutorStats;
+
+        [[nodiscard]]
+        auto GetOptions() const noexcept -> const ThreadPoolOptions& {
+            return this->m_options;
+        }
+
+    private:
+        auto IsFull() const noexcept -> bool;
+        auto WorkerLoop() -> void;
+
+        const ThreadPoolOptions m_options;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_not_empty, m_not_full;
+        std::deque<std::function<void()>> m_queue;
+        std::vector<std::thread> m_workers;
+        std::size_t m_running = 0;
+        std::uint64_t m_completed = 0, m_rejected = 0;
+        bool m_stopping = false;
+    };
+
+    /**
+     * @brief Runs fn(args...) on the passed executor.
+     *
+     * Arguments are decay-copied into the task, as with std::async. fn must
+     * return a liboai::Result<T>; if the executor rejects the task, the
+     * returned future is immediately ready with an ErrorCode::Rejected error.
+     *
+     * @return A future holding the result of fn(args...).
+     */
+    template <class Fn, class... Args>
+    [[nodiscard]]
+    auto Submit(Executor& executor, Fn&& fn, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<Fn>, std::decay_t<Args>...>> {
+        using R = std::invoke_result_t<std::decay_t<Fn>, std::decay_t<Args>...>;
+
+        auto promise = std::make_shared<std::promise<R>>();
+        auto future = promise->get_future();
+
+        const bool accepted = executor.Execute(
+            [promise,
+             fn = std::forward<Fn>(fn),
+             ... args = std::forward<Args>(args)]() mutable {
+                try {
+                    promise->set_value(std::invoke(std::move(fn), std::move(args)...));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            }
+        );
+
+        if (!accepted) {
+            promise->set_value(
+                std::unexpected(OpenAIError::rejected("Executor queue is full"))
+            );
+        }
+
+        return future;
+    }
+
+    // Implementation
+    inline ThreadPoolExecutor::ThreadPoolExecutor(ThreadPoolOptions options)
+        : m_options(std::move(options)) {
+        std::size_t count = this->m_options.worker_count;
+        if (count == 0) {
+            count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        this->m_workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            this->m_workers.emplace_back(&ThreadPoolExecutor::WorkerLoop, this);
+        }
+    }
+
+    inline ThreadPoolExecutor::~ThreadPoolExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_stopping = true;
+        }
+        this->m_not_empty.notify_all();
+        this->m_not_full.notify_all();
+
+        for (auto& worker : this->m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    inline auto ThreadPoolExecutor::IsFull() const noexcept -> bool {
+        if (this->m_options.max_queue_depth != 0 &&
+            this->m_queue.size() >= this->m_options.max_queue_depth) {
+            return true;
+        }
+        return this->m_options.max_in_flight != 0 &&
+               this->m_queue.size() + this->m_running >= this->m_options.max_in_flight;
+    }
+
+    inline auto ThreadPoolExecutor::Execute(std::function<void()> task) -> bool {
+        {
+            std::unique_lock<std::mutex> lock(this->m_mutex);
+            if (this->IsFull() && this->m_options.on_overflow == OverflowPolicy::Reject) {
+                this->m_rejected++;
+                return false;
+            }
+
+            this->m_not_full.wait(lock, [this] { return this->m_stopping || !this->IsFull(); });
+            if (this->m_stopping) {
+                this->m_rejected++;
+                return false;
+            }
+
+            this->m_queue.push_back(std::move(task));
+        }
+        this->m_not_empty.notify_one();
+        return true;
+    }
+
+    inline auto ThreadPoolExecutor::Stats() const noexcept -> ExecutorStats {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        return { this->m_queue.size(), this->m_running, this->m_completed, this->m_rejected };
+    }
+
+    inline auto ThreadPoolExecutor::WorkerLoop() -> void {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(this->m_mutex);
+                this->m_not_empty.wait(lock, [this] {
+                    return this->m_stopping || !this->m_queue.empty();
+                });
+                if (this->m_queue.empty()) {
+                    return; // stopping and drained
+                }
+
+                task = std::move(this->m_queue.front());
+                this->m_queue.pop_front();
+                this->m_running++;
+            }
+            this->m_not_full.notify_one();
+
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(this->m_mutex);
+                this->m_running--;
+                this->m_completed++;
+            }
+            this->m_not_full.notify_one();
+        }
+    }
+
+} // namespace liboai
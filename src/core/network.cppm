@@ -16,22 +16,42 @@
 module;
 
 // Standard library headers
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <future>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 // Third-party library headers
 #include <cpr/cpr.h>
 
 export module liboai:core.network;
 
+import :core.awaitable;
+import :core.cancellation;
+import :core.connection_pool;
+import :core.context;
 import :core.error;
+import :core.event_loop;
+import :core.executor;
+import :core.observer;
+import :core.rate_limiter;
+import :core.request;
 import :core.response;
+import :core.response_cache;
+import :core.retry;
+import :core.sse;
+import :core.transfer;
 
 export namespace liboai {
 
@@ -40,9 +60,16 @@ export namespace liboai {
         /**
          * @brief Initialise the Network instance to use the provided API url.
          *
-         * @param root The URL to direct API calls to.
+         * @param root    The URL to direct API calls to.
+         * @param context The client context (connection pool, ...) to use. If
+         *                not provided, the process-wide default context is used.
          */
-        explicit Network(const std::string& root) noexcept : m_openai_root(root) {}
+        explicit Network(
+            const std::string& root,
+            std::shared_ptr<ClientContext> context = nullptr
+        ) noexcept
+            : m_openai_root(root),
+              m_context(context ? std::move(context) : ClientContext::Default()) {}
 
         Network(const Network&) = delete;
         Network& operator=(const Network&) = delete;
@@ -57,9 +84,15 @@ export namespace liboai {
          * This function is not to be confused with liboai::File::download(...)
          * which is used to download .jsonl files from the OpenAI API.
          *
+         * The download is performed by liboai::Downloader, and so is
+         * buffered, resumed after a dropped connection and, if 'options'
+         * asks for it, split into parallel segments.
+         *
          * @param to The path and filename to download the file to.
          * @param from Where to download the file data from (such as a URL).
          * @param authorization Authorization header for the request.
+         * @param options Buffering, segmenting and progress of the download.
+         * @param call Cancellation token and deadline of the download.
          *
          * @return Bool indicating success or failure.
          */
@@ -67,16 +100,27 @@ export namespace liboai {
         static auto Download(
             const std::string& to,
             const std::string& from,
-            const cpr::Header& authorization
+            const cpr::Header& authorization,
+            const DownloadOptions& options = {},
+            const CallOptions& call = {}
         ) noexcept -> Result<bool> {
-            std::ofstream file(to, std::ios::binary);
-            auto cpr_res = cpr::Download(file, cpr::Url{ from }, authorization);
-            auto res = to_liboai_response(std::move(cpr_res));
-
-            if (!res) {
-                return std::unexpected(res.error());
+            try {
+                auto stats = Downloader::ToFile(
+                    to,
+                    from,
+                    authorization,
+                    options,
+                    {},
+                    {},
+                    RequestControl::From(call)
+                );
+                if (!stats) {
+                    return std::unexpected(stats.error());
+                }
+                return true;
+            } catch (const std::exception& e) {
+                return std::unexpected(OpenAIError::file_error(e.what()));
             }
-            return res->status_code == 200;
         }
 
         [[nodiscard]]
@@ -109,6 +153,8 @@ export namespace liboai {
          * @param to The path and filename to download the file to.
          * @param from Where to download the file data from (such as a URL).
          * @param authorization Authorization header for the request.
+         * @param options Buffering, segmenting and progress of the download.
+         * @param call Cancellation token and deadline of the download.
          *
          * @return Future bool indicating success or failure.
          */
@@ -116,18 +162,19 @@ export namespace liboai {
         static auto DownloadAsync(
             const std::string& to,
             const std::string& from,
-            cpr::Header authorization
+            cpr::Header authorization,
+            DownloadOptions options = {},
+            const CallOptions& call = {}
         ) noexcept -> FutureExpected<bool> {
-            return std::async(std::launch::async, [&]() -> Result<bool> {
-                std::ofstream file(to, std::ios::binary);
-                auto cpr_res = cpr::Download(file, cpr::Url{ from }, std::move(authorization));
-                auto res = to_liboai_response(std::move(cpr_res));
-
-                if (!res) {
-                    return std::unexpected(res.error());
-                }
-                return res->status_code == 200;
-            });
+            return Submit(
+                ClientContext::Default()->GetExecutor(),
+                &Network::Download,
+                to,
+                from,
+                std::move(authorization),
+                std::move(options),
+                call.Anchored()
+            );
         }
 
         [[nodiscard]]
@@ -137,81 +184,238 @@ export namespace liboai {
             cpr::Header authorization,
             cpr::Session& session
         ) noexcept -> FutureExpected<bool> {
-            return std::async(std::launch::async, [&]() -> Result<bool> {
-                std::ofstream file(to, std::ios::binary);
-                session.SetUrl(cpr::Url{ from });
-                session.SetHeader(authorization);
-                auto cpr_res = cpr::Download(
-                    file,
-                    cpr::Url{ session.GetFullRequestUrl() },
-                    std::move(authorization)
-                );
-                auto res = to_liboai_response(std::move(cpr_res));
-
-                if (!res) {
-                    return std::unexpected(res.error());
-                }
-                return res->status_code == 200;
-            });
+            return Submit(
+                ClientContext::Default()->GetExecutor(),
+                &Network::DownloadWithSession,
+                to,
+                from,
+                std::move(authorization),
+                std::ref(session)
+            );
         }
 
     protected:
-        enum class Method : uint8_t {
-            HTTP_GET,   // GET
-            HTTP_POST,  // POST
-            HTTP_DELETE // DELETE
-        };
+        using Method = HttpMethod;
 
+        /**
+         * @brief Configures a pooled session for a request without sending it.
+         *
+         * 'headers' should be one of the prebuilt lists of a Credentials
+         * snapshot (see liboai::RequestHeaders); a pooled session that
+         * already carries that list, or already points at root + endpoint,
+         * is not reconfigured. Option parameters may be passed as lvalues
+         * (such as the members of a shared Credentials snapshot), in which
+         * case they are copied into the session rather than moved.
+         *
+         * Requests with a non-empty cpr::WriteCallback are streams and are
+         * never retried, as part of the response may already have been
+         * handed to the callback; nor are requests whose body is produced
+         * by a cpr::ReadCallback, which cannot be read a second time. All
+         * others follow the context's RetryPolicy. The size of a cpr::Body
+         * parameter is used to estimate the request's cost against the
+         * tokens/min quota.
+         *
+         * Passing an enabled liboai::Cacheable marks the request as
+         * deterministic: if the context has a ResponseCache, the request is
+         * keyed by root, endpoint and body, answered from the cache when
+         * possible and its successful response stored there. Streams and
+         * bodies produced by a cpr::ReadCallback are never cached.
+         *
+         * If the context has a RequestObserver, the request is given a
+         * RequestTrace, reported under the liboai::EndpointTemplate passed
+         * for paths that carry an ID and under 'endpoint' otherwise, and
+         * the callback of a stream is wrapped so that the observer sees
+         * each chunk before it does. Streams (but not uploads through a
+         * cpr::ReadCallback) are also given a StreamClock, which fills in
+         * Response::stream.
+         *
+         * @return The prepared request, to be passed to Execute(...) or
+         *         ExecuteAsync(...).
+         */
         template <class... Params>
-        requires (... && !std::is_lvalue_reference_v<Params>)
         [[nodiscard]]
-        auto Request(
+        auto Prepare(
             const Method& http_method,
-            const std::string& root,
-            const std::string& endpoint,
-            const std::string& content_type,
-            std::optional<cpr::Header> headers = std::nullopt,
+            std::string_view root,
+            std::string_view endpoint,
+            std::shared_ptr<const cpr::Header> headers,
             Params&&... parameters
-        ) const -> Result<Response> {
-            cpr::Header _headers = {
-                { "Content-Type", content_type }
+        ) const -> PreparedRequest {
+            const bool streaming = (Network::IsStream(parameters) || ...);
+            // streams, and bodies produced by a callback, cannot be sent twice
+            const bool replayable = !streaming && !(Network::IsUpload(parameters) || ...);
+            const std::size_t body_bytes = (std::size_t{ 0 } + ... + Network::BodySize(parameters));
+
+            // keyed and traced before the body is moved into the session
+            std::string_view body;
+            (Network::FindBody(parameters, body), ...);
+
+            const auto& cache = this->m_context->GetResponseCache();
+            std::optional<ResponseCacheKey> cache_key;
+            if (cache && replayable && (Network::IsCacheable(parameters) || ...)) {
+                cache_key = ResponseCache::MakeKey({ root, endpoint, body });
+            }
+
+            std::chrono::milliseconds timeout{ 0 };
+            (Network::FindTimeout(parameters, timeout), ...);
+
+            std::shared_ptr<RequestTrace> trace;
+            if (const auto& observer = this->m_context->GetObserver()) {
+                std::string_view reported = endpoint;
+                (Network::FindTemplate(parameters, reported), ...);
+                trace = std::make_shared<RequestTrace>(observer, reported, body);
+            }
+
+            auto stream_clock = streaming ? std::make_shared<StreamClock>() : nullptr;
+
+            auto session = this->m_context->GetConnectionPool().Acquire(root);
+            session.SetUrl(root, endpoint);
+            session.SetHeader(std::move(headers));
+            (Network::SetOption(session, std::forward<Params>(parameters), trace, stream_clock),
+             ...);
+
+            const auto& limiter = this->m_context->GetRateLimiter();
+            return {
+                http_method,
+                std::move(session),
+                this->m_context->GetOptions().json_parsing,
+                replayable ? this->m_context->GetRetryController() : nullptr,
+                {},
+                limiter,
+                limiter ? limiter->EstimateTokens(body_bytes) : 0,
+                {},
+                cache_key ? cache : nullptr,
+                cache_key,
+                std::move(trace),
+                std::move(stream_clock),
+                timeout
             };
-            if (headers) {
-                if (headers.value().size() != 0) {
-                    for (auto& i : headers.value()) {
-                        _headers.insert(std::move(i));
-                    }
-                }
+        }
+
+        /**
+         * @brief Sends a prepared request and waits for its response.
+         *
+         * Called from an event loop thread (e.g. by a coroutine resumed
+         * there), the request is sent from that thread rather than queued
+         * on a loop it would then be blocking; the loop's other transfers
+         * stall until it returns.
+         *
+         * @param call Cancellation token and deadline of the call; see
+         *             liboai::CallOptions.
+         */
+        [[nodiscard]]
+        auto Execute(Result<PreparedRequest> request, const CallOptions& call = {}) const
+            -> Result<Response> {
+            if (!request) {
+                return std::unexpected(request.error());
+            }
+            request->control = RequestControl::From(call);
+            if (auto error = request->control.Check()) {
+                return std::unexpected(std::move(*error));
             }
+            if (auto cached = Network::Cached(*request)) {
+                return std::move(*cached);
+            }
+            if (this->m_context->GetOptions().transport == TransportMode::EventLoop &&
+                !EventLoop::OnLoopThread()) {
+                return this->m_context->GetEventLoop().Submit(std::move(*request)).get();
+            }
+            return Network::Perform(*request);
+        }
 
-            cpr::Url url{ root + endpoint };
-            cpr::Response cpr_res;
+        /**
+         * @brief Sends a prepared request without waiting for its response.
+         *
+         * The request is handed to the context's event loop when the
+         * context uses TransportMode::EventLoop, and otherwise performed
+         * on the context's executor. A request cancelled while it waits
+         * for an executor thread is never sent.
+         *
+         * Called from an event loop thread, it always goes to the executor,
+         * so that waiting on the future there cannot deadlock the loop.
+         */
+        [[nodiscard]]
+        auto ExecuteAsync(Result<PreparedRequest> request, const CallOptions& call = {}) const
+            -> FutureExpected<Response> {
+            if (!request) {
+                return MakeReadyFuture<Response>(std::unexpected(request.error()));
+            }
+            request->control = RequestControl::From(call);
+            if (auto error = request->control.Check()) {
+                return MakeReadyFuture<Response>(std::unexpected(std::move(*error)));
+            }
+            if (auto cached = Network::Cached(*request)) {
+                return MakeReadyFuture<Response>(std::move(*cached));
+            }
+            if (this->m_context->GetOptions().transport == TransportMode::EventLoop &&
+                !EventLoop::OnLoopThread()) {
+                return this->m_context->GetEventLoop().Submit(std::move(*request));
+            }
 
-            switch (http_method) {
-                case Method::HTTP_GET:
-                    if constexpr (sizeof...(parameters) > 0) {
-                        cpr_res = cpr::Get(url, _headers, std::forward<Params>(parameters)...);
-                    } else {
-                        cpr_res = cpr::Get(url, _headers);
-                    }
-                    break;
-                case Method::HTTP_POST:
-                    if constexpr (sizeof...(parameters) > 0) {
-                        cpr_res = cpr::Post(url, _headers, std::forward<Params>(parameters)...);
-                    } else {
-                        cpr_res = cpr::Post(url, _headers);
-                    }
-                    break;
-                case Method::HTTP_DELETE:
-                    if constexpr (sizeof...(parameters) > 0) {
-                        cpr_res = cpr::Delete(url, _headers, std::forward<Params>(parameters)...);
-                    } else {
-                        cpr_res = cpr::Delete(url, _headers);
-                    }
-                    break;
+            // executor tasks must be copyable, the prepared request is not
+            auto shared = std::make_shared<PreparedRequest>(std::move(*request));
+            return this->Async([shared]() { return Network::Perform(*shared); });
+        }
+
+        /**
+         * @brief Sends a prepared request from a coroutine.
+         *
+         * The request is always driven by the context's event loop,
+         * whichever transport ClientOptions selects for blocking and
+         * *Async calls, so the awaiting coroutine never parks a thread.
+         */
+        [[nodiscard]]
+        auto ExecuteCo(Result<PreparedRequest> request, const CallOptions& call = {}) const
+            -> ResponseAwaitable {
+            if (request) {
+                request->control = RequestControl::From(call);
+                if (auto error = request->control.Check()) {
+                    request = std::unexpected(std::move(*error));
+                }
             }
+            if (request) {
+                if (auto cached = Network::Cached(*request)) {
+                    return ResponseAwaitable::Ready(
+                        std::move(*cached),
+                        this->m_context->GetEventLoop()
+                    );
+                }
+            }
+            return ResponseAwaitable(std::move(request), this->m_context->GetEventLoop());
+        }
 
-            return to_liboai_response(std::move(cpr_res));
+        template <class... Params>
+        [[nodiscard]]
+        auto Request(
+            const Method& http_method,
+            std::string_view root,
+            std::string_view endpoint,
+            std::shared_ptr<const cpr::Header> headers,
+            Params&&... parameters
+        ) const -> Result<Response> {
+            return this->Execute(this->Prepare(
+                http_method,
+                root,
+                endpoint,
+                std::move(headers),
+                std::forward<Params>(parameters)...
+            ));
+        }
+
+        /**
+         * @brief Runs fn(args...) on this instance's executor.
+         *
+         * Used by the *Async methods of each component class; arguments are
+         * copied into the task in the same way std::async would copy them.
+         */
+        template <class Fn, class... Args>
+        [[nodiscard]]
+        auto Async(Fn&& fn, Args&&... args) const {
+            return Submit(
+                this->m_context->GetExecutor(),
+                std::forward<Fn>(fn),
+                std::forward<Args>(args)...
+            );
         }
 
         /**
@@ -243,9 +447,245 @@ export namespace liboai {
             return m_azure_root;
         }
 
+        [[nodiscard]]
+        const std::shared_ptr<ClientContext>& GetContext() const noexcept {
+            return m_context;
+        }
+
     private:
+        template <class Param>
+        [[nodiscard]]
+        static auto IsStream(const Param& parameter) noexcept -> bool {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, cpr::WriteCallback>) {
+                return static_cast<bool>(parameter.callback);
+            } else {
+                return false;
+            }
+        }
+
+        template <class Param>
+        [[nodiscard]]
+        static auto IsUpload(const Param& parameter) noexcept -> bool {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, cpr::ReadCallback>) {
+                return static_cast<bool>(parameter.callback);
+            } else {
+                return false;
+            }
+        }
+
+        template <class Param>
+        [[nodiscard]]
+        static auto BodySize(const Param& parameter) noexcept -> std::size_t {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, cpr::Body>) {
+                return parameter.str().size();
+            } else {
+                return 0;
+            }
+        }
+
+        template <class Param>
+        [[nodiscard]]
+        static auto IsCacheable(const Param& parameter) noexcept -> bool {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, Cacheable>) {
+                return parameter.enabled;
+            } else {
+                return false;
+            }
+        }
+
+        template <class Param>
+        static auto FindTimeout(const Param& parameter, std::chrono::milliseconds& timeout) noexcept
+            -> void {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, cpr::Timeout>) {
+                timeout = parameter.ms;
+            }
+        }
+
+        template <class Param>
+        static auto FindTemplate(const Param& parameter, std::string_view& endpoint) noexcept
+            -> void {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, EndpointTemplate>) {
+                endpoint = parameter.path;
+            }
+        }
+
+        template <class Param>
+        static auto FindBody(const Param& parameter, std::string_view& body) noexcept -> void {
+            if constexpr (std::is_same_v<std::remove_cvref_t<Param>, cpr::Body>) {
+                body = parameter.str();
+            }
+        }
+
+        // applies a Prepare(...) parameter to the session, skipping liboai's own
+        // markers and letting 'trace' and 'clock' see what a stream callback
+        // is given
+        template <class Param>
+        static auto SetOption(
+            ConnectionPool::Lease& session,
+            Param&& parameter,
+            const std::shared_ptr<RequestTrace>& trace,
+            const std::shared_ptr<StreamClock>& clock
+        ) -> void {
+            using Type = std::remove_cvref_t<Param>;
+            if constexpr (std::is_same_v<Type, Cacheable> ||
+                          std::is_same_v<Type, EndpointTemplate>) {
+                return;
+            } else if constexpr (std::is_same_v<Type, cpr::WriteCallback>) {
+                if ((trace || clock) && parameter.callback) {
+                    session->SetOption(cpr::WriteCallback{
+                        [trace, clock, callback = parameter.callback](
+                            std::string_view data,
+                            intptr_t userdata
+                        ) -> bool {
+                            if (clock) {
+                                clock->Feed(data);
+                            }
+                            if (trace) {
+                                trace->Chunk(data);
+                            }
+                            return callback(data, userdata);
+                        },
+                        parameter.userdata
+                    });
+                    return;
+                }
+                session->SetOption(std::forward<Param>(parameter));
+            } else {
+                session->SetOption(std::forward<Param>(parameter));
+            }
+        }
+
+        /**
+         * @return The cached response to 'request', if it is cacheable and
+         *         the cache has one.
+         */
+        [[nodiscard]]
+        static auto Cached(const PreparedRequest& request) -> std::optional<Response> {
+            if (!request.cache_key) {
+                return std::nullopt;
+            }
+            return request.cache->Lookup(*request.cache_key, request.parsing);
+        }
+
+        /**
+         * @brief Sends a prepared request on the calling thread, retrying
+         *        it as its RetryController decides and pacing each attempt
+         *        through the context's RateLimiter.
+         *
+         * A cancellable request is watched through curl's progress
+         * callback, which curl calls at least once a second even while
+         * the transfer is idle; a deadline bounds each attempt's timeout.
+         */
+        [[nodiscard]]
+        static auto Perform(PreparedRequest& request) -> Result<Response> {
+            if (const auto& cancel = request.control.cancel; cancel.CanBeCancelled()) {
+                request.session->SetProgressCallback(cpr::ProgressCallback{
+                    [cancel](
+                        cpr::cpr_pf_arg_t,
+                        cpr::cpr_pf_arg_t,
+                        cpr::cpr_pf_arg_t,
+                        cpr::cpr_pf_arg_t,
+                        intptr_t
+                    ) -> bool { return !cancel.IsCancelled(); }
+                });
+            }
+
+            while (true) {
+                auto result = Network::Attempt(request);
+                if (const auto delay = request.retry ?
+                                           request.retry->NextDelay(result, request.retry_state) :
+                                           std::nullopt) {
+                    auto error = request.control.Wait(*delay);
+                    if (!error) {
+                        continue;
+                    }
+                    result = std::unexpected(std::move(*error));
+                }
+
+                if (request.on_finish) {
+                    request.on_finish();
+                }
+                if (request.stream_clock && result) {
+                    result->stream = request.stream_clock->Timings();
+                }
+                if (request.cache_key) {
+                    request.cache->Store(*request.cache_key, result);
+                }
+                if (request.trace) {
+                    request.trace->Finish(result, request.retry_state.retries);
+                }
+                return result;
+            }
+        }
+
+        /**
+         * @brief Sends one attempt of a prepared request on the calling thread.
+         */
+        [[nodiscard]]
+        static auto Attempt(PreparedRequest& request) -> Result<Response> {
+            const auto& control = request.control;
+            if (request.limiter) {
+                auto admission = request.limiter->Admit(request.token_cost);
+                request.permit = std::move(admission.permit);
+                if (admission.wait.count() > 0) {
+                    if (auto error = control.Wait(admission.wait)) {
+                        request.permit.Refund();
+                        return std::unexpected(std::move(*error));
+                    }
+                }
+            }
+            if (auto error = control.Check()) {
+                request.permit.Refund();
+                return std::unexpected(std::move(*error));
+            }
+
+            if (const auto remaining = control.Remaining()) {
+                const auto timeout = request.timeout.count() > 0 ?
+                                         std::min(request.timeout, *remaining) :
+                                         *remaining;
+                request.session->SetTimeout(cpr::Timeout{ timeout });
+            }
+
+            if (request.trace) {
+                request.trace->Start();
+            }
+            if (request.stream_clock) {
+                request.stream_clock->Start();
+            }
+
+            cpr::Response cpr_res;
+
+            switch (request.method) {
+                case Method::HTTP_GET:
+                    cpr_res = request.session->Get();
+                    break;
+                case Method::HTTP_POST:
+                    cpr_res = request.session->Post();
+                    break;
+                case Method::HTTP_DELETE:
+                    cpr_res = request.session->Delete();
+                    break;
+            }
+            request.session.RecordTransfer();
+            request.permit.Release(cpr_res.header);
+
+            auto result = to_liboai_response(
+                std::move(cpr_res),
+                request.parsing,
+                request.session->GetCurlHolder()->handle
+            );
+            if (!result && control) {
+                // the transfer was aborted for the caller, not by the network
+                if (auto error = control.Check()) {
+                    result = std::unexpected(std::move(*error));
+                }
+            }
+            return result;
+        }
+
         const std::string m_openai_root;
         const std::string m_azure_root = ".openai.azure.com/openai";
+        const std::shared_ptr<ClientContext> m_context;
     };
 
 } // namespace liboai
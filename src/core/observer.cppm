@@ -0,0 +1,534 @@
+/**
+ * @file observer.cppm
+ *
+ * liboai request observer implementation.
+ * This module provides declarations for liboai::RequestObserver, the
+ * interface through which a client reports the life of each request it
+ * sends (start, first byte, streamed chunks, completion or error), and
+ * liboai::MetricsCollector, an observer keeping per-endpoint latency
+ * histograms in process, including time to first token and
+ * inter-token latency for streamed completions.
+ *
+ * A client only tracks its requests when ClientOptions::observer is
+ * set; without one, no per-request state is allocated and no hook is
+ * called, so instrumentation costs nothing unless it is used.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+export module liboai:core.observer;
+
+import :core.error;
+import :core.response;
+import :core.sse;
+
+export namespace liboai {
+
+    /**
+     * @brief A Prepare(...) parameter naming the path a request is
+     *        reported under when its actual path carries an ID, such as
+     *        "/files/{id}" for "/files/file-abc123", so that observers see
+     *        one endpoint rather than one per ID.
+     */
+    struct EndpointTemplate {
+        std::string_view path;
+    };
+
+    /**
+     * @brief What is known about a request at the time of a hook.
+     *
+     * The views point into state owned by the request and are only valid
+     * for the duration of the hook.
+     */
+    struct RequestEvent {
+        // the API path, such as "/chat/completions"; for paths carrying an
+        // ID, its EndpointTemplate, such as "/files/{id}"
+        std::string_view endpoint{};
+        // the "model" of the request body; empty if it has none
+        std::string_view model{};
+        // size of the request body
+        std::uint64_t bytes_out = 0;
+        // response bytes received so far
+        std::uint64_t bytes_in = 0;
+        // HTTP status, once known; 0 for transport errors
+        long status = 0;
+        // attempts that were retried before this one
+        std::uint32_t retries = 0;
+        // time since the request was first sent
+        std::chrono::steady_clock::duration elapsed{};
+        // from the response's "usage" field, once it has arrived
+        std::uint64_t prompt_tokens = 0, completion_tokens = 0, total_tokens = 0;
+    };
+
+    /**
+     * @brief Receives the events of every request sent by a client.
+     *
+     * Each hook does nothing by default, so an observer only overrides
+     * those it needs. Hooks of one request are called in order, but
+     * hooks of different requests may be called concurrently from any
+     * thread, including event loop threads; they should be quick and
+     * must not block. Exceptions thrown by a hook are swallowed.
+     */
+    class RequestObserver {
+    public:
+        RequestObserver() = default;
+        RequestObserver(const RequestObserver&) = delete;
+        RequestObserver& operator=(const RequestObserver&) = delete;
+        RequestObserver(RequestObserver&&) = delete;
+        RequestObserver& operator=(RequestObserver&&) = delete;
+        virtual ~RequestObserver() = default;
+
+        // the first attempt is about to be sent
+        virtual auto OnStart(const RequestEvent& /* event */) -> void {}
+        // the first byte of the response body arrived; for requests that
+        // are not streamed, reported once the response is complete
+        virtual auto OnFirstByte(const RequestEvent& /* event */) -> void {}
+        // a chunk of a streamed response arrived
+        virtual auto OnChunk(
+            const RequestEvent& /* event */,
+            std::string_view /* chunk */
+        ) -> void {}
+        // a successful response arrived, after any retries; a stream's
+        // token timings are in response.stream
+        virtual auto OnComplete(
+            const RequestEvent& /* event */,
+            const Response& /* response */
+        ) -> void {}
+        // the request failed, after any retries
+        virtual auto OnError(
+            const RequestEvent& /* event */,
+            const OpenAIError& /* error */
+        ) -> void {}
+    };
+
+    /**
+     * @brief The observed state of one request, shared by the request
+     *        and its stream callback.
+     */
+    class RequestTrace final {
+    public:
+        RequestTrace(
+            std::shared_ptr<RequestObserver> observer,
+            std::string_view endpoint,
+            std::string_view body
+        );
+
+        RequestTrace(const RequestTrace&) = delete;
+        RequestTrace& operator=(const RequestTrace&) = delete;
+        RequestTrace(RequestTrace&&) = delete;
+        RequestTrace& operator=(RequestTrace&&) = delete;
+        ~RequestTrace() = default;
+
+        /**
+         * @brief Reports the start of the request; later calls, for its
+         *        retries, do nothing.
+         */
+        auto Start() noexcept -> void;
+
+        /**
+         * @brief Reports a chunk of a streamed response.
+         */
+        auto Chunk(std::string_view chunk) noexcept -> void;
+
+        /**
+         * @brief Reports the outcome of the request.
+         */
+        auto Finish(const Result<Response>& result, std::uint32_t retries) noexcept -> void;
+
+        /**
+         * @brief Reads the token counts of a "usage" object in 'text' into
+         *        'event'.
+         */
+        static auto ScanUsage(std::string_view text, RequestEvent& event) noexcept -> void;
+
+    private:
+        auto Stamp() noexcept -> const RequestEvent&;
+
+        std::shared_ptr<RequestObserver> m_observer;
+        std::string m_endpoint, m_model;
+        RequestEvent m_event{};
+        std::chrono::steady_clock::time_point m_start{};
+        bool m_started = false, m_first_byte = false;
+    };
+
+    /**
+     * @brief A histogram of durations with about 6% resolution.
+     *
+     * Values below 32us are kept exactly; above that, each power of two
+     * is split into 16 buckets. Not synchronized.
+     */
+    class LatencyHistogram final {
+    public:
+        auto Record(std::chrono::microseconds value) noexcept -> void;
+
+        /**
+         * @param quantile In [0, 1], such as 0.99 for the p99.
+         *
+         * @return The value below which 'quantile' of the recorded values
+         *         lie, or zero if none were recorded.
+         */
+        [[nodiscard]]
+        auto Percentile(double quantile) const noexcept -> std::chrono::microseconds;
+
+        [[nodiscard]]
+        auto Count() const noexcept -> std::uint64_t {
+            return this->m_count;
+        }
+
+    private:
+        static constexpr std::size_t kExact = 32, kSubBuckets = 16;
+        static constexpr std::size_t kBuckets = kExact + (64 - 5) * kSubBuckets;
+
+        [[nodiscard]]
+        static auto Index(std::uint64_t value) noexcept -> std::size_t;
+        [[nodiscard]]
+        static auto Midpoint(std::size_t index) noexcept -> std::uint64_t;
+
+        std::array<std::uint64_t, kBuckets> m_buckets{};
+        std::uint64_t m_count = 0;
+    };
+
+    struct LatencyPercentiles {
+        std::chrono::microseconds p50{}, p95{}, p99{};
+    };
+
+    /**
+     * @brief What a MetricsCollector recorded for one endpoint.
+     */
+    struct EndpointMetrics {
+        std::string endpoint;
+        std::uint64_t requests = 0, errors = 0, retries = 0;
+        // from the start of the request to its completion
+        LatencyPercentiles latency{};
+        // from the start of the request to the first byte of the response
+        LatencyPercentiles time_to_first_byte{};
+        // completed streams, which the two below are taken over
+        std::uint64_t streams = 0;
+        // from the start of a stream to its first token
+        LatencyPercentiles time_to_first_token{};
+        // the mean gap between the tokens of a stream
+        LatencyPercentiles inter_token{};
+        std::uint64_t bytes_out = 0, bytes_in = 0;
+        std::uint64_t prompt_tokens = 0, completion_tokens = 0;
+    };
+
+    /**
+     * @brief An observer keeping request counts, latency, time to first
+     *        byte and (for streams) token timing histograms, traffic and
+     *        token usage per endpoint.
+     *
+     * At most kMaxEndpoints endpoints are tracked; requests to any further
+     * ones are recorded together under kOverflowEndpoint.
+     */
+    class MetricsCollector final : public RequestObserver {
+    public:
+        static constexpr std::size_t kMaxEndpoints = 64;
+        static constexpr std::string_view kOverflowEndpoint = "(other)";
+
+        MetricsCollector() = default;
+        ~MetricsCollector() override = default;
+
+        auto OnFirstByte(const RequestEvent& event) -> void override;
+        auto OnComplete(const RequestEvent& event, const Response& response) -> void override;
+        auto OnError(const RequestEvent& event, const OpenAIError& error) -> void override;
+
+        /**
+         * @return The metrics of every endpoint seen so far.
+         */
+        [[nodiscard]]
+        auto Snapshot() const -> std::vector<EndpointMetrics>;
+
+        /**
+         * @brief Forgets everything recorded so far.
+         */
+        auto Reset() -> void;
+
+    private:
+        struct Entry {
+            EndpointMetrics totals;
+            LatencyHistogram latency, time_to_first_byte;
+            LatencyHistogram time_to_first_token, inter_token;
+        };
+
+        auto Record(const RequestEvent& event, bool failed) -> void;
+        // the entry of 'endpoint', or the overflow entry once full; call
+        // with m_mutex held
+        auto Slot(std::string_view endpoint) -> Entry&;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+    };
+
+    // Implementation
+    inline RequestTrace::RequestTrace(
+        std::shared_ptr<RequestObserver> observer,
+        std::string_view endpoint,
+        std::string_view body
+    )
+        : m_observer(std::move(observer)),
+          m_endpoint(endpoint) {
+        // serialized bodies are compact, and model names need no escaping
+        constexpr std::string_view key = "\"model\":\"";
+        if (const auto at = body.find(key); at != std::string_view::npos) {
+            const auto begin = at + key.size();
+            const auto end = body.find('"', begin);
+            if (end != std::string_view::npos) {
+                this->m_model = body.substr(begin, end - begin);
+            }
+        }
+        this->m_event.bytes_out = body.size();
+    }
+
+    inline auto RequestTrace::Stamp() noexcept -> const RequestEvent& {
+        this->m_event.endpoint = this->m_endpoint;
+        this->m_event.model = this->m_model;
+        this->m_event.elapsed = std::chrono::steady_clock::now() - this->m_start;
+        return this->m_event;
+    }
+
+    inline auto RequestTrace::Start() noexcept -> void {
+        if (this->m_started) {
+            return;
+        }
+        this->m_started = true;
+        this->m_start = std::chrono::steady_clock::now();
+        try {
+            this->m_observer->OnStart(this->Stamp());
+        } catch (...) {
+        }
+    }
+
+    inline auto RequestTrace::Chunk(std::string_view chunk) noexcept -> void {
+        this->m_event.bytes_in += chunk.size();
+        if (chunk.find("\"usage\"") != std::string_view::npos) {
+            RequestTrace::ScanUsage(chunk, this->m_event);
+        }
+        try {
+            if (!this->m_first_byte) {
+                this->m_first_byte = true;
+                this->m_observer->OnFirstByte(this->Stamp());
+            }
+            this->m_observer->OnChunk(this->Stamp(), chunk);
+        } catch (...) {
+        }
+    }
+
+    inline auto RequestTrace::Finish(const Result<Response>& result, std::uint32_t retries) noexcept
+        -> void {
+        if (!this->m_started) {
+            // given up on before it was sent, e.g. cancelled while queued
+            this->m_start = std::chrono::steady_clock::now();
+        }
+        this->m_event.retries = retries;
+        try {
+            if (result) {
+                const auto& response = *result;
+                this->m_event.status = response.status_code;
+                this->m_event.bytes_in = std::max<std::uint64_t>(
+                    this->m_event.bytes_in,
+                    response.content.size()
+                );
+                if (response.timings.bytes_sent > 0) {
+                    this->m_event.bytes_out = response.timings.bytes_sent;
+                }
+                RequestTrace::ScanUsage(response.content, this->m_event);
+
+                if (!this->m_first_byte) {
+                    // measured by curl; the response has been read since
+                    this->m_first_byte = true;
+                    auto event = this->Stamp();
+                    event.elapsed -= std::min<std::chrono::steady_clock::duration>(
+                        event.elapsed,
+                        response.timings.transfer
+                    );
+                    this->m_observer->OnFirstByte(event);
+                }
+                this->m_observer->OnComplete(this->Stamp(), response);
+            } else {
+                this->m_event.status = result.error().http_status;
+                this->m_observer->OnError(this->Stamp(), result.error());
+            }
+        } catch (...) {
+        }
+    }
+
+    inline auto RequestTrace::ScanUsage(std::string_view text, RequestEvent& event) noexcept
+        -> void {
+        const auto usage = text.rfind("\"usage\"");
+        if (usage == std::string_view::npos) {
+            return;
+        }
+        const auto read = [text = text.substr(usage)](std::string_view key, std::uint64_t& out) {
+            auto at = text.find(key);
+            if (at == std::string_view::npos) {
+                return;
+            }
+            at = text.find(':', at + key.size());
+            if (at == std::string_view::npos) {
+                return;
+            }
+            std::uint64_t value = 0;
+            bool digits = false;
+            for (++at; at < text.size(); ++at) {
+                const char c = text[at];
+                if (c >= '0' && c <= '9') {
+                    value = value * 10 + static_cast<std::uint64_t>(c - '0');
+                    digits = true;
+                } else if (digits || (c != ' ' && c != '\n')) {
+                    break;
+                }
+            }
+            if (digits) {
+                out = value;
+            }
+        };
+        read("\"prompt_tokens\"", event.prompt_tokens);
+        read("\"completion_tokens\"", event.completion_tokens);
+        read("\"total_tokens\"", event.total_tokens);
+    }
+
+    inline auto LatencyHistogram::Index(std::uint64_t value) noexcept -> std::size_t {
+        if (value < kExact) {
+            return static_cast<std::size_t>(value);
+        }
+        const auto exponent = static_cast<std::size_t>(std::bit_width(value)) - 1; // >= 5
+        const auto sub = static_cast<std::size_t>(value >> (exponent - 4)) & (kSubBuckets - 1);
+        return kExact + (exponent - 5) * kSubBuckets + sub;
+    }
+
+    inline auto LatencyHistogram::Midpoint(std::size_t index) noexcept -> std::uint64_t {
+        if (index < kExact) {
+            return index;
+        }
+        const auto exponent = (index - kExact) / kSubBuckets + 5;
+        const auto sub = (index - kExact) % kSubBuckets;
+        const std::uint64_t width = std::uint64_t{ 1 } << (exponent - 4);
+        return ((kSubBuckets + sub) * width) + width / 2;
+    }
+
+    inline auto LatencyHistogram::Record(std::chrono::microseconds value) noexcept -> void {
+        const auto count = std::max<std::int64_t>(value.count(), 0);
+        this->m_buckets[Index(static_cast<std::uint64_t>(count))] += 1;
+        this->m_count += 1;
+    }
+
+    inline auto LatencyHistogram::Percentile(double quantile) const noexcept
+        -> std::chrono::microseconds {
+        if (this->m_count == 0) {
+            return {};
+        }
+        const auto rank = std::max<std::uint64_t>(
+            1,
+            static_cast<std::uint64_t>(
+                std::clamp(quantile, 0.0, 1.0) * static_cast<double>(this->m_count) + 0.5
+            )
+        );
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += this->m_buckets[i];
+            if (seen >= rank) {
+                return std::chrono::microseconds(static_cast<std::int64_t>(Midpoint(i)));
+            }
+        }
+        return {};
+    }
+
+    inline auto MetricsCollector::OnFirstByte(const RequestEvent& event) -> void {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->Slot(event.endpoint).time_to_first_byte.Record(
+            std::chrono::duration_cast<std::chrono::microseconds>(event.elapsed)
+        );
+    }
+
+    inline auto MetricsCollector::OnComplete(const RequestEvent& event, const Response& response)
+        -> void {
+        this->Record(event, false);
+
+        const auto& stream = response.stream;
+        if (!stream || stream->token_events == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        auto& entry = this->Slot(event.endpoint);
+        entry.totals.streams += 1;
+        entry.time_to_first_token.Record(stream->time_to_first_token);
+        if (stream->token_events > 1) {
+            entry.inter_token.Record(stream->gap_mean);
+        }
+    }
+
+    inline auto MetricsCollector::OnError(const RequestEvent& event, const OpenAIError&) -> void {
+        this->Record(event, true);
+    }
+
+    inline auto MetricsCollector::Record(const RequestEvent& event, bool failed) -> void {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        auto& entry = this->Slot(event.endpoint);
+        auto& totals = entry.totals;
+        totals.requests += 1;
+        totals.errors += failed ? 1 : 0;
+        totals.retries += event.retries;
+        totals.bytes_out += event.bytes_out;
+        totals.bytes_in += event.bytes_in;
+        totals.prompt_tokens += event.prompt_tokens;
+        totals.completion_tokens += event.completion_tokens;
+        entry.latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(event.elapsed));
+    }
+
+    inline auto MetricsCollector::Slot(std::string_view endpoint) -> Entry& {
+        std::string key(endpoint);
+        if (const auto it = this->m_entries.find(key); it != this->m_entries.end()) {
+            return it->second;
+        }
+        if (this->m_entries.size() >= kMaxEndpoints - 1) {
+            key = kOverflowEndpoint;
+        }
+        return this->m_entries[std::move(key)];
+    }
+
+    inline auto MetricsCollector::Snapshot() const -> std::vector<EndpointMetrics> {
+        const auto percentiles = [](const LatencyHistogram& histogram) {
+            return LatencyPercentiles{
+                histogram.Percentile(0.50),
+                histogram.Percentile(0.95),
+                histogram.Percentile(0.99)
+            };
+        };
+
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        std::vector<EndpointMetrics> metrics;
+        metrics.reserve(this->m_entries.size());
+        for (const auto& [endpoint, entry] : this->m_entries) {
+            auto& out = metrics.emplace_back(entry.totals);
+            out.endpoint = endpoint;
+            out.latency = percentiles(entry.latency);
+            out.time_to_first_byte = percentiles(entry.time_to_first_byte);
+            out.time_to_first_token = percentiles(entry.time_to_first_token);
+            out.inter_token = percentiles(entry.inter_token);
+        }
+        std::ranges::sort(metrics, {}, &EndpointMetrics::endpoint);
+        return metrics;
+    }
+
+    inline auto MetricsCollector::Reset() -> void {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_entries.clear();
+    }
+
+} // namespace liboai
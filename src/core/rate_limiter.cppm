@@ -0,0 +1,370 @@
+/**
+ * @file rate_limiter.cppm
+ *
+ * liboai client-side rate limiter implementation.
+ * This module provides declarations for liboai::RateLimiter, which
+ * keeps the requests of one client context within the API's
+ * requests-per-minute and tokens-per-minute quotas, so that they wait
+ * on the client instead of being turned away with HTTP 429.
+ *
+ * Each quota is a token bucket refilled continuously at its per-minute
+ * rate. A request reserves its share of both buckets before it is sent;
+ * when a bucket runs dry the reservation still succeeds, but the caller
+ * is told how long to wait first, so requests queue in arrival order.
+ * The limits and the remaining budget are resynchronised from the
+ * x-ratelimit-limit-* and x-ratelimit-remaining-* headers of every
+ * response, which also accounts for other clients sharing the quota.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// Third-party library headers
+#include <cpr/cpr.h>
+
+export module liboai:core.rate_limiter;
+
+export namespace liboai {
+
+    /**
+     * @brief Construction-time options for liboai::RateLimiter.
+     */
+    struct RateLimitOptions {
+        bool enabled = true;
+        // initial quotas; 0 means unlimited until the API reports one
+        // through the x-ratelimit-limit-* headers
+        std::uint32_t requests_per_minute = 0;
+        std::uint32_t tokens_per_minute = 0;
+        // request body bytes per token, used to estimate a request's cost
+        // against the tokens-per-minute quota
+        std::uint32_t bytes_per_token = 4;
+    };
+
+    struct RateLimiterStats {
+        std::uint64_t admitted = 0;
+        // admissions that had to wait for the buckets to refill
+        std::uint64_t delayed = 0;
+        std::chrono::milliseconds total_wait{ 0 };
+        // what is left in each bucket; negative while requests queue
+        double requests_available = 0.0;
+        double tokens_available = 0.0;
+    };
+
+    class RateLimiter final {
+    private:
+        struct State;
+
+    public:
+        /**
+         * @brief Marks a request as in flight until it completes.
+         *
+         * Move-only. Released (with the response's headers, if any) once
+         * the request's response has arrived, or when destroyed.
+         */
+        class Permit final {
+        public:
+            Permit() = default;
+            Permit(const Permit&) = delete;
+            Permit& operator=(const Permit&) = delete;
+            Permit(Permit&& old) noexcept = default;
+            Permit& operator=(Permit&& old) noexcept;
+            ~Permit();
+
+            [[nodiscard]]
+            explicit operator bool() const noexcept {
+                return this->m_state != nullptr;
+            }
+
+            /**
+             * @brief Ends the request, resynchronising the limiter from the
+             *        rate limit headers of its response.
+             */
+            auto Release(const cpr::Header& headers) noexcept -> void;
+
+            /**
+             * @brief Ends the request without a response to learn from.
+             */
+            auto Release() noexcept -> void;
+
+            /**
+             * @brief Ends a request that was never sent, such as one
+             *        cancelled while it waited, returning the request and
+             *        tokens it reserved to the limiter.
+             */
+            auto Refund() noexcept -> void;
+
+        private:
+            friend class RateLimiter;
+
+            Permit(std::shared_ptr<State> state, std::uint32_t tokens) noexcept
+                : m_state(std::move(state)), m_tokens(tokens) {}
+
+            auto End(const cpr::Header* headers, bool refund) noexcept -> void;
+
+            std::shared_ptr<State> m_state;
+            std::uint32_t m_tokens = 0;
+        };
+
+        struct Admission {
+            Permit permit;
+            // how long to wait before sending the request
+            std::chrono::milliseconds wait{ 0 };
+        };
+
+        explicit RateLimiter(RateLimitOptions options = {});
+
+        RateLimiter(const RateLimiter&) = delete;
+        RateLimiter& operator=(const RateLimiter&) = delete;
+        RateLimiter(RateLimiter&&) = delete;
+        RateLimiter& operator=(RateLimiter&&) = delete;
+        ~RateLimiter() = default;
+
+        /**
+         * @brief Reserves one request and 'tokens' tokens.
+         *
+         * Never fails. If the buckets cannot pay for the request yet, the
+         * returned wait is how long until they can, counting every request
+         * admitted before this one.
+         */
+        [[nodiscard]]
+        auto Admit(std::uint32_t tokens) -> Admission;
+
+        /**
+         * @return A rough token count for a request with a body of the
+         *         passed size.
+         */
+        [[nodiscard]]
+        auto EstimateTokens(std::size_t body_bytes) const noexcept -> std::uint32_t;
+
+        [[nodiscard]]
+        auto Stats() const noexcept -> RateLimiterStats;
+
+        [[nodiscard]]
+        auto GetOptions() const noexcept -> const RateLimitOptions&;
+
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // Implementation
+    struct RateLimiter::State {
+        using clock = std::chrono::steady_clock;
+
+        struct Bucket {
+            // per minute; 0 = unlimited
+            double limit = 0.0;
+            double available = 0.0;
+            // reserved by requests still in flight
+            double in_flight = 0.0;
+            clock::time_point updated = clock::now();
+
+            auto Refill(clock::time_point now) noexcept -> void {
+                if (this->limit > 0.0) {
+                    const std::chrono::duration<double, std::ratio<60>> elapsed =
+                        now - this->updated;
+                    this->available =
+                        std::min(this->limit, this->available + this->limit * elapsed.count());
+                }
+                this->updated = now;
+            }
+
+            // returns how long until the bucket has paid for 'cost'
+            auto Take(double cost, clock::time_point now) noexcept -> std::chrono::milliseconds {
+                this->in_flight += cost;
+                if (this->limit <= 0.0) {
+                    return std::chrono::milliseconds(0);
+                }
+                this->Refill(now);
+                this->available -= std::min(cost, this->limit);
+                if (this->available >= 0.0) {
+                    return std::chrono::milliseconds(0);
+                }
+                const double minutes = -this->available / this->limit;
+                return std::chrono::ceil<std::chrono::milliseconds>(
+                    std::chrono::duration<double, std::ratio<60>>(minutes)
+                );
+            }
+
+            // gives back what Take(cost) took, for a request never sent
+            auto Return(double cost, clock::time_point now) noexcept -> void {
+                if (this->limit <= 0.0) {
+                    return;
+                }
+                this->Refill(now);
+                this->available =
+                    std::min(this->limit, this->available + std::min(cost, this->limit));
+            }
+
+            auto Resync(const cpr::Header& headers, const char* limit, const char* remaining)
+                -> void {
+                if (auto value = ReadHeader(headers, limit)) {
+                    this->limit = static_cast<double>(*value);
+                }
+                if (auto value = ReadHeader(headers, remaining)) {
+                    // requests sent after this response still have to be paid for
+                    this->available = static_cast<double>(*value) - this->in_flight;
+                    this->updated = clock::now();
+                }
+            }
+        };
+
+        explicit State(RateLimitOptions opts) : options(std::move(opts)) {
+            this->requests.limit = this->requests.available = this->options.requests_per_minute;
+            this->tokens.limit = this->tokens.available = this->options.tokens_per_minute;
+        }
+
+        static auto ReadHeader(const cpr::Header& headers, const char* name)
+            -> std::optional<std::uint64_t> {
+            auto it = headers.find(name);
+            if (it == headers.end()) {
+                return std::nullopt;
+            }
+            std::uint64_t value = 0;
+            const auto& text = it->second;
+            const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec != std::errc{} || ptr == text.data()) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        const RateLimitOptions options;
+        mutable std::mutex mutex;
+        Bucket requests, tokens;
+        std::atomic<std::uint64_t> admitted{ 0 };
+        std::atomic<std::uint64_t> delayed{ 0 };
+        std::atomic<std::int64_t> total_wait_ms{ 0 };
+    };
+
+    inline RateLimiter::RateLimiter(RateLimitOptions options)
+        : m_state(std::make_shared<State>(std::move(options))) {}
+
+    inline auto RateLimiter::Admit(std::uint32_t tokens) -> Admission {
+        std::chrono::milliseconds wait{ 0 };
+        {
+            std::lock_guard<std::mutex> lock(this->m_state->mutex);
+            const auto now = State::clock::now();
+            wait = std::max(
+                this->m_state->requests.Take(1.0, now),
+                this->m_state->tokens.Take(static_cast<double>(tokens), now)
+            );
+        }
+
+        this->m_state->admitted.fetch_add(1, std::memory_order_relaxed);
+        if (wait.count() > 0) {
+            this->m_state->delayed.fetch_add(1, std::memory_order_relaxed);
+            this->m_state->total_wait_ms.fetch_add(wait.count(), std::memory_order_relaxed);
+        }
+        return { Permit(this->m_state, tokens), wait };
+    }
+
+    inline auto RateLimiter::EstimateTokens(std::size_t body_bytes) const noexcept
+        -> std::uint32_t {
+        const auto per_token = std::max<std::uint32_t>(this->m_state->options.bytes_per_token, 1);
+        return static_cast<std::uint32_t>(
+            std::min<std::size_t>(
+                body_bytes / per_token + 1,
+                std::numeric_limits<std::uint32_t>::max()
+            )
+        );
+    }
+
+    inline auto RateLimiter::Stats() const noexcept -> RateLimiterStats {
+        RateLimiterStats stats;
+        stats.admitted = this->m_state->admitted.load(std::memory_order_relaxed);
+        stats.delayed = this->m_state->delayed.load(std::memory_order_relaxed);
+        stats.total_wait =
+            std::chrono::milliseconds(this->m_state->total_wait_ms.load(std::memory_order_relaxed));
+
+        std::lock_guard<std::mutex> lock(this->m_state->mutex);
+        const auto now = State::clock::now();
+        this->m_state->requests.Refill(now);
+        this->m_state->tokens.Refill(now);
+        stats.requests_available = this->m_state->requests.available;
+        stats.tokens_available = this->m_state->tokens.available;
+        return stats;
+    }
+
+    inline auto RateLimiter::GetOptions() const noexcept -> const RateLimitOptions& {
+        return this->m_state->options;
+    }
+
+    inline auto RateLimiter::Permit::operator=(Permit&& old) noexcept -> Permit& {
+        if (this != &old) {
+            this->Release();
+            this->m_state = std::move(old.m_state);
+            this->m_tokens = old.m_tokens;
+        }
+        return *this;
+    }
+
+    inline RateLimiter::Permit::~Permit() {
+        this->Release();
+    }
+
+    inline auto RateLimiter::Permit::Release(const cpr::Header& headers) noexcept -> void {
+        this->End(&headers, false);
+    }
+
+    inline auto RateLimiter::Permit::Release() noexcept -> void {
+        this->End(nullptr, false);
+    }
+
+    inline auto RateLimiter::Permit::Refund() noexcept -> void {
+        this->End(nullptr, true);
+    }
+
+    inline auto RateLimiter::Permit::End(const cpr::Header* headers, bool refund) noexcept
+        -> void {
+        if (!this->m_state) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->m_state->mutex);
+            auto& state = *this->m_state;
+            state.requests.in_flight = std::max(0.0, state.requests.in_flight - 1.0);
+            state.tokens.in_flight =
+                std::max(0.0, state.tokens.in_flight - static_cast<double>(this->m_tokens));
+
+            if (refund) {
+                const auto now = State::clock::now();
+                state.requests.Return(1.0, now);
+                state.tokens.Return(static_cast<double>(this->m_tokens), now);
+            }
+            if (headers) {
+                try {
+                    state.requests.Resync(
+                        *headers,
+                        "x-ratelimit-limit-requests",
+                        "x-ratelimit-remaining-requests"
+                    );
+                    state.tokens.Resync(
+                        *headers,
+                        "x-ratelimit-limit-tokens",
+                        "x-ratelimit-remaining-tokens"
+                    );
+                } catch (...) {
+                    // malformed headers - keep the current estimate
+                }
+            }
+        }
+
+        this->m_state.reset();
+    }
+
+} // namespace liboai
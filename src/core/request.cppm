@@ -0,0 +1,77 @@
+/**
+ * @file request.cppm
+ *
+ * liboai prepared request implementation.
+ * This module provides declarations for liboai::PreparedRequest, a
+ * request whose pooled session has already been configured with its
+ * URL, headers, body, callbacks and options by liboai::Network and
+ * which only remains to be sent - either on the calling thread, on
+ * an Executor, or by the non-blocking liboai::EventLoop. Since the
+ * session keeps its configuration, a failed request can be sent again
+ * as it is.
+ */
+
+module;
+
+// Standard library headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+export module liboai:core.request;
+
+import :core.cancellation;
+import :core.connection_pool;
+import :core.observer;
+import :core.rate_limiter;
+import :core.response;
+import :core.response_cache;
+import :core.retry;
+import :core.sse;
+
+export namespace liboai {
+
+    enum class HttpMethod : std::uint8_t {
+        HTTP_GET,   // GET
+        HTTP_POST,  // POST
+        HTTP_DELETE // DELETE
+    };
+
+    /**
+     * @brief A fully configured request, ready to be sent.
+     *
+     * Move-only; owns the pooled session the request will be sent on.
+     */
+    struct PreparedRequest {
+        HttpMethod method = HttpMethod::HTTP_GET;
+        ConnectionPool::Lease session;
+        JsonParsing parsing = JsonParsing::Eager;
+        // decides whether failed attempts are sent again; null for
+        // requests that must not be retried, such as streams
+        std::shared_ptr<RetryController> retry = nullptr;
+        RetryState retry_state{};
+        // client-side rate limiting; null when the context does not limit
+        std::shared_ptr<RateLimiter> limiter = nullptr;
+        std::uint32_t token_cost = 0;
+        // held from admission by the limiter until the response arrives
+        RateLimiter::Permit permit{};
+        // where the response is stored once it arrives; the key is only
+        // set for cacheable requests of a context that has a cache
+        std::shared_ptr<ResponseCache> cache = nullptr;
+        std::optional<ResponseCacheKey> cache_key = std::nullopt;
+        // reports the request to the context's observer; null without one
+        std::shared_ptr<RequestTrace> trace = nullptr;
+        // times the events of a stream; null for requests that do not stream
+        std::shared_ptr<StreamClock> stream_clock = nullptr;
+        // the session's cpr::Timeout, which a deadline can only shorten
+        std::chrono::milliseconds timeout{ 0 };
+        // the caller's cancellation token and deadline
+        RequestControl control{};
+        // run once the request has ended, however it ended, before its
+        // result is handed on; lets a stream settle what it has buffered
+        std::function<void()> on_finish = nullptr;
+    };
+
+} // namespace liboai
@@ -12,17 +12,42 @@
  * - This class will construct itself from the output of
  *   liboai::Network::Request(...) (cpr::Response) and parse it
  *   into a usable format for the user to access via this class.
+ * - The body is parsed at most once. With JsonParsing::Lazy, parsing
+ *   is deferred until the JSON is first accessed, so callers that
+ *   only forward Response::content never pay for it.
+ * - Errors that are worth retrying carry the wait the server asked
+ *   for (Retry-After, retry-after-ms or x-ratelimit-reset-*) in
+ *   OpenAIError::retry_after_ms, and rounded up to whole seconds in
+ *   OpenAIError::retry_after.
+ * - The response headers are kept, shared between copies of a
+ *   Response, along with curl's breakdown of where the request's time
+ *   went (liboai::ResponseTimings).
+ * - Streamed responses also carry how their events arrived
+ *   (liboai::StreamTimings): time to first token and the gaps after it.
  */
 
 module;
 
 // Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <expected>
+#include <functional>
 #include <future>
+#include <mutex>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 // Third-party library headers
 #include <cpr/cpr.h>
@@ -32,6 +57,7 @@ module;
 export module liboai:core.response;
 
 import :core.error;
+import :core.sse;
 
 // Import std::unexpected for use in implementation
 using std::unexpected;
@@ -76,13 +102,324 @@ export namespace liboai {
             }
         }
 
+        /**
+         * @brief Serializes the constructed JSON.
+         *
+         * Compact by default; see SetPrettyPrint(...).
+         */
         [[nodiscard]]
         std::string dump() const {
-            return this->m_json.dump(4);
+            const bool pretty = JsonConstructor::s_pretty.load(std::memory_order_relaxed);
+            return this->m_json.dump(pretty ? 4 : -1);
+        }
+
+        /**
+         * @brief Serializes the constructed JSON into a request body,
+         *        moving the string into the cpr::Body rather than copying it.
+         */
+        [[nodiscard]]
+        cpr::Body body() const {
+            return cpr::Body{ this->dump() };
+        }
+
+        /**
+         * @brief Indents every request body by 4 spaces (process-wide).
+         *
+         * For debugging only; compact bodies are smaller on the wire and
+         * faster to produce.
+         */
+        static void SetPrettyPrint(bool pretty) noexcept {
+            JsonConstructor::s_pretty.store(pretty, std::memory_order_relaxed);
         }
 
     private:
+        friend class JsonWriter;
+
         nlohmann::json m_json;
+        static inline std::atomic<bool> s_pretty{ false };
+    };
+
+    /**
+     * @brief Serializes a JSON object member by member as it is built.
+     *
+     * Unlike JsonConstructor, no document is assembled first: each value
+     * is written out when pushed, so a large nlohmann::json value (such
+     * as a conversation's messages) is serialized in place rather than
+     * copied into a new document. Members keep the order they were pushed
+     * in, and their keys are written as given, without escaping.
+     *
+     * Copying a writer copies what it has written so far, so a body's
+     * unchanging beginning can be serialized once and then completed
+     * differently by each copy.
+     */
+    class JsonWriter final {
+    public:
+        JsonWriter()
+            : m_pretty(JsonConstructor::s_pretty.load(std::memory_order_relaxed)) {
+            this->m_out.reserve(JsonWriter::s_size_hint);
+            this->m_out.push_back('{');
+        }
+
+        JsonWriter(const JsonWriter& other)
+            : m_pretty(other.m_pretty),
+              m_members(other.m_members),
+              m_elements(other.m_elements) {
+            // with room for whatever the copy is completed with
+            this->m_out.reserve(other.m_out.size() + other.m_out.size() / 4 + 256);
+            this->m_out.append(other.m_out);
+        }
+
+        JsonWriter& operator=(const JsonWriter&) = delete;
+        ~JsonWriter() = default;
+
+        template <class _Ty>
+        void push_back(std::string_view key, const _Ty& value) {
+            this->key(key);
+            if constexpr (std::is_same_v<_Ty, nlohmann::json>) {
+                this->value(value);
+            } else {
+                this->value(nlohmann::json(value));
+            }
+        }
+
+        // unset optionals are left out
+        template <class _Ty>
+        void push_back(std::string_view key, const std::optional<_Ty>& value) {
+            if (value) {
+                this->push_back(key, *value);
+            }
+        }
+
+        // a stream callback only sets the member to true
+        template <class _Sig>
+        void push_back(std::string_view key, const std::function<_Sig>& callback) {
+            if (callback) {
+                this->push_back(key, true);
+            }
+        }
+
+        /**
+         * @brief Writes 'key' and opens an array for its value, to be filled
+         *        by push_back_element(...) and ended by close_array().
+         */
+        void open_array(std::string_view key) {
+            this->key(key);
+            this->m_out.push_back('[');
+            this->m_elements = 0;
+        }
+
+        void push_back_element(const nlohmann::json& value) {
+            if (this->m_elements++ > 0) {
+                this->m_out.push_back(',');
+            }
+            if (this->m_pretty) {
+                this->m_out.append("\n        ");
+            }
+            this->write(value, "\n        ");
+        }
+
+        void close_array() {
+            if (this->m_pretty && this->m_elements > 0) {
+                this->m_out.append("\n    ");
+            }
+            this->m_out.push_back(']');
+        }
+
+        /**
+         * @brief Closes the object and moves it into a request body,
+         *        leaving the writer empty.
+         */
+        [[nodiscard]]
+        cpr::Body body() && {
+            this->m_out.append(this->m_pretty && this->m_members > 0 ? "\n}" : "}");
+            // capped, so one huge request does not inflate every later one
+            JsonWriter::s_size_hint = std::clamp<std::size_t>(
+                this->m_out.size() + this->m_out.size() / 4,
+                256,
+                64 * 1024
+            );
+            return cpr::Body{ std::move(this->m_out) };
+        }
+
+    private:
+        void key(std::string_view key) {
+            if (this->m_members++ > 0) {
+                this->m_out.push_back(',');
+            }
+            if (this->m_pretty) {
+                this->m_out.append("\n    ");
+            }
+            this->m_out.push_back('"');
+            this->m_out.append(key);
+            this->m_out.append(this->m_pretty ? "\": " : "\":");
+        }
+
+        void value(const nlohmann::json& value) {
+            this->write(value, "\n    ");
+        }
+
+        // pretty values are indented by 'newline' past their first line;
+        // strings are escaped, so every newline is the serializer's own
+        void write(const nlohmann::json& value, std::string_view newline) {
+            if (!this->m_pretty) {
+                this->m_out.append(value.dump());
+                return;
+            }
+            const auto text = value.dump(4);
+            std::size_t from = 0;
+            for (auto at = text.find('\n'); at != std::string::npos; at = text.find('\n', from)) {
+                this->m_out.append(text, from, at - from);
+                this->m_out.append(newline);
+                from = at + 1;
+            }
+            this->m_out.append(text, from);
+        }
+
+        const bool m_pretty;
+        std::size_t m_members = 0;
+        // of the array opened last
+        std::size_t m_elements = 0;
+        std::string m_out;
+        static inline thread_local std::size_t s_size_hint = 256;
+    };
+
+    /**
+     * @brief When a Response parses its JSON body.
+     */
+    enum class JsonParsing : std::uint8_t {
+        // parsed (and validated) before the response is returned
+        Eager,
+        // parsed on first access to the JSON; malformed bodies of
+        // successful responses then read as null instead of failing
+        Lazy
+    };
+
+    /**
+     * @brief The parsed JSON body of a liboai::Response.
+     *
+     * Behaves like a const nlohmann::json. When deferred, the body is
+     * parsed from the owning Response's content on first access; this
+     * is thread-safe. Only copies made along with their Response stay
+     * deferred; any other copy or move parses the body first, as it
+     * cannot tell how long the Response's content will live.
+     */
+    class LazyJson final {
+    public:
+        LazyJson() noexcept = default;
+        LazyJson(nlohmann::json json) noexcept : m_json(std::move(json)) {}
+        LazyJson(const LazyJson& other);
+        LazyJson(LazyJson&& old) noexcept;
+
+        LazyJson& operator=(const LazyJson& other);
+        LazyJson& operator=(LazyJson&& old) noexcept;
+        LazyJson& operator=(nlohmann::json json) noexcept;
+
+        ~LazyJson() = default;
+
+        /**
+         * @return The parsed JSON, parsing it first if needed.
+         */
+        [[nodiscard]]
+        auto get() const -> const nlohmann::json&;
+
+        [[nodiscard]]
+        auto get() -> nlohmann::json&;
+
+        operator const nlohmann::json&() const {
+            return this->get();
+        }
+
+        auto operator*() const -> const nlohmann::json& {
+            return this->get();
+        }
+
+        auto operator->() const -> const nlohmann::json* {
+            return &this->get();
+        }
+
+        auto operator->() -> nlohmann::json* {
+            return &this->get();
+        }
+
+        template <class _Ty>
+        [[nodiscard]]
+        auto operator[](const _Ty& key) const -> nlohmann::json::const_reference {
+            return this->get()[key];
+        }
+
+        template <class _Ty>
+        [[nodiscard]]
+        auto contains(const _Ty& key) const -> bool {
+            return this->get().contains(key);
+        }
+
+        [[nodiscard]]
+        auto empty() const -> bool {
+            return this->get().empty();
+        }
+
+        [[nodiscard]]
+        auto dump(int indent = -1) const -> std::string {
+            return this->get().dump(indent);
+        }
+
+        /**
+         * @return Whether the JSON has been parsed (or was never deferred).
+         */
+        [[nodiscard]]
+        auto is_parsed() const noexcept -> bool {
+            return this->m_parsed.load(std::memory_order_acquire);
+        }
+
+    private:
+        friend class Response;
+
+        // parse 'source' on first access; 'source' must outlive this object
+        auto Defer(const std::string* source) noexcept -> void;
+        // take on 'other' for a Response whose copy of the content is
+        // 'source', staying deferred if 'other' still is
+        auto Adopt(const LazyJson& other, const std::string* source) -> void;
+        auto Adopt(LazyJson&& old, const std::string* source) noexcept -> void;
+
+        mutable nlohmann::json m_json{};
+        const std::string* m_source = nullptr;
+        mutable std::mutex m_mutex;
+        mutable std::atomic<bool> m_parsed{ true };
+    };
+
+    /**
+     * @brief Where the time of a request went, as measured by curl.
+     *
+     * Covers the last attempt of a retried request. Phases that did not
+     * take place, such as DNS and connect on a reused connection, or TLS
+     * over plain HTTP, are zero; every field is zero for a response that
+     * was not received over the network, such as one read from a cache.
+     */
+    struct ResponseTimings {
+        // name resolution
+        std::chrono::microseconds dns{};
+        // TCP connect, after name resolution
+        std::chrono::microseconds connect{};
+        // TLS handshake, after the TCP connect
+        std::chrono::microseconds tls{};
+        // from the request being sent to the first byte of the response;
+        // includes the server's processing time
+        std::chrono::microseconds time_to_first_byte{};
+        // from the first byte of the response to the last
+        std::chrono::microseconds transfer{};
+        // the whole request
+        std::chrono::microseconds total{};
+        // processing time reported by the API (openai-processing-ms)
+        std::optional<std::chrono::microseconds> server_processing{};
+
+        std::uint64_t bytes_sent = 0, bytes_received = 0;
+
+        /**
+         * @brief Reads the timings of the last transfer on a curl handle.
+         */
+        [[nodiscard]]
+        static auto FromCurl(CURL* handle, const cpr::Header& headers) noexcept
+            -> ResponseTimings;
     };
 
     class Response final {
@@ -103,7 +440,9 @@ export namespace liboai {
          * @brief Factory method to create a validated Response.
          *
          * Constructs a Response and validates it. Returns std::expected
-         * with the Response on success or OpenAIError on failure.
+         * with the Response on success or OpenAIError on failure. The
+         * body is parsed once (or, with JsonParsing::Lazy, on first
+         * access) and the result kept in raw_json.
          */
         [[nodiscard]]
         static auto create(
@@ -112,7 +451,8 @@ export namespace liboai {
             std::string&& status_line,
             std::string&& reason,
             long status_code,
-            double elapsed
+            double elapsed,
+            JsonParsing parsing = JsonParsing::Eager
         ) -> Result<Response>;
 
         Response& operator=(const liboai::Response& other) noexcept;
@@ -129,6 +469,19 @@ export namespace liboai {
             return this->raw_json[key];
         }
 
+        /**
+         * @return The response's headers; empty if it has none.
+         */
+        [[nodiscard]]
+        auto GetHeaders() const noexcept -> const cpr::Header&;
+
+        /**
+         * @return The value of the header 'name' (compared without regard
+         *         to case), if the response has it.
+         */
+        [[nodiscard]]
+        auto GetHeader(const std::string& name) const -> std::optional<std::string_view>;
+
         /**
          * @brief std::ostream operator<< overload.
          *
@@ -140,9 +493,14 @@ export namespace liboai {
         long status_code = 0;
         double elapsed = 0.0;
         std::string status_line{}, content{}, url{}, reason{};
-        nlohmann::json raw_json{};
+        LazyJson raw_json{};
+        ResponseTimings timings{};
+        // set for streamed requests only
+        std::optional<StreamTimings> stream{};
 
     private:
+        friend auto to_liboai_response(cpr::Response&&, JsonParsing, CURL*) -> Result<Response>;
+
         /**
          * @brief Validate response for errors.
          *
@@ -150,14 +508,115 @@ export namespace liboai {
          * Returns std::expected<void, OpenAIError>.
          */
         auto CheckResponse() const -> Result<void>;
+
+        // shared, so that copying a Response does not copy its headers
+        std::shared_ptr<const cpr::Header> m_headers;
     };
 
+    /**
+     * @brief Converts a completed cpr::Response.
+     *
+     * @param handle The curl handle the response was received on, if its
+     *               timings should be read into Response::timings.
+     */
     [[nodiscard]]
-    auto to_liboai_response(cpr::Response&& cpr_res) -> Result<Response>;
+    auto to_liboai_response(
+        cpr::Response&& cpr_res,
+        JsonParsing parsing = JsonParsing::Eager,
+        CURL* handle = nullptr
+    ) -> Result<Response>;
+
+    /**
+     * @brief Parses a rate limit reset duration such as "20ms", "1.5s" or
+     *        "6m0s", as sent in the x-ratelimit-reset-* headers.
+     */
+    [[nodiscard]]
+    auto ParseResetDuration(std::string_view value) noexcept
+        -> std::optional<std::chrono::milliseconds>;
+
+    /**
+     * @brief Returns how long the server asked the client to wait before
+     *        trying again, if it did.
+     *
+     * retry-after-ms is preferred over Retry-After (in seconds or as an
+     * HTTP-date). Without either, the x-ratelimit-reset-* header of the
+     * exhausted limit is used.
+     */
+    [[nodiscard]]
+    auto ParseRetryAfter(const cpr::Header& headers) noexcept
+        -> std::optional<std::chrono::milliseconds>;
 
     using FutureResponse = std::future<liboai::Response>;
 
     // Implementation
+    inline LazyJson::LazyJson(const LazyJson& other) : m_json(other.get()) {}
+
+    inline LazyJson::LazyJson(LazyJson&& old) noexcept : m_json(std::move(old.get())) {}
+
+    inline LazyJson& LazyJson::operator=(const LazyJson& other) {
+        if (this != &other) {
+            *this = nlohmann::json(other.get());
+        }
+        return *this;
+    }
+
+    inline LazyJson& LazyJson::operator=(LazyJson&& old) noexcept {
+        if (this != &old) {
+            *this = std::move(old.get());
+        }
+        return *this;
+    }
+
+    inline LazyJson& LazyJson::operator=(nlohmann::json json) noexcept {
+        this->m_json = std::move(json);
+        this->m_source = nullptr;
+        this->m_parsed.store(true, std::memory_order_release);
+        return *this;
+    }
+
+    inline auto LazyJson::get() const -> const nlohmann::json& {
+        if (!this->m_parsed.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            if (!this->m_parsed.load(std::memory_order_relaxed)) {
+                if (this->m_source) {
+                    this->m_json = nlohmann::json::parse(*this->m_source, nullptr, false);
+                    if (this->m_json.is_discarded()) {
+                        this->m_json = nullptr;
+                    }
+                }
+                this->m_parsed.store(true, std::memory_order_release);
+            }
+        }
+        return this->m_json;
+    }
+
+    inline auto LazyJson::get() -> nlohmann::json& {
+        std::as_const(*this).get();
+        return this->m_json;
+    }
+
+    inline auto LazyJson::Defer(const std::string* source) noexcept -> void {
+        this->m_json = nullptr;
+        this->m_source = source;
+        this->m_parsed.store(false, std::memory_order_release);
+    }
+
+    inline auto LazyJson::Adopt(const LazyJson& other, const std::string* source) -> void {
+        if (other.is_parsed()) {
+            *this = nlohmann::json(other.m_json);
+        } else {
+            this->Defer(source);
+        }
+    }
+
+    inline auto LazyJson::Adopt(LazyJson&& old, const std::string* source) noexcept -> void {
+        if (old.is_parsed()) {
+            *this = std::move(old.m_json);
+        } else {
+            this->Defer(source);
+        }
+    }
+
     inline Response::Response(const Response& other) noexcept
         : status_code(other.status_code),
           elapsed(other.elapsed),
@@ -165,7 +624,11 @@ export namespace liboai {
           content(other.content),
           url(other.url),
           reason(other.reason),
-          raw_json(other.raw_json) {}
+          timings(other.timings),
+          stream(other.stream),
+          m_headers(other.m_headers) {
+        this->raw_json.Adopt(other.raw_json, &this->content);
+    }
 
     inline Response::Response(Response&& other) noexcept
         : status_code(other.status_code),
@@ -174,7 +637,11 @@ export namespace liboai {
           content(std::move(other.content)),
           url(std::move(other.url)),
           reason(std::move(other.reason)),
-          raw_json(std::move(other.raw_json)) {}
+          timings(other.timings),
+          stream(other.stream),
+          m_headers(std::move(other.m_headers)) {
+        this->raw_json.Adopt(std::move(other.raw_json), &this->content);
+    }
 
     inline Response::Response(
         std::string&& url,
@@ -205,26 +672,30 @@ export namespace liboai {
         std::string&& status_line,
         std::string&& reason,
         long status_code,
-        double elapsed
+        double elapsed,
+        JsonParsing parsing
     ) -> Result<Response> {
-        // Check for JSON parse errors first
-        if (!content.empty() && content[0] == '{') {
-            try {
-                auto _ = nlohmann::json::parse(content);
-            } catch (const nlohmann::json::parse_error& e) {
-                return std::unexpected(OpenAIError::parse_error(e.what()));
+        Response resp;
+        resp.status_code = status_code;
+        resp.elapsed = elapsed;
+        resp.status_line = std::move(status_line);
+        resp.content = std::move(content);
+        resp.url = std::move(url);
+        resp.reason = std::move(reason);
+
+        if (!resp.content.empty() && resp.content[0] == '{') {
+            if (parsing == JsonParsing::Lazy) {
+                resp.raw_json.Defer(&resp.content);
+            } else {
+                // parse once, keeping the result rather than re-parsing in a constructor
+                try {
+                    resp.raw_json = nlohmann::json::parse(resp.content);
+                } catch (const nlohmann::json::parse_error& e) {
+                    return std::unexpected(OpenAIError::parse_error(e.what()));
+                }
             }
         }
 
-        Response resp(
-            std::move(url),
-            std::move(content),
-            std::move(status_line),
-            std::move(reason),
-            status_code,
-            elapsed
-        );
-
         auto result = resp.CheckResponse();
         if (!result) {
             return std::unexpected(result.error());
@@ -240,7 +711,10 @@ export namespace liboai {
         this->content = other.content;
         this->url = other.url;
         this->reason = other.reason;
-        this->raw_json = other.raw_json;
+        this->raw_json.Adopt(other.raw_json, &this->content);
+        this->timings = other.timings;
+        this->stream = other.stream;
+        this->m_headers = other.m_headers;
 
         return *this;
     }
@@ -252,11 +726,70 @@ export namespace liboai {
         this->content = std::move(other.content);
         this->url = std::move(other.url);
         this->reason = std::move(other.reason);
-        this->raw_json = std::move(other.raw_json);
+        this->raw_json.Adopt(std::move(other.raw_json), &this->content);
+        this->timings = other.timings;
+        this->stream = other.stream;
+        this->m_headers = std::move(other.m_headers);
 
         return *this;
     }
 
+    inline auto Response::GetHeaders() const noexcept -> const cpr::Header& {
+        static const cpr::Header empty;
+        return this->m_headers ? *this->m_headers : empty;
+    }
+
+    inline auto Response::GetHeader(const std::string& name) const
+        -> std::optional<std::string_view> {
+        const auto& headers = this->GetHeaders();
+        const auto it = headers.find(name);
+        if (it == headers.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    inline auto ResponseTimings::FromCurl(CURL* handle, const cpr::Header& headers) noexcept
+        -> ResponseTimings {
+        const auto read = [handle](CURLINFO info) {
+            curl_off_t value = 0;
+            curl_easy_getinfo(handle, info, &value);
+            return value;
+        };
+
+        // curl's times are each measured from the start of the request
+        const auto lookup = read(CURLINFO_NAMELOOKUP_TIME_T);
+        const auto connect = read(CURLINFO_CONNECT_TIME_T);
+        const auto appconnect = read(CURLINFO_APPCONNECT_TIME_T);
+        const auto pretransfer = read(CURLINFO_PRETRANSFER_TIME_T);
+        const auto starttransfer = read(CURLINFO_STARTTRANSFER_TIME_T);
+        const auto total = read(CURLINFO_TOTAL_TIME_T);
+        const auto span = [](curl_off_t from, curl_off_t to) {
+            return std::chrono::microseconds(to > from ? to - from : 0);
+        };
+
+        ResponseTimings timings;
+        timings.dns = std::chrono::microseconds(lookup);
+        timings.connect = span(lookup, connect);
+        timings.tls = appconnect > 0 ? span(connect, appconnect) : std::chrono::microseconds{};
+        timings.time_to_first_byte = span(pretransfer, starttransfer);
+        timings.transfer = span(starttransfer, total);
+        timings.total = std::chrono::microseconds(total);
+        timings.bytes_sent = static_cast<std::uint64_t>(read(CURLINFO_SIZE_UPLOAD_T));
+        timings.bytes_received = static_cast<std::uint64_t>(read(CURLINFO_SIZE_DOWNLOAD_T));
+
+        if (const auto it = headers.find("openai-processing-ms"); it != headers.end()) {
+            char* end = nullptr;
+            const double ms = std::strtod(it->second.c_str(), &end);
+            if (end != it->second.c_str() && ms >= 0.0) {
+                timings.server_processing = std::chrono::microseconds(
+                    static_cast<std::int64_t>(ms * 1000.0)
+                );
+            }
+        }
+        return timings;
+    }
+
     inline auto operator<<(std::ostream& os, const Response& r) -> std::ostream& {
         !r.raw_json.empty() ? os << r.raw_json.dump(4) : os << "null";
         return os;
@@ -298,19 +831,165 @@ export namespace liboai {
         return {};
     }
 
-    inline auto to_liboai_response(cpr::Response&& cpr_res) -> Result<Response> {
+    inline auto to_liboai_response(cpr::Response&& cpr_res, JsonParsing parsing, CURL* handle)
+        -> Result<Response> {
         if (cpr_res.error && cpr_res.status_code == 0) {
             return std::unexpected(OpenAIError::curl_error(cpr_res.error.message));
         }
 
-        return Response::create(
+        auto res = Response::create(
             std::string(cpr_res.url.str()),
             std::move(cpr_res.text),
             std::move(cpr_res.status_line),
             std::move(cpr_res.reason),
             cpr_res.status_code,
-            cpr_res.elapsed
+            cpr_res.elapsed,
+            parsing
         );
+
+        if (!res) {
+            auto& error = res.error();
+            if (error.code == ErrorCode::RateLimited || error.http_status >= 500) {
+                if (auto retry_after = ParseRetryAfter(cpr_res.header)) {
+                    error.retry_after_ms = retry_after;
+                    error.retry_after = std::chrono::ceil<std::chrono::seconds>(*retry_after);
+                }
+            }
+            return res;
+        }
+
+        if (handle) {
+            res->timings = ResponseTimings::FromCurl(handle, cpr_res.header);
+        }
+        // the map's nodes are moved, not copied
+        res->m_headers = std::make_shared<const cpr::Header>(std::move(cpr_res.header));
+        return res;
+    }
+
+    inline auto ParseResetDuration(std::string_view value) noexcept
+        -> std::optional<std::chrono::milliseconds> {
+        // a sequence of <number><unit> pairs, units being h, m, s or ms
+        double total_ms = 0.0;
+        bool any = false;
+        std::size_t i = 0;
+        while (i < value.size()) {
+            double number = 0.0, scale = 0.0;
+            bool digits = false;
+            for (; i < value.size(); ++i) {
+                const char c = value[i];
+                if (std::isdigit(static_cast<unsigned char>(c))) {
+                    digits = true;
+                    if (scale == 0.0) {
+                        number = number * 10.0 + (c - '0');
+                    } else {
+                        number += (c - '0') * scale;
+                        scale /= 10.0;
+                    }
+                } else if (c == '.' && scale == 0.0) {
+                    scale = 0.1;
+                } else {
+                    break;
+                }
+            }
+            if (!digits) {
+                return std::nullopt;
+            }
+
+            const auto unit = value.substr(i);
+            if (unit.starts_with("ms")) {
+                total_ms += number;
+                i += 2;
+            } else if (unit.starts_with("h")) {
+                total_ms += number * 3'600'000.0;
+                i += 1;
+            } else if (unit.starts_with("m")) {
+                total_ms += number * 60'000.0;
+                i += 1;
+            } else if (unit.starts_with("s")) {
+                total_ms += number * 1'000.0;
+                i += 1;
+            } else {
+                return std::nullopt;
+            }
+            any = true;
+        }
+
+        if (!any) {
+            return std::nullopt;
+        }
+        return std::chrono::milliseconds(static_cast<std::int64_t>(total_ms + 0.999));
+    }
+
+    inline auto ParseRetryAfter(const cpr::Header& headers) noexcept
+        -> std::optional<std::chrono::milliseconds> {
+        using std::chrono::ceil;
+        using std::chrono::milliseconds;
+        using std::chrono::seconds;
+
+        const auto header = [&headers](const char* name) -> std::string_view {
+            auto it = headers.find(name);
+            return it != headers.end() ? std::string_view(it->second) : std::string_view{};
+        };
+
+        if (auto ms = header("retry-after-ms"); !ms.empty()) {
+            if (auto parsed = ParseResetDuration(std::string(ms) + "ms")) {
+                return parsed;
+            }
+        }
+
+        if (auto value = header("retry-after"); !value.empty()) {
+            if (std::isdigit(static_cast<unsigned char>(value.front()))) {
+                if (auto parsed = ParseResetDuration(std::string(value) + "s")) {
+                    return parsed;
+                }
+            } else {
+                // HTTP-date, e.g. "Wed, 21 Oct 2015 07:28:00 GMT"
+                static constexpr std::string_view months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+                unsigned d = 0, y = 0, hh = 0, mm = 0, ss = 0;
+                char mon[4] = {};
+                std::string date(value);
+                const int fields = std::sscanf(
+                    date.c_str(),
+                    "%*3s, %u %3s %u %u:%u:%u",
+                    &d,
+                    mon,
+                    &y,
+                    &hh,
+                    &mm,
+                    &ss
+                );
+                if (fields == 6) {
+                    const auto m = months.find(mon);
+                    if (m != std::string_view::npos && m % 3 == 0) {
+                        const std::chrono::sys_seconds at =
+                            std::chrono::sys_days(
+                                std::chrono::year(static_cast<int>(y)) /
+                                std::chrono::month(static_cast<unsigned>(m / 3 + 1)) /
+                                std::chrono::day(d)
+                            ) +
+                            std::chrono::hours(hh) + std::chrono::minutes(mm) + seconds(ss);
+                        const auto wait =
+                            ceil<milliseconds>(at - std::chrono::system_clock::now());
+                        return std::max(wait, milliseconds(0));
+                    }
+                }
+            }
+        }
+
+        // otherwise wait for whichever limit ran out to reset
+        std::optional<std::chrono::milliseconds> reset;
+        for (const auto& [remaining, reset_at] : {
+                 std::pair{ "x-ratelimit-remaining-requests", "x-ratelimit-reset-requests" },
+                 std::pair{ "x-ratelimit-remaining-tokens", "x-ratelimit-reset-tokens" }
+             }) {
+            if (header(remaining) != "0") {
+                continue;
+            }
+            if (auto parsed = ParseResetDuration(header(reset_at))) {
+                reset = reset ? std::max(*reset, *parsed) : *parsed;
+            }
+        }
+        return reset;
     }
 
 } // namespace liboai
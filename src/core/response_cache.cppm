@@ -0,0 +1,546 @@
+/**
+ * @file response_cache.cppm
+ *
+ * liboai response cache implementation.
+ * This module provides declarations for liboai::ResponseCache, which
+ * keeps the responses of deterministic requests (embeddings,
+ * moderations, temperature-0 completions) so that repeating a request
+ * does not repeat the API call.
+ *
+ * Entries are content-addressed: the key is a 128-bit hash of the API
+ * root, the endpoint and the serialized request body, which includes
+ * the model. Responses live in an in-memory LRU tier bounded in bytes,
+ * and optionally in a directory on disk as well, which survives the
+ * process and can be shared between processes. Either tier honours a
+ * time-to-live. Only successful responses are stored.
+ */
+
+module;
+
+// Standard library headers
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+export module liboai:core.response_cache;
+
+import :core.error;
+import :core.response;
+
+export namespace liboai {
+
+    /**
+     * @brief Marks a request as deterministic, and so cacheable.
+     *
+     * Passed to Network::Prepare(...) along with the request's other
+     * parameters; it is not applied to the session.
+     */
+    struct Cacheable {
+        bool enabled = true;
+    };
+
+    struct ResponseCacheKey {
+        std::uint64_t hi = 0, lo = 0;
+
+        auto operator==(const ResponseCacheKey&) const noexcept -> bool = default;
+
+        /**
+         * @return The key as 32 lowercase hex digits.
+         */
+        [[nodiscard]]
+        auto hex() const -> std::string;
+    };
+
+    /**
+     * @brief Construction-time options for liboai::ResponseCache.
+     */
+    struct ResponseCacheOptions {
+        // size of the in-memory tier (response bodies and metadata)
+        std::size_t max_bytes = 64 * 1024 * 1024;
+        // how long an entry stays valid; 0 keeps entries until evicted
+        std::chrono::seconds ttl{ 0 };
+        // directory of the on-disk tier; empty keeps the cache in memory
+        std::filesystem::path directory{};
+    };
+
+    struct ResponseCacheStats {
+        std::uint64_t hits = 0;
+        // hits served from the on-disk tier (also counted in 'hits')
+        std::uint64_t disk_hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t stores = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t expirations = 0;
+        // the in-memory tier
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+    };
+
+    class ResponseCache final {
+    public:
+        explicit ResponseCache(ResponseCacheOptions options = {});
+
+        ResponseCache(const ResponseCache&) = delete;
+        ResponseCache& operator=(const ResponseCache&) = delete;
+        ResponseCache(ResponseCache&&) = delete;
+        ResponseCache& operator=(ResponseCache&&) = delete;
+        ~ResponseCache() = default;
+
+        /**
+         * @brief Hashes the parts of a request into a cache key.
+         *
+         * The hash is fast rather than cryptographic; do not share an
+         * on-disk tier with parties you would not share responses with.
+         */
+        [[nodiscard]]
+        static auto MakeKey(std::initializer_list<std::string_view> parts) noexcept
+            -> ResponseCacheKey;
+
+        /**
+         * @return The response stored under 'key', parsed as 'parsing'
+         *         asks, or std::nullopt on a miss.
+         */
+        [[nodiscard]]
+        auto Lookup(const ResponseCacheKey& key, JsonParsing parsing = JsonParsing::Eager)
+            -> std::optional<Response>;
+
+        /**
+         * @brief Stores 'result' under 'key' if it is a successful response;
+         *        anything else is ignored.
+         */
+        auto Store(const ResponseCacheKey& key, const Result<Response>& result) -> void;
+
+        auto Erase(const ResponseCacheKey& key) -> void;
+
+        /**
+         * @brief Empties both tiers.
+         */
+        auto Clear() -> void;
+
+        [[nodiscard]]
+        auto Stats() const noexcept -> ResponseCacheStats;
+
+        [[nodiscard]]
+        auto GetOptions() const noexcept -> const ResponseCacheOptions& {
+            return this->m_options;
+        }
+
+    private:
+        using clock = std::chrono::system_clock;
+
+        struct Entry {
+            ResponseCacheKey key;
+            long status_code = 0;
+            std::string url, content, status_line, reason;
+            clock::time_point stored;
+
+            [[nodiscard]]
+            auto bytes() const noexcept -> std::size_t {
+                return sizeof(Entry) + url.size() + content.size() + status_line.size() +
+                       reason.size();
+            }
+        };
+
+        struct KeyHash {
+            auto operator()(const ResponseCacheKey& key) const noexcept -> std::size_t {
+                return static_cast<std::size_t>(key.lo ^ (key.hi >> 7));
+            }
+        };
+
+        // fixed-size prefix of an on-disk entry, followed by its strings
+        struct DiskHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t reserved;
+            std::int64_t status_code;
+            std::int64_t stored; // seconds since the epoch
+            std::uint64_t key_hi, key_lo;
+            std::uint64_t url_size, content_size, status_line_size, reason_size;
+        };
+
+        static constexpr char kMagic[8] = { 'L', 'I', 'B', 'O', 'A', 'I', 'R', 'C' };
+        static constexpr std::uint32_t kVersion = 1;
+
+        [[nodiscard]]
+        auto Expired(const Entry& entry, clock::time_point now) const noexcept -> bool;
+        // both called with m_mutex held
+        auto Insert(std::shared_ptr<const Entry> entry) -> void;
+        auto EraseLocked(const ResponseCacheKey& key) -> void;
+
+        [[nodiscard]]
+        auto DiskPath(const ResponseCacheKey& key) const -> std::filesystem::path;
+        [[nodiscard]]
+        auto ReadDisk(const ResponseCacheKey& key) const -> std::shared_ptr<const Entry>;
+        auto WriteDisk(const Entry& entry) const -> void;
+
+        [[nodiscard]]
+        static auto ToResponse(const Entry& entry, JsonParsing parsing)
+            -> std::optional<Response>;
+
+        const ResponseCacheOptions m_options;
+
+        mutable std::mutex m_mutex;
+        // most recently used first
+        std::list<std::shared_ptr<const Entry>> m_lru;
+        std::unordered_map<
+            ResponseCacheKey,
+            std::list<std::shared_ptr<const Entry>>::iterator,
+            KeyHash>
+            m_index;
+        std::size_t m_bytes = 0;
+
+        std::atomic<std::uint64_t> m_hits{ 0 }, m_disk_hits{ 0 }, m_misses{ 0 };
+        std::atomic<std::uint64_t> m_stores{ 0 }, m_evictions{ 0 }, m_expirations{ 0 };
+    };
+
+    // Implementation
+    inline auto ResponseCacheKey::hex() const -> std::string {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string out(32, '0');
+        for (std::size_t i = 0; i < 16; ++i) {
+            out[15 - i] = digits[(this->hi >> (4 * i)) & 0xf];
+            out[31 - i] = digits[(this->lo >> (4 * i)) & 0xf];
+        }
+        return out;
+    }
+
+    inline ResponseCache::ResponseCache(ResponseCacheOptions options)
+        : m_options(std::move(options)) {}
+
+    inline auto ResponseCache::MakeKey(std::initializer_list<std::string_view> parts) noexcept
+        -> ResponseCacheKey {
+        // two 64-bit lanes over 8-byte words, each part prefixed with its
+        // length so that part boundaries are part of the key
+        constexpr std::uint64_t c1 = 0x87c37b91114253d5ULL, c2 = 0x4cf5ad432745937fULL;
+        std::uint64_t h1 = 0x9e3779b97f4a7c15ULL, h2 = 0xc2b2ae3d27d4eb4fULL;
+        std::uint64_t total = 0;
+
+        const auto mix = [&](std::uint64_t word) {
+            h1 = std::rotl(h1 ^ (word * c1), 31) * c2 + h2;
+            h2 = std::rotl(h2 ^ (word * c2), 27) * c1 + h1;
+        };
+        const auto fmix = [](std::uint64_t k) {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdULL;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ULL;
+            k ^= k >> 33;
+            return k;
+        };
+
+        for (const auto part : parts) {
+            mix(part.size());
+            std::size_t i = 0;
+            for (; i + 8 <= part.size(); i += 8) {
+                std::uint64_t word;
+                std::memcpy(&word, part.data() + i, 8);
+                mix(word);
+            }
+            if (i < part.size()) {
+                std::uint64_t word = 0;
+                std::memcpy(&word, part.data() + i, part.size() - i);
+                mix(word);
+            }
+            total += part.size();
+        }
+
+        h1 ^= total;
+        h2 ^= total;
+        h1 += h2;
+        h2 += h1;
+        h1 = fmix(h1);
+        h2 = fmix(h2);
+        h1 += h2;
+        h2 += h1;
+        return { h1, h2 };
+    }
+
+    inline auto ResponseCache::Lookup(const ResponseCacheKey& key, JsonParsing parsing)
+        -> std::optional<Response> {
+        const auto now = clock::now();
+        std::shared_ptr<const Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            if (auto it = this->m_index.find(key); it != this->m_index.end()) {
+                if (this->Expired(**it->second, now)) {
+                    this->EraseLocked(key);
+                    this->m_expirations.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    this->m_lru.splice(this->m_lru.begin(), this->m_lru, it->second);
+                    entry = *it->second;
+                }
+            }
+        }
+
+        if (!entry && !this->m_options.directory.empty()) {
+            entry = this->ReadDisk(key);
+            if (entry && this->Expired(*entry, now)) {
+                std::error_code ec;
+                std::filesystem::remove(this->DiskPath(key), ec);
+                this->m_expirations.fetch_add(1, std::memory_order_relaxed);
+                entry.reset();
+            }
+            if (entry) {
+                this->m_disk_hits.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(this->m_mutex);
+                this->Insert(entry);
+            }
+        }
+
+        if (entry) {
+            if (auto response = ToResponse(*entry, parsing)) {
+                this->m_hits.fetch_add(1, std::memory_order_relaxed);
+                return response;
+            }
+        }
+        this->m_misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    inline auto ResponseCache::Store(const ResponseCacheKey& key, const Result<Response>& result)
+        -> void {
+        if (!result || result->status_code < 200 || result->status_code >= 300) {
+            return;
+        }
+
+        auto entry = std::make_shared<Entry>();
+        entry->key = key;
+        entry->status_code = result->status_code;
+        entry->url = result->url;
+        entry->content = result->content;
+        entry->status_line = result->status_line;
+        entry->reason = result->reason;
+        entry->stored = clock::now();
+
+        if (!this->m_options.directory.empty()) {
+            this->WriteDisk(*entry);
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->Insert(std::move(entry));
+        }
+        this->m_stores.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline auto ResponseCache::Erase(const ResponseCacheKey& key) -> void {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->EraseLocked(key);
+        }
+        if (!this->m_options.directory.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(this->DiskPath(key), ec);
+        }
+    }
+
+    inline auto ResponseCache::Clear() -> void {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_lru.clear();
+            this->m_index.clear();
+            this->m_bytes = 0;
+        }
+        if (!this->m_options.directory.empty()) {
+            // only remove what this cache wrote: the two-hex-digit shard directories
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(this->m_options.directory, ec), end;
+                 !ec && it != end;
+                 it.increment(ec)) {
+                const auto name = it->path().filename().string();
+                if (it->is_directory(ec) && name.size() == 2 &&
+                    name.find_first_not_of("0123456789abcdef") == std::string::npos) {
+                    std::filesystem::remove_all(it->path(), ec);
+                }
+            }
+        }
+    }
+
+    inline auto ResponseCache::Stats() const noexcept -> ResponseCacheStats {
+        ResponseCacheStats stats;
+        stats.hits = this->m_hits.load(std::memory_order_relaxed);
+        stats.disk_hits = this->m_disk_hits.load(std::memory_order_relaxed);
+        stats.misses = this->m_misses.load(std::memory_order_relaxed);
+        stats.stores = this->m_stores.load(std::memory_order_relaxed);
+        stats.evictions = this->m_evictions.load(std::memory_order_relaxed);
+        stats.expirations = this->m_expirations.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        stats.entries = this->m_index.size();
+        stats.bytes = this->m_bytes;
+        return stats;
+    }
+
+    inline auto ResponseCache::Expired(const Entry& entry, clock::time_point now) const noexcept
+        -> bool {
+        return this->m_options.ttl.count() > 0 && now - entry.stored > this->m_options.ttl;
+    }
+
+    inline auto ResponseCache::Insert(std::shared_ptr<const Entry> entry) -> void {
+        const auto bytes = entry->bytes();
+        if (bytes > this->m_options.max_bytes) {
+            return; // would evict everything else; the disk tier may still have it
+        }
+
+        this->EraseLocked(entry->key);
+        const auto key = entry->key;
+        this->m_lru.push_front(std::move(entry));
+        this->m_index.emplace(key, this->m_lru.begin());
+        this->m_bytes += bytes;
+
+        while (this->m_bytes > this->m_options.max_bytes) {
+            this->EraseLocked(this->m_lru.back()->key);
+            this->m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline auto ResponseCache::EraseLocked(const ResponseCacheKey& key) -> void {
+        if (auto it = this->m_index.find(key); it != this->m_index.end()) {
+            this->m_bytes -= (*it->second)->bytes();
+            this->m_lru.erase(it->second);
+            this->m_index.erase(it);
+        }
+    }
+
+    inline auto ResponseCache::DiskPath(const ResponseCacheKey& key) const
+        -> std::filesystem::path {
+        const auto hex = key.hex();
+        return this->m_options.directory / hex.substr(0, 2) / hex;
+    }
+
+    inline auto ResponseCache::ReadDisk(const ResponseCacheKey& key) const
+        -> std::shared_ptr<const Entry> {
+        const auto path = this->DiskPath(key);
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return nullptr;
+        }
+        std::error_code ec;
+        const auto file_size = std::filesystem::file_size(path, ec);
+        if (ec || file_size < sizeof(DiskHeader)) {
+            return nullptr;
+        }
+
+        DiskHeader header{};
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion || header.key_hi != key.hi || header.key_lo != key.lo) {
+            return nullptr;
+        }
+
+        // the sizes are checked against the file before any is allocated,
+        // so a truncated or corrupt entry is a miss rather than a huge resize
+        const std::uint64_t sizes[] = {
+            header.url_size, header.content_size, header.status_line_size, header.reason_size
+        };
+        std::uint64_t left = file_size - sizeof(DiskHeader);
+        for (const auto size : sizes) {
+            if (size > left) {
+                return nullptr;
+            }
+            left -= size;
+        }
+        if (left != 0) {
+            return nullptr;
+        }
+
+        auto entry = std::make_shared<Entry>();
+        entry->key = key;
+        entry->status_code = static_cast<long>(header.status_code);
+        entry->stored = clock::time_point(std::chrono::seconds(header.stored));
+
+        const auto read = [&in](std::string& out, std::uint64_t size) {
+            out.resize(static_cast<std::size_t>(size));
+            return static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(size)));
+        };
+        if (!read(entry->url, header.url_size) || !read(entry->content, header.content_size) ||
+            !read(entry->status_line, header.status_line_size) ||
+            !read(entry->reason, header.reason_size)) {
+            return nullptr;
+        }
+        return entry;
+    }
+
+    inline auto ResponseCache::WriteDisk(const Entry& entry) const -> void {
+        const auto path = this->DiskPath(entry.key);
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec) {
+            return;
+        }
+
+        // unique per writer, so concurrent stores of one key never interleave
+        static std::atomic<std::uint64_t> sequence{ 0 };
+        auto temp = path;
+        temp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+                "-" + std::to_string(sequence.fetch_add(1, std::memory_order_relaxed));
+
+        {
+            DiskHeader header{};
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.status_code = entry.status_code;
+            header.stored =
+                std::chrono::floor<std::chrono::seconds>(entry.stored.time_since_epoch()).count();
+            header.key_hi = entry.key.hi;
+            header.key_lo = entry.key.lo;
+            header.url_size = entry.url.size();
+            header.content_size = entry.content.size();
+            header.status_line_size = entry.status_line.size();
+            header.reason_size = entry.reason.size();
+
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto* part :
+                 { &entry.url, &entry.content, &entry.status_line, &entry.reason }) {
+                out.write(part->data(), static_cast<std::streamsize>(part->size()));
+            }
+            out.flush();
+            if (!out) {
+                out.close();
+                std::filesystem::remove(temp, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+        }
+    }
+
+    inline auto ResponseCache::ToResponse(const Entry& entry, JsonParsing parsing)
+        -> std::optional<Response> {
+        auto response = Response::create(
+            std::string(entry.url),
+            std::string(entry.content),
+            std::string(entry.status_line),
+            std::string(entry.reason),
+            entry.status_code,
+            0.0,
+            parsing
+        );
+        if (!response) {
+            return std::nullopt;
+        }
+        return std::move(*response);
+    }
+
+} // namespace liboai
@@ -0,0 +1,227 @@
+/**
+ * @file retry.cppm
+ *
+ * liboai retry implementation.
+ * This module provides declarations for liboai::RetryPolicy and
+ * liboai::RetryController, which decide whether and when a failed
+ * request is sent again. Rate limited requests (HTTP 429), server
+ * errors (HTTP 5xx) and connection or curl errors are retried after a
+ * decorrelated-jitter backoff, or after the wait the server asked for
+ * when it sent one.
+ *
+ * Every client context owns one controller. Besides the per-request
+ * limits, the controller keeps a retry budget shared by all of the
+ * context's requests: each request earns a fraction of a retry, and a
+ * retry is only made while the budget can pay for it. During an outage
+ * this keeps retries from multiplying the load on the API.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <random>
+
+export module liboai:core.retry;
+
+import :core.error;
+import :core.response;
+
+export namespace liboai {
+
+    /**
+     * @brief Which failures are retried, and how patiently.
+     */
+    struct RetryPolicy {
+        // retries after the first attempt; 0 disables retrying
+        std::uint32_t max_retries = 2;
+        // lower bound of the jittered backoff
+        std::chrono::milliseconds base_delay{ 500 };
+        // upper bound of the jittered backoff (a longer Retry-After still applies)
+        std::chrono::milliseconds max_delay{ 20'000 };
+        // total time one request may spend waiting between its attempts
+        std::chrono::milliseconds max_total_delay{ 60'000 };
+        bool retry_rate_limited = true;
+        bool retry_server_errors = true;
+        bool retry_connection_errors = true;
+        // wait at least as long as the server asked (OpenAIError::retry_after_ms,
+        // or retry_after when only that is set)
+        bool respect_retry_after = true;
+        // share of a retry earned by each request, and the most retries
+        // that can be banked; see liboai::RetryController
+        double budget_ratio = 0.2;
+        std::uint32_t budget_reserve = 10;
+    };
+
+    /**
+     * @brief Retry bookkeeping carried by a single request.
+     */
+    struct RetryState {
+        std::uint32_t retries = 0;
+        std::chrono::milliseconds last_delay{ 0 };
+        std::chrono::milliseconds total_delay{ 0 };
+    };
+
+    struct RetryStats {
+        std::uint64_t retries = 0;
+        // retries denied because the shared budget was spent
+        std::uint64_t budget_exhausted = 0;
+    };
+
+    class RetryController final {
+    public:
+        explicit RetryController(RetryPolicy policy = {}) noexcept;
+
+        RetryController(const RetryController&) = delete;
+        RetryController& operator=(const RetryController&) = delete;
+        RetryController(RetryController&&) = delete;
+        RetryController& operator=(RetryController&&) = delete;
+        ~RetryController() = default;
+
+        /**
+         * @brief Decides what to do with the outcome of one attempt.
+         *
+         * Must be called once for every completed attempt of a request,
+         * including successful ones, which is how the shared budget is
+         * replenished.
+         *
+         * @param result The outcome of the attempt.
+         * @param state  The request's retry state, updated when a retry
+         *               is granted.
+         *
+         * @return How long to wait before sending the request again, or
+         *         std::nullopt if 'result' should be returned as it is.
+         */
+        [[nodiscard]]
+        auto NextDelay(const Result<Response>& result, RetryState& state) noexcept
+            -> std::optional<std::chrono::milliseconds>;
+
+        /**
+         * @return Whether the policy retries errors like 'error' at all.
+         */
+        [[nodiscard]]
+        auto IsRetryable(const OpenAIError& error) const noexcept -> bool;
+
+        [[nodiscard]]
+        auto GetPolicy() const noexcept -> const RetryPolicy& {
+            return this->m_policy;
+        }
+
+        [[nodiscard]]
+        auto Stats() const noexcept -> RetryStats;
+
+    private:
+        // budget is kept in thousandths of a retry
+        static constexpr std::int64_t kUnit = 1000;
+
+        auto Deposit() noexcept -> void;
+        [[nodiscard]]
+        auto TryWithdraw() noexcept -> bool;
+
+        const RetryPolicy m_policy;
+        const std::int64_t m_capacity;
+        std::atomic<std::int64_t> m_budget;
+        std::atomic<std::uint64_t> m_retries{ 0 };
+        std::atomic<std::uint64_t> m_budget_exhausted{ 0 };
+    };
+
+    // Implementation
+    inline RetryController::RetryController(RetryPolicy policy) noexcept
+        : m_policy(policy),
+          m_capacity(static_cast<std::int64_t>(policy.budget_reserve) * kUnit),
+          m_budget(m_capacity) {}
+
+    inline auto RetryController::IsRetryable(const OpenAIError& error) const noexcept -> bool {
+        switch (error.code) {
+            case ErrorCode::RateLimited:
+                return this->m_policy.retry_rate_limited;
+            case ErrorCode::ConnectionError:
+            case ErrorCode::CURLError:
+                return this->m_policy.retry_connection_errors;
+            default:
+                return error.http_status >= 500 && this->m_policy.retry_server_errors;
+        }
+    }
+
+    inline auto
+    RetryController::NextDelay(const Result<Response>& result, RetryState& state) noexcept
+        -> std::optional<std::chrono::milliseconds> {
+        using std::chrono::milliseconds;
+
+        if (state.retries == 0) {
+            this->Deposit();
+        }
+        if (result || state.retries >= this->m_policy.max_retries ||
+            !this->IsRetryable(result.error())) {
+            return std::nullopt;
+        }
+
+        // decorrelated jitter: uniform in [base, 3 * previous delay], capped
+        thread_local std::minstd_rand rng{ std::random_device{}() };
+        const auto base = std::max<milliseconds::rep>(this->m_policy.base_delay.count(), 1);
+        const auto upper = std::max(base, state.last_delay.count() * 3);
+        milliseconds delay(std::uniform_int_distribution<milliseconds::rep>(base, upper)(rng));
+        delay = std::min(delay, this->m_policy.max_delay);
+
+        if (this->m_policy.respect_retry_after) {
+            const auto& error = result.error();
+            if (error.retry_after_ms) {
+                delay = std::max(delay, *error.retry_after_ms);
+            } else if (error.retry_after) {
+                delay = std::max<milliseconds>(delay, *error.retry_after);
+            }
+        }
+        if (state.total_delay + delay > this->m_policy.max_total_delay) {
+            return std::nullopt;
+        }
+        if (!this->TryWithdraw()) {
+            this->m_budget_exhausted.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        state.retries += 1;
+        state.last_delay = delay;
+        state.total_delay += delay;
+        this->m_retries.fetch_add(1, std::memory_order_relaxed);
+        return delay;
+    }
+
+    inline auto RetryController::Stats() const noexcept -> RetryStats {
+        return {
+            this->m_retries.load(std::memory_order_relaxed),
+            this->m_budget_exhausted.load(std::memory_order_relaxed)
+        };
+    }
+
+    inline auto RetryController::Deposit() noexcept -> void {
+        const auto earned = static_cast<std::int64_t>(this->m_policy.budget_ratio * kUnit);
+        auto current = this->m_budget.load(std::memory_order_relaxed);
+        while (current < this->m_capacity &&
+               !this->m_budget.compare_exchange_weak(
+                   current,
+                   std::min(current + earned, this->m_capacity),
+                   std::memory_order_relaxed
+               )) {
+        }
+    }
+
+    inline auto RetryController::TryWithdraw() noexcept -> bool {
+        auto current = this->m_budget.load(std::memory_order_relaxed);
+        while (current >= kUnit) {
+            if (this->m_budget.compare_exchange_weak(
+                    current,
+                    current - kUnit,
+                    std::memory_order_relaxed
+                )) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace liboai
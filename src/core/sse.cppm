@@ -0,0 +1,388 @@
+/**
+ * @file sse.cppm
+ *
+ * liboai server-sent events implementation.
+ * This module provides declarations for liboai::SseParser, an
+ * incremental parser for the text/event-stream format used by the
+ * OpenAI API's streamed responses.
+ *
+ * Chunks are fed in as they arrive from the network, in whatever
+ * pieces the transport delivers them. Lines and events may span any
+ * number of chunks. Events that arrive whole within one chunk and
+ * carry a single data line are reported as views into that chunk,
+ * without copying; only events split across chunks or made of
+ * several data lines are assembled in an internal buffer.
+ *
+ * liboai::StreamClock times the events of a streamed completion as
+ * they arrive: the time to the first token and the cadence of the
+ * tokens after it.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+export module liboai:core.sse;
+
+export namespace liboai {
+
+    /**
+     * @brief A single dispatched server-sent event.
+     *
+     * The views are only valid for the duration of the callback the event
+     * is passed to.
+     */
+    struct SseEvent {
+        // the event type; "message" if the stream did not name one
+        std::string_view event;
+        // the last event ID seen on the stream
+        std::string_view id;
+        // the event's data lines, joined by '\n'
+        std::string_view data;
+    };
+
+    class SseParser final {
+    public:
+        SseParser() = default;
+        SseParser(const SseParser&) = default;
+        SseParser& operator=(const SseParser&) = default;
+        SseParser(SseParser&&) noexcept = default;
+        SseParser& operator=(SseParser&&) noexcept = default;
+        ~SseParser() = default;
+
+        /**
+         * @brief Feeds the next chunk of the stream to the parser.
+         *
+         * @param chunk    The bytes received, in order.
+         * @param on_event Invoked with a const SseEvent& for every event
+         *                 completed by this chunk. If it returns a value
+         *                 convertible to false, parsing stops and the rest
+         *                 of the chunk is discarded.
+         *
+         * @return False if on_event asked to stop, true otherwise.
+         */
+        template <class OnEvent>
+        auto Feed(std::string_view chunk, OnEvent&& on_event) -> bool;
+
+        /**
+         * @brief Discards any partially received line or event.
+         */
+        auto Reset() noexcept -> void;
+
+        /**
+         * @return The reconnection time last sent in a 'retry:' field, if any.
+         */
+        [[nodiscard]]
+        auto GetRetry() const noexcept -> std::optional<std::uint32_t> {
+            return this->m_retry;
+        }
+
+        [[nodiscard]]
+        auto GetLastEventId() const noexcept -> std::string_view {
+            return this->m_id;
+        }
+
+    private:
+        template <class OnEvent>
+        auto ProcessLine(std::string_view line, bool stable, OnEvent& on_event) -> bool;
+        auto AppendData(std::string_view value, bool stable) -> void;
+        auto OwnData() -> void;
+
+        // bytes of an unterminated line carried over from earlier chunks
+        std::string m_line;
+        // the current event's data, once it had to be copied
+        std::string m_data;
+        // the current event's data, while it is still a view into the chunk
+        std::string_view m_data_view;
+        bool m_has_data = false;
+        bool m_data_owned = false;
+        std::string m_event, m_id;
+        std::optional<std::uint32_t> m_retry = std::nullopt;
+        // the previous chunk ended in '\r', so a leading '\n' ends no line
+        bool m_skip_lf = false;
+    };
+
+    /**
+     * @brief How the events of a streamed response arrived.
+     *
+     * A "token event" is one carrying generated text (a content, text or
+     * function call arguments delta); the API sends about one token in
+     * each.
+     */
+    struct StreamTimings {
+        // from the request being sent to its first event
+        std::chrono::microseconds time_to_first_event{};
+        // from the request being sent to its first token event
+        std::chrono::microseconds time_to_first_token{};
+        // events received, and how many of them were token events
+        std::uint32_t events = 0, token_events = 0;
+        // gaps between consecutive token events
+        std::chrono::microseconds gap_mean{}, gap_stddev{}, gap_max{};
+        // token events after the first, per second from the first to the last
+        double tokens_per_second = 0.0;
+    };
+
+    /**
+     * @brief Times the events of a stream, given its chunks as they arrive.
+     */
+    class StreamClock final {
+    public:
+        /**
+         * @brief Marks the request as sent.
+         */
+        auto Start() noexcept -> void {
+            this->m_start = std::chrono::steady_clock::now();
+        }
+
+        auto Feed(std::string_view chunk) -> void;
+
+        [[nodiscard]]
+        auto Timings() const noexcept -> StreamTimings;
+
+    private:
+        [[nodiscard]]
+        static auto CarriesToken(std::string_view data) noexcept -> bool;
+
+        using Clock = std::chrono::steady_clock;
+
+        SseParser m_parser;
+        Clock::time_point m_start{}, m_first_event{}, m_first_token{}, m_last_token{};
+        std::uint32_t m_events = 0, m_token_events = 0;
+        // running mean and sum of squared deviations of the gaps, in us
+        double m_gap_mean = 0.0, m_gap_m2 = 0.0;
+        Clock::duration m_gap_max{};
+    };
+
+    // Implementation
+    template <class OnEvent>
+    auto SseParser::Feed(std::string_view chunk, OnEvent&& on_event) -> bool {
+        std::size_t pos = 0;
+
+        if (this->m_skip_lf && !chunk.empty() && chunk.front() == '\n') {
+            pos = 1;
+        }
+        this->m_skip_lf = false;
+
+        while (pos < chunk.size()) {
+            const std::size_t end = chunk.find_first_of("\r\n", pos);
+            if (end == std::string_view::npos) {
+                break;
+            }
+
+            bool keep_going;
+            if (!this->m_line.empty()) {
+                // completes a line started in an earlier chunk
+                this->m_line.append(chunk.substr(pos, end - pos));
+                keep_going = this->ProcessLine(this->m_line, false, on_event);
+                this->m_line.clear();
+            } else {
+                keep_going = this->ProcessLine(chunk.substr(pos, end - pos), true, on_event);
+            }
+
+            pos = end + 1;
+            if (chunk[end] == '\r') {
+                if (pos < chunk.size()) {
+                    pos += chunk[pos] == '\n' ? 1 : 0;
+                } else {
+                    this->m_skip_lf = true;
+                }
+            }
+
+            if (!keep_going) {
+                this->Reset();
+                return false;
+            }
+        }
+
+        this->m_line.append(chunk.substr(std::min(pos, chunk.size())));
+
+        // views into this chunk will not outlive the call
+        if (this->m_has_data && !this->m_data_owned) {
+            this->OwnData();
+        }
+
+        return true;
+    }
+
+    template <class OnEvent>
+    auto SseParser::ProcessLine(std::string_view line, bool stable, OnEvent& on_event) -> bool {
+        if (line.empty()) {
+            // blank line - dispatch the pending event, if it has data
+            bool keep_going = true;
+            if (this->m_has_data) {
+                SseEvent event{
+                    this->m_event.empty() ? std::string_view("message") :
+                                            std::string_view(this->m_event),
+                    this->m_id,
+                    this->m_data_owned ? std::string_view(this->m_data) : this->m_data_view
+                };
+
+                if constexpr (std::is_void_v<std::invoke_result_t<OnEvent&, const SseEvent&>>) {
+                    on_event(std::as_const(event));
+                } else {
+                    keep_going = static_cast<bool>(on_event(std::as_const(event)));
+                }
+            }
+
+            this->m_event.clear();
+            this->m_data.clear();
+            this->m_data_view = {};
+            this->m_has_data = false;
+            this->m_data_owned = false;
+            return keep_going;
+        }
+
+        if (line.front() == ':') {
+            return true; // comment
+        }
+
+        std::string_view field = line, value;
+        if (const auto colon = line.find(':'); colon != std::string_view::npos) {
+            field = line.substr(0, colon);
+            value = line.substr(colon + 1);
+            if (!value.empty() && value.front() == ' ') {
+                value.remove_prefix(1);
+            }
+        }
+
+        if (field == "data") {
+            this->AppendData(value, stable);
+        } else if (field == "event") {
+            this->m_event.assign(value);
+        } else if (field == "id") {
+            if (value.find('\0') == std::string_view::npos) {
+                this->m_id.assign(value);
+            }
+        } else if (field == "retry") {
+            std::uint32_t retry = 0;
+            const auto [ptr, ec] =
+                std::from_chars(value.data(), value.data() + value.size(), retry);
+            if (ec == std::errc{} && ptr == value.data() + value.size()) {
+                this->m_retry = retry;
+            }
+        }
+        // unknown fields are ignored
+
+        return true;
+    }
+
+    inline auto SseParser::AppendData(std::string_view value, bool stable) -> void {
+        if (!this->m_has_data) {
+            this->m_has_data = true;
+            if (stable) {
+                this->m_data_view = value;
+                return;
+            }
+            this->m_data_owned = true;
+            this->m_data.assign(value);
+            return;
+        }
+
+        this->OwnData();
+        this->m_data.push_back('\n');
+        this->m_data.append(value);
+    }
+
+    inline auto SseParser::OwnData() -> void {
+        if (!this->m_data_owned) {
+            this->m_data.assign(this->m_data_view);
+            this->m_data_view = {};
+            this->m_data_owned = true;
+        }
+    }
+
+    inline auto SseParser::Reset() noexcept -> void {
+        this->m_line.clear();
+        this->m_data.clear();
+        this->m_data_view = {};
+        this->m_has_data = false;
+        this->m_data_owned = false;
+        this->m_event.clear();
+        this->m_skip_lf = false;
+    }
+
+
+    inline auto StreamClock::Feed(std::string_view chunk) -> void {
+        const auto now = Clock::now();
+        this->m_parser.Feed(chunk, [this, now](const SseEvent& event) {
+            if (event.data == "[DONE]") {
+                return true;
+            }
+            if (this->m_events++ == 0) {
+                this->m_first_event = now;
+            }
+            if (!StreamClock::CarriesToken(event.data)) {
+                return true;
+            }
+
+            if (this->m_token_events++ == 0) {
+                this->m_first_token = now;
+            } else {
+                // Welford's update, so no gap has to be kept
+                const auto gap = now - this->m_last_token;
+                const double us = std::chrono::duration<double, std::micro>(gap).count();
+                const double n = static_cast<double>(this->m_token_events - 1);
+                const double delta = us - this->m_gap_mean;
+                this->m_gap_mean += delta / n;
+                this->m_gap_m2 += delta * (us - this->m_gap_mean);
+                this->m_gap_max = std::max(this->m_gap_max, gap);
+            }
+            this->m_last_token = now;
+            return true;
+        });
+    }
+
+    inline auto StreamClock::Timings() const noexcept -> StreamTimings {
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+
+        StreamTimings timings;
+        timings.events = this->m_events;
+        timings.token_events = this->m_token_events;
+        if (this->m_events > 0) {
+            timings.time_to_first_event =
+                duration_cast<microseconds>(this->m_first_event - this->m_start);
+        }
+        if (this->m_token_events > 0) {
+            timings.time_to_first_token =
+                duration_cast<microseconds>(this->m_first_token - this->m_start);
+        }
+        if (this->m_token_events > 1) {
+            const double gaps = static_cast<double>(this->m_token_events - 1);
+            timings.gap_mean = microseconds(static_cast<std::int64_t>(this->m_gap_mean));
+            timings.gap_stddev =
+                microseconds(static_cast<std::int64_t>(std::sqrt(this->m_gap_m2 / gaps)));
+            timings.gap_max = duration_cast<microseconds>(this->m_gap_max);
+
+            const double seconds =
+                std::chrono::duration<double>(this->m_last_token - this->m_first_token).count();
+            timings.tokens_per_second = seconds > 0.0 ? gaps / seconds : 0.0;
+        }
+        return timings;
+    }
+
+    inline auto StreamClock::CarriesToken(std::string_view data) noexcept -> bool {
+        // a non-empty string value for any of the keys deltas carry text in
+        for (const std::string_view key : { "\"content\":\"", "\"text\":\"", "\"arguments\":\"" }) {
+            const auto at = data.find(key);
+            if (at != std::string_view::npos && at + key.size() < data.size() &&
+                data[at + key.size()] != '"') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace liboai
@@ -0,0 +1,846 @@
+/**
+ * @file transfer.cppm
+ *
+ * liboai transfer implementation.
+ * This module provides declarations for liboai::TransferProgress, the
+ * progress reports of long-running transfers, liboai::MultipartUpload,
+ * which streams a file as a multipart/form-data request body, and
+ * liboai::Downloader, which fetches a URL to a file or to memory.
+ *
+ * A MultipartUpload reads its file in fixed-size chunks while the
+ * request is being sent, so uploading a multi-gigabyte dataset needs no
+ * more memory than one chunk. The size of the body is known up front
+ * and sent as its Content-Length.
+ *
+ * The Downloader buffers what it receives and writes it out a buffer at
+ * a time. A transfer that breaks off is resumed with a Range request
+ * from the last byte written, and large files can be fetched as several
+ * ranged segments in parallel when the server accepts ranges.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Third-party library headers
+#include <cpr/cpr.h>
+
+export module liboai:core.transfer;
+
+import :core.cancellation;
+import :core.error;
+import :core.response;
+
+export namespace liboai {
+
+    /**
+     * @brief A snapshot of a transfer's progress.
+     */
+    struct TransferProgress {
+        // bytes transferred so far
+        std::uint64_t bytes = 0;
+        // size of the whole transfer, 0 if it is not known
+        std::uint64_t total = 0;
+        // time since the first byte was transferred
+        std::chrono::steady_clock::duration elapsed{};
+
+        /**
+         * @return The average throughput so far, in bytes per second.
+         */
+        [[nodiscard]]
+        auto BytesPerSecond() const noexcept -> double {
+            const auto seconds = std::chrono::duration<double>(this->elapsed).count();
+            return seconds > 0.0 ? static_cast<double>(this->bytes) / seconds : 0.0;
+        }
+    };
+
+    /**
+     * @brief Receives the progress of a transfer; returning false cancels it.
+     */
+    using TransferCallback = std::function<bool(const TransferProgress&)>;
+
+    /**
+     * @brief Options for uploading a file, such as with Files::Create(...).
+     */
+    struct UploadOptions {
+        // how much of the file is read, and held in memory, at a time
+        std::size_t chunk_size = 1024 * 1024;
+        // called each time another chunk has been handed to the connection,
+        // and once more when the whole body has been
+        TransferCallback on_progress{};
+    };
+
+    /**
+     * @brief A multipart/form-data request body made of text fields and
+     *        one file, read from disk as the body is sent.
+     *
+     * The body is handed to a request as a cpr::ReadCallback, along with
+     * the Content-Type returned by ContentType(). Since it is produced as
+     * it is read, it can be sent only once; requests carrying it are not
+     * retried.
+     */
+    class MultipartUpload final : public std::enable_shared_from_this<MultipartUpload> {
+    public:
+        struct Field {
+            std::string name, value;
+        };
+
+        MultipartUpload(const MultipartUpload&) = delete;
+        MultipartUpload& operator=(const MultipartUpload&) = delete;
+        MultipartUpload(MultipartUpload&&) = delete;
+        MultipartUpload& operator=(MultipartUpload&&) = delete;
+        ~MultipartUpload() = default;
+
+        /**
+         * @brief Opens 'file' for upload as the form field 'file_field',
+         *        following the text 'fields'.
+         *
+         * @return The upload, or a FileError if the file cannot be read.
+         */
+        [[nodiscard]]
+        static auto Open(
+            const std::filesystem::path& file,
+            std::string_view file_field,
+            std::vector<Field> fields,
+            UploadOptions options = {}
+        ) -> Result<std::shared_ptr<MultipartUpload>>;
+
+        /**
+         * @return The value of the request's Content-Type header, which
+         *         carries the body's boundary.
+         */
+        [[nodiscard]]
+        auto ContentType() const -> std::string;
+
+        /**
+         * @return The size of the whole body, in bytes.
+         */
+        [[nodiscard]]
+        auto Size() const noexcept -> std::uint64_t;
+
+        /**
+         * @brief Returns a read callback producing the body.
+         *
+         * The callback keeps the upload alive. Reading fails, aborting the
+         * transfer, if the file cannot be read to the end or if
+         * UploadOptions::on_progress returns false.
+         */
+        [[nodiscard]]
+        auto ReadCallback() -> cpr::ReadCallback;
+
+        /**
+         * @return Whether the upload was cancelled through on_progress.
+         */
+        [[nodiscard]]
+        auto Cancelled() const noexcept -> bool;
+
+    private:
+        MultipartUpload() = default;
+
+        auto Read(char* buffer, std::size_t& size) -> bool;
+        auto Report() -> bool;
+
+        [[nodiscard]]
+        static auto MakeBoundary() -> std::string;
+        [[nodiscard]]
+        static auto QuoteFilename(std::string_view name) -> std::string;
+
+        UploadOptions m_options;
+        std::string m_boundary;
+        // the form before and after the file's contents
+        std::string m_head, m_tail;
+
+        std::ifstream m_file;
+        std::uint64_t m_file_size = 0;
+        std::vector<char> m_chunk;
+        std::size_t m_chunk_pos = 0, m_chunk_len = 0;
+
+        std::uint64_t m_sent = 0, m_next_report = 0;
+        bool m_reported_done = false;
+        std::chrono::steady_clock::time_point m_started{};
+        std::atomic<bool> m_cancelled{ false };
+    };
+
+    /**
+     * @brief Options for liboai::Downloader.
+     */
+    struct DownloadOptions {
+        // bytes received on a connection before they are written out
+        std::size_t buffer_size = 1024 * 1024;
+        // ranged requests a download is split into, if the server accepts
+        // ranges; 1 fetches it with a single request
+        std::size_t segments = 1;
+        // downloads are not split into segments smaller than this
+        std::uint64_t min_segment_size = 8 * 1024 * 1024;
+        // times a transfer that broke off is resumed from its last byte
+        std::uint32_t max_resumes = 3;
+        // called each time a buffer has been written out, and once more
+        // when the download is complete
+        TransferCallback on_progress{};
+    };
+
+    /**
+     * @brief The outcome of a completed download.
+     */
+    struct DownloadStats : TransferProgress {
+        // ranged requests the download was split into
+        std::uint32_t segments = 0;
+        // transfers resumed after breaking off
+        std::uint32_t resumes = 0;
+    };
+
+    /**
+     * @brief Fetches a URL with a GET request, to a file or to memory.
+     *
+     * When DownloadOptions::segments is above 1, a HEAD request first asks
+     * for the size of the content; if the server accepts byte ranges, the
+     * content is split into that many segments, each fetched on its own
+     * connection and thread. Otherwise it is fetched with one request.
+     *
+     * A request that fails with a connection error or a 5xx status is
+     * resumed from the first byte not yet received. A server ignoring the
+     * Range of a resumed request restarts the download from the beginning.
+     * Cancelling through DownloadOptions::on_progress fails the download
+     * with ErrorCode::CURLError; cancelling its RequestControl, or letting
+     * its deadline pass, fails it with ErrorCode::Cancelled or
+     * ErrorCode::DeadlineExceeded.
+     */
+    class Downloader final {
+    public:
+        Downloader() = delete;
+
+        /**
+         * @brief Downloads 'url' to the file 'to'.
+         *
+         * The content is written to 'to' + ".part", which replaces 'to'
+         * once the download is complete and is removed if it fails, so an
+         * incomplete download never takes the place of the file.
+         */
+        [[nodiscard]]
+        static auto ToFile(
+            const std::filesystem::path& to,
+            const std::string& url,
+            const cpr::Header& headers,
+            const DownloadOptions& options = {},
+            const cpr::Proxies& proxies = {},
+            const cpr::ProxyAuthentication& proxy_auth = {},
+            const RequestControl& control = {}
+        ) -> Result<DownloadStats>;
+
+        /**
+         * @brief Downloads 'url' into 'to', replacing its contents.
+         */
+        [[nodiscard]]
+        static auto ToMemory(
+            std::string& to,
+            const std::string& url,
+            const cpr::Header& headers,
+            const DownloadOptions& options = {},
+            const cpr::Proxies& proxies = {},
+            const cpr::ProxyAuthentication& proxy_auth = {},
+            const RequestControl& control = {}
+        ) -> Result<DownloadStats>;
+
+    private:
+        // writes received data at an offset of the content
+        using Writer = std::function<bool(std::uint64_t offset, std::string_view data)>;
+
+        struct Job {
+            const std::string& url;
+            const cpr::Header& headers;
+            const DownloadOptions& options;
+            const cpr::Proxies& proxies;
+            const cpr::ProxyAuthentication& proxy_auth;
+            const RequestControl& control;
+
+            // called once per segment
+            std::function<Writer()> open_writer{};
+            // called with the size of the content once it is known
+            std::function<bool(std::uint64_t size)> resize{};
+
+            std::atomic<std::uint64_t> bytes{ 0 };
+            std::atomic<std::uint32_t> resumes{ 0 };
+            std::atomic<bool> abort{ false };
+
+            std::mutex progress_mutex{};
+            std::uint64_t total = 0, next_report = 0;
+            // the error that ended the download, rather than those of the
+            // segments it aborted
+            std::optional<OpenAIError> error{};
+            std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        };
+
+        [[nodiscard]]
+        static auto Run(Job& job) -> Result<DownloadStats>;
+
+        [[nodiscard]]
+        static auto Probe(Job& job) -> std::optional<std::uint64_t>;
+
+        [[nodiscard]]
+        static auto Fetch(Job& job, std::uint64_t start, std::optional<std::uint64_t> last)
+            -> Result<void>;
+
+        static auto Report(Job& job, bool done) -> bool;
+
+        static auto Fail(Job& job, OpenAIError error) -> std::unexpected<OpenAIError>;
+    };
+
+    // Implementation
+    inline auto MultipartUpload::Open(
+        const std::filesystem::path& file,
+        std::string_view file_field,
+        std::vector<Field> fields,
+        UploadOptions options
+    ) -> Result<std::shared_ptr<MultipartUpload>> {
+        std::shared_ptr<MultipartUpload> upload(new MultipartUpload());
+
+        std::error_code ec;
+        upload->m_file_size = std::filesystem::file_size(file, ec);
+        if (ec) {
+            return std::unexpected(
+                OpenAIError::file_error("Cannot stat '" + file.string() + "': " + ec.message())
+            );
+        }
+
+        upload->m_file.rdbuf()->pubsetbuf(nullptr, 0); // reads go straight into m_chunk
+        upload->m_file.open(file, std::ios::binary);
+        if (!upload->m_file) {
+            return std::unexpected(
+                OpenAIError::file_error("Cannot open '" + file.string() + "' for reading.")
+            );
+        }
+
+        upload->m_options = std::move(options);
+        if (upload->m_options.chunk_size == 0) {
+            upload->m_options.chunk_size = UploadOptions{}.chunk_size;
+        }
+        upload->m_chunk.resize(
+            static_cast<std::size_t>(
+                std::min<std::uint64_t>(upload->m_options.chunk_size, upload->m_file_size)
+            )
+        );
+
+        upload->m_boundary = MakeBoundary();
+        auto& head = upload->m_head;
+        for (const auto& field : fields) {
+            head += "--" + upload->m_boundary + "\r\n";
+            head += "Content-Disposition: form-data; name=\"" + field.name + "\"\r\n\r\n";
+            head += field.value + "\r\n";
+        }
+        head += "--" + upload->m_boundary + "\r\n";
+        head += "Content-Disposition: form-data; name=\"";
+        head += file_field;
+        head += "\"; filename=\"" + QuoteFilename(file.filename().string()) + "\"\r\n";
+        head += "Content-Type: application/octet-stream\r\n\r\n";
+        upload->m_tail = "\r\n--" + upload->m_boundary + "--\r\n";
+
+        return upload;
+    }
+
+    inline auto MultipartUpload::ContentType() const -> std::string {
+        return "multipart/form-data; boundary=" + this->m_boundary;
+    }
+
+    inline auto MultipartUpload::Size() const noexcept -> std::uint64_t {
+        return this->m_head.size() + this->m_file_size + this->m_tail.size();
+    }
+
+    inline auto MultipartUpload::ReadCallback() -> cpr::ReadCallback {
+        return cpr::ReadCallback{
+            static_cast<cpr_off_t>(this->Size()),
+            [self = this->shared_from_this()](char* buffer, std::size_t& size, std::intptr_t) {
+                return self->Read(buffer, size);
+            }
+        };
+    }
+
+    inline auto MultipartUpload::Cancelled() const noexcept -> bool {
+        return this->m_cancelled.load(std::memory_order_relaxed);
+    }
+
+    inline auto MultipartUpload::Read(char* buffer, std::size_t& size) -> bool {
+        if (this->m_sent == 0) {
+            this->m_started = std::chrono::steady_clock::now();
+        }
+
+        const std::uint64_t head_end = this->m_head.size();
+        const std::uint64_t file_end = head_end + this->m_file_size;
+        std::size_t filled = 0;
+
+        while (filled < size && this->m_sent < this->Size()) {
+            std::size_t n = 0;
+            if (this->m_sent < head_end) {
+                n = std::min<std::size_t>(size - filled, head_end - this->m_sent);
+                std::memcpy(buffer + filled, this->m_head.data() + this->m_sent, n);
+            } else if (this->m_sent < file_end) {
+                if (this->m_chunk_pos == this->m_chunk_len) {
+                    const auto want = std::min<std::uint64_t>(
+                        this->m_chunk.size(),
+                        file_end - this->m_sent
+                    );
+                    this->m_file.read(this->m_chunk.data(), static_cast<std::streamsize>(want));
+                    if (static_cast<std::uint64_t>(this->m_file.gcount()) != want) {
+                        return false; // the file shrank or could not be read
+                    }
+                    this->m_chunk_pos = 0;
+                    this->m_chunk_len = static_cast<std::size_t>(want);
+                }
+                n = std::min(size - filled, this->m_chunk_len - this->m_chunk_pos);
+                std::memcpy(buffer + filled, this->m_chunk.data() + this->m_chunk_pos, n);
+                this->m_chunk_pos += n;
+            } else {
+                const auto offset = static_cast<std::size_t>(this->m_sent - file_end);
+                n = std::min(size - filled, this->m_tail.size() - offset);
+                std::memcpy(buffer + filled, this->m_tail.data() + offset, n);
+            }
+            filled += n;
+            this->m_sent += n;
+        }
+
+        size = filled;
+        return this->Report();
+    }
+
+    inline auto MultipartUpload::Report() -> bool {
+        if (!this->m_options.on_progress) {
+            return true;
+        }
+        const bool done = this->m_sent == this->Size();
+        if (this->m_reported_done || (!done && this->m_sent < this->m_next_report)) {
+            return true;
+        }
+        this->m_next_report = this->m_sent + this->m_options.chunk_size;
+        this->m_reported_done = done;
+
+        const TransferProgress progress{
+            this->m_sent,
+            this->Size(),
+            std::chrono::steady_clock::now() - this->m_started
+        };
+        if (!this->m_options.on_progress(progress)) {
+            this->m_cancelled.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    inline auto MultipartUpload::MakeBoundary() -> std::string {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::random_device random;
+        std::string boundary = "liboai-";
+        for (int i = 0; i < 4; ++i) {
+            auto bits = random();
+            for (int j = 0; j < 8; ++j, bits >>= 4) {
+                boundary += digits[bits & 0xF];
+            }
+        }
+        return boundary;
+    }
+
+    inline auto MultipartUpload::QuoteFilename(std::string_view name) -> std::string {
+        // as browsers encode them in a quoted filename parameter
+        std::string quoted;
+        quoted.reserve(name.size());
+        for (const char c : name) {
+            switch (c) {
+                case '"':
+                    quoted += "%22";
+                    break;
+                case '\r':
+                    quoted += "%0D";
+                    break;
+                case '\n':
+                    quoted += "%0A";
+                    break;
+                default:
+                    quoted += c;
+            }
+        }
+        return quoted;
+    }
+
+    inline auto Downloader::ToFile(
+        const std::filesystem::path& to,
+        const std::string& url,
+        const cpr::Header& headers,
+        const DownloadOptions& options,
+        const cpr::Proxies& proxies,
+        const cpr::ProxyAuthentication& proxy_auth,
+        const RequestControl& control
+    ) -> Result<DownloadStats> {
+        auto part = to;
+        part += ".part";
+        {
+            std::ofstream create(part, std::ios::binary | std::ios::trunc);
+            if (!create) {
+                return std::unexpected(
+                    OpenAIError::file_error("Cannot open '" + part.string() + "' for writing.")
+                );
+            }
+        }
+
+        Job job{ url, headers, options, proxies, proxy_auth, control };
+        job.open_writer = [&part]() -> Writer {
+            // one stream per segment, so segments can write concurrently
+            auto file = std::make_shared<std::ofstream>(
+                part,
+                std::ios::binary | std::ios::in | std::ios::out
+            );
+            if (!*file) {
+                return nullptr;
+            }
+            return [file](std::uint64_t offset, std::string_view data) {
+                file->seekp(static_cast<std::streamoff>(offset));
+                file->write(data.data(), static_cast<std::streamsize>(data.size()));
+                return file->good() && file->flush().good();
+            };
+        };
+        job.resize = [&part](std::uint64_t size) {
+            std::error_code ec;
+            std::filesystem::resize_file(part, size, ec);
+            return !ec;
+        };
+
+        auto stats = Downloader::Run(job);
+        std::error_code ec;
+        if (stats) {
+            std::filesystem::rename(part, to, ec);
+            if (ec) {
+                std::filesystem::remove(part, ec);
+                return std::unexpected(
+                    OpenAIError::file_error("Cannot move download to '" + to.string() + "'.")
+                );
+            }
+        } else {
+            std::filesystem::remove(part, ec);
+        }
+        return stats;
+    }
+
+    inline auto Downloader::ToMemory(
+        std::string& to,
+        const std::string& url,
+        const cpr::Header& headers,
+        const DownloadOptions& options,
+        const cpr::Proxies& proxies,
+        const cpr::ProxyAuthentication& proxy_auth,
+        const RequestControl& control
+    ) -> Result<DownloadStats> {
+        to.clear();
+        Job job{ url, headers, options, proxies, proxy_auth, control };
+        job.open_writer = [&to]() -> Writer {
+            // segments write disjoint ranges of a string sized up front
+            return [&to](std::uint64_t offset, std::string_view data) {
+                const auto end = static_cast<std::size_t>(offset) + data.size();
+                if (end > to.size()) {
+                    to.resize(end);
+                }
+                std::memcpy(to.data() + offset, data.data(), data.size());
+                return true;
+            };
+        };
+        job.resize = [&to](std::uint64_t size) {
+            to.resize(static_cast<std::size_t>(size));
+            return true;
+        };
+        return Downloader::Run(job);
+    }
+
+    inline auto Downloader::Run(Job& job) -> Result<DownloadStats> {
+        std::size_t segments = 1;
+        if (job.options.segments > 1) {
+            if (auto size = Downloader::Probe(job); size && job.resize(*size)) {
+                job.total = *size;
+                const auto most = std::max<std::uint64_t>(
+                    1,
+                    *size / std::max<std::uint64_t>(job.options.min_segment_size, 1)
+                );
+                segments = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(job.options.segments, most)
+                );
+            }
+        }
+
+        if (segments == 1) {
+            if (Downloader::Fetch(job, 0, std::nullopt)) {
+                // a restarted download may have come back shorter
+                job.total = job.bytes.load();
+                if (!job.resize(job.total)) {
+                    Downloader::Fail(job, OpenAIError::file_error("Cannot resize download."));
+                }
+            }
+        } else {
+            const auto step = job.total / segments;
+            std::vector<std::jthread> threads;
+            threads.reserve(segments - 1);
+            for (std::size_t i = 1; i < segments; ++i) {
+                const auto first = i * step;
+                const auto last = i + 1 == segments ? job.total - 1 : first + step - 1;
+                threads.emplace_back([&job, first, last]() {
+                    static_cast<void>(Downloader::Fetch(job, first, last));
+                });
+            }
+            static_cast<void>(Downloader::Fetch(job, 0, step - 1));
+            threads.clear();
+        }
+        if (job.error) {
+            return std::unexpected(std::move(*job.error));
+        }
+
+        Downloader::Report(job, true);
+
+        DownloadStats stats;
+        stats.bytes = job.bytes.load();
+        stats.total = job.total;
+        stats.elapsed = std::chrono::steady_clock::now() - job.started;
+        stats.segments = static_cast<std::uint32_t>(segments);
+        stats.resumes = job.resumes.load();
+        return stats;
+    }
+
+    inline auto Downloader::Probe(Job& job) -> std::optional<std::uint64_t> {
+        cpr::Session session;
+        session.SetUrl(cpr::Url{ job.url });
+        session.SetHeader(job.headers);
+        session.SetProxies(job.proxies);
+        session.SetProxyAuth(job.proxy_auth);
+        if (const auto remaining = job.control.Remaining()) {
+            session.SetTimeout(cpr::Timeout{ *remaining });
+        }
+        const auto response = session.Head();
+        if (response.error || response.status_code != 200) {
+            return std::nullopt;
+        }
+
+        const auto ranges = response.header.find("Accept-Ranges");
+        const auto length = response.header.find("Content-Length");
+        if (ranges == response.header.end() || ranges->second != "bytes" ||
+            length == response.header.end()) {
+            return std::nullopt;
+        }
+
+        std::uint64_t size = 0;
+        const auto& value = length->second;
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), size);
+        if (ec != std::errc{} || end != value.data() + value.size() || size == 0) {
+            return std::nullopt;
+        }
+        return size;
+    }
+
+    inline auto Downloader::Fetch(
+        Job& job,
+        std::uint64_t start,
+        std::optional<std::uint64_t> last
+    ) -> Result<void> {
+        auto write = job.open_writer();
+        if (!write) {
+            return Downloader::Fail(
+                job,
+                OpenAIError::file_error("Cannot open download for writing.")
+            );
+        }
+
+        cpr::Session session;
+        session.SetUrl(cpr::Url{ job.url });
+        session.SetProxies(job.proxies);
+        session.SetProxyAuth(job.proxy_auth);
+        CURL* handle = session.GetCurlHolder()->handle;
+        if (job.control) {
+            // also ends stalled transfers, which receive nothing to refuse
+            session.SetProgressCallback(cpr::ProgressCallback{
+                [&job](
+                    cpr::cpr_pf_arg_t,
+                    cpr::cpr_pf_arg_t,
+                    cpr::cpr_pf_arg_t,
+                    cpr::cpr_pf_arg_t,
+                    std::intptr_t
+                ) -> bool { return !job.abort.load() && !job.control.Check(); }
+            });
+        }
+
+        // bytes of this segment written out so far
+        std::uint64_t done = 0;
+        std::string buffer;
+        buffer.reserve(job.options.buffer_size);
+        bool write_failed = false, range_ignored = false;
+
+        const auto flush = [&]() -> bool {
+            if (buffer.empty()) {
+                return true;
+            }
+            if (!write(start + done, buffer)) {
+                write_failed = true;
+                return false;
+            }
+            done += buffer.size();
+            job.bytes += buffer.size();
+            buffer.clear();
+            return Downloader::Report(job, false);
+        };
+
+        for (std::uint32_t attempt = 0;; ++attempt) {
+            if (auto error = job.control.Check()) {
+                return Downloader::Fail(job, std::move(*error));
+            }
+            if (const auto remaining = job.control.Remaining()) {
+                session.SetTimeout(cpr::Timeout{ *remaining });
+            }
+
+            const auto from = start + done;
+            cpr::Header headers = job.headers;
+            if (from > 0 || last) {
+                headers["Range"] = "bytes=" + std::to_string(from) + "-" +
+                                   (last ? std::to_string(*last) : std::string{});
+            }
+            session.SetHeader(headers);
+
+            long status = 0;
+            std::string error_body;
+            session.SetWriteCallback(cpr::WriteCallback{
+                [&](std::string_view data, std::intptr_t) -> bool {
+                    if (job.abort.load(std::memory_order_relaxed)) {
+                        return false;
+                    }
+                    if (status == 0) {
+                        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+                        // a segment, the first one included, must get only its
+                        // range; the whole file would overwrite the others
+                        if (status == 200 && (start > 0 || last)) {
+                            range_ignored = true;
+                            return false;
+                        }
+                        if (status == 200 && from > 0) {
+                            job.bytes -= done; // the content starts over
+                            done = 0;
+                        }
+                        if (status == 200 && !last) {
+                            curl_off_t length = -1;
+                            curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+                            if (length > 0) {
+                                std::lock_guard<std::mutex> lock(job.progress_mutex);
+                                job.total = static_cast<std::uint64_t>(length);
+                            }
+                        }
+                    }
+                    if (status >= 300) {
+                        // kept to report the error, up to a sensible size
+                        error_body.append(data.substr(
+                            0,
+                            std::min<std::size_t>(data.size(), 64 * 1024 - error_body.size())
+                        ));
+                        return true;
+                    }
+                    buffer.append(data);
+                    return buffer.size() < job.options.buffer_size || flush();
+                }
+            });
+
+            auto response = session.Get();
+            const bool flushed = status < 300 && flush();
+            if (write_failed) {
+                return Downloader::Fail(job, OpenAIError::file_error("Cannot write download."));
+            }
+            if (range_ignored) {
+                return Downloader::Fail(
+                    job,
+                    OpenAIError::bad_request("The server ignored the Range of a segment.")
+                );
+            }
+
+            if (auto error = job.control.Check()) {
+                return Downloader::Fail(job, std::move(*error));
+            }
+
+            const bool received = !response.error &&
+                                  (response.status_code == 200 || response.status_code == 206);
+            const bool whole = !last || start + done == *last + 1;
+            if (received && flushed && whole) {
+                return {};
+            }
+
+            // the connection broke off, or the server failed
+            const bool transient = !job.abort.load() &&
+                                   (response.error || received || response.status_code >= 500);
+            if (!transient || attempt >= job.options.max_resumes) {
+                if (response.error) {
+                    return Downloader::Fail(job, OpenAIError::curl_error(response.error.message));
+                }
+                if (received) {
+                    return Downloader::Fail(
+                        job,
+                        OpenAIError::connection_error("Download ended before it was complete.")
+                    );
+                }
+
+                const auto status = static_cast<int>(response.status_code);
+                response.text = std::move(error_body);
+                auto error = to_liboai_response(std::move(response));
+                return Downloader::Fail(
+                    job,
+                    error ? OpenAIError::bad_request("Unexpected download status.", status) :
+                            std::move(error.error())
+                );
+            }
+            job.resumes += 1;
+        }
+    }
+
+    inline auto Downloader::Report(Job& job, bool done) -> bool {
+        if (!job.options.on_progress) {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(job.progress_mutex);
+        const auto bytes = job.bytes.load();
+        if (!done && bytes < job.next_report) {
+            return true;
+        }
+        job.next_report = bytes + job.options.buffer_size;
+
+        const TransferProgress progress{
+            bytes,
+            job.total,
+            std::chrono::steady_clock::now() - job.started
+        };
+        if (!job.options.on_progress(progress)) {
+            job.abort = true;
+            return false;
+        }
+        return true;
+    }
+
+
+    inline auto Downloader::Fail(Job& job, OpenAIError error) -> std::unexpected<OpenAIError> {
+        {
+            std::lock_guard<std::mutex> lock(job.progress_mutex);
+            if (!job.error) {
+                job.error = error;
+            }
+        }
+        job.abort = true;
+        return std::unexpected(std::move(error));
+    }
+
+} // namespace liboai
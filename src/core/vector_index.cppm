@@ -0,0 +1,1204 @@
+/**
+ * @file vector_index.cppm
+ *
+ * liboai vector index implementation.
+ * This module provides declarations for liboai::VectorIndex, a small
+ * in-process nearest-neighbour index over embeddings, and
+ * liboai::VectorKernels, the similarity kernels it is built on.
+ *
+ * The kernels are compiled for AVX-512, AVX2/FMA and NEON where the
+ * compiler supports them; on x86 the best one the CPU runs is picked at
+ * startup, so binaries built for a generic target still use wide
+ * vectors. A scalar kernel covers everything else.
+ *
+ * The index is searched exhaustively, split across threads for large
+ * collections, or, once trained, as an inverted file (IVF): vectors are
+ * clustered around k-means centroids and a query only scans the
+ * clusters nearest to it. An index can be saved to a single file and
+ * loaded back through a read-only memory mapping, so opening one costs
+ * no parsing and pages in only what searches touch.
+ */
+
+module;
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Platform headers
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+// each kernel is compiled for its own ISA and chosen at runtime
+#define LIBOAI_VECTOR_TARGET(isa) __attribute__((target(isa)))
+#define LIBOAI_VECTOR_RUNTIME_DISPATCH 1
+#define LIBOAI_VECTOR_AVX2 1
+#define LIBOAI_VECTOR_AVX512 1
+#else
+// only the ISAs enabled for the whole build (/arch) are available; this
+// includes clang-cl, whose __builtin_cpu_supports needs compiler-rt
+#define LIBOAI_VECTOR_TARGET(isa)
+#if defined(__AVX2__)
+#define LIBOAI_VECTOR_AVX2 1
+#endif
+#if defined(__AVX512F__)
+#define LIBOAI_VECTOR_AVX512 1
+#endif
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LIBOAI_VECTOR_NEON 1
+#endif
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+export module liboai:core.vector_index;
+
+import :core.embedding_matrix;
+import :core.error;
+
+export namespace liboai {
+
+    /**
+     * @brief Dot-product and cosine kernels over float vectors.
+     */
+    class VectorKernels final {
+    public:
+        VectorKernels() = delete;
+
+        /**
+         * @return The dot product of 'a' and 'b', which must be the same
+         *         length.
+         */
+        [[nodiscard]]
+        static auto Dot(std::span<const float> a, std::span<const float> b) noexcept -> float {
+            return Selected().dot(a.data(), b.data(), std::min(a.size(), b.size()));
+        }
+
+        /**
+         * @return The cosine similarity of 'a' and 'b'; 0 if either is zero.
+         */
+        [[nodiscard]]
+        static auto Cosine(std::span<const float> a, std::span<const float> b) noexcept -> float;
+
+        [[nodiscard]]
+        static auto Norm(std::span<const float> v) noexcept -> float {
+            return std::sqrt(Dot(v, v));
+        }
+
+        /**
+         * @brief Scales 'v' to unit length, leaving a zero vector as it is.
+         */
+        static auto Normalize(std::span<float> v) noexcept -> void;
+
+        /**
+         * @return The instruction set of the kernel in use: "avx512",
+         *         "avx2", "neon" or "scalar".
+         */
+        [[nodiscard]]
+        static auto Isa() noexcept -> std::string_view {
+            return Selected().isa;
+        }
+
+    private:
+        using DotFn = float (*)(const float*, const float*, std::size_t) noexcept;
+
+        struct Kernel {
+            DotFn dot;
+            std::string_view isa;
+        };
+
+        [[nodiscard]]
+        static auto Selected() noexcept -> const Kernel& {
+            static const Kernel kernel = Select();
+            return kernel;
+        }
+
+        static auto Select() noexcept -> Kernel;
+
+        static auto DotScalar(const float* a, const float* b, std::size_t n) noexcept -> float;
+#if defined(LIBOAI_VECTOR_AVX2)
+        LIBOAI_VECTOR_TARGET("avx2,fma")
+        static auto DotAvx2(const float* a, const float* b, std::size_t n) noexcept -> float;
+#endif
+#if defined(LIBOAI_VECTOR_AVX512)
+        LIBOAI_VECTOR_TARGET("avx512f")
+        static auto DotAvx512(const float* a, const float* b, std::size_t n) noexcept -> float;
+#endif
+#if defined(LIBOAI_VECTOR_NEON)
+        static auto DotNeon(const float* a, const float* b, std::size_t n) noexcept -> float;
+#endif
+    };
+
+    enum class VectorMetric : std::uint8_t {
+        Cosine,      // vectors are normalized when added; scores in [-1, 1]
+        InnerProduct // raw dot product
+    };
+
+    /**
+     * @brief Construction-time options for liboai::VectorIndex.
+     */
+    struct VectorIndexOptions {
+        VectorMetric metric = VectorMetric::Cosine;
+        // clusters scanned per query once the index is trained
+        std::size_t nprobe = 8;
+        // threads an exhaustive search or training pass is split across;
+        // 0 means one per hardware thread
+        std::size_t threads = 0;
+        // fewest vectors given to each thread; smaller scans stay on the
+        // calling thread
+        std::size_t min_rows_per_thread = 8192;
+    };
+
+    struct VectorHit {
+        std::uint64_t id = 0;
+        float score = 0.0f;
+    };
+
+    class VectorIndex final {
+    public:
+        /**
+         * @param dims    Length of the indexed vectors; 0 takes it from the
+         *                first vector added.
+         * @param options Metric and search settings.
+         */
+        explicit VectorIndex(std::size_t dims = 0, VectorIndexOptions options = {});
+
+        VectorIndex(const VectorIndex&) = delete;
+        VectorIndex& operator=(const VectorIndex&) = delete;
+        VectorIndex(VectorIndex&&) noexcept = default;
+        VectorIndex& operator=(VectorIndex&&) noexcept = default;
+        ~VectorIndex() = default;
+
+        /**
+         * @brief Adds one vector under the next free id.
+         *
+         * @return The id given to the vector.
+         */
+        auto Add(std::span<const float> vector) -> Result<std::uint64_t>;
+
+        /**
+         * @brief Adds one vector under 'id'. Ids are opaque to the index
+         *        and need not be unique.
+         */
+        auto Add(std::span<const float> vector, std::uint64_t id) -> Result<void>;
+
+        /**
+         * @brief Adds every row of 'matrix', under consecutive ids.
+         *
+         * @return The id given to the first row.
+         */
+        auto Add(const EmbeddingMatrix& matrix) -> Result<std::uint64_t>;
+
+        /**
+         * @brief Clusters the indexed vectors into 'lists' k-means clusters,
+         *        switching searches from exhaustive to IVF.
+         *
+         * Vectors added later are assigned to their nearest cluster
+         * without retraining. Training with 0 lists returns the index to
+         * exhaustive search.
+         *
+         * @param lists      Number of clusters; a few times the square root
+         *                   of the number of vectors is a good start.
+         * @param iterations Rounds of k-means refinement.
+         */
+        auto Train(std::size_t lists, std::size_t iterations = 10) -> Result<void>;
+
+        /**
+         * @return The 'k' vectors scoring highest against 'query', best
+         *         first.
+         */
+        [[nodiscard]]
+        auto Search(std::span<const float> query, std::size_t k) const
+            -> Result<std::vector<VectorHit>>;
+
+        /**
+         * @brief Writes the index to 'path', replacing it atomically.
+         */
+        auto Save(const std::filesystem::path& path) const -> Result<void>;
+
+        /**
+         * @brief Opens an index written by Save(...), mapping it read-only.
+         *
+         * The vectors stay in the mapped file; adding to or training the
+         * loaded index first copies them into memory. The metric is the
+         * one the index was saved with.
+         */
+        [[nodiscard]]
+        static auto Load(const std::filesystem::path& path, VectorIndexOptions options = {})
+            -> Result<VectorIndex>;
+
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t {
+            return this->m_view.ids.size();
+        }
+
+        [[nodiscard]]
+        auto dims() const noexcept -> std::size_t {
+            return this->m_dims;
+        }
+
+        /**
+         * @return The number of IVF clusters; 0 for an exhaustive index.
+         */
+        [[nodiscard]]
+        auto lists() const noexcept -> std::size_t {
+            return this->m_dims == 0 ? 0 : this->m_view.centroids.size() / this->m_dims;
+        }
+
+        [[nodiscard]]
+        auto IsMapped() const noexcept -> bool {
+            return this->m_mapped != nullptr;
+        }
+
+        [[nodiscard]]
+        auto GetOptions() const noexcept -> const VectorIndexOptions& {
+            return this->m_options;
+        }
+
+        auto SetOptions(const VectorIndexOptions& options) noexcept -> void {
+            const auto metric = this->m_options.metric;
+            this->m_options = options;
+            this->m_options.metric = metric; // fixed by the stored vectors
+        }
+
+    private:
+        class MappedFile;
+
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            // 0x01020304 as written by the saving host
+            std::uint32_t byte_order;
+            std::uint32_t metric;
+            std::uint32_t reserved;
+            std::uint64_t dims, count, lists;
+        };
+
+        static constexpr char kMagic[8] = { 'L', 'I', 'B', 'O', 'A', 'I', 'V', 'X' };
+        static constexpr std::uint32_t kVersion = 1;
+        static constexpr std::uint32_t kByteOrder = 0x01020304;
+        // fewest added rows merged into the lists at once
+        static constexpr std::size_t kMinPending = 4096;
+
+        // what searches read: the owned storage below, or the mapped file
+        struct View {
+            std::span<const std::uint64_t> ids;
+            std::span<const float> vectors;
+            std::span<const float> centroids;
+            // IVF cluster i holds rows list_rows[list_offsets[i], list_offsets[i + 1])
+            std::span<const std::uint64_t> list_offsets;
+            std::span<const std::uint32_t> list_rows;
+        };
+
+        struct Candidate {
+            float score;
+            std::size_t row;
+        };
+
+        // the best 'k' candidates seen, as a min-heap on score
+        class TopK {
+        public:
+            explicit TopK(std::size_t k) : m_k(k) {
+                this->m_heap.reserve(k);
+            }
+
+            auto Push(float score, std::size_t row) -> void;
+
+            [[nodiscard]]
+            auto Take() && -> std::vector<Candidate> {
+                return std::move(this->m_heap);
+            }
+
+        private:
+            static auto Worse(const Candidate& a, const Candidate& b) noexcept -> bool {
+                return a.score > b.score;
+            }
+
+            std::size_t m_k;
+            std::vector<Candidate> m_heap;
+        };
+
+        auto AddRows(const float* data, std::size_t rows, std::uint64_t first_id) -> Result<void>;
+        auto CheckDims(std::size_t dims) -> Result<void>;
+        // copies mapped data into owned storage before a modification
+        auto Materialize() -> void;
+        auto Rebind() noexcept -> void;
+
+        [[nodiscard]]
+        auto Row(std::size_t row) const noexcept -> std::span<const float> {
+            return this->m_view.vectors.subspan(row * this->m_dims, this->m_dims);
+        }
+
+        [[nodiscard]]
+        auto NearestList(std::span<const float> vector) const noexcept -> std::uint32_t;
+        auto BuildLists(std::span<const std::uint32_t> assignment) -> void;
+        // the lists with the pending rows merged in, as BuildLists would make them
+        auto MergeLists(std::vector<std::uint64_t>& offsets, std::vector<std::uint32_t>& rows) const
+            -> void;
+        auto FlushPending() -> void;
+
+        [[nodiscard]]
+        auto Chunks(std::size_t rows) const noexcept -> std::size_t;
+
+        /**
+         * @brief Runs fn(chunk, begin, end) for 'chunks' slices of [0, rows),
+         *        the first on the calling thread and the rest on their own.
+         */
+        template <class Fn>
+        auto ForEachChunk(std::size_t rows, std::size_t chunks, Fn&& fn) const -> void;
+
+        std::size_t m_dims = 0;
+        VectorIndexOptions m_options;
+        std::uint64_t m_next_id = 0;
+
+        std::vector<std::uint64_t> m_ids;
+        std::vector<float> m_vectors;
+        std::vector<float> m_centroids;
+        std::vector<std::uint64_t> m_list_offsets;
+        std::vector<std::uint32_t> m_list_rows;
+        // the clusters of rows added since the lists were built, which
+        // follow the listed rows; merged into the lists in batches
+        std::vector<std::uint32_t> m_pending;
+
+        View m_view;
+        std::unique_ptr<MappedFile> m_mapped;
+    };
+
+    // Implementation
+    inline auto
+    VectorKernels::Cosine(std::span<const float> a, std::span<const float> b) noexcept -> float {
+        const float norms = Norm(a) * Norm(b);
+        return norms > 0.0f ? Dot(a, b) / norms : 0.0f;
+    }
+
+    inline auto VectorKernels::Normalize(std::span<float> v) noexcept -> void {
+        const float norm = Norm(v);
+        if (norm > 0.0f) {
+            const float scale = 1.0f / norm;
+            for (auto& x : v) {
+                x *= scale;
+            }
+        }
+    }
+
+    inline auto VectorKernels::Select() noexcept -> Kernel {
+#if defined(LIBOAI_VECTOR_RUNTIME_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return { &VectorKernels::DotAvx512, "avx512" };
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return { &VectorKernels::DotAvx2, "avx2" };
+        }
+#elif defined(LIBOAI_VECTOR_AVX512)
+        return { &VectorKernels::DotAvx512, "avx512" };
+#elif defined(LIBOAI_VECTOR_AVX2)
+        return { &VectorKernels::DotAvx2, "avx2" };
+#elif defined(LIBOAI_VECTOR_NEON)
+        return { &VectorKernels::DotNeon, "neon" };
+#endif
+        return { &VectorKernels::DotScalar, "scalar" };
+    }
+
+    inline auto VectorKernels::DotScalar(const float* a, const float* b, std::size_t n) noexcept
+        -> float {
+        // independent accumulators let the compiler pipeline (and vectorize) the loop
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; ++i) {
+            s0 += a[i] * b[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+#if defined(LIBOAI_VECTOR_AVX2)
+    LIBOAI_VECTOR_TARGET("avx2,fma")
+    inline auto VectorKernels::DotAvx2(const float* a, const float* b, std::size_t n) noexcept
+        -> float {
+        __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+        __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+            s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+            s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), s2);
+            s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), s3);
+        }
+        for (; i + 8 <= n; i += 8) {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+        }
+
+        const __m256 s = _mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3));
+        __m128 r = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+        r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+        r = _mm_add_ss(r, _mm_shuffle_ps(r, r, 1));
+        float sum = _mm_cvtss_f32(r);
+
+        for (; i < n; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+#endif
+
+#if defined(LIBOAI_VECTOR_AVX512)
+    LIBOAI_VECTOR_TARGET("avx512f")
+    inline auto VectorKernels::DotAvx512(const float* a, const float* b, std::size_t n) noexcept
+        -> float {
+        __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+            s1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), s1);
+        }
+        for (; i + 16 <= n; i += 16) {
+            s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+        }
+        if (i < n) {
+            // masked loads read nothing past the end
+            const auto mask = static_cast<__mmask16>((1u << (n - i)) - 1u);
+            s1 = _mm512_fmadd_ps(
+                _mm512_maskz_loadu_ps(mask, a + i),
+                _mm512_maskz_loadu_ps(mask, b + i),
+                s1
+            );
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(s0, s1));
+    }
+#endif
+
+#if defined(LIBOAI_VECTOR_NEON)
+    inline auto VectorKernels::DotNeon(const float* a, const float* b, std::size_t n) noexcept
+        -> float {
+        float32x4_t s0 = vdupq_n_f32(0.0f), s1 = vdupq_n_f32(0.0f);
+        float32x4_t s2 = vdupq_n_f32(0.0f), s3 = vdupq_n_f32(0.0f);
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            s0 = vfmaq_f32(s0, vld1q_f32(a + i), vld1q_f32(b + i));
+            s1 = vfmaq_f32(s1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+            s2 = vfmaq_f32(s2, vld1q_f32(a + i + 8), vld1q_f32(b + i + 8));
+            s3 = vfmaq_f32(s3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+        }
+        for (; i + 4 <= n; i += 4) {
+            s0 = vfmaq_f32(s0, vld1q_f32(a + i), vld1q_f32(b + i));
+        }
+
+        float sum = vaddvq_f32(vaddq_f32(vaddq_f32(s0, s1), vaddq_f32(s2, s3)));
+        for (; i < n; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+#endif
+
+    /**
+     * @brief A file mapped read-only into memory.
+     */
+    class VectorIndex::MappedFile final {
+    public:
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+        ~MappedFile();
+
+        [[nodiscard]]
+        static auto Open(const std::filesystem::path& path) -> Result<std::unique_ptr<MappedFile>>;
+
+        [[nodiscard]]
+        auto data() const noexcept -> const unsigned char* {
+            return this->m_data;
+        }
+
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t {
+            return this->m_size;
+        }
+
+    private:
+        MappedFile() = default;
+
+        const unsigned char* m_data = nullptr;
+        std::size_t m_size = 0;
+#if defined(_WIN32)
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#endif
+    };
+
+    inline auto VectorIndex::MappedFile::Open(const std::filesystem::path& path)
+        -> Result<std::unique_ptr<MappedFile>> {
+        const auto fail = [&path](std::string_view what) {
+            return std::unexpected(OpenAIError::file_error(
+                "Failed to " + std::string(what) + " '" + path.string() + "'"
+            ));
+        };
+
+        std::unique_ptr<MappedFile> file(new MappedFile());
+#if defined(_WIN32)
+        file->m_file = ::CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        );
+        if (file->m_file == INVALID_HANDLE_VALUE) {
+            return fail("open");
+        }
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file->m_file, &size)) {
+            return fail("stat");
+        }
+        file->m_size = static_cast<std::size_t>(size.QuadPart);
+        if (file->m_size == 0) {
+            return file;
+        }
+        file->m_mapping = ::CreateFileMappingW(file->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file->m_mapping) {
+            return fail("map");
+        }
+        file->m_data = static_cast<const unsigned char*>(
+            ::MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0)
+        );
+        if (!file->m_data) {
+            return fail("map");
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return fail("open");
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return fail("stat");
+        }
+        file->m_size = static_cast<std::size_t>(st.st_size);
+        if (file->m_size == 0) {
+            ::close(fd);
+            return file;
+        }
+        void* data = ::mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file open
+        if (data == MAP_FAILED) {
+            return fail("map");
+        }
+        file->m_data = static_cast<const unsigned char*>(data);
+#endif
+        return file;
+    }
+
+    inline VectorIndex::MappedFile::~MappedFile() {
+#if defined(_WIN32)
+        if (this->m_data) {
+            ::UnmapViewOfFile(this->m_data);
+        }
+        if (this->m_mapping) {
+            ::CloseHandle(this->m_mapping);
+        }
+        if (this->m_file != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(this->m_file);
+        }
+#else
+        if (this->m_data) {
+            ::munmap(const_cast<unsigned char*>(this->m_data), this->m_size);
+        }
+#endif
+    }
+
+    inline auto VectorIndex::TopK::Push(float score, std::size_t row) -> void {
+        if (this->m_heap.size() < this->m_k) {
+            this->m_heap.push_back({ score, row });
+            std::push_heap(this->m_heap.begin(), this->m_heap.end(), &TopK::Worse);
+        } else if (this->m_k > 0 && score > this->m_heap.front().score) {
+            std::pop_heap(this->m_heap.begin(), this->m_heap.end(), &TopK::Worse);
+            this->m_heap.back() = { score, row };
+            std::push_heap(this->m_heap.begin(), this->m_heap.end(), &TopK::Worse);
+        }
+    }
+
+    inline VectorIndex::VectorIndex(std::size_t dims, VectorIndexOptions options)
+        : m_dims(dims), m_options(options) {}
+
+    inline auto VectorIndex::Add(std::span<const float> vector) -> Result<std::uint64_t> {
+        const auto id = this->m_next_id;
+        if (auto added = this->Add(vector, id); !added) {
+            return std::unexpected(added.error());
+        }
+        return id;
+    }
+
+    inline auto VectorIndex::Add(std::span<const float> vector, std::uint64_t id) -> Result<void> {
+        if (auto checked = this->CheckDims(vector.size()); !checked) {
+            return checked;
+        }
+        return this->AddRows(vector.data(), 1, id);
+    }
+
+    inline auto VectorIndex::Add(const EmbeddingMatrix& matrix) -> Result<std::uint64_t> {
+        if (matrix.empty()) {
+            return this->m_next_id;
+        }
+        if (auto checked = this->CheckDims(matrix.dims()); !checked) {
+            return std::unexpected(checked.error());
+        }
+        const auto first_id = this->m_next_id;
+        if (auto added = this->AddRows(matrix.data().data(), matrix.rows(), first_id); !added) {
+            return std::unexpected(added.error());
+        }
+        return first_id;
+    }
+
+    inline auto VectorIndex::CheckDims(std::size_t dims) -> Result<void> {
+        if (dims == 0) {
+            return std::unexpected(OpenAIError::bad_request("Cannot index an empty vector"));
+        }
+        if (this->m_dims == 0) {
+            this->m_dims = dims;
+        } else if (dims != this->m_dims) {
+            return std::unexpected(OpenAIError::bad_request(
+                "Vector has " + std::to_string(dims) + " dimensions, the index " +
+                std::to_string(this->m_dims)
+            ));
+        }
+        return {};
+    }
+
+    inline auto VectorIndex::AddRows(const float* data, std::size_t rows, std::uint64_t first_id)
+        -> Result<void> {
+        if (this->size() + rows > std::numeric_limits<std::uint32_t>::max()) {
+            return std::unexpected(OpenAIError::bad_request("Vector index is full"));
+        }
+        this->Materialize();
+
+        const std::size_t first_row = this->m_ids.size();
+        this->m_vectors.insert(this->m_vectors.end(), data, data + rows * this->m_dims);
+        for (std::size_t i = 0; i < rows; ++i) {
+            this->m_ids.push_back(first_id + i);
+        }
+        this->m_next_id = std::max(this->m_next_id, first_id + rows);
+
+        if (this->m_options.metric == VectorMetric::Cosine) {
+            for (std::size_t i = first_row; i < first_row + rows; ++i) {
+                VectorKernels::Normalize(
+                    std::span<float>(this->m_vectors).subspan(i * this->m_dims, this->m_dims)
+                );
+            }
+        }
+        this->Rebind();
+
+        if (!this->m_centroids.empty()) {
+            for (std::size_t i = first_row; i < first_row + rows; ++i) {
+                this->m_pending.push_back(this->NearestList(this->Row(i)));
+            }
+            // a batch in proportion to the lists keeps each row's share of
+            // the merges constant, however the rows are added
+            const auto batch = std::max(kMinPending, this->m_list_rows.size() / 8);
+            if (this->m_pending.size() >= batch) {
+                this->FlushPending();
+            }
+        }
+        return {};
+    }
+
+    inline auto VectorIndex::Train(std::size_t lists, std::size_t iterations) -> Result<void> {
+        this->Materialize();
+        const std::size_t rows = this->size();
+
+        if (lists == 0) {
+            this->m_centroids.clear();
+            this->m_list_offsets.clear();
+            this->m_list_rows.clear();
+            this->m_pending.clear();
+            this->Rebind();
+            return {};
+        }
+        if (rows == 0) {
+            return std::unexpected(OpenAIError::bad_request("Cannot train an empty vector index"));
+        }
+        lists = std::min(lists, rows);
+
+        // seed the centroids with distinct vectors, chosen reproducibly
+        std::vector<std::size_t> seeds;
+        seeds.reserve(lists);
+        {
+            std::vector<std::size_t> all(rows);
+            std::iota(all.begin(), all.end(), std::size_t{ 0 });
+            std::minstd_rand rng(0x11b0a1);
+            std::sample(all.begin(), all.end(), std::back_inserter(seeds), lists, rng);
+        }
+        this->m_centroids.assign(lists * this->m_dims, 0.0f);
+        for (std::size_t c = 0; c < lists; ++c) {
+            const auto row = this->Row(seeds[c]);
+            std::copy(row.begin(), row.end(), this->m_centroids.begin() + c * this->m_dims);
+        }
+        this->Rebind();
+
+        std::vector<std::uint32_t> assignment(rows, 0);
+        const auto assign = [&] {
+            this->ForEachChunk(
+                rows,
+                this->Chunks(rows),
+                [&](std::size_t, std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        assignment[i] = this->NearestList(this->Row(i));
+                    }
+                }
+            );
+        };
+
+        std::vector<double> sums(lists * this->m_dims);
+        std::vector<std::size_t> counts(lists);
+        for (std::size_t round = 0; round < iterations; ++round) {
+            assign();
+
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(counts.begin(), counts.end(), 0);
+            for (std::size_t i = 0; i < rows; ++i) {
+                const auto row = this->Row(i);
+                auto* sum = sums.data() + assignment[i] * this->m_dims;
+                for (std::size_t d = 0; d < this->m_dims; ++d) {
+                    sum[d] += row[d];
+                }
+                ++counts[assignment[i]];
+            }
+
+            for (std::size_t c = 0; c < lists; ++c) {
+                if (counts[c] == 0) {
+                    continue; // an empty cluster keeps its centroid
+                }
+                auto centroid =
+                    std::span<float>(this->m_centroids).subspan(c * this->m_dims, this->m_dims);
+                for (std::size_t d = 0; d < this->m_dims; ++d) {
+                    centroid[d] = static_cast<float>(
+                        sums[c * this->m_dims + d] / static_cast<double>(counts[c])
+                    );
+                }
+                if (this->m_options.metric == VectorMetric::Cosine) {
+                    VectorKernels::Normalize(centroid);
+                }
+            }
+        }
+
+        assign();
+        this->BuildLists(assignment);
+        return {};
+    }
+
+    inline auto VectorIndex::Search(std::span<const float> query, std::size_t k) const
+        -> Result<std::vector<VectorHit>> {
+        if (this->m_dims != 0 && query.size() != this->m_dims) {
+            return std::unexpected(OpenAIError::bad_request(
+                "Query has " + std::to_string(query.size()) + " dimensions, the index " +
+                std::to_string(this->m_dims)
+            ));
+        }
+
+        std::vector<VectorHit> hits;
+        if (k == 0 || this->size() == 0) {
+            return hits;
+        }
+        // every TopK reserves room for k
+        k = std::min(k, this->size());
+
+        std::vector<float> normalized;
+        if (this->m_options.metric == VectorMetric::Cosine) {
+            normalized.assign(query.begin(), query.end());
+            VectorKernels::Normalize(normalized);
+            query = normalized;
+        }
+
+        std::vector<Candidate> candidates;
+        if (const std::size_t lists = this->lists(); lists > 0) {
+            // score the centroids, then scan the best 'nprobe' clusters
+            TopK probes(std::clamp<std::size_t>(this->m_options.nprobe, 1, lists));
+            for (std::size_t c = 0; c < lists; ++c) {
+                const auto centroid =
+                    this->m_view.centroids.subspan(c * this->m_dims, this->m_dims);
+                probes.Push(VectorKernels::Dot(query, centroid), c);
+            }
+
+            TopK best(k);
+            std::vector<bool> probed(lists, false);
+            for (const auto& probe : std::move(probes).Take()) {
+                probed[probe.row] = true;
+                const auto begin = this->m_view.list_offsets[probe.row];
+                const auto end = this->m_view.list_offsets[probe.row + 1];
+                for (auto i = begin; i < end; ++i) {
+                    const std::size_t row = this->m_view.list_rows[i];
+                    best.Push(VectorKernels::Dot(query, this->Row(row)), row);
+                }
+            }
+            const std::size_t listed = this->m_view.list_rows.size();
+            for (std::size_t i = 0; i < this->m_pending.size(); ++i) {
+                if (probed[this->m_pending[i]]) {
+                    best.Push(VectorKernels::Dot(query, this->Row(listed + i)), listed + i);
+                }
+            }
+            candidates = std::move(best).Take();
+        } else {
+            const std::size_t rows = this->size();
+            const std::size_t chunks = this->Chunks(rows);
+            std::vector<TopK> partial(chunks, TopK(k));
+            this->ForEachChunk(
+                rows,
+                chunks,
+                [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        partial[chunk].Push(VectorKernels::Dot(query, this->Row(i)), i);
+                    }
+                }
+            );
+            for (auto& part : partial) {
+                auto taken = std::move(part).Take();
+                candidates.insert(candidates.end(), taken.begin(), taken.end());
+            }
+        }
+
+        const std::size_t count = std::min(k, candidates.size());
+        std::partial_sort(
+            candidates.begin(),
+            candidates.begin() + static_cast<std::ptrdiff_t>(count),
+            candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+                return a.score != b.score ? a.score > b.score : a.row < b.row;
+            }
+        );
+        hits.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            hits.push_back({ this->m_view.ids[candidates[i].row], candidates[i].score });
+        }
+        return hits;
+    }
+
+    inline auto VectorIndex::Save(const std::filesystem::path& path) const -> Result<void> {
+        auto temp = path;
+        temp += ".tmp";
+
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                return std::unexpected(
+                    OpenAIError::file_error("Failed to create '" + temp.string() + "'")
+                );
+            }
+
+            FileHeader header{};
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.byte_order = kByteOrder;
+            header.metric = static_cast<std::uint32_t>(this->m_options.metric);
+            header.dims = this->m_dims;
+            header.count = this->size();
+            header.lists = this->lists();
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            // every section is padded to 8 bytes, keeping the next aligned in the mapping
+            const auto section = [&out](const auto& span) {
+                const auto bytes = span.size_bytes();
+                out.write(
+                    reinterpret_cast<const char*>(span.data()),
+                    static_cast<std::streamsize>(bytes)
+                );
+                static constexpr char padding[8] = {};
+                out.write(padding, static_cast<std::streamsize>((8 - bytes % 8) % 8));
+            };
+            section(this->m_view.ids);
+            section(this->m_view.vectors);
+            if (header.lists > 0) {
+                section(this->m_view.centroids);
+                if (this->m_pending.empty()) {
+                    section(this->m_view.list_offsets);
+                    section(this->m_view.list_rows);
+                } else {
+                    std::vector<std::uint64_t> offsets;
+                    std::vector<std::uint32_t> rows;
+                    this->MergeLists(offsets, rows);
+                    section(std::span<const std::uint64_t>(offsets));
+                    section(std::span<const std::uint32_t>(rows));
+                }
+            }
+
+            out.flush();
+            if (!out) {
+                return std::unexpected(
+                    OpenAIError::file_error("Failed to write '" + temp.string() + "'")
+                );
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+            return std::unexpected(
+                OpenAIError::file_error("Failed to replace '" + path.string() + "'")
+            );
+        }
+        return {};
+    }
+
+    inline auto VectorIndex::Load(const std::filesystem::path& path, VectorIndexOptions options)
+        -> Result<VectorIndex> {
+        const auto invalid = [&path](std::string_view why) {
+            return std::unexpected(OpenAIError::file_error(
+                "'" + path.string() + "' is not a usable vector index: " + std::string(why)
+            ));
+        };
+
+        auto mapped = MappedFile::Open(path);
+        if (!mapped) {
+            return std::unexpected(mapped.error());
+        }
+        const auto* base = (*mapped)->data();
+        const std::size_t size = (*mapped)->size();
+
+        FileHeader header{};
+        if (size < sizeof(header)) {
+            return invalid("too short");
+        }
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+            return invalid("bad signature");
+        }
+        if (header.version != kVersion) {
+            return invalid("unsupported version");
+        }
+        if (header.byte_order != kByteOrder) {
+            return invalid("saved on a host of different byte order");
+        }
+        if (header.metric > static_cast<std::uint32_t>(VectorMetric::InnerProduct) ||
+            header.dims == 0 || header.count > std::numeric_limits<std::uint32_t>::max() ||
+            header.dims > (1u << 20) || header.lists > header.count) {
+            return invalid("bad header");
+        }
+
+        // lay out the sections as Save(...) wrote them
+        std::size_t offset = sizeof(header);
+        bool truncated = false;
+        const auto section = [&]<class T>(std::size_t count) -> std::span<const T> {
+            const std::size_t bytes = count * sizeof(T);
+            if (truncated || size - offset < bytes) {
+                truncated = true;
+                return {};
+            }
+            std::span<const T> span(reinterpret_cast<const T*>(base + offset), count);
+            offset += bytes + (8 - bytes % 8) % 8;
+            offset = std::min(offset, size);
+            return span;
+        };
+
+        const auto count = static_cast<std::size_t>(header.count);
+        const auto dims = static_cast<std::size_t>(header.dims);
+        const auto lists = static_cast<std::size_t>(header.lists);
+
+        VectorIndex index(dims, options);
+        index.m_options.metric = static_cast<VectorMetric>(header.metric);
+        index.m_view.ids = section.template operator()<std::uint64_t>(count);
+        index.m_view.vectors = section.template operator()<float>(count * dims);
+        if (lists > 0) {
+            index.m_view.centroids = section.template operator()<float>(lists * dims);
+            index.m_view.list_offsets = section.template operator()<std::uint64_t>(lists + 1);
+            index.m_view.list_rows = section.template operator()<std::uint32_t>(count);
+        }
+        if (truncated) {
+            return invalid("truncated");
+        }
+
+        if (lists > 0) {
+            const auto& offsets = index.m_view.list_offsets;
+            if (offsets.front() != 0 || offsets.back() != count ||
+                !std::is_sorted(offsets.begin(), offsets.end())) {
+                return invalid("bad cluster offsets");
+            }
+            for (const auto row : index.m_view.list_rows) {
+                if (row >= count) {
+                    return invalid("bad cluster rows");
+                }
+            }
+        }
+
+        for (const auto id : index.m_view.ids) {
+            index.m_next_id = std::max(index.m_next_id, id + 1);
+        }
+        index.m_mapped = std::move(*mapped);
+        return index;
+    }
+
+    inline auto VectorIndex::Materialize() -> void {
+        if (!this->m_mapped) {
+            return;
+        }
+        this->m_ids.assign(this->m_view.ids.begin(), this->m_view.ids.end());
+        this->m_vectors.assign(this->m_view.vectors.begin(), this->m_view.vectors.end());
+        this->m_centroids.assign(this->m_view.centroids.begin(), this->m_view.centroids.end());
+        this->m_list_offsets.assign(
+            this->m_view.list_offsets.begin(),
+            this->m_view.list_offsets.end()
+        );
+        this->m_list_rows.assign(this->m_view.list_rows.begin(), this->m_view.list_rows.end());
+        this->Rebind();
+        this->m_mapped.reset();
+    }
+
+    inline auto VectorIndex::Rebind() noexcept -> void {
+        this->m_view = {
+            this->m_ids,
+            this->m_vectors,
+            this->m_centroids,
+            this->m_list_offsets,
+            this->m_list_rows
+        };
+    }
+
+    inline auto VectorIndex::NearestList(std::span<const float> vector) const noexcept
+        -> std::uint32_t {
+        std::uint32_t best = 0;
+        float best_score = -std::numeric_limits<float>::infinity();
+        const std::size_t lists = this->lists();
+        for (std::size_t c = 0; c < lists; ++c) {
+            const float score = VectorKernels::Dot(
+                vector,
+                this->m_view.centroids.subspan(c * this->m_dims, this->m_dims)
+            );
+            if (score > best_score) {
+                best_score = score;
+                best = static_cast<std::uint32_t>(c);
+            }
+        }
+        return best;
+    }
+
+    inline auto VectorIndex::BuildLists(std::span<const std::uint32_t> assignment) -> void {
+        const std::size_t lists = this->m_centroids.size() / this->m_dims;
+
+        // counting sort of rows by cluster
+        this->m_list_offsets.assign(lists + 1, 0);
+        for (const auto list : assignment) {
+            ++this->m_list_offsets[list + 1];
+        }
+        std::partial_sum(
+            this->m_list_offsets.begin(),
+            this->m_list_offsets.end(),
+            this->m_list_offsets.begin()
+        );
+
+        this->m_list_rows.resize(assignment.size());
+        std::vector<std::uint64_t> next(
+            this->m_list_offsets.begin(),
+            this->m_list_offsets.end() - 1
+        );
+        for (std::size_t row = 0; row < assignment.size(); ++row) {
+            this->m_list_rows[next[assignment[row]]++] = static_cast<std::uint32_t>(row);
+        }
+        this->m_pending.clear();
+        this->Rebind();
+    }
+
+    inline auto VectorIndex::MergeLists(
+        std::vector<std::uint64_t>& offsets,
+        std::vector<std::uint32_t>& rows
+    ) const -> void {
+        const std::size_t lists = this->lists();
+        const std::size_t listed = this->m_view.list_rows.size();
+        const auto& old_offsets = this->m_view.list_offsets;
+
+        std::vector<std::uint64_t> added(lists, 0);
+        for (const auto list : this->m_pending) {
+            ++added[list];
+        }
+        offsets.assign(lists + 1, 0);
+        for (std::size_t c = 0; c < lists; ++c) {
+            offsets[c + 1] = offsets[c] + (old_offsets[c + 1] - old_offsets[c]) + added[c];
+        }
+
+        // each cluster keeps its rows and gets its pending ones after them
+        rows.resize(listed + this->m_pending.size());
+        std::vector<std::uint64_t> next(lists);
+        for (std::size_t c = 0; c < lists; ++c) {
+            const auto list = this->m_view.list_rows.subspan(
+                old_offsets[c],
+                old_offsets[c + 1] - old_offsets[c]
+            );
+            std::copy(list.begin(), list.end(), rows.begin() + offsets[c]);
+            next[c] = offsets[c] + list.size();
+        }
+        for (std::size_t i = 0; i < this->m_pending.size(); ++i) {
+            rows[next[this->m_pending[i]]++] = static_cast<std::uint32_t>(listed + i);
+        }
+    }
+
+    inline auto VectorIndex::FlushPending() -> void {
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint32_t> rows;
+        this->MergeLists(offsets, rows);
+        this->m_list_offsets = std::move(offsets);
+        this->m_list_rows = std::move(rows);
+        this->m_pending.clear();
+        this->Rebind();
+    }
+
+    inline auto VectorIndex::Chunks(std::size_t rows) const noexcept -> std::size_t {
+        std::size_t threads = this->m_options.threads;
+        if (threads == 0) {
+            threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        const std::size_t per_thread =
+            std::max<std::size_t>(this->m_options.min_rows_per_thread, 1);
+        return std::clamp<std::size_t>(rows / per_thread, 1, threads);
+    }
+
+    template <class Fn>
+    auto VectorIndex::ForEachChunk(std::size_t rows, std::size_t chunks, Fn&& fn) const -> void {
+        const std::size_t step = (rows + chunks - 1) / chunks;
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+            const std::size_t begin = std::min(rows, chunk * step);
+            const std::size_t end = std::min(rows, begin + step);
+            workers.emplace_back([&fn, chunk, begin, end] { fn(chunk, begin, end); });
+        }
+        fn(std::size_t{ 0 }, std::size_t{ 0 }, std::min(rows, step));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+} // namespace liboai
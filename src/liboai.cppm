@@ -30,14 +30,30 @@ module;
 
 #include <memory>
 #include <string>
+#include <utility>
 
 export module liboai;
 
 // Core partitions
 export import :core.error;
 export import :core.response;
-export import :core.network;
+export import :core.sse;
+export import :core.embedding_matrix;
+export import :core.vector_index;
+export import :core.response_cache;
+export import :core.transfer;
+export import :core.cancellation;
+export import :core.observer;
+export import :core.connection_pool;
+export import :core.executor;
+export import :core.retry;
+export import :core.rate_limiter;
+export import :core.request;
+export import :core.event_loop;
+export import :core.awaitable;
 export import :core.authorization;
+export import :core.context;
+export import :core.network;
 
 // Component partitions
 export import :components.audio;
@@ -55,18 +71,23 @@ export import :components.moderations;
 export namespace liboai {
     class OpenAI {
     public:
-        explicit OpenAI(const std::string& root = "https://api.openai.com/v1")
-            : Audio(std::make_unique<liboai::Audio>(root)),
-              Azure(std::make_unique<liboai::Azure>(root)),
-              ChatCompletion(std::make_unique<liboai::ChatCompletion>(root)),
-              Completion(std::make_unique<liboai::Completions>(root)),
-              Edit(std::make_unique<liboai::Edits>(root)),
-              Embedding(std::make_unique<liboai::Embeddings>(root)),
-              File(std::make_unique<liboai::Files>(root)),
-              FineTune(std::make_unique<liboai::FineTunes>(root)),
-              Image(std::make_unique<liboai::Images>(root)),
-              Model(std::make_unique<liboai::Models>(root)),
-              Moderation(std::make_unique<liboai::Moderations>(root)) {}
+        explicit OpenAI(
+            const std::string& root = "https://api.openai.com/v1",
+            ClientOptions options = {}
+        )
+            : context(std::make_shared<ClientContext>(std::move(options))),
+              auth(context->GetAuthorization()),
+              Audio(std::make_unique<liboai::Audio>(root, context)),
+              Azure(std::make_unique<liboai::Azure>(root, context)),
+              ChatCompletion(std::make_unique<liboai::ChatCompletion>(root, context)),
+              Completion(std::make_unique<liboai::Completions>(root, context)),
+              Edit(std::make_unique<liboai::Edits>(root, context)),
+              Embedding(std::make_unique<liboai::Embeddings>(root, context)),
+              File(std::make_unique<liboai::Files>(root, context)),
+              FineTune(std::make_unique<liboai::FineTunes>(root, context)),
+              Image(std::make_unique<liboai::Images>(root, context)),
+              Model(std::make_unique<liboai::Models>(root, context)),
+              Moderation(std::make_unique<liboai::Moderations>(root, context)) {}
 
         OpenAI(OpenAI const&) = delete;
         OpenAI(OpenAI&&) = delete;
@@ -74,6 +95,13 @@ export namespace liboai {
         OpenAI& operator=(OpenAI&&) = delete;
         ~OpenAI() = default;
 
+        // state (credentials, connection pool, executor, ...) shared by all components below
+        const std::shared_ptr<ClientContext> context;
+
+        // this client's credentials; the process-wide Authorization::Authorizer()
+        // unless ClientOptions::authorization was set
+        Authorization& auth;
+
         std::unique_ptr<liboai::Audio> Audio;
         std::unique_ptr<liboai::Azure> Azure;
         std::unique_ptr<liboai::ChatCompletion> ChatCompletion;
@@ -85,7 +113,5 @@ export namespace liboai {
         std::unique_ptr<liboai::Images> Image;
         std::unique_ptr<liboai::Models> Model;
         std::unique_ptr<liboai::Moderations> Moderation;
-
-        Authorization& auth = Authorization::Authorizer();
     };
 } // namespace liboai